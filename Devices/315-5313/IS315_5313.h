@@ -4,6 +4,7 @@
 #include "DeviceInterface/DeviceInterface.pkg"
 #include "TimedBuffers/TimedBuffers.pkg"
 #include "MarshalSupport/MarshalSupport.pkg"
+#include <string>
 #include <list>
 
 class IS315_5313 :public virtual IGenericAccess
@@ -38,7 +39,7 @@ public:
 
 public:
 	//Interface version functions
-	static inline unsigned int ThisIS315_5313Version() { return 1; }
+	static inline unsigned int ThisIS315_5313Version() { return 2; }
 	virtual unsigned int GetIS315_5313Version() const = 0;
 
 	//Device access functions
@@ -56,8 +57,8 @@ public:
 	virtual unsigned int GetImageLastRenderedFrameToken() const = 0;
 	virtual unsigned int GetImageCompletedBufferPlaneNo() const = 0;
 	virtual unsigned int GetImageDrawingBufferPlaneNo() const = 0;
-	virtual void LockImageBufferData(unsigned int planeNo) = 0;
-	virtual void UnlockImageBufferData(unsigned int planeNo) = 0;
+	virtual unsigned int AcquireLatestImageBufferPlane() const = 0;
+	virtual void ReleaseImageBufferPlane(unsigned int planeNo) const = 0;
 	virtual const unsigned char* GetImageBufferData(unsigned int planeNo) const = 0;
 	virtual const ImageBufferInfo* GetImageBufferInfo(unsigned int planeNo) const = 0;
 	virtual const ImageBufferInfo* GetImageBufferInfo(unsigned int planeNo, unsigned int lineNo, unsigned int pixelNo) const = 0;
@@ -135,6 +136,10 @@ public:
 	inline void SetVideoShowBoundaryTitleSafe(bool adata);
 	inline bool GetVideoEnableFullImageBufferInfo() const;
 	inline void SetVideoEnableFullImageBufferInfo(bool adata);
+	inline unsigned int GetVideoFrameRenderInterval() const;
+	inline void SetVideoFrameRenderInterval(unsigned int adata);
+	inline bool GetVideoFrameRenderRequested() const;
+	inline void SetVideoFrameRenderRequested(bool adata);
 
 	//Layer removal
 	inline bool GetEnableLayerA() const;
@@ -162,6 +167,29 @@ public:
 	inline bool GetEnableSpriteLow() const;
 	inline void SetEnableSpriteLow(bool adata);
 
+	//Frame hash logging
+	inline bool GetFrameHashLoggingEnabled() const;
+	inline void SetFrameHashLoggingEnabled(bool adata);
+	inline std::wstring GetFrameHashLoggingPath() const;
+	inline void SetFrameHashLoggingPath(const std::wstring& adata);
+	inline std::wstring GetFrameHashComparisonPath() const;
+	inline void SetFrameHashComparisonPath(const std::wstring& adata);
+	inline unsigned int GetFrameHashInterval() const;
+	inline void SetFrameHashInterval(unsigned int adata);
+
+	//Video capture
+	inline bool GetVideoCaptureEnabled() const;
+	inline void SetVideoCaptureEnabled(bool adata);
+	inline std::wstring GetVideoCapturePath() const;
+	inline void SetVideoCapturePath(const std::wstring& adata);
+	inline unsigned int GetVideoCaptureDroppedFrameCount() const;
+
+	//Render thread statistics
+	inline double GetRenderLatency() const;
+	inline double GetRenderDrainRate() const;
+	inline unsigned int GetRenderDegradedCount() const;
+	inline unsigned int GetRenderBlockedCount() const;
+
 	//Raw register functions
 	inline unsigned int GetRegisterData(unsigned int location) const;
 	inline void SetRegisterData(unsigned int location, unsigned int adata);
@@ -145,7 +145,20 @@ enum class IS315_5313::IS315_5313DataSource
 	SettingsVideoEnableWindowLow,
 	SettingsVideoEnableSprite,
 	SettingsVideoEnableSpriteHigh,
-	SettingsVideoEnableSpriteLow
+	SettingsVideoEnableSpriteLow,
+	SettingsFrameHashLoggingEnabled,
+	SettingsFrameHashLoggingPath,
+	SettingsFrameHashComparisonPath,
+	SettingsFrameHashInterval,
+	SettingsVideoFrameRenderInterval,
+	SettingsVideoFrameRenderRequested,
+	SettingsVideoCaptureEnabled,
+	SettingsVideoCapturePath,
+	SettingsVideoCaptureDroppedFrameCount,
+	SettingsRenderLatency,
+	SettingsRenderDrainRate,
+	SettingsRenderDegradedCount,
+	SettingsRenderBlockedCount
 };
 
 //----------------------------------------------------------------------------------------
@@ -562,6 +575,36 @@ void IS315_5313::SetVideoEnableFullImageBufferInfo(bool adata)
 	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsVideoEnableFullImageBufferInfo, 0, data);
 }
 
+//----------------------------------------------------------------------------------------
+unsigned int IS315_5313::GetVideoFrameRenderInterval() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsVideoFrameRenderInterval, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void IS315_5313::SetVideoFrameRenderInterval(unsigned int adata)
+{
+	GenericAccessDataValueUInt data(adata);
+	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsVideoFrameRenderInterval, 0, data);
+}
+
+//----------------------------------------------------------------------------------------
+bool IS315_5313::GetVideoFrameRenderRequested() const
+{
+	GenericAccessDataValueBool data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsVideoFrameRenderRequested, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void IS315_5313::SetVideoFrameRenderRequested(bool adata)
+{
+	GenericAccessDataValueBool data(adata);
+	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsVideoFrameRenderRequested, 0, data);
+}
+
 //----------------------------------------------------------------------------------------
 //Layer removal
 //----------------------------------------------------------------------------------------
@@ -744,6 +787,142 @@ void IS315_5313::SetEnableSpriteLow(bool adata)
 	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsVideoEnableSpriteLow, 0, data);
 }
 
+//----------------------------------------------------------------------------------------
+//Frame hash logging
+//----------------------------------------------------------------------------------------
+bool IS315_5313::GetFrameHashLoggingEnabled() const
+{
+	GenericAccessDataValueBool data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsFrameHashLoggingEnabled, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void IS315_5313::SetFrameHashLoggingEnabled(bool adata)
+{
+	GenericAccessDataValueBool data(adata);
+	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsFrameHashLoggingEnabled, 0, data);
+}
+
+//----------------------------------------------------------------------------------------
+std::wstring IS315_5313::GetFrameHashLoggingPath() const
+{
+	GenericAccessDataValueFilePath data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsFrameHashLoggingPath, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void IS315_5313::SetFrameHashLoggingPath(const std::wstring& adata)
+{
+	GenericAccessDataValueFilePath data(adata);
+	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsFrameHashLoggingPath, 0, data);
+}
+
+//----------------------------------------------------------------------------------------
+std::wstring IS315_5313::GetFrameHashComparisonPath() const
+{
+	GenericAccessDataValueFilePath data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsFrameHashComparisonPath, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void IS315_5313::SetFrameHashComparisonPath(const std::wstring& adata)
+{
+	GenericAccessDataValueFilePath data(adata);
+	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsFrameHashComparisonPath, 0, data);
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int IS315_5313::GetFrameHashInterval() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsFrameHashInterval, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void IS315_5313::SetFrameHashInterval(unsigned int adata)
+{
+	GenericAccessDataValueUInt data(adata);
+	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsFrameHashInterval, 0, data);
+}
+
+//----------------------------------------------------------------------------------------
+//Video capture
+//----------------------------------------------------------------------------------------
+bool IS315_5313::GetVideoCaptureEnabled() const
+{
+	GenericAccessDataValueBool data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsVideoCaptureEnabled, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void IS315_5313::SetVideoCaptureEnabled(bool adata)
+{
+	GenericAccessDataValueBool data(adata);
+	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsVideoCaptureEnabled, 0, data);
+}
+
+//----------------------------------------------------------------------------------------
+std::wstring IS315_5313::GetVideoCapturePath() const
+{
+	GenericAccessDataValueFilePath data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsVideoCapturePath, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void IS315_5313::SetVideoCapturePath(const std::wstring& adata)
+{
+	GenericAccessDataValueFilePath data(adata);
+	WriteGenericData((unsigned int)IS315_5313DataSource::SettingsVideoCapturePath, 0, data);
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int IS315_5313::GetVideoCaptureDroppedFrameCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsVideoCaptureDroppedFrameCount, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+//Render thread statistics
+//----------------------------------------------------------------------------------------
+double IS315_5313::GetRenderLatency() const
+{
+	GenericAccessDataValueDouble data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsRenderLatency, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+double IS315_5313::GetRenderDrainRate() const
+{
+	GenericAccessDataValueDouble data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsRenderDrainRate, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int IS315_5313::GetRenderDegradedCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsRenderDegradedCount, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int IS315_5313::GetRenderBlockedCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)IS315_5313DataSource::SettingsRenderBlockedCount, 0, data);
+	return data.GetValue();
+}
+
 //----------------------------------------------------------------------------------------
 //Raw register functions
 //----------------------------------------------------------------------------------------
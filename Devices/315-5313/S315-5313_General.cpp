@@ -48,7 +48,8 @@ renderPatternDataCacheLayerB(maxCellsPerRow, Data(32)),
 renderPatternDataCacheRowNoLayerA(maxCellsPerRow, 0),
 renderPatternDataCacheRowNoLayerB(maxCellsPerRow, 0),
 renderSpriteDisplayCache(maxSpriteDisplayCacheSize),
-renderSpriteDisplayCellCache(maxSpriteDisplayCellCacheSize)
+renderSpriteDisplayCellCache(maxSpriteDisplayCellCacheSize),
+renderSpriteAttributeCache(maxSpriteAttributeTableSize)
 {
 	fifoBuffer.resize(fifoBufferSize);
 	bfifoBuffer.resize(fifoBufferSize);
@@ -91,9 +92,12 @@ renderSpriteDisplayCellCache(maxSpriteDisplayCellCacheSize)
 	renderThreadActive = false;
 	renderTimeslicePending = false;
 	drawingImageBufferPlane = 0;
+	completedImageBufferPlane = imageBufferPlanes - 1;
 	lastRenderedFrameToken = 0;
 	for(unsigned int bufferPlaneNo = 0; bufferPlaneNo < imageBufferPlanes; ++bufferPlaneNo)
 	{
+		imageBufferReferenceCount[bufferPlaneNo] = 0;
+		imageBufferInfoCapture[bufferPlaneNo] = 0;
 		imageBufferLineCount[bufferPlaneNo] = 0;
 		for(unsigned int lineNo = 0; lineNo < imageBufferHeight; ++lineNo)
 		{
@@ -130,6 +134,17 @@ renderSpriteDisplayCellCache(maxSpriteDisplayCellCacheSize)
 	videoShowBoundaryActionSafe = false;
 	videoShowBoundaryTitleSafe = false;
 	videoEnableFullImageBufferInfo = false;
+	videoFrameRenderInterval = 1;
+	videoFrameRenderRequested = false;
+
+	//Allow the render thread to skip frames before we stall the execute thread
+	renderBackpressure.SetPolicy(RenderBackpressure::Policy::DegradeThenBlock);
+
+	frameHashLoggingEnabled = false;
+	frameHashInterval = 1;
+	frameHashFrameNo = 0;
+	frameHashComparisonIndex = 0;
+	frameHashDivergenceReported = false;
 
 	enableLayerAHigh = true;
 	enableLayerALow = true;
@@ -147,6 +162,37 @@ renderSpriteDisplayCellCache(maxSpriteDisplayCellCacheSize)
 	logDataPortWrite = false;
 	portMonitorListSize = 2000;
 	portMonitorLastModifiedToken = 0;
+
+	videoCaptureEnabled = false;
+	videoCaptureThreadActive = false;
+	videoCaptureThreadRunning = false;
+	videoCapturePendingFrameStart = 0;
+	videoCapturePendingFrameCount = 0;
+	videoCaptureNextFrameNo = 0;
+	videoCaptureDroppedFrameCount = 0;
+	videoCaptureWrittenFrameCount = 0;
+	videoCaptureLastFrameNo = 0;
+	videoCaptureHeaderWritten = false;
+	videoCaptureWidth = 0;
+	videoCaptureHeight = 0;
+	videoCaptureFrameRateNumerator = 0;
+	videoCaptureFrameRateDenominator = 1;
+	audioCaptureMixer = 0;
+	audioCaptureSampleRemainder = 0;
+	audioCaptureWrittenSampleCount = 0;
+}
+
+//----------------------------------------------------------------------------------------
+S315_5313::~S315_5313()
+{
+	//Stop any active video capture, so that the writer thread has finished with our
+	//buffers before they're destroyed. Note that we can't log the result here, as the
+	//device context may no longer be valid.
+	std::unique_lock<std::mutex> lock(videoCaptureMutex);
+	if(videoCaptureEnabled)
+	{
+		StopVideoCapture(lock);
+	}
 }
 
 //----------------------------------------------------------------------------------------
@@ -170,35 +216,19 @@ IDevice* S315_5313::GetDevice()
 //----------------------------------------------------------------------------------------
 bool S315_5313::BuildDevice()
 {
-	//Initialize the layer priority lookup table. We use this table to speed up layer
-	//priority selection during rendering.
-	layerPriorityLookupTable.resize(layerPriorityLookupTableSize);
-	for(unsigned int i = 0; i < layerPriorityLookupTableSize; ++i)
-	{
-		//Determine the input layer settings for this table index value
-		bool shadowHighlightEnabled = (i & (1 << 8)) != 0;
-		bool spriteIsShadowOperator = (i & (1 << 7)) != 0;
-		bool spriteIsHighlightOperator = (i & (1 << 6)) != 0;
-		bool foundSpritePixel = (i & (1 << 5)) != 0;
-		bool foundLayerAPixel = (i & (1 << 4)) != 0;
-		bool foundLayerBPixel = (i & (1 << 3)) != 0;
-		bool prioritySprite = (i & (1 << 2)) != 0;
-		bool priorityLayerA = (i & (1 << 1)) != 0;
-		bool priorityLayerB = (i & 1) != 0;
-
-		//Resolve the layer priority for this combination of layer settings
-		unsigned int layerIndex;
-		bool shadow;
-		bool highlight;
-		CalculateLayerPriorityIndex(layerIndex, shadow, highlight, shadowHighlightEnabled, spriteIsShadowOperator, spriteIsHighlightOperator, foundSpritePixel, foundLayerAPixel, foundLayerBPixel, prioritySprite, priorityLayerA, priorityLayerB);
-
-		//Incorporate the shadow and highlight bits into the layer index value
-		layerIndex |= shadow? 1 << 3: 0;
-		layerIndex |= highlight? 1 << 2: 0;
-
-		//Write the combined value to the layer priority lookup table
-		layerPriorityLookupTable[i] = layerIndex;
-	}
+	//Initialize the layer priority and palette colour lookup tables. We use these tables
+	//to eliminate branching from layer priority selection and colour output during
+	//rendering.
+	BuildLayerPriorityLookupTable(layerPriorityLookupTable);
+	BuildPaletteColorLookupTable(paletteColorLookupTable);
+
+	//Initialize the frame hash logging state
+	std::wstring captureFolder = GetSystemInterface().GetCapturePath();
+	frameHashLoggingPath = PathCombinePaths(captureFolder, GetDeviceInstanceName() + L" Frame Hashes.txt");
+	frameHashComparisonPath.clear();
+
+	//Initialize the video capture state
+	videoCapturePath = PathCombinePaths(captureFolder, GetDeviceInstanceName() + L" Video.y4m");
 
 	//Register each data source with the generic data access base class
 	bool result = true;
@@ -213,6 +243,8 @@ bool S315_5313::BuildDevice()
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoShowBoundaryActionSafe, IGenericAccessDataValue::DataType::Bool)));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoShowBoundaryTitleSafe, IGenericAccessDataValue::DataType::Bool)));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoEnableFullImageBufferInfo, IGenericAccessDataValue::DataType::Bool)));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoFrameRenderInterval, IGenericAccessDataValue::DataType::UInt)));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoFrameRenderRequested, IGenericAccessDataValue::DataType::Bool)));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsOutputPortAccessDebugMessages, IGenericAccessDataValue::DataType::Bool)));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsOutputTimingDebugMessages, IGenericAccessDataValue::DataType::Bool)));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsOutputRenderSyncDebugMessages, IGenericAccessDataValue::DataType::Bool)));
@@ -229,6 +261,17 @@ bool S315_5313::BuildDevice()
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoEnableSprite, IGenericAccessDataValue::DataType::Bool)));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoEnableSpriteHigh, IGenericAccessDataValue::DataType::Bool)));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoEnableSpriteLow, IGenericAccessDataValue::DataType::Bool)));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsFrameHashLoggingEnabled, IGenericAccessDataValue::DataType::Bool)));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsFrameHashLoggingPath, IGenericAccessDataValue::DataType::FilePath))->SetFilePathExtensionFilter(L"Text file|txt")->SetFilePathDefaultExtension(L"txt")->SetFilePathCreatingTarget(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsFrameHashComparisonPath, IGenericAccessDataValue::DataType::FilePath))->SetFilePathExtensionFilter(L"Text file|txt")->SetFilePathDefaultExtension(L"txt"));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsFrameHashInterval, IGenericAccessDataValue::DataType::UInt))->SetUIntMinValue(1));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoCaptureEnabled, IGenericAccessDataValue::DataType::Bool)));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoCapturePath, IGenericAccessDataValue::DataType::FilePath))->SetFilePathExtensionFilter(L"YUV4MPEG2 video|y4m")->SetFilePathDefaultExtension(L"y4m")->SetFilePathCreatingTarget(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsVideoCaptureDroppedFrameCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsRenderLatency, IGenericAccessDataValue::DataType::Double))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsRenderDrainRate, IGenericAccessDataValue::DataType::Double))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsRenderDegradedCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IS315_5313DataSource::SettingsRenderBlockedCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
 
 	//Register page layouts for generic access to this device
 	GenericAccessPage* systemSettingsPage = new GenericAccessPage(L"SystemSettings", L"System Settings", IGenericAccessPage::Type::Settings);
@@ -240,6 +283,8 @@ bool S315_5313::BuildDevice()
 	GenericAccessPage* debugSettingsPage = new GenericAccessPage(L"DebugSettings", L"Debug Settings");
 	debugSettingsPage->AddEntry((new GenericAccessGroup(L"Image Debug"))
 	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsVideoDisableRenderOutput, L"Disable Rendering"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsVideoFrameRenderInterval, L"Render Every Nth Frame"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsVideoFrameRenderRequested, L"Render Next Frame"))
 	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsVideoHighlightRenderPos, L"Highlight Render Pos"))
 	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsVideoEnableSpriteBoxing, L"Sprite Boxing"))
 	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsVideoEnableFullImageBufferInfo, L"Show Pixel Info")))
@@ -251,7 +296,21 @@ bool S315_5313::BuildDevice()
 	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsOutputPortAccessDebugMessages, L"Port Access Debug"))
 	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsOutputTimingDebugMessages, L"Timing Debug"))
 	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsOutputRenderSyncDebugMessages, L"Render Sync Debug"))
-	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsOutputInterruptDebugMessages, L"Interrupt Debug")));
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsOutputInterruptDebugMessages, L"Interrupt Debug")))
+	                 ->AddEntry((new GenericAccessGroup(L"Frame Hash Logging"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsFrameHashLoggingEnabled, L"Log Enabled"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsFrameHashLoggingPath, L"Log Path"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsFrameHashComparisonPath, L"Compare Against"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsFrameHashInterval, L"Frame Interval")))
+	                 ->AddEntry((new GenericAccessGroup(L"Video Capture"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsVideoCaptureEnabled, L"Capture Enabled"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsVideoCapturePath, L"Capture Path"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsVideoCaptureDroppedFrameCount, L"Dropped Frames")))
+	                 ->AddEntry((new GenericAccessGroup(L"Render Thread"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsRenderLatency, L"Backlog (ms)"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsRenderDrainRate, L"Drain Rate"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsRenderDegradedCount, L"Frame Skip Events"))
+	                     ->AddEntry(new GenericAccessGroupDataEntry(IS315_5313DataSource::SettingsRenderBlockedCount, L"Stall Events")));
 	result &= AddGenericAccessPage(debugSettingsPage);
 	GenericAccessPage* layerRemovalPage = new GenericAccessPage(L"LayerVisibility", L"Layer Visibility");
 	layerRemovalPage->AddEntry((new GenericAccessGroup(L"Layer A"))
@@ -349,6 +408,7 @@ void S315_5313::Initialize()
 	dmaTransferActive = false;
 	dmaTransferInvalidPortWriteCached = false;
 	dmaAdvanceUntilDMAComplete = false;
+	dmaTransferSourceWindowValid = false;
 
 	//External line state
 	busGranted = false;
@@ -459,6 +519,10 @@ void S315_5313::Initialize()
 	renderLayerBVscrollMappingDisplacement = 0;
 	currentRenderPosOnScreen = false;
 
+	//Analog render data buffers
+	renderAnalogFrameSkipped = false;
+	renderAnalogFrameSkipCounter = 0;
+
 	//Additional render buffers
 	for(unsigned int i = 0; i < maxSpriteDisplayCellCacheSize; ++i)
 	{
@@ -486,6 +550,13 @@ void S315_5313::Initialize()
 	lineCAS0SavedStateRMW = false;
 	lineRAS0SavedStateRMW = false;
 	lineOE0SavedStateRMW = false;
+
+	//Restart the frame count for frame hash logging, so that the hashes logged from
+	//power on line up with those in the comparison log.
+	std::unique_lock<std::mutex> frameHashLock(frameHashMutex);
+	frameHashFrameNo = 0;
+	frameHashComparisonIndex = 0;
+	frameHashDivergenceReported = false;
 }
 
 //----------------------------------------------------------------------------------------
@@ -521,8 +592,8 @@ void S315_5313::Reset(double accessTime)
 void S315_5313::BeginExecution()
 {
 	//Initialize the render worker thread state
-	pendingRenderOperationCount = 0;
-	renderThreadLagging = false;
+	renderBackpressure.Reset();
+	uncommittedRenderTime = 0;
 	timesliceRenderInfoList.clear();
 	regTimesliceList.clear();
 	vramTimesliceList.clear();
@@ -606,6 +677,19 @@ bool S315_5313::AddReference(const MarshalSupport::Marshal::In<std::wstring>& re
 	{
 		psg = target;
 	}
+	else if(referenceName == L"AudioCaptureSource")
+	{
+		IAudioCaptureSource* audioCaptureSource = dynamic_cast<IAudioCaptureSource*>(target);
+		if(audioCaptureSource != 0)
+		{
+			std::unique_lock<std::mutex> lock(videoCaptureMutex);
+			audioCaptureSources.push_back(audioCaptureSource);
+		}
+		else
+		{
+			result = false;
+		}
+	}
 	else
 	{
 		result = false;
@@ -685,6 +769,22 @@ void S315_5313::RemoveReference(IDevice* target)
 	{
 		psg = 0;
 	}
+
+	//If the target is an audio capture source, remove it from the list of sources. If a
+	//capture is currently running, we detach the source from the audio mixer first.
+	IAudioCaptureSource* targetAsAudioCaptureSource = dynamic_cast<IAudioCaptureSource*>(target);
+	if(targetAsAudioCaptureSource != 0)
+	{
+		std::unique_lock<std::mutex> lock(videoCaptureMutex);
+		std::map<IAudioCaptureSource*, IAudioSink*>::iterator audioCaptureInputsIterator = audioCaptureInputs.find(targetAsAudioCaptureSource);
+		if(audioCaptureInputsIterator != audioCaptureInputs.end())
+		{
+			targetAsAudioCaptureSource->SetAudioCaptureSink(0);
+			audioCaptureMixer->DeleteInput(audioCaptureInputsIterator->second);
+			audioCaptureInputs.erase(audioCaptureInputsIterator);
+		}
+		audioCaptureSources.remove(targetAsAudioCaptureSource);
+	}
 	externalReferenceLock.ReleaseWriteLock();
 }
 
@@ -807,6 +907,7 @@ void S315_5313::NotifyUpcomingTimeslice(double nanoseconds)
 	vsramTimesliceListUncommitted.push_back(vsram->GetLatestTimesliceReference());
 	spriteCacheTimesliceListUncommitted.push_back(spriteCache->GetLatestTimesliceReference());
 	timesliceRenderInfoListUncommitted.push_back(TimesliceRenderInfo(lastTimesliceMclkCyclesOverrun));
+	uncommittedRenderTime += nanoseconds;
 }
 
 //----------------------------------------------------------------------------------------
@@ -965,17 +1066,10 @@ void S315_5313::ExecuteTimeslice(double nanoseconds)
 		workerThreadIdle.wait(workerThreadLock);
 	}
 
-	//If the render thread is lagging, pause here until it has caught up, so we don't
-	//leave the render thread behind with an ever-increasing workload it will never be
-	//able to complete.
-	if(renderThreadLagging)
-	{
-		std::unique_lock<std::mutex> lock(timesliceMutex);
-		while(renderThreadLagging)
-		{
-			renderThreadLaggingStateChange.wait(lock);
-		}
-	}
+	//If the render thread has fallen too far behind, pause here until it has caught up,
+	//so we don't leave the render thread behind with an ever-increasing workload it will
+	//never be able to complete.
+	renderBackpressure.WaitWhileBlocked();
 }
 
 //----------------------------------------------------------------------------------------
@@ -1202,6 +1296,7 @@ void S315_5313::ExecuteRollback()
 	//DMA transfer registers
 	dmaTransferActive = bdmaTransferActive;
 	dmaTransferReadDataCached = bdmaTransferReadDataCached;
+	dmaTransferSourceWindowValid = false;
 	dmaTransferReadCache = bdmaTransferReadCache;
 	dmaTransferNextReadMclk = bdmaTransferNextReadMclk;
 	dmaTransferLastTimesliceUsedReadDelay = bdmaTransferLastTimesliceUsedReadDelay;
@@ -1215,6 +1310,7 @@ void S315_5313::ExecuteRollback()
 	externalInterruptVideoTriggerPointVCounter = bexternalInterruptVideoTriggerPointVCounter;
 
 	//Clear any uncommitted timeslices from our render timeslice buffers
+	uncommittedRenderTime = 0;
 	timesliceRenderInfoListUncommitted.clear();
 	regTimesliceListUncommitted.clear();
 	for(std::list<ITimedBufferInt::Timeslice*>::const_iterator i = vramTimesliceListUncommitted.begin(); i != vramTimesliceListUncommitted.end(); ++i)
@@ -1242,11 +1338,7 @@ void S315_5313::ExecuteRollback()
 	if(outputRenderSyncMessages || outputTimingDebugMessages)
 	{
 		//Wait for the render thread to complete its work
-		std::unique_lock<std::mutex> lock(renderThreadMutex);
-		while(pendingRenderOperationCount > 0)
-		{
-			renderThreadLaggingStateChange.wait(lock);
-		}
+		renderBackpressure.WaitForIdle();
 
 		//Print out render thread synchronization info
 		if(outputTimingDebugMessages)
@@ -1430,9 +1522,10 @@ void S315_5313::ExecuteCommit()
 		//Obtain a timeslice lock so we can update the data we feed to the render thread
 		std::unique_lock<std::mutex> lock(timesliceMutex);
 
-		//Add the number of timeslices we are about to commit to the count of pending
-		//render operations. This is used to track if the render thread is lagging.
-		pendingRenderOperationCount += (unsigned int)regTimesliceListUncommitted.size();
+		//Add the timeslices we are about to commit to the pending work for the render
+		//thread. This is used to track if the render thread is lagging.
+		renderBackpressure.QueueWork((unsigned int)regTimesliceListUncommitted.size(), uncommittedRenderTime);
+		uncommittedRenderTime = 0;
 
 		//Move all timeslices in our uncommitted timeslice lists over to the committed
 		//timeslice lists, for processing by the render thread.
@@ -1451,11 +1544,7 @@ void S315_5313::ExecuteCommit()
 	if(outputRenderSyncMessages || outputTimingDebugMessages)
 	{
 		//Wait for the render thread to complete its work
-		std::unique_lock<std::mutex> lock(renderThreadMutex);
-		while(pendingRenderOperationCount > 0)
-		{
-			renderThreadLaggingStateChange.wait(lock);
-		}
+		renderBackpressure.WaitForIdle();
 
 		//Print out render thread synchronization info
 		if(outputTimingDebugMessages)
@@ -2824,13 +2913,85 @@ void S315_5313::CacheDMATransferReadData(unsigned int mclkTime)
 	//by one.
 	unsigned int sourceAddress = (dmaSourceAddressByte1 << 1) | (dmaSourceAddressByte2 << 9) | (dmaSourceAddressByte3 << 17);
 
-	//Read the next data word to transfer from the source
-	memoryBus->ReadMemory(sourceAddress, dmaTransferReadCache, GetDeviceContext(), dmaTransferNextReadMclk, (unsigned int)AccessContext::DMARead);
+	//Read the next data word to transfer from the source. If the source block for this
+	//DMA transfer has been resolved to a single plain mapping on the bus, we pass the
+	//read directly to the target device, skipping the CE line and address decoding for
+	//each word. The access time and access context are identical in both cases.
+	//-Note that we deliberately still read and write one word at a time here, rather than
+	//reading the source block in bulk and writing it to VRAM in one go. Each word is
+	//written to VRAM in a particular access slot, interleaved with the render process
+	//reads and any pending FIFO writes, and the write is recorded in the VRAM timed
+	//buffer at the time of that slot so that the render thread sees it at the correct
+	//point in the frame. A batched write would still need to step through the same
+	//sequence of slots to generate these times, so it saves nothing over this path.
+	//Reading ahead from the source isn't possible either without changing the device
+	//interface, since memory devices only accept single timed reads, and each read is
+	//visible to the debugger at its own access time.
+	const IBusInterface::MemoryTarget* sourceTarget = GetDMATransferSourceTarget(sourceAddress);
+	if(sourceTarget != 0)
+	{
+		sourceTarget->device->ReadInterface(sourceTarget->interfaceNumber, sourceTarget->GetInterfaceOffset(sourceAddress), dmaTransferReadCache, GetDeviceContext(), dmaTransferNextReadMclk, (unsigned int)AccessContext::DMARead);
+	}
+	else
+	{
+		memoryBus->ReadMemory(sourceAddress, dmaTransferReadCache, GetDeviceContext(), dmaTransferNextReadMclk, (unsigned int)AccessContext::DMARead);
+	}
 
 	//Flag that data has been cached for the DMA transfer operation
 	dmaTransferReadDataCached = true;
 }
 
+//----------------------------------------------------------------------------------------
+const IBusInterface::MemoryTarget* S315_5313::GetDMATransferSourceTarget(unsigned int sourceAddress)
+{
+	//If the source address is still within the window we resolved for this DMA transfer,
+	//and neither the memory map nor the CE line generation state on the bus has been
+	//modified since, return the existing resolution. Note that we check the change
+	//counts even when the window failed to resolve, since a change in the cartridge or
+	//boot ROM state for example may allow a window which previously failed to resolve to
+	//succeed, or vice versa.
+	unsigned int mappingChangeCount = memoryBus->GetMemoryMappingChangeCount();
+	unsigned int ceLineStateChangeCount = memoryBus->GetCELineStateChangeCount();
+	if(dmaTransferSourceWindowValid && (sourceAddress >= dmaTransferSourceWindowStart) && (sourceAddress <= dmaTransferSourceWindowEnd)
+	&& (dmaTransferSourceTarget.mappingChangeCount == mappingChangeCount) && (dmaTransferSourceTarget.ceLineStateChangeCount == ceLineStateChangeCount))
+	{
+		return dmaTransferSourceTargetResolved? &dmaTransferSourceTarget: 0;
+	}
+
+	//Calculate the window of source addresses which remain to be read for this DMA
+	//transfer. Since the upper DMA source address register isn't advanced during a DMA
+	//transfer, the source address wraps within a 0x20000 byte block, so we limit the
+	//window to the end of the current block. Note that a DMA length counter of 0 is
+	//equivalent to a transfer count of 0x10000. Since the bus verifies the mapping for
+	//every address in a window as it's resolved, we also bound the window size, so that
+	//a long transfer resolves its source in a series of small steps rather than stalling
+	//on a single large scan when it begins.
+	unsigned int remainingWordCount = (dmaLengthCounter == 0)? 0x10000: dmaLengthCounter;
+	unsigned int remainingBytesInBlock = 0x20000 - (sourceAddress & 0x1FFFF);
+	unsigned int windowSize = ((remainingWordCount * 2) < remainingBytesInBlock)? (remainingWordCount * 2): remainingBytesInBlock;
+	windowSize = (windowSize < dmaTransferSourceWindowMaxSize)? windowSize: dmaTransferSourceWindowMaxSize;
+	dmaTransferSourceWindowStart = sourceAddress;
+	dmaTransferSourceWindowEnd = sourceAddress + (windowSize - 1);
+	dmaTransferSourceWindowValid = true;
+
+	//Attempt to resolve the source window to a single target. We never resolve a DMA
+	//source within the VDP address range at 0xC00000-0xDFFFFF, since accesses to this
+	//region can trigger side effects from CE line generation on the bus, such as TMSS
+	//lockout, which must be performed as part of each access. Since this region is
+	//aligned to a 0x20000 byte boundary, a window never partially overlaps it.
+	dmaTransferSourceTargetResolved = false;
+	if((sourceAddress < 0xC00000) || (sourceAddress > 0xDFFFFF))
+	{
+		dmaTransferSourceTargetResolved = memoryBus->ResolveMemoryTarget(dmaTransferSourceWindowStart, windowSize, GetDeviceContext(), dmaTransferSourceTarget);
+	}
+	if(!dmaTransferSourceTargetResolved)
+	{
+		dmaTransferSourceTarget.mappingChangeCount = mappingChangeCount;
+		dmaTransferSourceTarget.ceLineStateChangeCount = ceLineStateChangeCount;
+	}
+	return dmaTransferSourceTargetResolved? &dmaTransferSourceTarget: 0;
+}
+
 //----------------------------------------------------------------------------------------
 void S315_5313::PerformDMATransferOperation()
 {
@@ -3192,11 +3353,9 @@ void S315_5313::M5WriteVSRAM(const Data& address, const Data& data, const RAMAcc
 //----------------------------------------------------------------------------------------
 bool S315_5313::GetScreenshot(IImage& targetImage) const
 {
-	//Determine the index of the current image plane that is being used for display
-	unsigned int displayingImageBufferPlane = GetImageCompletedBufferPlaneNo();
-
-	//Obtain a read lock on the image buffer
-	imageBufferLock[displayingImageBufferPlane].ObtainReadLock();
+	//Obtain a reference to the most recently completed image plane. The render thread
+	//will not draw into this plane until we release it.
+	unsigned int displayingImageBufferPlane = AcquireLatestImageBufferPlane();
 
 	//Calculate the width and height of the output image. We take the line width of the
 	//first line as the width of the output image, but it should be noted that the width
@@ -3219,41 +3378,32 @@ bool S315_5313::GetScreenshot(IImage& targetImage) const
 		if(lineWidth != imageWidth)
 		{
 			Image lineImage(lineWidth, 1, IImage::PIXELFORMAT_RGB, IImage::DATAFORMAT_8BIT);
+			unsigned char* lineRowData = lineImage.GetRowData8Bit(0);
 			for(unsigned int xpos = 0; xpos < lineWidth; ++xpos)
 			{
-				ImageBufferColorEntry& imageBufferEntry = *((ImageBufferColorEntry*)&imageBuffer[drawingImageBufferPlane][((ypos * imageBufferWidth) + xpos) * 4]);
-				lineImage.WritePixelData(xpos, ypos, 0, imageBufferEntry.r);
-				lineImage.WritePixelData(xpos, ypos, 1, imageBufferEntry.g);
-				lineImage.WritePixelData(xpos, ypos, 2, imageBufferEntry.b);
+				const ImageBufferColorEntry& imageBufferEntry = *((const ImageBufferColorEntry*)&imageBuffer[displayingImageBufferPlane][((ypos * imageBufferWidth) + xpos) * 4]);
+				lineRowData[(xpos * 3) + 0] = imageBufferEntry.r;
+				lineRowData[(xpos * 3) + 1] = imageBufferEntry.g;
+				lineRowData[(xpos * 3) + 2] = imageBufferEntry.b;
 			}
 			lineImage.ResampleBilinear(imageWidth, 1);
-			for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
-			{
-				unsigned char r;
-				unsigned char g;
-				unsigned char b;
-				lineImage.ReadPixelData(xpos, 0, 0, r);
-				lineImage.ReadPixelData(xpos, 0, 1, g);
-				lineImage.ReadPixelData(xpos, 0, 2, b);
-				targetImage.WritePixelData(xpos, ypos, 0, r);
-				targetImage.WritePixelData(xpos, ypos, 1, g);
-				targetImage.WritePixelData(xpos, ypos, 2, b);
-			}
+			targetImage.CopyImageData(lineImage, 0, 0, imageWidth, 1, 0, ypos);
 		}
 		else
 		{
+			unsigned char* targetRowData = targetImage.GetRowData8Bit(ypos);
 			for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
 			{
-				ImageBufferColorEntry& imageBufferEntry = *((ImageBufferColorEntry*)&imageBuffer[drawingImageBufferPlane][((ypos * imageBufferWidth) + xpos) * 4]);
-				targetImage.WritePixelData(xpos, ypos, 0, imageBufferEntry.r);
-				targetImage.WritePixelData(xpos, ypos, 1, imageBufferEntry.g);
-				targetImage.WritePixelData(xpos, ypos, 2, imageBufferEntry.b);
+				const ImageBufferColorEntry& imageBufferEntry = *((const ImageBufferColorEntry*)&imageBuffer[displayingImageBufferPlane][((ypos * imageBufferWidth) + xpos) * 4]);
+				targetRowData[(xpos * 3) + 0] = imageBufferEntry.r;
+				targetRowData[(xpos * 3) + 1] = imageBufferEntry.g;
+				targetRowData[(xpos * 3) + 2] = imageBufferEntry.b;
 			}
 		}
 	}
 
-	//Release the read lock on the image buffer
-	imageBufferLock[displayingImageBufferPlane].ReleaseReadLock();
+	//Release our reference to the image plane
+	ReleaseImageBufferPlane(displayingImageBufferPlane);
 
 	return true;
 }
@@ -3496,6 +3646,10 @@ void S315_5313::LoadState(IHierarchicalStorageNode& node)
 		}
 	}
 
+	//Discard any resolved DMA transfer source target, since the DMA source registers may
+	//have been modified by the loaded state.
+	dmaTransferSourceWindowValid = false;
+
 	Device::LoadState(node);
 }
 
@@ -3748,6 +3902,13 @@ void S315_5313::LoadDebuggerState(IHierarchicalStorageNode& node)
 				else if(registerName == L"VideoShowBoundaryActionSafe")		videoShowBoundaryActionSafe = (*i)->ExtractData<bool>();
 				else if(registerName == L"VideoShowBoundaryTitleSafe")		videoShowBoundaryTitleSafe = (*i)->ExtractData<bool>();
 				else if(registerName == L"VideoEnableFullImageBufferInfo")	videoEnableFullImageBufferInfo = (*i)->ExtractData<bool>();
+				else if(registerName == L"VideoFrameRenderInterval")		videoFrameRenderInterval = (*i)->ExtractData<unsigned int>();
+				//Frame hash logging settings
+				else if(registerName == L"FrameHashLoggingPath")	frameHashLoggingPath = (*i)->GetData();
+				else if(registerName == L"FrameHashComparisonPath")	frameHashComparisonPath = (*i)->GetData();
+				else if(registerName == L"FrameHashInterval")		frameHashInterval = (*i)->ExtractData<unsigned int>();
+				//Video capture settings
+				else if(registerName == L"VideoCapturePath")		videoCapturePath = (*i)->GetData();
 				//Layer removal settings
 				else if(registerName == L"EnableLayerAHigh")		enableLayerAHigh = (*i)->ExtractData<bool>();
 				else if(registerName == L"EnableLayerALow")			enableLayerALow = (*i)->ExtractData<bool>();
@@ -3779,6 +3940,15 @@ void S315_5313::SaveDebuggerState(IHierarchicalStorageNode& node) const
 	node.CreateChild(L"Register", videoShowBoundaryActionSafe).CreateAttribute(L"name", L"VideoShowBoundaryActionSafe");
 	node.CreateChild(L"Register", videoShowBoundaryTitleSafe).CreateAttribute(L"name", L"VideoShowBoundaryTitleSafe");
 	node.CreateChild(L"Register", videoEnableFullImageBufferInfo).CreateAttribute(L"name", L"VideoEnableFullImageBufferInfo");
+	node.CreateChild(L"Register", videoFrameRenderInterval).CreateAttribute(L"name", L"VideoFrameRenderInterval");
+
+	//Frame hash logging settings
+	node.CreateChild(L"Register", frameHashLoggingPath).CreateAttribute(L"name", L"FrameHashLoggingPath");
+	node.CreateChild(L"Register", frameHashComparisonPath).CreateAttribute(L"name", L"FrameHashComparisonPath");
+	node.CreateChild(L"Register", frameHashInterval).CreateAttribute(L"name", L"FrameHashInterval");
+
+	//Video capture settings
+	node.CreateChild(L"Register", videoCapturePath).CreateAttribute(L"name", L"VideoCapturePath");
 
 	//Layer removal settings
 	node.CreateChild(L"Register", enableLayerAHigh).CreateAttribute(L"name", L"EnableLayerAHigh");
@@ -3797,9 +3967,14 @@ void S315_5313::SaveDebuggerState(IHierarchicalStorageNode& node) const
 //Data read/write functions
 //----------------------------------------------------------------------------------------
 bool S315_5313::ReadGenericData(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue) const
+{
+	return ReadGenericData(dataID, dataContext, dataValue, AccessTarget().AccessLatest());
+}
+
+//----------------------------------------------------------------------------------------
+bool S315_5313::ReadGenericData(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue, const AccessTarget& accessTarget) const
 {
 	ApplyGenericDataValueDisplaySettings(dataID, dataValue);
-	AccessTarget accessTarget = AccessTarget().AccessLatest();
 	switch((IS315_5313DataSource)dataID)
 	{
 	case IS315_5313DataSource::RawRegister:{
@@ -4053,6 +4228,33 @@ bool S315_5313::ReadGenericData(unsigned int dataID, const DataContext* dataCont
 		return dataValue.SetValue(videoShowBoundaryTitleSafe);
 	case IS315_5313DataSource::SettingsVideoEnableFullImageBufferInfo:
 		return dataValue.SetValue(videoEnableFullImageBufferInfo);
+	case IS315_5313DataSource::SettingsVideoFrameRenderInterval:
+		return dataValue.SetValue(videoFrameRenderInterval);
+	case IS315_5313DataSource::SettingsVideoFrameRenderRequested:
+		return dataValue.SetValue(videoFrameRenderRequested.load());
+	case IS315_5313DataSource::SettingsFrameHashLoggingEnabled:
+		return dataValue.SetValue(frameHashLoggingEnabled);
+	case IS315_5313DataSource::SettingsFrameHashLoggingPath:
+		return dataValue.SetValue(frameHashLoggingPath);
+	case IS315_5313DataSource::SettingsFrameHashComparisonPath:
+		return dataValue.SetValue(frameHashComparisonPath);
+	case IS315_5313DataSource::SettingsFrameHashInterval:
+		return dataValue.SetValue(frameHashInterval);
+	case IS315_5313DataSource::SettingsVideoCaptureEnabled:
+		return dataValue.SetValue(videoCaptureEnabled);
+	case IS315_5313DataSource::SettingsVideoCapturePath:{
+		std::unique_lock<std::mutex> lock(videoCaptureMutex);
+		return dataValue.SetValue(videoCapturePath);}
+	case IS315_5313DataSource::SettingsVideoCaptureDroppedFrameCount:
+		return dataValue.SetValue(videoCaptureDroppedFrameCount);
+	case IS315_5313DataSource::SettingsRenderLatency:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().estimatedDrainTimeInNanoseconds / 1000000.0);
+	case IS315_5313DataSource::SettingsRenderDrainRate:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().drainRate);
+	case IS315_5313DataSource::SettingsRenderDegradedCount:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().degradedCount);
+	case IS315_5313DataSource::SettingsRenderBlockedCount:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().blockedCount);
 	case IS315_5313DataSource::SettingsVideoEnableLayerA:
 		return dataValue.SetValue(enableLayerAHigh && enableLayerALow);
 	case IS315_5313DataSource::SettingsVideoEnableLayerAHigh:
@@ -4770,6 +4972,50 @@ bool S315_5313::WriteGenericData(unsigned int dataID, const DataContext* dataCon
 		IGenericAccessDataValueBool& dataValueAsBool = (IGenericAccessDataValueBool&)dataValue;
 		videoEnableFullImageBufferInfo = dataValueAsBool.GetValue();
 		return true;}
+	case IS315_5313DataSource::SettingsVideoFrameRenderInterval:{
+		if(dataType != IGenericAccessDataValue::DataType::UInt) return false;
+		IGenericAccessDataValueUInt& dataValueAsUInt = (IGenericAccessDataValueUInt&)dataValue;
+		videoFrameRenderInterval = dataValueAsUInt.GetValue();
+		return true;}
+	case IS315_5313DataSource::SettingsVideoFrameRenderRequested:{
+		if(dataType != IGenericAccessDataValue::DataType::Bool) return false;
+		IGenericAccessDataValueBool& dataValueAsBool = (IGenericAccessDataValueBool&)dataValue;
+		videoFrameRenderRequested = dataValueAsBool.GetValue();
+		return true;}
+	case IS315_5313DataSource::SettingsFrameHashLoggingEnabled:{
+		if(dataType != IGenericAccessDataValue::DataType::Bool) return false;
+		IGenericAccessDataValueBool& dataValueAsBool = (IGenericAccessDataValueBool&)dataValue;
+		SetFrameHashLoggingEnabled(dataValueAsBool.GetValue());
+		return true;}
+	case IS315_5313DataSource::SettingsFrameHashLoggingPath:{
+		if(dataType != IGenericAccessDataValue::DataType::FilePath) return false;
+		IGenericAccessDataValueFilePath& dataValueAsFilePath = (IGenericAccessDataValueFilePath&)dataValue;
+		std::unique_lock<std::mutex> lock(frameHashMutex);
+		frameHashLoggingPath = dataValueAsFilePath.GetValue();
+		return true;}
+	case IS315_5313DataSource::SettingsFrameHashComparisonPath:{
+		if(dataType != IGenericAccessDataValue::DataType::FilePath) return false;
+		IGenericAccessDataValueFilePath& dataValueAsFilePath = (IGenericAccessDataValueFilePath&)dataValue;
+		std::unique_lock<std::mutex> lock(frameHashMutex);
+		frameHashComparisonPath = dataValueAsFilePath.GetValue();
+		return true;}
+	case IS315_5313DataSource::SettingsFrameHashInterval:{
+		if(dataType != IGenericAccessDataValue::DataType::UInt) return false;
+		IGenericAccessDataValueUInt& dataValueAsUInt = (IGenericAccessDataValueUInt&)dataValue;
+		std::unique_lock<std::mutex> lock(frameHashMutex);
+		frameHashInterval = (dataValueAsUInt.GetValue() > 0)? dataValueAsUInt.GetValue(): 1;
+		return true;}
+	case IS315_5313DataSource::SettingsVideoCaptureEnabled:{
+		if(dataType != IGenericAccessDataValue::DataType::Bool) return false;
+		IGenericAccessDataValueBool& dataValueAsBool = (IGenericAccessDataValueBool&)dataValue;
+		SetVideoCaptureEnabled(dataValueAsBool.GetValue());
+		return true;}
+	case IS315_5313DataSource::SettingsVideoCapturePath:{
+		if(dataType != IGenericAccessDataValue::DataType::FilePath) return false;
+		IGenericAccessDataValueFilePath& dataValueAsFilePath = (IGenericAccessDataValueFilePath&)dataValue;
+		std::unique_lock<std::mutex> lock(videoCaptureMutex);
+		videoCapturePath = dataValueAsFilePath.GetValue();
+		return true;}
 	case IS315_5313DataSource::SettingsVideoEnableLayerA:{
 		if(dataType != IGenericAccessDataValue::DataType::Bool) return false;
 		IGenericAccessDataValueBool& dataValueAsBool = (IGenericAccessDataValueBool&)dataValue;
@@ -4834,6 +5080,24 @@ bool S315_5313::WriteGenericData(unsigned int dataID, const DataContext* dataCon
 	return false;
 }
 
+//----------------------------------------------------------------------------------------
+//Batch read functions
+//----------------------------------------------------------------------------------------
+void S315_5313::BeginGenericDataBatch() const
+{
+	//Take a single copy of the register buffer for the whole batch, so that the raw and
+	//interpreted register reads in the batch only take the buffer lock once, and all see
+	//the same register state. The copy is retained between batches to avoid reallocating
+	//it each time.
+	reg.GetBufferCopy(genericDataBatchRegisterSnapshot, AccessTarget().AccessLatest());
+}
+
+//----------------------------------------------------------------------------------------
+bool S315_5313::ReadGenericDataBatchEntry(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue) const
+{
+	return ReadGenericData(dataID, dataContext, dataValue, AccessTarget().AccessSnapshot(genericDataBatchRegisterSnapshot));
+}
+
 //----------------------------------------------------------------------------------------
 //Data locking functions
 //----------------------------------------------------------------------------------------
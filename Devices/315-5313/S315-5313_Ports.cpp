@@ -1493,6 +1493,7 @@ IBusInterface::AccessResult S315_5313::WriteInterface(unsigned int interfaceNumb
 				std::unique_lock<std::mutex> lock(workerThreadMutex);
 				dmaTransferActive = true;
 				dmaTransferReadDataCached = false;
+				dmaTransferSourceWindowValid = false;
 				//Note that we technically don't need to set these here, as they are only
 				//correctly initialized once the bus request is granted, but we set them
 				//here anyway as it can be useful for debugging purposes to know when the
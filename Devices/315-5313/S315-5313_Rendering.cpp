@@ -1,4 +1,7 @@
 #include "S315_5313.h"
+#include <sstream>
+#include <thread>
+#include <cstring>
 
 //----------------------------------------------------------------------------------------
 //##TODO## Our new colour values are basically correct, assuming what is suspected after
@@ -66,7 +69,7 @@ unsigned int S315_5313::GetImageLastRenderedFrameToken() const
 //----------------------------------------------------------------------------------------
 unsigned int S315_5313::GetImageCompletedBufferPlaneNo() const
 {
-	unsigned int displayingImageBufferPlane = videoSingleBuffering? drawingImageBufferPlane: ((drawingImageBufferPlane + imageBufferPlanes) - 1) % imageBufferPlanes;
+	unsigned int displayingImageBufferPlane = videoSingleBuffering? drawingImageBufferPlane: completedImageBufferPlane;
 	return displayingImageBufferPlane;
 }
 
@@ -77,15 +80,24 @@ unsigned int S315_5313::GetImageDrawingBufferPlaneNo() const
 }
 
 //----------------------------------------------------------------------------------------
-void S315_5313::LockImageBufferData(unsigned int planeNo)
+unsigned int S315_5313::AcquireLatestImageBufferPlane() const
 {
-	imageBufferLock[planeNo].ObtainReadLock();
+	//In single buffering mode, consumers read from the drawing plane directly, and there
+	//is no consistent frame to pin. We still take a reference, so that every call here
+	//can be paired with a call to ReleaseImageBufferPlane.
+	if(videoSingleBuffering)
+	{
+		unsigned int planeNo = drawingImageBufferPlane;
+		ReferenceCounterIncrement(imageBufferReferenceCount[planeNo]);
+		return planeNo;
+	}
+	return AcquireImageBufferPlane(completedImageBufferPlane, imageBufferReferenceCount);
 }
 
 //----------------------------------------------------------------------------------------
-void S315_5313::UnlockImageBufferData(unsigned int planeNo)
+void S315_5313::ReleaseImageBufferPlane(unsigned int planeNo) const
 {
-	imageBufferLock[planeNo].ReleaseReadLock();
+	ReferenceCounterDecrement(imageBufferReferenceCount[planeNo]);
 }
 
 //----------------------------------------------------------------------------------------
@@ -97,18 +109,19 @@ const unsigned char* S315_5313::GetImageBufferData(unsigned int planeNo) const
 //----------------------------------------------------------------------------------------
 const S315_5313::ImageBufferInfo* S315_5313::GetImageBufferInfo(unsigned int planeNo) const
 {
-	return &imageBufferInfo[planeNo][0];
+	return imageBufferInfoCapture[planeNo];
 }
 
 //----------------------------------------------------------------------------------------
 const S315_5313::ImageBufferInfo* S315_5313::GetImageBufferInfo(unsigned int planeNo, unsigned int lineNo, unsigned int pixelNo) const
 {
-	if((lineNo >= imageBufferHeight) || (pixelNo >= imageBufferWidth))
+	const ImageBufferInfo* capture = imageBufferInfoCapture[planeNo];
+	if((capture == 0) || (lineNo >= imageBufferHeight) || (pixelNo >= imageBufferWidth))
 	{
 		return 0;
 	}
 	unsigned int index = (lineNo * imageBufferWidth) + pixelNo;
-	return &imageBufferInfo[planeNo][index];
+	return &capture[index];
 }
 
 //----------------------------------------------------------------------------------------
@@ -143,6 +156,164 @@ void S315_5313::GetImageBufferActiveScanPosY(unsigned int planeNo, unsigned int&
 	endPosY = imageBufferActiveScanPosYEnd[planeNo];
 }
 
+//----------------------------------------------------------------------------------------
+//Image buffer handoff functions
+//----------------------------------------------------------------------------------------
+unsigned int S315_5313::AcquireImageBufferPlane(const volatile unsigned int& completedPlaneNo, volatile ReferenceCounterType* referenceCounts)
+{
+	//Take a reference on the most recently completed image plane, and confirm it's still
+	//the most recently completed plane after our reference has been added. If the render
+	//thread published a new frame in between, it may have already selected the plane we
+	//referenced as its next drawing plane, so we drop our reference and try again. Since
+	//the render thread publishes the completed plane before it inspects the reference
+	//counts, once this check succeeds the plane is guaranteed not to be drawn into until
+	//we release it. Note that no locks are taken here, and the render thread is never
+	//blocked by this operation.
+	unsigned int planeNo;
+	while(true)
+	{
+		planeNo = completedPlaneNo;
+		ReferenceCounterIncrement(referenceCounts[planeNo]);
+		if(planeNo == completedPlaneNo)
+		{
+			break;
+		}
+		ReferenceCounterDecrement(referenceCounts[planeNo]);
+	}
+	return planeNo;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int S315_5313::PublishImageBufferPlane(unsigned int drawingPlaneNo, volatile unsigned int& completedPlaneNo, const volatile ReferenceCounterType* referenceCounts)
+{
+	//Publish the plane we just finished drawing as the latest completed frame, then
+	//select the plane to draw the next frame into. We only ever draw into a plane which
+	//isn't the latest completed frame and which has no outstanding references held by a
+	//consumer. Note that the completed plane must be published before we inspect the
+	//reference counts. Refer to AcquireImageBufferPlane for further info.
+	completedPlaneNo = drawingPlaneNo;
+	SafeMemoryBarrierReadWrite();
+	unsigned int newDrawingPlaneNo = drawingPlaneNo;
+	while(newDrawingPlaneNo == drawingPlaneNo)
+	{
+		for(unsigned int i = 1; i < imageBufferPlanes; ++i)
+		{
+			unsigned int planeNo = (drawingPlaneNo + i) % imageBufferPlanes;
+			if(referenceCounts[planeNo] == 0)
+			{
+				newDrawingPlaneNo = planeNo;
+				break;
+			}
+		}
+
+		//If every other plane is currently referenced by a consumer, which can only
+		//occur when multiple consumers are each holding a different older frame, yield
+		//until one of them releases its reference. Consumers only hold references for
+		//the duration of a copy, so this is brief.
+		if(newDrawingPlaneNo == drawingPlaneNo)
+		{
+			Sleep(0);
+		}
+	}
+	return newDrawingPlaneNo;
+}
+
+//----------------------------------------------------------------------------------------
+//Frame skip functions
+//----------------------------------------------------------------------------------------
+bool S315_5313::SelectFrameRenderSkip(unsigned int frameRenderInterval, std::atomic<bool>& frameRenderRequested, unsigned int& frameSkipCounter, bool renderDegraded)
+{
+	//A pending render request always renders the next frame, and restarts the interval
+	//count from that frame. The request is taken with an atomic exchange, so a request
+	//made by another thread between testing and clearing the flag can't be lost.
+	if(frameRenderRequested.exchange(false))
+	{
+		frameSkipCounter = 0;
+		return false;
+	}
+
+	//A frame render interval of 0 only renders frames which have been explicitly
+	//requested. Otherwise, an interval of N renders every Nth frame, unless the render
+	//thread is currently degraded.
+	if(frameRenderInterval == 0)
+	{
+		return true;
+	}
+	frameSkipCounter = (frameSkipCounter + 1) % frameRenderInterval;
+	return (frameSkipCounter != 0) || renderDegraded;
+}
+
+//----------------------------------------------------------------------------------------
+//Sprite attribute cache functions
+//----------------------------------------------------------------------------------------
+const S315_5313::SpriteAttributeCacheEntry& S315_5313::ReadCachedSpriteCacheEntry(SpriteAttributeCache& cache, const ITimedBufferInt& spriteCacheBuffer, unsigned int spriteTableIndex)
+{
+	//If we haven't decoded the data for this sprite from the sprite cache since it was
+	//last modified, read it now. Since the sprite cache is only modified at access slots
+	//or between timeslices, the decoded data can be reused across every line until then.
+	static const unsigned int spriteCacheEntrySize = 4;
+	SpriteAttributeCacheEntry& entry = cache.entries[spriteTableIndex];
+	if(entry.spriteCacheGeneration != cache.spriteCacheGeneration)
+	{
+		unsigned int spriteCacheAddress = (spriteTableIndex * spriteCacheEntrySize);
+		entry.vposData = ((unsigned int)spriteCacheBuffer.ReadCommitted(spriteCacheAddress+0) << 8) | (unsigned int)spriteCacheBuffer.ReadCommitted(spriteCacheAddress+1);
+		entry.sizeAndLinkData = ((unsigned int)spriteCacheBuffer.ReadCommitted(spriteCacheAddress+2) << 8) | (unsigned int)spriteCacheBuffer.ReadCommitted(spriteCacheAddress+3);
+		entry.spriteCacheGeneration = cache.spriteCacheGeneration;
+	}
+	return entry;
+}
+
+//----------------------------------------------------------------------------------------
+const S315_5313::SpriteAttributeCacheEntry& S315_5313::ReadCachedSpriteTableEntry(SpriteAttributeCache& cache, const ITimedBufferInt& vramBuffer, unsigned int spriteTableIndex, unsigned int spriteTableEntryAddress)
+{
+	//If we haven't decoded the remaining data for this sprite from the sprite attribute
+	//table in VRAM since VRAM was last modified, or the sprite attribute table has moved
+	//since it was decoded, read it now. Only the last 4 bytes of each table entry are read
+	//from VRAM, so we extend the range of addresses the cache depends on to cover them.
+	SpriteAttributeCacheEntry& entry = cache.entries[spriteTableIndex];
+	if((entry.vramGeneration != cache.vramGeneration) || (entry.vramAddress != spriteTableEntryAddress))
+	{
+		entry.mappingData = ((unsigned int)vramBuffer.ReadCommitted(spriteTableEntryAddress+4) << 8) | (unsigned int)vramBuffer.ReadCommitted(spriteTableEntryAddress+5);
+		entry.hposData = ((unsigned int)vramBuffer.ReadCommitted(spriteTableEntryAddress+6) << 8) | (unsigned int)vramBuffer.ReadCommitted(spriteTableEntryAddress+7);
+		entry.vramAddress = spriteTableEntryAddress;
+		entry.vramGeneration = cache.vramGeneration;
+
+		unsigned int readAddressStart = spriteTableEntryAddress + 4;
+		unsigned int readAddressEnd = spriteTableEntryAddress + 8;
+		if(cache.vramAddressStart == cache.vramAddressEnd)
+		{
+			cache.vramAddressStart = readAddressStart;
+			cache.vramAddressEnd = readAddressEnd;
+		}
+		else
+		{
+			cache.vramAddressStart = (readAddressStart < cache.vramAddressStart)? readAddressStart: cache.vramAddressStart;
+			cache.vramAddressEnd = (readAddressEnd > cache.vramAddressEnd)? readAddressEnd: cache.vramAddressEnd;
+		}
+	}
+	return entry;
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::AdvanceVRAMBySession(SpriteAttributeCache& cache, ITimedBufferInt& vramBuffer, unsigned int currentProgress, ITimedBufferInt::AdvanceSession& advanceSession, const ITimedBufferInt::Timeslice* targetTimeslice)
+{
+	//Commit pending VRAM writes one at a time, so that we can check the address of each
+	//write against the decoded sprite attribute data before it takes effect. Note that
+	//this relies on no two writes sharing the same write time, which holds since the VDP
+	//writes at most one byte to VRAM at each access slot.
+	while(currentProgress >= advanceSession.nextWriteTime)
+	{
+		ITimedBufferInt::WriteInfo writeInfo = vramBuffer.GetWriteInfo(0, targetTimeslice);
+		if(!writeInfo.exists)
+		{
+			break;
+		}
+		InvalidateSpriteAttributeCacheForVRAMWrite(cache, writeInfo.writeAddress);
+		vramBuffer.AdvanceBySession(advanceSession.nextWriteTime, advanceSession, targetTimeslice);
+	}
+	vramBuffer.AdvanceBySession(currentProgress, advanceSession, targetTimeslice);
+}
+
 //----------------------------------------------------------------------------------------
 //Rendering functions
 //----------------------------------------------------------------------------------------
@@ -150,6 +321,12 @@ void S315_5313::RenderThread()
 {
 	std::unique_lock<std::mutex> lock(renderThreadMutex);
 
+	//Discard any decoded sprite attribute data left from before execution was last
+	//suspended, since the system may have been initialized or had its state loaded while
+	//this thread was stopped. The sprite attribute cache is only ever touched by this
+	//thread while it is running.
+	InvalidateSpriteAttributeCache(renderSpriteAttributeCache, true, true);
+
 	//Start the render loop
 	bool done = false;
 	while(!done)
@@ -161,20 +338,10 @@ void S315_5313::RenderThread()
 			std::unique_lock<std::mutex> timesliceLock(timesliceMutex);
 
 			//If there is at least one render timeslice pending, grab it from the queue.
-			//##FIX## Our pendingRenderOperationCount doesn't really work the way we want.
-			//Currently, here in the render thread, we decrement it once for each
-			//timeslice received, but we don't increment it once for each timeslice.
-			//##FIX## This problem with pendingRenderOperationCount is now breaking our
-			//PSG and YM2612 cores, since the render thread marks itself as lagging when
-			//it's not, and the execute thread waits forever for it to fix itself. We need
-			//to get this working, and replicate it in the PSG and YM2612 cores.
-//			if((pendingRenderOperationCount > 0) && !regTimesliceList.empty() && !vramTimesliceList.empty() && !cramTimesliceList.empty() && !vsramTimesliceList.empty())
 			if(!regTimesliceList.empty() && !vramTimesliceList.empty() && !cramTimesliceList.empty() && !vsramTimesliceList.empty() && !spriteCacheTimesliceList.empty())
 			{
 				//Update the lagging state for the render thread
-				--pendingRenderOperationCount;
-				renderThreadLagging = (pendingRenderOperationCount > maxPendingRenderOperationCount);
-				renderThreadLaggingStateChange.notify_all();
+				renderBackpressure.BeginOperation();
 
 				//Grab the next completed timeslice from the timeslice list
 				timesliceRenderInfo = *timesliceRenderInfoList.begin();
@@ -260,6 +427,14 @@ void S315_5313::RenderThread()
 			vsram->FreeTimesliceReference(vsramTimesliceCopy);
 			spriteCache->FreeTimesliceReference(spriteCacheTimesliceCopy);
 		}
+
+		//Any writes remaining in the timeslice we've just advanced past have now been
+		//committed, so discard our decoded sprite attribute data. This also picks up any
+		//changes made directly to the committed buffer contents by the debugger.
+		InvalidateSpriteAttributeCache(renderSpriteAttributeCache, true, true);
+
+		//Record that we've finished rendering this timeslice
+		renderBackpressure.EndOperation();
 	}
 	renderThreadStopped.notify_all();
 }
@@ -1015,8 +1190,12 @@ void S315_5313::PerformVRAMRenderOperation(const AccessTarget& accessTarget, con
 	case VRAMRenderOp::ACC_SLOT:
 		//Since we've reached an external access slot, changes may now be made to VRAM or
 		//VSRAM, so we need to advance the VRAM and VSRAM buffers up to this time so any
-		//changes which occur at this access slot can take effect.
-		vram->AdvanceBySession(renderDigitalMclkCycleProgress, vramSession, vramTimesliceCopy);
+		//changes which occur at this access slot can take effect. Our decoded sprite
+		//attribute data is discarded if a VRAM write lands within the range it was read
+		//from, or if any write is made to the sprite cache, since the sprite cache only
+		//holds sprite attributes.
+		AdvanceVRAMBySession(renderSpriteAttributeCache, *vram, renderDigitalMclkCycleProgress, vramSession, vramTimesliceCopy);
+		InvalidateSpriteAttributeCache(renderSpriteAttributeCache, (renderDigitalMclkCycleProgress >= spriteCacheSession.nextWriteTime), false);
 		vsram->AdvanceBySession(renderDigitalMclkCycleProgress, vsramSession, vsramTimesliceCopy);
 		spriteCache->AdvanceBySession(renderDigitalMclkCycleProgress, spriteCacheSession, spriteCacheTimesliceCopy);
 		break;
@@ -1134,17 +1313,73 @@ void S315_5313::UpdateAnalogRenderProcess(const AccessTarget& accessTarget, cons
 	}
 	else if((renderDigitalHCounterPos == hscanSettings.vcounterIncrementPoint) && (renderDigitalVCounterPos == vscanSettings.vsyncClearedPoint))
 	{
-		//Calculate the image buffer plane to use for the next frame
-		unsigned int newDrawingImageBufferPlane = videoSingleBuffering? drawingImageBufferPlane: (drawingImageBufferPlane + 1) % imageBufferPlanes;
+		//If frame hash logging is enabled, record the hash of the frame we just completed.
+		if(frameHashLoggingEnabled && !renderAnalogFrameSkipped)
+		{
+			RecordFrameHash(drawingImageBufferPlane);
+		}
 
-		//Obtain a write lock on the new drawing image buffer plane
-		imageBufferLock[newDrawingImageBufferPlane].ObtainWriteLock();
+		//If video capture is enabled, pass the frame we just completed to the capture
+		//writer thread.
+		if(videoCaptureEnabled && !renderAnalogFrameSkipped)
+		{
+			CaptureVideoFrame(drawingImageBufferPlane);
+		}
+
+		//If the frame we just completed had its pixel output skipped, there's nothing new
+		//to present, so we keep drawing into the same image buffer plane. Otherwise,
+		//publish the frame we just completed as the latest completed frame, and advance
+		//to an image buffer plane which no consumer holds a reference to. Consumers can
+		//read a completed frame without any locking, and are never blocked by the render
+		//thread.
+		if(!videoSingleBuffering && !renderAnalogFrameSkipped)
+		{
+			drawingImageBufferPlane = PublishImageBufferPlane(drawingImageBufferPlane, completedImageBufferPlane, imageBufferReferenceCount);
+		}
 
-		//Advance the drawing image buffer to the next plane
-		drawingImageBufferPlane = newDrawingImageBufferPlane;
+		//Allocate or release the pixel info capture for the new drawing plane. Pixel info
+		//is only recorded for frames which begin while full image buffer info is
+		//enabled, and no memory is held for it otherwise. The capture for a plane is
+		//only ever released when double buffering is active, in which case the drawing
+		//plane is guaranteed not to be referenced by any consumer. In single buffering
+		//mode consumers read from the drawing plane directly, so we retain the capture
+		//until double buffering is restored.
+		if(videoEnableFullImageBufferInfo)
+		{
+			if(imageBufferInfo[drawingImageBufferPlane].empty())
+			{
+				imageBufferInfo[drawingImageBufferPlane].resize(imageBufferHeight * imageBufferWidth);
+				SafeMemoryBarrierWrite();
+			}
+			imageBufferInfoCapture[drawingImageBufferPlane] = &imageBufferInfo[drawingImageBufferPlane][0];
+		}
+		else
+		{
+			imageBufferInfoCapture[drawingImageBufferPlane] = 0;
+			if(!videoSingleBuffering && !imageBufferInfo[drawingImageBufferPlane].empty())
+			{
+				std::vector<ImageBufferInfo>().swap(imageBufferInfo[drawingImageBufferPlane]);
+			}
+		}
 
 		//Now that we've completed another frame, advance the last rendered frame token.
-		++lastRenderedFrameToken;
+		if(!renderAnalogFrameSkipped)
+		{
+			++lastRenderedFrameToken;
+		}
+
+		//Determine whether pixel output will be generated for the frame we're about to
+		//begin. Skipped frames still run the complete digital render process, so VRAM
+		//access timing and the sprite overflow and collision state are unaffected. Only
+		//the pixel generation and layer compositing in the analog render process is
+		//skipped. If the render thread has fallen behind, we also skip pixel output to
+		//allow it to catch up, rather than stalling the rest of the system. Whether this
+		//occurs depends on the load on the host, so we never do it while frame hashes are
+		//being logged or video is being captured, otherwise the output would differ
+		//between runs. In that case, the render thread is only ever slowed down by
+		//blocking the execute thread.
+		bool renderDegraded = !frameHashLoggingEnabled && !videoCaptureEnabled && renderBackpressure.IsDegraded();
+		renderAnalogFrameSkipped = SelectFrameRenderSkip(videoFrameRenderInterval, videoFrameRenderRequested, renderAnalogFrameSkipCounter, renderDegraded);
 
 		//Record the odd interlace frame flag
 		imageBufferLineCount[drawingImageBufferPlane] = renderDigitalOddFlagSet;
@@ -1159,9 +1394,15 @@ void S315_5313::UpdateAnalogRenderProcess(const AccessTarget& accessTarget, cons
 		//Clear the cache of sprite boundary lines in this frame
 		std::unique_lock<std::mutex> spriteLock(spriteBoundaryMutex[drawingImageBufferPlane]);
 		imageBufferSpriteBoundaryLines[drawingImageBufferPlane].clear();
+	}
 
-		//Release the write lock on the image buffer plane
-		imageBufferLock[newDrawingImageBufferPlane].ReleaseWriteLock();
+	//If pixel output is being skipped for this frame, keep the committed state of the
+	//CRAM buffer in step with the render position, and skip the remainder of the analog
+	//render process.
+	if(renderAnalogFrameSkipped)
+	{
+		cram->AdvanceBySession(renderDigitalMclkCycleProgress, cramSession, cramTimesliceCopy);
+		return;
 	}
 
 	//Read the display enable register. If this register is cleared, the output for this
@@ -1184,9 +1425,10 @@ void S315_5313::UpdateAnalogRenderProcess(const AccessTarget& accessTarget, cons
 
 	//Set the initial data for this pixel info entry
 	ImageBufferInfo* imageBufferInfoEntry = 0;
-	if(videoEnableFullImageBufferInfo && insidePixelBufferRegion)
+	ImageBufferInfo* drawingImageBufferInfo = imageBufferInfoCapture[drawingImageBufferPlane];
+	if((drawingImageBufferInfo != 0) && insidePixelBufferRegion)
 	{
-		imageBufferInfoEntry = &imageBufferInfo[drawingImageBufferPlane][(renderAnalogCurrentRow * imageBufferWidth) + renderAnalogCurrentPixel];
+		imageBufferInfoEntry = &drawingImageBufferInfo[(renderAnalogCurrentRow * imageBufferWidth) + renderAnalogCurrentPixel];
 		imageBufferInfoEntry->hcounter = renderDigitalHCounterPos;
 		imageBufferInfoEntry->vcounter = renderDigitalVCounterPos;
 		imageBufferInfoEntry->mappingData = 0;
@@ -1361,16 +1603,7 @@ void S315_5313::UpdateAnalogRenderProcess(const AccessTarget& accessTarget, cons
 
 		//Encode the parameters for the layer priority calculation into an index value for
 		//the priority lookup table.
-		unsigned int priorityIndex = 0;
-		priorityIndex |= (unsigned int)shadowHighlightEnabled << 8;
-		priorityIndex |= (unsigned int)spriteIsShadowOperator << 7;
-		priorityIndex |= (unsigned int)spriteIsHighlightOperator << 6;
-		priorityIndex |= (unsigned int)foundSpritePixel << 5;
-		priorityIndex |= (unsigned int)foundLayerAPixel << 4;
-		priorityIndex |= (unsigned int)foundLayerBPixel << 3;
-		priorityIndex |= (unsigned int)layerPriority[LAYERINDEX_SPRITE] << 2;
-		priorityIndex |= (unsigned int)layerPriority[LAYERINDEX_LAYERA] << 1;
-		priorityIndex |= (unsigned int)layerPriority[LAYERINDEX_LAYERB];
+		unsigned int priorityIndex = CalculateLayerPriorityLookupIndex(shadowHighlightEnabled, spriteIsShadowOperator, spriteIsHighlightOperator, foundSpritePixel, foundLayerAPixel, foundLayerBPixel, layerPriority[LAYERINDEX_SPRITE], layerPriority[LAYERINDEX_LAYERA], layerPriority[LAYERINDEX_LAYERB]);
 
 		//Lookup the pre-calculated layer priority from the lookup table. We use a lookup
 		//table to eliminate branching, which should yield a significant performance
@@ -1507,40 +1740,19 @@ void S315_5313::UpdateAnalogRenderProcess(const AccessTarget& accessTarget, cons
 		unsigned int paletteEntryAddress = (paletteIndex + (paletteLine * paletteEntriesPerLine)) * paletteEntrySize;
 
 		//Read the target palette entry
-		Data paletteData(16);
-		paletteData = (unsigned int)(cram->ReadCommitted(paletteEntryAddress+0) << 8) | (unsigned int)cram->ReadCommitted(paletteEntryAddress+1);
+		unsigned int paletteData = ((unsigned int)cram->ReadCommitted(paletteEntryAddress+0) << 8) | (unsigned int)cram->ReadCommitted(paletteEntryAddress+1);
 
-		//Decode the target palette entry, and extract the individual 7-bit R, G, and B
-		//intensity values.
-		//-----------------------------------------------------------------
-		//|15 |14 |13 |12 |11 |10 | 9 | 8 | 7 | 6 | 5 | 4 | 3 | 2 | 1 | 0 |
-		//|---------------------------------------------------------------|
-		//| /   /   /   / |   Blue    | / |   Green   | / |    Red    | / |
-		//-----------------------------------------------------------------
-		unsigned int colorIntensityR = paletteData.GetDataSegment(1, 3);
-		unsigned int colorIntensityG = paletteData.GetDataSegment(5, 3);
-		unsigned int colorIntensityB = paletteData.GetDataSegment(9, 3);
-
-		//If a reduced palette is in effect, due to bit 2 of register 1 being cleared,
-		//only the lowest bit of each intensity value has any effect, and it selects
-		//between half intensity and minimum intensity. Note that hardware tests have
-		//shown that changes to this register take effect immediately, at any point in a
-		//line.
+		//Decode the target palette entry into a packed 9-bit colour value. A reduced
+		//palette is in effect when bit 2 of register 1 is cleared. Note that hardware
+		//tests have shown that changes to this register take effect immediately, at any
+		//point in a line.
 		//##TODO## Confirm the interaction of shadow highlight mode with the palette
 		//select bit.
-		//##TODO## Confirm the mapping of intensity values when the palette select bit is
-		//cleared.
-		if(!RegGetPS(accessTarget))
-		{
-			colorIntensityR = (colorIntensityR & 0x01) << 2;
-			colorIntensityG = (colorIntensityG & 0x01) << 2;
-			colorIntensityB = (colorIntensityB & 0x01) << 2;
-		}
+		unsigned int colorValue = DecodePaletteColorValue(paletteData, !RegGetPS(accessTarget));
 
-		//Convert the palette data to a 32-bit RGBA triple and write it to the image
-		//buffer
-		//##TODO## As an optimization, use a combined lookup table for colour value
-		//decoding, and eliminate the branching logic here.
+		//Convert the colour value to a 32-bit RGBA triple using the palette colour lookup
+		//table, and write it to the image buffer. The shadow and highlight states select
+		//the adjusted intensity values from the upper half of the table.
 		ImageBufferColorEntry& imageBufferEntry = *((ImageBufferColorEntry*)&imageBuffer[drawingImageBufferPlane][((renderAnalogCurrentRow * imageBufferWidth) + renderAnalogCurrentPixel) * 4]);
 		if(outputNothing)
 		{
@@ -1549,34 +1761,17 @@ void S315_5313::UpdateAnalogRenderProcess(const AccessTarget& accessTarget, cons
 			imageBufferEntry.b = 0;
 			imageBufferEntry.a = 0xFF;
 		}
-		else if(shadow == highlight)
-		{
-			imageBufferEntry.r = paletteEntryTo8Bit[colorIntensityR];
-			imageBufferEntry.g = paletteEntryTo8Bit[colorIntensityG];
-			imageBufferEntry.b = paletteEntryTo8Bit[colorIntensityB];
-			imageBufferEntry.a = 0xFF;
-		}
-		else if(shadow && !highlight)
-		{
-			imageBufferEntry.r = paletteEntryTo8BitShadow[colorIntensityR];
-			imageBufferEntry.g = paletteEntryTo8BitShadow[colorIntensityG];
-			imageBufferEntry.b = paletteEntryTo8BitShadow[colorIntensityB];
-			imageBufferEntry.a = 0xFF;
-		}
-		else if(highlight && !shadow)
+		else
 		{
-			imageBufferEntry.r = paletteEntryTo8BitHighlight[colorIntensityR];
-			imageBufferEntry.g = paletteEntryTo8BitHighlight[colorIntensityG];
-			imageBufferEntry.b = paletteEntryTo8BitHighlight[colorIntensityB];
-			imageBufferEntry.a = 0xFF;
+			imageBufferEntry = paletteColorLookupTable[CalculatePaletteColorLookupIndex(colorValue, shadow, highlight)];
 		}
 
 		//Record information on the output colour for this pixel
 		if(imageBufferInfoEntry != 0)
 		{
-			imageBufferInfoEntry->colorComponentR = colorIntensityR;
-			imageBufferInfoEntry->colorComponentG = colorIntensityG;
-			imageBufferInfoEntry->colorComponentB = colorIntensityB;
+			imageBufferInfoEntry->colorComponentR = colorValue & 0x7;
+			imageBufferInfoEntry->colorComponentG = (colorValue >> 3) & 0x7;
+			imageBufferInfoEntry->colorComponentB = (colorValue >> 6) & 0x7;
 		}
 	}
 }
@@ -1873,7 +2068,6 @@ void S315_5313::DigitalRenderBuildSpriteList(unsigned int screenRowNumber, bool
 {
 	if(!spriteSearchComplete && !spriteOverflow)
 	{
-		static const unsigned int spriteCacheEntrySize = 4;
 		const unsigned int spriteAttributeTableSize = (screenModeRS1Active)? 80: 64;
 		static const unsigned int spritePosScreenStartH = 0x80;
 		const unsigned int spritePosScreenStartV = (interlaceMode2Active)? 0x100: 0x80;
@@ -1882,14 +2076,10 @@ void S315_5313::DigitalRenderBuildSpriteList(unsigned int screenRowNumber, bool
 		const unsigned int renderSpriteDisplayCacheSize = (screenModeRS1Active)? 20: 16;
 		const unsigned int renderSpriteCellDisplayCacheSize = (screenModeRS1Active)? 40: 32;
 
-		//Calculate the address in the sprite cache of the next sprite to read data for
-		unsigned int spriteCacheAddress = (nextTableEntryToRead * spriteCacheEntrySize);
-
 		//Read all available data on the next sprite from the sprite cache
-		Data spriteVPosData(16);
-		Data spriteSizeAndLinkData(16);
-		spriteVPosData = ((unsigned int)spriteCache->ReadCommitted(spriteCacheAddress+0) << 8) | (unsigned int)spriteCache->ReadCommitted(spriteCacheAddress+1);
-		spriteSizeAndLinkData = ((unsigned int)spriteCache->ReadCommitted(spriteCacheAddress+2) << 8) | (unsigned int)spriteCache->ReadCommitted(spriteCacheAddress+3);
+		const SpriteAttributeCacheEntry& spriteAttributeCacheEntry = ReadCachedSpriteCacheEntry(renderSpriteAttributeCache, *spriteCache, nextTableEntryToRead);
+		Data spriteVPosData(16, spriteAttributeCacheEntry.vposData);
+		Data spriteSizeAndLinkData(16, spriteAttributeCacheEntry.sizeAndLinkData);
 
 		//Calculate the width and height of this sprite in cells
 		unsigned int spriteHeightInCells = spriteSizeAndLinkData.GetDataSegment(8, 2) + 1;
@@ -1955,7 +2145,6 @@ void S315_5313::DigitalRenderBuildSpriteCellList(const HScanSettings& hscanSetti
 	if(!spriteDotOverflow)
 	{
 		//##TODO## Tidy up this list of constants
-		static const unsigned int spriteCacheEntrySize = 4;
 		static const unsigned int spriteTableEntrySize = 8;
 		const unsigned int spriteAttributeTableSize = (screenModeRS1Active)? 80: 64;
 		static const unsigned int spritePosScreenStartH = 0x80;
@@ -1974,10 +2163,9 @@ void S315_5313::DigitalRenderBuildSpriteCellList(const HScanSettings& hscanSetti
 		//buffered after it is read the first time while parsing the sprite table to
 		//determine the list of sprites on the current line, or if the data is read again
 		//from the cache during the mapping decoding.
-		Data spriteMappingData(16);
-		Data spriteHPosData(16);
-		spriteMappingData = ((unsigned int)vram->ReadCommitted(spriteTableEntryAddress+4) << 8) | (unsigned int)vram->ReadCommitted(spriteTableEntryAddress+5);
-		spriteHPosData = ((unsigned int)vram->ReadCommitted(spriteTableEntryAddress+6) << 8) | (unsigned int)vram->ReadCommitted(spriteTableEntryAddress+7);
+		const SpriteAttributeCacheEntry& spriteAttributeCacheEntry = ReadCachedSpriteTableEntry(renderSpriteAttributeCache, *vram, spriteDisplayCacheEntry.spriteTableIndex, spriteTableEntryAddress);
+		Data spriteMappingData(16, spriteAttributeCacheEntry.mappingData);
+		Data spriteHPosData(16, spriteAttributeCacheEntry.hposData);
 
 		//Load the remaining data into the sprite display cache
 		spriteDisplayCacheEntry.mappingData = spriteMappingData;
@@ -2144,7 +2332,61 @@ unsigned int S315_5313::DigitalRenderReadPixelIndex(const Data& patternRow, bool
 }
 
 //----------------------------------------------------------------------------------------
-void S315_5313::CalculateLayerPriorityIndex(unsigned int& layerIndex, bool& shadow, bool& highlight, bool shadowHighlightEnabled, bool spriteIsShadowOperator, bool spriteIsHighlightOperator, bool foundSpritePixel, bool foundLayerAPixel, bool foundLayerBPixel, bool prioritySprite, bool priorityLayerA, bool priorityLayerB) const
+//Render lookup table functions
+//----------------------------------------------------------------------------------------
+void S315_5313::BuildLayerPriorityLookupTable(std::vector<unsigned int>& table)
+{
+	table.resize(layerPriorityLookupTableSize);
+	for(unsigned int i = 0; i < layerPriorityLookupTableSize; ++i)
+	{
+		//Determine the input layer settings for this table index value
+		bool shadowHighlightEnabled = (i & (1 << 8)) != 0;
+		bool spriteIsShadowOperator = (i & (1 << 7)) != 0;
+		bool spriteIsHighlightOperator = (i & (1 << 6)) != 0;
+		bool foundSpritePixel = (i & (1 << 5)) != 0;
+		bool foundLayerAPixel = (i & (1 << 4)) != 0;
+		bool foundLayerBPixel = (i & (1 << 3)) != 0;
+		bool prioritySprite = (i & (1 << 2)) != 0;
+		bool priorityLayerA = (i & (1 << 1)) != 0;
+		bool priorityLayerB = (i & 1) != 0;
+
+		//Resolve the layer priority for this combination of layer settings
+		unsigned int layerIndex;
+		bool shadow;
+		bool highlight;
+		CalculateLayerPriorityIndex(layerIndex, shadow, highlight, shadowHighlightEnabled, spriteIsShadowOperator, spriteIsHighlightOperator, foundSpritePixel, foundLayerAPixel, foundLayerBPixel, prioritySprite, priorityLayerA, priorityLayerB);
+
+		//Incorporate the shadow and highlight bits into the layer index value
+		layerIndex |= shadow? 1 << 3: 0;
+		layerIndex |= highlight? 1 << 2: 0;
+
+		//Write the combined value to the layer priority lookup table
+		table[i] = layerIndex;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::BuildPaletteColorLookupTable(std::vector<ImageBufferColorEntry>& table)
+{
+	//Each entry in this table converts a decoded 9-bit palette colour value directly into
+	//an output colour, with the shadow and highlight adjustment already applied. The
+	//shadow and highlight states form bits 9 and 10 of the table index respectively.
+	//Where both or neither are set, the normal colour intensity is selected.
+	table.resize(paletteColorLookupTableSize);
+	for(unsigned int i = 0; i < paletteColorLookupTableSize; ++i)
+	{
+		bool shadow = (i & (1 << 9)) != 0;
+		bool highlight = (i & (1 << 10)) != 0;
+		ImageBufferColorEntry& colorEntry = table[i];
+		colorEntry.r = ConvertColorValueTo8Bit(i & 0x7, shadow, highlight);
+		colorEntry.g = ConvertColorValueTo8Bit((i >> 3) & 0x7, shadow, highlight);
+		colorEntry.b = ConvertColorValueTo8Bit((i >> 6) & 0x7, shadow, highlight);
+		colorEntry.a = 0xFF;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::CalculateLayerPriorityIndex(unsigned int& layerIndex, bool& shadow, bool& highlight, bool shadowHighlightEnabled, bool spriteIsShadowOperator, bool spriteIsHighlightOperator, bool foundSpritePixel, bool foundLayerAPixel, bool foundLayerBPixel, bool prioritySprite, bool priorityLayerA, bool priorityLayerB)
 {
 	//Initialize the shadow/highlight flags
 	shadow = false;
@@ -2392,6 +2634,12 @@ S315_5313::DecodedPaletteColorEntry S315_5313::ReadDecodedPaletteColor(unsigned
 
 //----------------------------------------------------------------------------------------
 unsigned char S315_5313::ColorValueTo8BitValue(unsigned int colorValue, bool shadow, bool highlight) const
+{
+	return ConvertColorValueTo8Bit(colorValue, shadow, highlight);
+}
+
+//----------------------------------------------------------------------------------------
+unsigned char S315_5313::ConvertColorValueTo8Bit(unsigned int colorValue, bool shadow, bool highlight)
 {
 	if(shadow == highlight)
 	{
@@ -2411,6 +2659,539 @@ MarshalSupport::Marshal::Ret<std::list<S315_5313::SpriteBoundaryLineEntry>> S315
 	return imageBufferSpriteBoundaryLines[planeNo];
 }
 
+//----------------------------------------------------------------------------------------
+//Frame hash logging functions
+//----------------------------------------------------------------------------------------
+//The frame hash log records a hash of the rendered image and of VRAM, CRAM, and VSRAM as
+//seen by the render process, for every Nth completed frame. Each line of the log file
+//holds the frame number followed by the four hash values in that order. If a comparison
+//log has been specified, each recorded frame is compared against the matching frame in
+//that log, and the first divergence is reported to the event log. This is intended to
+//catch accuracy regressions from changes to the emulation cores, by comparing a log
+//captured from a known good build against a log generated by a new build.
+//----------------------------------------------------------------------------------------
+void S315_5313::SetFrameHashLoggingEnabled(bool state)
+{
+	std::unique_lock<std::mutex> lock(frameHashMutex);
+	if(state == frameHashLoggingEnabled)
+	{
+		return;
+	}
+
+	//If frame hash logging is being disabled, close the log file, and discard the
+	//comparison log.
+	if(!state)
+	{
+		frameHashLoggingEnabled = false;
+		frameHashLogFile.Close();
+		frameHashComparisonLog.clear();
+		return;
+	}
+
+	//Load the comparison log, if one has been specified.
+	frameHashComparisonLog.clear();
+	if(!frameHashComparisonPath.empty() && !LoadFrameHashComparisonLog(frameHashComparisonPath, frameHashComparisonLog))
+	{
+		LogEntry logEntry(LogEntry::EventLevel::Error);
+		logEntry << L"Failed to load frame hash comparison log from file " << frameHashComparisonPath;
+		GetDeviceContext()->WriteLogEvent(logEntry);
+	}
+
+	//Create the output log file
+	if(!frameHashLogFile.Open(frameHashLoggingPath, Stream::File::OpenMode::ReadAndWrite, Stream::File::CreateMode::Create))
+	{
+		LogEntry logEntry(LogEntry::EventLevel::Error);
+		logEntry << L"Failed to create frame hash log file " << frameHashLoggingPath;
+		GetDeviceContext()->WriteLogEvent(logEntry);
+		frameHashComparisonLog.clear();
+		return;
+	}
+	frameHashLogFile.SetTextEncoding(Stream::IStream::TextEncoding::UTF8);
+
+	//Begin logging from the next completed frame
+	frameHashFrameNo = 0;
+	frameHashComparisonIndex = 0;
+	frameHashDivergenceReported = false;
+	frameHashLoggingEnabled = true;
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::RecordFrameHash(unsigned int planeNo)
+{
+	std::unique_lock<std::mutex> lock(frameHashMutex);
+	if(!frameHashLoggingEnabled)
+	{
+		return;
+	}
+
+	//Only record a hash for every Nth frame
+	unsigned int frameNo = frameHashFrameNo++;
+	if((frameNo % frameHashInterval) != 0)
+	{
+		return;
+	}
+
+	//Calculate the hash of the image data for this frame. We only include the pixels
+	//which were actually output on each line.
+	static const unsigned long long initialHashValue = 14695981039346656037ULL;
+	FrameHashEntry entry;
+	entry.frameNo = frameNo;
+	entry.imageHash = initialHashValue;
+	unsigned int lineCount = (imageBufferLineCount[planeNo] < imageBufferHeight)? imageBufferLineCount[planeNo]: imageBufferHeight;
+	for(unsigned int lineNo = 0; lineNo < lineCount; ++lineNo)
+	{
+		unsigned int lineWidth = (imageBufferLineWidth[planeNo][lineNo] < imageBufferWidth)? imageBufferLineWidth[planeNo][lineNo]: imageBufferWidth;
+		entry.imageHash = CalculateFrameHash(entry.imageHash, &imageBuffer[planeNo][lineNo * imageBufferWidth * 4], lineWidth * 4);
+	}
+
+	//Calculate the hash of each memory buffer. We're running on the render thread at the
+	//point the frame was completed, so the committed state of each buffer is the state
+	//the render process has reached.
+	entry.vramHash = CalculateFrameHash(initialHashValue, *vram);
+	entry.cramHash = CalculateFrameHash(initialHashValue, *cram);
+	entry.vsramHash = CalculateFrameHash(initialHashValue, *vsram);
+
+	//Write this entry to the log file
+	Stream::ViewText logView(frameHashLogFile);
+	logView << entry.frameNo << L'\t' << entry.imageHash << L'\t' << entry.vramHash << L'\t' << entry.cramHash << L'\t' << entry.vsramHash << L'\n';
+
+	//Compare this entry with the matching entry in the comparison log, if present.
+	while((frameHashComparisonIndex < (unsigned int)frameHashComparisonLog.size()) && (frameHashComparisonLog[frameHashComparisonIndex].frameNo < frameNo))
+	{
+		++frameHashComparisonIndex;
+	}
+	if(!frameHashDivergenceReported && (frameHashComparisonIndex < (unsigned int)frameHashComparisonLog.size()) && (frameHashComparisonLog[frameHashComparisonIndex].frameNo == frameNo))
+	{
+		const FrameHashEntry& comparisonEntry = frameHashComparisonLog[frameHashComparisonIndex];
+		std::wstring divergentComponents;
+		if(entry.imageHash != comparisonEntry.imageHash) divergentComponents += L" Image";
+		if(entry.vramHash != comparisonEntry.vramHash) divergentComponents += L" VRAM";
+		if(entry.cramHash != comparisonEntry.cramHash) divergentComponents += L" CRAM";
+		if(entry.vsramHash != comparisonEntry.vsramHash) divergentComponents += L" VSRAM";
+		if(!divergentComponents.empty())
+		{
+			LogEntry logEntry(LogEntry::EventLevel::Warning);
+			logEntry << L"Frame hash divergence from comparison log at frame " << frameNo << L". Divergent components:" << divergentComponents;
+			GetDeviceContext()->WriteLogEvent(logEntry);
+			frameHashDivergenceReported = true;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+bool S315_5313::LoadFrameHashComparisonLog(const std::wstring& filePath, std::vector<FrameHashEntry>& comparisonLog) const
+{
+	Stream::File source;
+	if(!source.Open(filePath, Stream::File::OpenMode::ReadOnly, Stream::File::CreateMode::Open))
+	{
+		return false;
+	}
+	source.SetTextEncoding(Stream::IStream::TextEncoding::UTF8);
+	Stream::ViewText sourceView(source);
+	while(!sourceView.IsAtEnd())
+	{
+		std::wstring line;
+		if(!sourceView.ReadTextString(line))
+		{
+			break;
+		}
+		std::wstringstream lineStream(line);
+		FrameHashEntry entry;
+		if(lineStream >> entry.frameNo >> entry.imageHash >> entry.vramHash >> entry.cramHash >> entry.vsramHash)
+		{
+			comparisonLog.push_back(entry);
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned long long S315_5313::CalculateFrameHash(unsigned long long hash, const unsigned char* data, unsigned int dataSize)
+{
+	//Accumulate the data into a 64-bit FNV-1a hash
+	static const unsigned long long hashPrime = 1099511628211ULL;
+	for(unsigned int i = 0; i < dataSize; ++i)
+	{
+		hash = (hash ^ data[i]) * hashPrime;
+	}
+	return hash;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned long long S315_5313::CalculateFrameHash(unsigned long long hash, const ITimedBufferInt& buffer)
+{
+	static const unsigned long long hashPrime = 1099511628211ULL;
+	unsigned int bufferSize = buffer.Size();
+	for(unsigned int i = 0; i < bufferSize; ++i)
+	{
+		hash = (hash ^ buffer.ReadCommitted(i)) * hashPrime;
+	}
+	return hash;
+}
+
+//----------------------------------------------------------------------------------------
+//Video capture functions
+//----------------------------------------------------------------------------------------
+void S315_5313::SetVideoCaptureEnabled(bool state)
+{
+	std::unique_lock<std::mutex> lock(videoCaptureMutex);
+	if(state == videoCaptureEnabled)
+	{
+		return;
+	}
+
+	//If video capture is being disabled, stop the capture, and report the result,
+	//including any frames which were dropped because the writer thread fell behind.
+	if(!state)
+	{
+		StopVideoCapture(lock);
+		LogEntry logEntry((videoCaptureDroppedFrameCount > 0)? LogEntry::EventLevel::Warning: LogEntry::EventLevel::Info);
+		logEntry << L"Video capture to " << videoCapturePath << L" complete. " << videoCaptureWrittenFrameCount << L" frames written, " << videoCaptureDroppedFrameCount << L" frames dropped, " << audioCaptureWrittenSampleCount << L" audio samples written.";
+		GetDeviceContext()->WriteLogEvent(logEntry);
+		return;
+	}
+
+	//Create the output files. The mixed audio is written to a WAV file alongside the
+	//video file, with the same name.
+	std::wstring videoCaptureExtension = PathGetFileExtension(videoCapturePath);
+	std::wstring audioCapturePath = videoCapturePath.substr(0, videoCapturePath.size() - (videoCaptureExtension.empty()? 0: videoCaptureExtension.size() + 1)) + L".wav";
+	if(!videoCaptureFile.Open(videoCapturePath, Stream::File::OpenMode::WriteOnly, Stream::File::CreateMode::Create))
+	{
+		LogEntry logEntry(LogEntry::EventLevel::Error);
+		logEntry << L"Failed to create video capture file " << videoCapturePath;
+		GetDeviceContext()->WriteLogEvent(logEntry);
+		return;
+	}
+	audioCaptureFile.SetDataFormat(audioCaptureChannelCount, 16, audioCaptureSamplesPerSec);
+	if(!audioCaptureFile.Open(audioCapturePath, Stream::WAVFile::OpenMode::WriteOnly, Stream::WAVFile::CreateMode::Create))
+	{
+		videoCaptureFile.Close();
+		LogEntry logEntry(LogEntry::EventLevel::Error);
+		logEntry << L"Failed to create audio capture file " << audioCapturePath;
+		GetDeviceContext()->WriteLogEvent(logEntry);
+		return;
+	}
+
+	//Allocate the fixed pool of capture frames. Completed frames are copied into a free
+	//frame from this pool by the render thread, and queued for the writer thread. If no
+	//free frame is available, the render thread drops the frame rather than waiting.
+	videoCaptureFrames.resize(videoCaptureQueueSize);
+	videoCaptureFreeFrames.clear();
+	videoCapturePendingFrames.assign(videoCaptureQueueSize, 0);
+	for(unsigned int i = 0; i < videoCaptureQueueSize; ++i)
+	{
+		videoCaptureFrames[i].lineWidth.resize(imageBufferHeight);
+		videoCaptureFrames[i].pixelData.resize(imageBufferHeight * imageBufferWidth * 4);
+		videoCaptureFreeFrames.push_back(i);
+	}
+	videoCapturePendingFrameStart = 0;
+	videoCapturePendingFrameCount = 0;
+	videoCaptureNextFrameNo = 0;
+	videoCaptureDroppedFrameCount = 0;
+	videoCaptureWrittenFrameCount = 0;
+	videoCaptureLastFrameNo = 0;
+	videoCaptureHeaderWritten = false;
+	audioCaptureSampleRemainder = 0;
+	audioCaptureWrittenSampleCount = 0;
+
+	//Attach an input of the audio mixer to each audio capture source. Each source renders
+	//into its input from its own thread, and the writer thread reads a block of mixed
+	//audio for each video frame it writes, so neither side waits on the other.
+	audioCaptureMixer = new AudioMixer(audioCaptureChannelCount, audioCaptureSamplesPerSec, audioCaptureInputCapacityInSamples);
+	for(std::list<IAudioCaptureSource*>::const_iterator i = audioCaptureSources.begin(); i != audioCaptureSources.end(); ++i)
+	{
+		IAudioSink* audioCaptureInput = audioCaptureMixer->CreateInput();
+		if(!(*i)->SetAudioCaptureSink(audioCaptureInput))
+		{
+			audioCaptureMixer->DeleteInput(audioCaptureInput);
+			LogEntry logEntry(LogEntry::EventLevel::Warning);
+			logEntry << L"An audio source couldn't be captured, as its output format isn't supported by the audio mixer.";
+			GetDeviceContext()->WriteLogEvent(logEntry);
+			continue;
+		}
+		audioCaptureInputs[*i] = audioCaptureInput;
+	}
+
+	//Start the writer thread, and begin capturing from the next completed frame.
+	videoCaptureThreadActive = true;
+	videoCaptureThreadRunning = true;
+	std::thread writerThread(std::bind(std::mem_fn(&S315_5313::VideoCaptureWriterThread), this));
+	writerThread.detach();
+	videoCaptureEnabled = true;
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::StopVideoCapture(std::unique_lock<std::mutex>& lock)
+{
+	//Stop the writer thread. The writer thread drains any frames which are still queued
+	//before it closes the output files.
+	videoCaptureEnabled = false;
+	videoCaptureThreadActive = false;
+	videoCaptureUpdate.notify_all();
+	while(videoCaptureThreadRunning)
+	{
+		videoCaptureStopped.wait(lock);
+	}
+
+	//Detach each audio capture source from the audio mixer, then destroy the mixer.
+	for(std::map<IAudioCaptureSource*, IAudioSink*>::const_iterator i = audioCaptureInputs.begin(); i != audioCaptureInputs.end(); ++i)
+	{
+		i->first->SetAudioCaptureSink(0);
+		audioCaptureMixer->DeleteInput(i->second);
+	}
+	audioCaptureInputs.clear();
+	delete audioCaptureMixer;
+	audioCaptureMixer = 0;
+
+	//Release the capture buffers
+	std::vector<VideoCaptureFrame>().swap(videoCaptureFrames);
+	std::vector<unsigned char>().swap(videoCaptureOutputBuffer);
+	std::vector<short>().swap(audioCaptureBuffer);
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::CaptureVideoFrame(unsigned int planeNo)
+{
+	std::unique_lock<std::mutex> lock(videoCaptureMutex);
+	if(!videoCaptureEnabled)
+	{
+		return;
+	}
+
+	//Assign a sequence number to this frame. If the writer thread has fallen far enough
+	//behind that there's no free capture frame, we drop this frame rather than block the
+	//render thread. The writer thread uses the gap in the sequence numbers to keep the
+	//output timeline intact.
+	unsigned int frameNo = videoCaptureNextFrameNo++;
+	if(videoCaptureFreeFrames.empty())
+	{
+		++videoCaptureDroppedFrameCount;
+		return;
+	}
+	unsigned int frameIndex = videoCaptureFreeFrames.back();
+	videoCaptureFreeFrames.pop_back();
+
+	//Copy the completed frame into the capture frame, along with the rate at which frames
+	//are being output under the current clock and screen mode settings.
+	VideoCaptureFrame& frame = videoCaptureFrames[frameIndex];
+	frame.frameNo = frameNo;
+	CalculateVideoFrameRate(clockMclkCurrent, renderDigitalScreenModeRS0Active, renderDigitalScreenModeRS1Active, renderDigitalScreenModeV30Active, renderDigitalPalModeActive, renderDigitalInterlaceEnabledActive, frame.frameRateNumerator, frame.frameRateDenominator);
+	frame.lineCount = (imageBufferLineCount[planeNo] < imageBufferHeight)? imageBufferLineCount[planeNo]: imageBufferHeight;
+	for(unsigned int lineNo = 0; lineNo < frame.lineCount; ++lineNo)
+	{
+		unsigned int lineWidth = imageBufferLineWidth[planeNo][lineNo];
+		frame.lineWidth[lineNo] = (lineWidth < imageBufferWidth)? lineWidth: imageBufferWidth;
+	}
+	std::memcpy(&frame.pixelData[0], &imageBuffer[planeNo][0], frame.lineCount * imageBufferWidth * 4);
+
+	//Queue the frame for the writer thread
+	unsigned int pendingIndex = (videoCapturePendingFrameStart + videoCapturePendingFrameCount) % videoCaptureQueueSize;
+	videoCapturePendingFrames[pendingIndex] = frameIndex;
+	++videoCapturePendingFrameCount;
+	videoCaptureUpdate.notify_all();
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::VideoCaptureWriterThread()
+{
+	std::unique_lock<std::mutex> lock(videoCaptureMutex);
+
+	//Write out queued frames until we're instructed to stop and the queue is empty
+	while(videoCaptureThreadActive || (videoCapturePendingFrameCount > 0))
+	{
+		//If no frames are waiting to be written, wait for a frame to be queued.
+		if(videoCapturePendingFrameCount == 0)
+		{
+			videoCaptureUpdate.wait(lock);
+			continue;
+		}
+
+		//Take the next frame from the queue, and write it to the output file. Note that
+		//we release the lock while writing, so the render thread can continue to queue
+		//frames.
+		unsigned int frameIndex = videoCapturePendingFrames[videoCapturePendingFrameStart];
+		videoCapturePendingFrameStart = (videoCapturePendingFrameStart + 1) % videoCaptureQueueSize;
+		--videoCapturePendingFrameCount;
+		lock.unlock();
+		WriteVideoCaptureFrame(videoCaptureFrames[frameIndex]);
+		lock.lock();
+
+		//Return the frame to the free pool
+		videoCaptureFreeFrames.push_back(frameIndex);
+	}
+
+	//Close the output files, and notify that this thread has stopped.
+	videoCaptureFile.Close();
+	audioCaptureFile.Close();
+	videoCaptureThreadRunning = false;
+	videoCaptureStopped.notify_all();
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::WriteVideoCaptureFrame(const VideoCaptureFrame& frame)
+{
+	//The YUV4MPEG2 format requires every frame to have the same dimensions and rate, so
+	//we fix the output dimensions and frame rate from the first captured frame, and write
+	//the stream header.
+	if(!videoCaptureHeaderWritten)
+	{
+		videoCaptureWidth = ((frame.lineCount > 0) && (frame.lineWidth[0] > 0))? frame.lineWidth[0]: 1;
+		videoCaptureHeight = (frame.lineCount > 0)? frame.lineCount: 1;
+		videoCaptureFrameRateNumerator = frame.frameRateNumerator;
+		videoCaptureFrameRateDenominator = frame.frameRateDenominator;
+		WriteVideoCaptureStreamHeader(videoCaptureFile, videoCaptureWidth, videoCaptureHeight, videoCaptureFrameRateNumerator, videoCaptureFrameRateDenominator);
+		videoCaptureHeaderWritten = true;
+	}
+	else
+	{
+		//If frames were dropped before this frame, repeat the last frame we wrote in
+		//their place, so that the captured video remains frame-accurate against the
+		//emulated timeline.
+		for(unsigned int frameNo = videoCaptureLastFrameNo + 1; frameNo < frame.frameNo; ++frameNo)
+		{
+			WriteVideoCaptureOutputBuffer();
+		}
+	}
+
+	//Convert the frame, and write it to the output files
+	ConvertVideoCaptureFrame(frame, videoCaptureWidth, videoCaptureHeight, videoCaptureOutputBuffer);
+	WriteVideoCaptureOutputBuffer();
+	videoCaptureLastFrameNo = frame.frameNo;
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::WriteVideoCaptureOutputBuffer()
+{
+	//Write the converted frame to the video file, then write the block of mixed audio
+	//which covers the same period to the audio file. Audio is always taken in step with
+	//the video frames we output, including repeated frames, so the two streams stay in
+	//sync regardless of how many frames were dropped.
+	WriteVideoCaptureStreamFrame(videoCaptureFile, videoCaptureOutputBuffer);
+	++videoCaptureWrittenFrameCount;
+	unsigned int sampleCount = CalculateAudioCaptureSampleCount(audioCaptureSamplesPerSec, videoCaptureFrameRateNumerator, videoCaptureFrameRateDenominator, audioCaptureSampleRemainder);
+	if(sampleCount > 0)
+	{
+		audioCaptureBuffer.resize(sampleCount * audioCaptureChannelCount);
+		audioCaptureMixer->ReadMixedSamples(&audioCaptureBuffer[0], sampleCount);
+		audioCaptureFile.WriteData(&audioCaptureBuffer[0], (Stream::WAVFile::SizeType)audioCaptureBuffer.size());
+		audioCaptureWrittenSampleCount += sampleCount;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Video capture stream functions
+//----------------------------------------------------------------------------------------
+void S315_5313::CalculateVideoFrameRate(double mclkFrequency, bool screenModeRS0Active, bool screenModeRS1Active, bool screenModeV30Active, bool palModeActive, bool interlaceActive, unsigned int& frameRateNumerator, unsigned int& frameRateDenominator)
+{
+	//If the mclk frequency isn't known yet, use the nominal frequency for the video mode.
+	static const double ntscMasterClockFrequency = 53693175.0;
+	static const double palMasterClockFrequency = 53203424.0;
+	if(mclkFrequency <= 0.0)
+	{
+		mclkFrequency = palModeActive? palMasterClockFrequency: ntscMasterClockFrequency;
+	}
+
+	//Calculate the number of mclk ticks in each line, and the number of lines in each
+	//field. In interlace mode, the vcounter repeats one extra value in every second field,
+	//so we average the length of the two fields, giving one output frame per field.
+	const HScanSettings& hscanSettings = GetHScanSettings(screenModeRS0Active, screenModeRS1Active);
+	const VScanSettings& vscanSettings = GetVScanSettings(screenModeV30Active, palModeActive, interlaceActive);
+	unsigned int mclkTicksPerLine = GetMclkTicksForPixelClockTicks(hscanSettings, hscanSettings.hcounterStepsPerIteration, 0, screenModeRS0Active, screenModeRS1Active);
+	unsigned int activeScanLineCount = vscanSettings.vcounterActiveScanMaxValue + 1;
+	unsigned int linesPerField = activeScanLineCount + ((vscanSettings.vcounterMaxValue + 1) - vscanSettings.vcounterBlankingInitialValue);
+	unsigned int fieldCount = 1;
+	if(interlaceActive)
+	{
+		linesPerField += activeScanLineCount + ((vscanSettings.vcounterMaxValue + 1) - vscanSettings.vcounterBlankingInitialValueOddFlag);
+		fieldCount = 2;
+	}
+
+	//Express the frame rate as an exact ratio, reduced to its lowest terms. We round the
+	//mclk frequency to the nearest whole hertz first, since the YUV4MPEG2 format only
+	//supports integer ratios.
+	unsigned long long numerator = (unsigned long long)(mclkFrequency + 0.5) * fieldCount;
+	unsigned long long denominator = (unsigned long long)mclkTicksPerLine * linesPerField;
+	unsigned long long a = numerator;
+	unsigned long long b = denominator;
+	while(b != 0)
+	{
+		unsigned long long remainder = a % b;
+		a = b;
+		b = remainder;
+	}
+	frameRateNumerator = (unsigned int)(numerator / a);
+	frameRateDenominator = (unsigned int)(denominator / a);
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int S315_5313::CalculateAudioCaptureSampleCount(unsigned int samplesPerSec, unsigned int frameRateNumerator, unsigned int frameRateDenominator, unsigned long long& sampleRemainder)
+{
+	//Calculate the number of audio samples which cover the next video frame. The
+	//fractional part is carried between frames in the remainder, so the total number of
+	//samples stays exact over any number of frames.
+	if(frameRateNumerator == 0)
+	{
+		return 0;
+	}
+	sampleRemainder += (unsigned long long)samplesPerSec * frameRateDenominator;
+	unsigned int sampleCount = (unsigned int)(sampleRemainder / frameRateNumerator);
+	sampleRemainder %= frameRateNumerator;
+	return sampleCount;
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::ConvertVideoCaptureFrame(const VideoCaptureFrame& frame, unsigned int outputWidth, unsigned int outputHeight, std::vector<unsigned char>& outputBuffer)
+{
+	//Convert the frame to planar 4:4:4 YCbCr at the output dimensions, using the BT.601
+	//conversion. Lines which differ in width from the output image, due to mid-frame
+	//screen mode changes, are resampled to the output width, and lines outside the frame
+	//are output as black.
+	unsigned int planeSize = outputWidth * outputHeight;
+	outputBuffer.resize(planeSize * 3);
+	unsigned char* planeY = &outputBuffer[0];
+	unsigned char* planeCb = planeY + planeSize;
+	unsigned char* planeCr = planeCb + planeSize;
+	for(unsigned int ypos = 0; ypos < outputHeight; ++ypos)
+	{
+		unsigned int lineWidth = (ypos < frame.lineCount)? frame.lineWidth[ypos]: 0;
+		for(unsigned int xpos = 0; xpos < outputWidth; ++xpos)
+		{
+			int r = 0;
+			int g = 0;
+			int b = 0;
+			if(lineWidth > 0)
+			{
+				unsigned int sourcePosX = (xpos * lineWidth) / outputWidth;
+				const unsigned char* sourcePixel = &frame.pixelData[((ypos * imageBufferWidth) + sourcePosX) * 4];
+				r = sourcePixel[0];
+				g = sourcePixel[1];
+				b = sourcePixel[2];
+			}
+			unsigned int outputIndex = (ypos * outputWidth) + xpos;
+			planeY[outputIndex] = (unsigned char)((((66 * r) + (129 * g) + (25 * b) + 128) >> 8) + 16);
+			planeCb[outputIndex] = (unsigned char)((((-38 * r) - (74 * g) + (112 * b) + 128) >> 8) + 128);
+			planeCr[outputIndex] = (unsigned char)((((112 * r) - (94 * g) - (18 * b) + 128) >> 8) + 128);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::WriteVideoCaptureStreamHeader(Stream::IStream& stream, unsigned int width, unsigned int height, unsigned int frameRateNumerator, unsigned int frameRateDenominator)
+{
+	std::stringstream header;
+	header << "YUV4MPEG2 W" << width << " H" << height << " F" << frameRateNumerator << ":" << frameRateDenominator << " Ip A1:1 C444\n";
+	std::string headerString = header.str();
+	stream.WriteData(headerString.c_str(), (Stream::IStream::SizeType)headerString.size());
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::WriteVideoCaptureStreamFrame(Stream::IStream& stream, const std::vector<unsigned char>& outputBuffer)
+{
+	static const char frameHeader[] = "FRAME\n";
+	stream.WriteData(frameHeader, (Stream::IStream::SizeType)(sizeof(frameHeader) - 1));
+	stream.WriteData(&outputBuffer[0], (Stream::IStream::SizeType)outputBuffer.size());
+}
+
 //----------------------------------------------------------------------------------------
 //Sprite list debugging functions
 //----------------------------------------------------------------------------------------
@@ -56,17 +56,21 @@ References:
 #include "WindowsSupport/WindowsSupport.pkg"
 #include "DeviceInterface/DeviceInterface.pkg"
 #include "TimedBuffers/TimedBuffers.pkg"
+#include "Stream/Stream.pkg"
+#include "AudioStream/AudioStream.pkg"
 #include <vector>
 #include <list>
 #include <map>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 
 class S315_5313 :public Device, public GenericAccessBase<IS315_5313>
 {
 public:
 	//Constructors
 	S315_5313(const std::wstring& aimplementationName, const std::wstring& ainstanceName, unsigned int amoduleID);
+	~S315_5313();
 
 	//Interface version functions
 	virtual unsigned int GetIS315_5313Version() const;
@@ -154,12 +158,64 @@ public:
 	virtual bool GetGenericDataLocked(unsigned int dataID, const DataContext* dataContext) const;
 	virtual bool SetGenericDataLocked(unsigned int dataID, const DataContext* dataContext, bool state);
 
+protected:
+	//Batch read functions
+	virtual void BeginGenericDataBatch() const;
+	virtual bool ReadGenericDataBatchEntry(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue) const;
+
+public:
+	//Enumerations
+	enum LayerIndex :unsigned int;
+
+	//Structures
+	struct ImageBufferColorEntry;
+	struct VideoCaptureFrame;
+	struct SpriteAttributeCacheEntry;
+	struct SpriteAttributeCache;
+
+	//Render constants
+	static const unsigned char paletteEntryTo8Bit[8];
+	static const unsigned char paletteEntryTo8BitShadow[8];
+	static const unsigned char paletteEntryTo8BitHighlight[8];
+	static const unsigned int layerPriorityLookupTableSize = 0x200;
+	static const unsigned int paletteColorLookupTableSize = 0x800;
+
+public:
+	//Render lookup table functions
+	static void BuildLayerPriorityLookupTable(std::vector<unsigned int>& table);
+	static void BuildPaletteColorLookupTable(std::vector<ImageBufferColorEntry>& table);
+	static void CalculateLayerPriorityIndex(unsigned int& layerIndex, bool& shadow, bool& highlight, bool shadowHighlightEnabled, bool spriteIsShadowOperator, bool spriteIsHighlightOperator, bool foundSpritePixel, bool foundLayerAPixel, bool foundLayerBPixel, bool prioritySprite, bool priorityLayerA, bool priorityLayerB);
+	static inline unsigned int CalculateLayerPriorityLookupIndex(bool shadowHighlightEnabled, bool spriteIsShadowOperator, bool spriteIsHighlightOperator, bool foundSpritePixel, bool foundLayerAPixel, bool foundLayerBPixel, bool prioritySprite, bool priorityLayerA, bool priorityLayerB);
+	static inline unsigned int DecodePaletteColorValue(unsigned int paletteData, bool reducedPalette);
+	static inline unsigned int CalculatePaletteColorLookupIndex(unsigned int colorValue, bool shadow, bool highlight);
+	static unsigned char ConvertColorValueTo8Bit(unsigned int colorValue, bool shadow, bool highlight);
+
+	//Video capture stream functions
+	static void CalculateVideoFrameRate(double mclkFrequency, bool screenModeRS0Active, bool screenModeRS1Active, bool screenModeV30Active, bool palModeActive, bool interlaceActive, unsigned int& frameRateNumerator, unsigned int& frameRateDenominator);
+	static unsigned int CalculateAudioCaptureSampleCount(unsigned int samplesPerSec, unsigned int frameRateNumerator, unsigned int frameRateDenominator, unsigned long long& sampleRemainder);
+	static void ConvertVideoCaptureFrame(const VideoCaptureFrame& frame, unsigned int outputWidth, unsigned int outputHeight, std::vector<unsigned char>& outputBuffer);
+	static void WriteVideoCaptureStreamHeader(Stream::IStream& stream, unsigned int width, unsigned int height, unsigned int frameRateNumerator, unsigned int frameRateDenominator);
+	static void WriteVideoCaptureStreamFrame(Stream::IStream& stream, const std::vector<unsigned char>& outputBuffer);
+
+	//Image buffer handoff functions
+	static unsigned int AcquireImageBufferPlane(const volatile unsigned int& completedPlaneNo, volatile ReferenceCounterType* referenceCounts);
+	static unsigned int PublishImageBufferPlane(unsigned int drawingPlaneNo, volatile unsigned int& completedPlaneNo, const volatile ReferenceCounterType* referenceCounts);
+
+	//Frame skip functions
+	static bool SelectFrameRenderSkip(unsigned int frameRenderInterval, std::atomic<bool>& frameRenderRequested, unsigned int& frameSkipCounter, bool renderDegraded);
+
+	//Sprite attribute cache functions
+	static const SpriteAttributeCacheEntry& ReadCachedSpriteCacheEntry(SpriteAttributeCache& cache, const ITimedBufferInt& spriteCacheBuffer, unsigned int spriteTableIndex);
+	static const SpriteAttributeCacheEntry& ReadCachedSpriteTableEntry(SpriteAttributeCache& cache, const ITimedBufferInt& vramBuffer, unsigned int spriteTableIndex, unsigned int spriteTableEntryAddress);
+	static inline void InvalidateSpriteAttributeCache(SpriteAttributeCache& cache, bool spriteCacheChanged, bool vramChanged);
+	static inline void InvalidateSpriteAttributeCacheForVRAMWrite(SpriteAttributeCache& cache, unsigned int vramWriteAddress);
+	static void AdvanceVRAMBySession(SpriteAttributeCache& cache, ITimedBufferInt& vramBuffer, unsigned int currentProgress, ITimedBufferInt::AdvanceSession& advanceSession, const ITimedBufferInt::Timeslice* targetTimeslice);
+
 private:
 	//Enumerations
 	enum class CELineID;
 	enum class LineID;
 	enum class ClockID;
-	enum LayerIndex :unsigned int;
 	enum class AccessContext;
 
 	//Structures
@@ -173,7 +229,7 @@ private:
 	struct InternalRenderOp;
 	struct FIFOBufferEntry;
 	struct HVCounterAdvanceSession;
-	struct ImageBufferColorEntry;
+	struct FrameHashEntry;
 
 	//Typedefs
 	typedef RandomTimeAccessBuffer<Data, unsigned int> RegBuffer;
@@ -182,9 +238,6 @@ private:
 
 	//Render constants
 	static const unsigned int renderDigitalBlockPixelSizeY = 8;
-	static const unsigned char paletteEntryTo8Bit[8];
-	static const unsigned char paletteEntryTo8BitShadow[8];
-	static const unsigned char paletteEntryTo8BitHighlight[8];
 	static const VRAMRenderOp vramOperationsH32ActiveLine[171];
 	static const VRAMRenderOp vramOperationsH32InactiveLine[171];
 	static const VRAMRenderOp vramOperationsH40ActiveLine[210];
@@ -212,6 +265,9 @@ private:
 	static const VScanSettings v30NtscIntEnScanSettingsStatic;
 
 private:
+	//Data read functions
+	bool ReadGenericData(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue, const AccessTarget& accessTarget) const;
+
 	//Line functions
 	unsigned int GetNewIPLLineState();
 	void UpdatePredictedLineStateChanges(IDeviceContext* callingDevice, double accessTime, unsigned int accessContext);
@@ -229,8 +285,8 @@ private:
 	virtual unsigned int GetImageLastRenderedFrameToken() const;
 	virtual unsigned int GetImageCompletedBufferPlaneNo() const;
 	virtual unsigned int GetImageDrawingBufferPlaneNo() const;
-	virtual void LockImageBufferData(unsigned int planeNo);
-	virtual void UnlockImageBufferData(unsigned int planeNo);
+	virtual unsigned int AcquireLatestImageBufferPlane() const;
+	virtual void ReleaseImageBufferPlane(unsigned int planeNo) const;
 	virtual const unsigned char* GetImageBufferData(unsigned int planeNo) const;
 	virtual const ImageBufferInfo* GetImageBufferInfo(unsigned int planeNo) const;
 	virtual const ImageBufferInfo* GetImageBufferInfo(unsigned int planeNo, unsigned int lineNo, unsigned int pixelNo) const;
@@ -256,7 +312,6 @@ private:
 	void DigitalRenderBuildSpriteList(unsigned int screenRowNumber, bool interlaceMode2Active, bool screenModeRS1Active, unsigned int& nextTableEntryToRead, bool& spriteSearchComplete, bool& spriteOverflow, unsigned int& spriteDisplayCacheEntryCount, std::vector<SpriteDisplayCacheEntry>& spriteDisplayCache) const;
 	void DigitalRenderBuildSpriteCellList(const HScanSettings& hscanSettings, const VScanSettings& vscanSettings, unsigned int spriteDisplayCacheIndex, unsigned int spriteTableBaseAddress, bool interlaceMode2Active, bool screenModeRS1Active, bool& spriteDotOverflow, SpriteDisplayCacheEntry& spriteDisplayCacheEntry, unsigned int& spriteCellDisplayCacheEntryCount, std::vector<SpriteCellDisplayCacheEntry>& spriteCellDisplayCache) const;
 	unsigned int DigitalRenderReadPixelIndex(const Data& patternRow, bool horizontalFlip, unsigned int pixelIndex) const;
-	void CalculateLayerPriorityIndex(unsigned int& layerIndex, bool& shadow, bool& highlight, bool shadowHighlightEnabled, bool spriteIsShadowOperator, bool spriteIsHighlightOperator, bool foundSpritePixel, bool foundLayerAPixel, bool foundLayerBPixel, bool prioritySprite, bool priorityLayerA, bool priorityLayerB) const;
 	virtual unsigned int CalculatePatternDataRowNumber(unsigned int patternRowNumberNoFlip, bool interlaceMode2Active, const Data& mappingData) const;
 	virtual unsigned int CalculatePatternDataRowAddress(unsigned int patternRowNumber, unsigned int patternCellOffset, bool interlaceMode2Active, const Data& mappingData) const;
 	virtual void CalculateEffectiveCellScrollSize(unsigned int hszState, unsigned int vszState, unsigned int& effectiveScrollWidth, unsigned int& effectiveScrollHeight) const;
@@ -264,6 +319,21 @@ private:
 	virtual unsigned char ColorValueTo8BitValue(unsigned int colorValue, bool shadow, bool highlight) const;
 	virtual MarshalSupport::Marshal::Ret<std::list<SpriteBoundaryLineEntry>> GetSpriteBoundaryLines(unsigned int planeNo) const;
 
+	//Frame hash logging functions
+	void SetFrameHashLoggingEnabled(bool state);
+	void RecordFrameHash(unsigned int planeNo);
+	bool LoadFrameHashComparisonLog(const std::wstring& filePath, std::vector<FrameHashEntry>& comparisonLog) const;
+	static unsigned long long CalculateFrameHash(unsigned long long hash, const unsigned char* data, unsigned int dataSize);
+	static unsigned long long CalculateFrameHash(unsigned long long hash, const ITimedBufferInt& buffer);
+
+	//Video capture functions
+	void SetVideoCaptureEnabled(bool state);
+	void StopVideoCapture(std::unique_lock<std::mutex>& lock);
+	void CaptureVideoFrame(unsigned int planeNo);
+	void VideoCaptureWriterThread();
+	void WriteVideoCaptureFrame(const VideoCaptureFrame& frame);
+	void WriteVideoCaptureOutputBuffer();
+
 	//Sprite list debugging functions
 	virtual SpriteMappingTableEntry GetSpriteMappingTableEntry(unsigned int spriteTableBaseAddress, unsigned int entryNo) const;
 	virtual void SetSpriteMappingTableEntry(unsigned int spriteTableBaseAddress, unsigned int entryNo, const SpriteMappingTableEntry& entry, bool useSeparatedData);
@@ -338,6 +408,7 @@ private:
 	void PerformDMACopyOperation();
 	void PerformDMAFillOperation();
 	void CacheDMATransferReadData(unsigned int mclkTime);
+	const IBusInterface::MemoryTarget* GetDMATransferSourceTarget(unsigned int sourceAddress);
 	void PerformDMATransferOperation();
 	void AdvanceDMAState();
 	bool TargetProcessorStateReached(bool stopWhenFifoEmpty, bool stopWhenFifoFull, bool stopWhenFifoNotFull, bool stopWhenReadDataAvailable, bool stopWhenNoDMAOperationInProgress);
@@ -561,6 +632,58 @@ private:
 	bool videoShowBoundaryActionSafe;
 	bool videoShowBoundaryTitleSafe;
 	bool videoEnableFullImageBufferInfo;
+	volatile unsigned int videoFrameRenderInterval;
+	std::atomic<bool> videoFrameRenderRequested;
+
+	//Frame hash logging
+	mutable std::mutex frameHashMutex;
+	volatile bool frameHashLoggingEnabled;
+	std::wstring frameHashLoggingPath;
+	std::wstring frameHashComparisonPath;
+	unsigned int frameHashInterval;
+	unsigned int frameHashFrameNo;
+	Stream::File frameHashLogFile;
+	std::vector<FrameHashEntry> frameHashComparisonLog;
+	unsigned int frameHashComparisonIndex;
+	bool frameHashDivergenceReported;
+
+	//Video capture
+	static const unsigned int videoCaptureQueueSize = 8;
+	mutable std::mutex videoCaptureMutex;
+	std::condition_variable videoCaptureUpdate;
+	std::condition_variable videoCaptureStopped;
+	volatile bool videoCaptureEnabled;
+	bool videoCaptureThreadActive;
+	bool videoCaptureThreadRunning;
+	std::wstring videoCapturePath;
+	Stream::File videoCaptureFile;
+	std::vector<VideoCaptureFrame> videoCaptureFrames;
+	std::vector<unsigned int> videoCaptureFreeFrames;
+	std::vector<unsigned int> videoCapturePendingFrames;
+	unsigned int videoCapturePendingFrameStart;
+	unsigned int videoCapturePendingFrameCount;
+	unsigned int videoCaptureNextFrameNo;
+	volatile unsigned int videoCaptureDroppedFrameCount;
+	unsigned int videoCaptureWrittenFrameCount;
+	unsigned int videoCaptureLastFrameNo;
+	bool videoCaptureHeaderWritten;
+	unsigned int videoCaptureWidth;
+	unsigned int videoCaptureHeight;
+	unsigned int videoCaptureFrameRateNumerator;
+	unsigned int videoCaptureFrameRateDenominator;
+	std::vector<unsigned char> videoCaptureOutputBuffer;
+
+	//Audio capture
+	static const unsigned int audioCaptureChannelCount = 2;
+	static const unsigned int audioCaptureSamplesPerSec = 48000;
+	static const unsigned int audioCaptureInputCapacityInSamples = 48000;
+	std::list<IAudioCaptureSource*> audioCaptureSources;
+	std::map<IAudioCaptureSource*, IAudioSink*> audioCaptureInputs;
+	AudioMixer* audioCaptureMixer;
+	Stream::WAVFile audioCaptureFile;
+	unsigned long long audioCaptureSampleRemainder;
+	unsigned int audioCaptureWrittenSampleCount;
+	std::vector<short> audioCaptureBuffer;
 
 	//Bus interface
 	IBusInterface* memoryBus;
@@ -611,6 +734,7 @@ private:
 	mutable std::mutex lineMutex; //Top level, must never be held during a blocking operation
 	double lastAccessTime;
 	RegBuffer reg;
+	mutable std::vector<Data> genericDataBatchRegisterSnapshot;
 	ITimedBufferInt* vram;
 	ITimedBufferInt* cram;
 	ITimedBufferInt* vsram;
@@ -809,13 +933,11 @@ private:
 	ITimedBufferInt::AdvanceSession vsramSession;
 	ITimedBufferInt::AdvanceSession spriteCacheSession;
 	unsigned int mclkCycleRenderProgress;
-	static const unsigned int layerPriorityLookupTableSize = 0x200;
 	std::vector<unsigned int> layerPriorityLookupTable;
+	std::vector<ImageBufferColorEntry> paletteColorLookupTable;
 
-	static const unsigned int maxPendingRenderOperationCount = 4;
-	volatile bool renderThreadLagging;
-	std::condition_variable renderThreadLaggingStateChange;
-	unsigned int pendingRenderOperationCount;
+	RenderBackpressure renderBackpressure;
+	double uncommittedRenderTime;
 	std::list<TimesliceRenderInfo> timesliceRenderInfoList;
 	std::list<RegBuffer::Timeslice> regTimesliceList;
 	std::list<ITimedBufferInt::Timeslice*> vramTimesliceList;
@@ -836,6 +958,7 @@ private:
 	static const unsigned int maxCellsPerRow = 42;
 	static const unsigned int maxSpriteDisplayCacheSize = 20;
 	static const unsigned int maxSpriteDisplayCellCacheSize = 40;
+	static const unsigned int maxSpriteAttributeTableSize = 80;
 	static const unsigned int spritePixelBufferSize = maxCellsPerRow*8;
 	static const unsigned int renderSpritePixelBufferPlaneCount = 2;
 	unsigned int renderDigitalHCounterPos;
@@ -877,6 +1000,7 @@ private:
 	unsigned int renderSpriteDisplayCellCacheEntryCount;
 	unsigned int renderSpriteDisplayCellCacheCurrentIndex;
 	bool renderSpriteDotOverflow;
+	mutable SpriteAttributeCache renderSpriteAttributeCache;
 	bool renderSpriteDotOverflowPreviousLine;
 	unsigned int renderSpritePixelBufferDigitalRenderPlane;
 	unsigned int renderSpritePixelBufferAnalogRenderPlane;
@@ -887,12 +1011,16 @@ private:
 	Data renderVSRAMCachedRead;
 
 	//Analog render data buffers
+	bool renderAnalogFrameSkipped;
+	unsigned int renderAnalogFrameSkipCounter;
 	mutable std::mutex imageBufferMutex;
 	unsigned int drawingImageBufferPlane;
+	volatile unsigned int completedImageBufferPlane;
 	volatile unsigned int lastRenderedFrameToken;
-	mutable ReadWriteLock imageBufferLock[imageBufferPlanes];
+	mutable volatile ReferenceCounterType imageBufferReferenceCount[imageBufferPlanes];
 	unsigned char imageBuffer[imageBufferPlanes][imageBufferHeight * imageBufferWidth * 4];
-	ImageBufferInfo imageBufferInfo[imageBufferPlanes][imageBufferHeight * imageBufferWidth];
+	std::vector<ImageBufferInfo> imageBufferInfo[imageBufferPlanes];
+	ImageBufferInfo* volatile imageBufferInfoCapture[imageBufferPlanes];
 	bool imageBufferOddInterlaceFrame[imageBufferPlanes];
 	unsigned int imageBufferLineCount[imageBufferPlanes];
 	unsigned int imageBufferLineWidth[imageBufferPlanes][imageBufferHeight];
@@ -934,6 +1062,14 @@ private:
 	Data bdmaTransferInvalidPortWriteDataCache;
 	volatile bool dmaAdvanceUntilDMAComplete;
 
+	//DMA transfer source resolution
+	static const unsigned int dmaTransferSourceWindowMaxSize = 0x1000;
+	bool dmaTransferSourceWindowValid;
+	bool dmaTransferSourceTargetResolved;
+	unsigned int dmaTransferSourceWindowStart;
+	unsigned int dmaTransferSourceWindowEnd;
+	IBusInterface::MemoryTarget dmaTransferSourceTarget;
+
 	//External interrupt settings
 	bool externalInterruptVideoTriggerPointPending;
 	bool bexternalInterruptVideoTriggerPointPending;
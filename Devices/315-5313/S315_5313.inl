@@ -258,6 +258,45 @@ struct S315_5313::SpriteDisplayCacheEntry
 	Data hpos;
 };
 
+//----------------------------------------------------------------------------------------
+struct S315_5313::SpriteAttributeCacheEntry
+{
+	SpriteAttributeCacheEntry()
+	:spriteCacheGeneration(0), vposData(0), sizeAndLinkData(0), vramGeneration(0), vramAddress(0), mappingData(0), hposData(0)
+	{}
+
+	//Data from the internal sprite cache
+	unsigned int spriteCacheGeneration;
+	unsigned int vposData;
+	unsigned int sizeAndLinkData;
+
+	//Data from the sprite attribute table in VRAM
+	unsigned int vramGeneration;
+	unsigned int vramAddress;
+	unsigned int mappingData;
+	unsigned int hposData;
+};
+
+//----------------------------------------------------------------------------------------
+struct S315_5313::SpriteAttributeCache
+{
+	SpriteAttributeCache(unsigned int entryCount)
+	:entries(entryCount), spriteCacheGeneration(1), vramGeneration(1), vramAddressStart(0), vramAddressEnd(0)
+	{}
+
+	//Decoded entries, indexed by sprite table entry number
+	std::vector<SpriteAttributeCacheEntry> entries;
+
+	//The current generation of data from each source buffer. Entries tagged with any
+	//other generation are stale.
+	unsigned int spriteCacheGeneration;
+	unsigned int vramGeneration;
+
+	//The range of VRAM addresses read by entries decoded in the current VRAM generation
+	unsigned int vramAddressStart;
+	unsigned int vramAddressEnd;
+};
+
 //----------------------------------------------------------------------------------------
 struct S315_5313::SpriteCellDisplayCacheEntry
 {
@@ -410,6 +449,35 @@ struct S315_5313::ImageBufferColorEntry
 	unsigned char a;
 };
 
+//----------------------------------------------------------------------------------------
+struct S315_5313::FrameHashEntry
+{
+	FrameHashEntry()
+	:frameNo(0), imageHash(0), vramHash(0), cramHash(0), vsramHash(0)
+	{}
+
+	unsigned int frameNo;
+	unsigned long long imageHash;
+	unsigned long long vramHash;
+	unsigned long long cramHash;
+	unsigned long long vsramHash;
+};
+
+//----------------------------------------------------------------------------------------
+struct S315_5313::VideoCaptureFrame
+{
+	VideoCaptureFrame()
+	:frameNo(0), frameRateNumerator(0), frameRateDenominator(1), lineCount(0)
+	{}
+
+	unsigned int frameNo;
+	unsigned int frameRateNumerator;
+	unsigned int frameRateDenominator;
+	unsigned int lineCount;
+	std::vector<unsigned int> lineWidth;
+	std::vector<unsigned char> pixelData;
+};
+
 //----------------------------------------------------------------------------------------
 //Status register functions
 //----------------------------------------------------------------------------------------
@@ -565,6 +633,84 @@ void S315_5313::SetStatusFlagPAL(bool state)
 	status.SetBit(0, state);
 }
 
+//----------------------------------------------------------------------------------------
+//Render lookup table functions
+//----------------------------------------------------------------------------------------
+unsigned int S315_5313::CalculateLayerPriorityLookupIndex(bool shadowHighlightEnabled, bool spriteIsShadowOperator, bool spriteIsHighlightOperator, bool foundSpritePixel, bool foundLayerAPixel, bool foundLayerBPixel, bool prioritySprite, bool priorityLayerA, bool priorityLayerB)
+{
+	unsigned int priorityIndex = 0;
+	priorityIndex |= (unsigned int)shadowHighlightEnabled << 8;
+	priorityIndex |= (unsigned int)spriteIsShadowOperator << 7;
+	priorityIndex |= (unsigned int)spriteIsHighlightOperator << 6;
+	priorityIndex |= (unsigned int)foundSpritePixel << 5;
+	priorityIndex |= (unsigned int)foundLayerAPixel << 4;
+	priorityIndex |= (unsigned int)foundLayerBPixel << 3;
+	priorityIndex |= (unsigned int)prioritySprite << 2;
+	priorityIndex |= (unsigned int)priorityLayerA << 1;
+	priorityIndex |= (unsigned int)priorityLayerB;
+	return priorityIndex;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int S315_5313::DecodePaletteColorValue(unsigned int paletteData, bool reducedPalette)
+{
+	//Decode the palette entry into a packed 9-bit colour value, with the 3-bit red
+	//intensity in bits 0-2, green in bits 3-5, and blue in bits 6-8.
+	//-----------------------------------------------------------------
+	//|15 |14 |13 |12 |11 |10 | 9 | 8 | 7 | 6 | 5 | 4 | 3 | 2 | 1 | 0 |
+	//|---------------------------------------------------------------|
+	//| /   /   /   / |   Blue    | / |   Green   | / |    Red    | / |
+	//-----------------------------------------------------------------
+	unsigned int colorValue = ((paletteData >> 1) & 0x007) | ((paletteData >> 2) & 0x038) | ((paletteData >> 3) & 0x1C0);
+
+	//If a reduced palette is in effect, only the lowest bit of each intensity value has
+	//any effect, and it selects between half intensity and minimum intensity.
+	//##TODO## Confirm the mapping of intensity values when the palette select bit is
+	//cleared.
+	if(reducedPalette)
+	{
+		colorValue = (colorValue & 0x049) << 2;
+	}
+	return colorValue;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int S315_5313::CalculatePaletteColorLookupIndex(unsigned int colorValue, bool shadow, bool highlight)
+{
+	return colorValue | ((unsigned int)shadow << 9) | ((unsigned int)highlight << 10);
+}
+
+//----------------------------------------------------------------------------------------
+//Sprite attribute cache functions
+//----------------------------------------------------------------------------------------
+void S315_5313::InvalidateSpriteAttributeCache(SpriteAttributeCache& cache, bool spriteCacheChanged, bool vramChanged)
+{
+	//Entries in the sprite attribute cache are tagged with the generation they were
+	//decoded in, so advancing the generation discards all existing entries at once.
+	if(spriteCacheChanged)
+	{
+		++cache.spriteCacheGeneration;
+	}
+	if(vramChanged)
+	{
+		++cache.vramGeneration;
+		cache.vramAddressStart = 0;
+		cache.vramAddressEnd = 0;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void S315_5313::InvalidateSpriteAttributeCacheForVRAMWrite(SpriteAttributeCache& cache, unsigned int vramWriteAddress)
+{
+	//Only discard the decoded VRAM data if the write lands within the range of addresses
+	//it was read from. Writes elsewhere in VRAM, such as pattern and mapping data
+	//updates, leave the cache intact.
+	if((vramWriteAddress >= cache.vramAddressStart) && (vramWriteAddress < cache.vramAddressEnd))
+	{
+		InvalidateSpriteAttributeCache(cache, false, true);
+	}
+}
+
 //----------------------------------------------------------------------------------------
 //Raw register functions
 //----------------------------------------------------------------------------------------
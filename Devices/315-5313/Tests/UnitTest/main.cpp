@@ -0,0 +1,948 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "S315_5313.h"
+#include "Memory/TimedBufferInt.h"
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <functional>
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+//Resolves a palette entry to an output colour in the same way as the analog render
+//process did before the palette colour lookup table was introduced, with the intensity
+//values extracted individually and the shadow/highlight adjustment applied by branching
+//between the three intensity tables.
+static S315_5313::ImageBufferColorEntry ReferenceResolvePaletteColor(unsigned int paletteWord, bool paletteSelect, bool shadow, bool highlight, unsigned int& colorIntensityR, unsigned int& colorIntensityG, unsigned int& colorIntensityB)
+{
+	Data paletteData(16);
+	paletteData = paletteWord;
+	colorIntensityR = paletteData.GetDataSegment(1, 3);
+	colorIntensityG = paletteData.GetDataSegment(5, 3);
+	colorIntensityB = paletteData.GetDataSegment(9, 3);
+	if(!paletteSelect)
+	{
+		colorIntensityR = (colorIntensityR & 0x01) << 2;
+		colorIntensityG = (colorIntensityG & 0x01) << 2;
+		colorIntensityB = (colorIntensityB & 0x01) << 2;
+	}
+
+	S315_5313::ImageBufferColorEntry color;
+	if(shadow == highlight)
+	{
+		color.r = S315_5313::paletteEntryTo8Bit[colorIntensityR];
+		color.g = S315_5313::paletteEntryTo8Bit[colorIntensityG];
+		color.b = S315_5313::paletteEntryTo8Bit[colorIntensityB];
+		color.a = 0xFF;
+	}
+	else if(shadow && !highlight)
+	{
+		color.r = S315_5313::paletteEntryTo8BitShadow[colorIntensityR];
+		color.g = S315_5313::paletteEntryTo8BitShadow[colorIntensityG];
+		color.b = S315_5313::paletteEntryTo8BitShadow[colorIntensityB];
+		color.a = 0xFF;
+	}
+	else
+	{
+		color.r = S315_5313::paletteEntryTo8BitHighlight[colorIntensityR];
+		color.g = S315_5313::paletteEntryTo8BitHighlight[colorIntensityG];
+		color.b = S315_5313::paletteEntryTo8BitHighlight[colorIntensityB];
+		color.a = 0xFF;
+	}
+	return color;
+}
+
+//----------------------------------------------------------------------------------------
+//Selects the output layer and shadow/highlight state for a pixel in the same way as the
+//analog render process did before the layer priority lookup table was introduced, by
+//walking the priority rules as a chain of branches.
+static void ReferenceCalculateLayerPriorityIndex(unsigned int& layerIndex, bool& shadow, bool& highlight, bool shadowHighlightEnabled, bool spriteIsShadowOperator, bool spriteIsHighlightOperator, bool foundSpritePixel, bool foundLayerAPixel, bool foundLayerBPixel, bool prioritySprite, bool priorityLayerA, bool priorityLayerB)
+{
+	shadow = false;
+	highlight = false;
+	if(!shadowHighlightEnabled)
+	{
+		if(foundSpritePixel && prioritySprite)
+		{
+			layerIndex = S315_5313::LAYERINDEX_SPRITE;
+		}
+		else if(foundLayerAPixel && priorityLayerA)
+		{
+			layerIndex = S315_5313::LAYERINDEX_LAYERA;
+		}
+		else if(foundLayerBPixel && priorityLayerB)
+		{
+			layerIndex = S315_5313::LAYERINDEX_LAYERB;
+		}
+		else if(foundSpritePixel)
+		{
+			layerIndex = S315_5313::LAYERINDEX_SPRITE;
+		}
+		else if(foundLayerAPixel)
+		{
+			layerIndex = S315_5313::LAYERINDEX_LAYERA;
+		}
+		else if(foundLayerBPixel)
+		{
+			layerIndex = S315_5313::LAYERINDEX_LAYERB;
+		}
+		else
+		{
+			layerIndex = S315_5313::LAYERINDEX_BACKGROUND;
+		}
+	}
+	else
+	{
+		if(foundSpritePixel && prioritySprite && !spriteIsShadowOperator && !spriteIsHighlightOperator)
+		{
+			layerIndex = S315_5313::LAYERINDEX_SPRITE;
+		}
+		else if(foundLayerAPixel && priorityLayerA)
+		{
+			layerIndex = S315_5313::LAYERINDEX_LAYERA;
+			if(prioritySprite && spriteIsShadowOperator)
+			{
+				shadow = true;
+			}
+			else if(prioritySprite && spriteIsHighlightOperator)
+			{
+				highlight = true;
+			}
+		}
+		else if(foundLayerBPixel && priorityLayerB)
+		{
+			layerIndex = S315_5313::LAYERINDEX_LAYERB;
+			if(prioritySprite && spriteIsShadowOperator)
+			{
+				shadow = true;
+			}
+			else if(prioritySprite && spriteIsHighlightOperator)
+			{
+				highlight = true;
+			}
+		}
+		else if(foundSpritePixel && !spriteIsShadowOperator && !spriteIsHighlightOperator)
+		{
+			layerIndex = S315_5313::LAYERINDEX_SPRITE;
+			if(!priorityLayerA && !priorityLayerB)
+			{
+				shadow = true;
+			}
+		}
+		else if(foundLayerAPixel)
+		{
+			layerIndex = S315_5313::LAYERINDEX_LAYERA;
+			if(!priorityLayerA && !priorityLayerB)
+			{
+				shadow = true;
+			}
+			if(spriteIsShadowOperator)
+			{
+				shadow = true;
+			}
+			else if(spriteIsHighlightOperator)
+			{
+				highlight = true;
+			}
+		}
+		else if(foundLayerBPixel)
+		{
+			layerIndex = S315_5313::LAYERINDEX_LAYERB;
+			if(!priorityLayerA && !priorityLayerB)
+			{
+				shadow = true;
+			}
+			if(spriteIsShadowOperator)
+			{
+				shadow = true;
+			}
+			else if(spriteIsHighlightOperator)
+			{
+				highlight = true;
+			}
+		}
+		else
+		{
+			layerIndex = S315_5313::LAYERINDEX_BACKGROUND;
+			if(!priorityLayerA && !priorityLayerB)
+			{
+				shadow = true;
+			}
+			if(spriteIsShadowOperator)
+			{
+				shadow = true;
+			}
+			else if(spriteIsHighlightOperator)
+			{
+				highlight = true;
+			}
+		}
+		if(shadow && highlight)
+		{
+			shadow = false;
+			highlight = false;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Looks up the layer selection result for a single set of priority inputs, and checks it
+//against the expected layer and shadow/highlight state.
+static void CheckLayerPriorityLookup(const std::vector<unsigned int>& layerPriorityLookupTable, unsigned int expectedLayerIndex, bool expectedShadow, bool expectedHighlight, bool shadowHighlightEnabled, bool spriteIsShadowOperator, bool spriteIsHighlightOperator, bool foundSpritePixel, bool foundLayerAPixel, bool foundLayerBPixel, bool prioritySprite, bool priorityLayerA, bool priorityLayerB)
+{
+	unsigned int layerSelectionResult = layerPriorityLookupTable[S315_5313::CalculateLayerPriorityLookupIndex(shadowHighlightEnabled, spriteIsShadowOperator, spriteIsHighlightOperator, foundSpritePixel, foundLayerAPixel, foundLayerBPixel, prioritySprite, priorityLayerA, priorityLayerB)];
+	REQUIRE((layerSelectionResult & 0x03) == expectedLayerIndex);
+	REQUIRE(((layerSelectionResult & 0x08) != 0) == expectedShadow);
+	REQUIRE(((layerSelectionResult & 0x04) != 0) == expectedHighlight);
+}
+
+//----------------------------------------------------------------------------------------
+//Holds a set of image buffer planes handed off between a simulated render thread and a
+//number of consumer threads, using the same handoff functions as the VDP. The render
+//thread fills each plane with the number of the frame it holds, so a consumer can detect
+//a torn frame by finding more than one value in the plane it has pinned.
+struct ImageBufferHandoffState
+{
+	ImageBufferHandoffState(unsigned int aplaneSize)
+	:drawingPlaneNo(0), completedPlaneNo(S315_5313::imageBufferPlanes - 1), renderComplete(false), tornFrameCount(0), outOfOrderFrameCount(0), acquireCount(0)
+	{
+		for(unsigned int i = 0; i < S315_5313::imageBufferPlanes; ++i)
+		{
+			referenceCounts[i] = 0;
+			planeData[i].assign(aplaneSize, 0);
+		}
+	}
+
+	unsigned int drawingPlaneNo;
+	volatile unsigned int completedPlaneNo;
+	volatile ReferenceCounterType referenceCounts[S315_5313::imageBufferPlanes];
+	std::vector<unsigned int> planeData[S315_5313::imageBufferPlanes];
+	std::atomic<bool> renderComplete;
+	std::atomic<unsigned int> tornFrameCount;
+	std::atomic<unsigned int> outOfOrderFrameCount;
+	std::atomic<unsigned long long> acquireCount;
+};
+
+//----------------------------------------------------------------------------------------
+static void ImageBufferHandoffRenderThread(ImageBufferHandoffState& state, unsigned int frameCount)
+{
+	for(unsigned int frameNo = 1; frameNo <= frameCount; ++frameNo)
+	{
+		std::vector<unsigned int>& plane = state.planeData[state.drawingPlaneNo];
+		for(unsigned int i = 0; i < (unsigned int)plane.size(); ++i)
+		{
+			plane[i] = frameNo;
+		}
+		state.drawingPlaneNo = S315_5313::PublishImageBufferPlane(state.drawingPlaneNo, state.completedPlaneNo, state.referenceCounts);
+	}
+	state.renderComplete = true;
+}
+
+//----------------------------------------------------------------------------------------
+static void ImageBufferHandoffConsumerThread(ImageBufferHandoffState& state)
+{
+	unsigned int lastFrameNo = 0;
+	unsigned long long acquireCount = 0;
+	while(!state.renderComplete)
+	{
+		unsigned int planeNo = S315_5313::AcquireImageBufferPlane(state.completedPlaneNo, state.referenceCounts);
+		const std::vector<unsigned int>& plane = state.planeData[planeNo];
+		unsigned int frameNo = plane[0];
+		for(unsigned int i = 1; i < (unsigned int)plane.size(); ++i)
+		{
+			if(plane[i] != frameNo)
+			{
+				++state.tornFrameCount;
+				break;
+			}
+		}
+		if(frameNo < lastFrameNo)
+		{
+			++state.outOfOrderFrameCount;
+		}
+		lastFrameNo = frameNo;
+		ReferenceCounterDecrement(state.referenceCounts[planeNo]);
+		++acquireCount;
+	}
+	state.acquireCount += acquireCount;
+}
+
+//----------------------------------------------------------------------------------------
+static double RunImageBufferHandoff(ImageBufferHandoffState& state, unsigned int frameCount, unsigned int consumerCount)
+{
+	std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+	std::vector<std::thread> consumerThreads;
+	for(unsigned int i = 0; i < consumerCount; ++i)
+	{
+		consumerThreads.push_back(std::thread(std::bind(ImageBufferHandoffConsumerThread, std::ref(state))));
+	}
+	std::thread renderThread(std::bind(ImageBufferHandoffRenderThread, std::ref(state), frameCount));
+	renderThread.join();
+	std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int i = 0; i < consumerCount; ++i)
+	{
+		consumerThreads[i].join();
+	}
+	return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+//----------------------------------------------------------------------------------------
+//Issues a series of render requests, waiting for each one to be taken by the render
+//loop before issuing the next.
+static void FrameRenderRequestThread(std::atomic<bool>& frameRenderRequested, std::atomic<bool>& requestsComplete, unsigned int requestCount)
+{
+	for(unsigned int i = 0; i < requestCount; ++i)
+	{
+		frameRenderRequested = true;
+		while(frameRenderRequested)
+		{
+			std::this_thread::yield();
+		}
+	}
+	requestsComplete = true;
+}
+
+//----------------------------------------------------------------------------------------
+//Reads the attributes of a sprite directly from the sprite cache and VRAM, in the same
+//way as the digital render process did before decoded sprite attributes were cached.
+static void ReferenceReadSpriteAttributes(const ITimedBufferInt& spriteCacheBuffer, const ITimedBufferInt& vramBuffer, unsigned int spriteTableIndex, unsigned int spriteTableEntryAddress, unsigned int& vposData, unsigned int& sizeAndLinkData, unsigned int& mappingData, unsigned int& hposData)
+{
+	static const unsigned int spriteCacheEntrySize = 4;
+	unsigned int spriteCacheAddress = (spriteTableIndex * spriteCacheEntrySize);
+	vposData = ((unsigned int)spriteCacheBuffer.ReadCommitted(spriteCacheAddress+0) << 8) | (unsigned int)spriteCacheBuffer.ReadCommitted(spriteCacheAddress+1);
+	sizeAndLinkData = ((unsigned int)spriteCacheBuffer.ReadCommitted(spriteCacheAddress+2) << 8) | (unsigned int)spriteCacheBuffer.ReadCommitted(spriteCacheAddress+3);
+	mappingData = ((unsigned int)vramBuffer.ReadCommitted(spriteTableEntryAddress+4) << 8) | (unsigned int)vramBuffer.ReadCommitted(spriteTableEntryAddress+5);
+	hposData = ((unsigned int)vramBuffer.ReadCommitted(spriteTableEntryAddress+6) << 8) | (unsigned int)vramBuffer.ReadCommitted(spriteTableEntryAddress+7);
+}
+
+//----------------------------------------------------------------------------------------
+//Reads every sprite in the sprite attribute table through the sprite attribute cache,
+//and ensures the decoded attributes match those read directly from the source buffers.
+static void CheckSpriteAttributeCache(S315_5313::SpriteAttributeCache& cache, const ITimedBufferInt& spriteCacheBuffer, const ITimedBufferInt& vramBuffer, unsigned int spriteTableBaseAddress, unsigned int spriteCount)
+{
+	static const unsigned int spriteTableEntrySize = 8;
+	for(unsigned int spriteTableIndex = 0; spriteTableIndex < spriteCount; ++spriteTableIndex)
+	{
+		unsigned int spriteTableEntryAddress = spriteTableBaseAddress + (spriteTableIndex * spriteTableEntrySize);
+		unsigned int vposData;
+		unsigned int sizeAndLinkData;
+		unsigned int mappingData;
+		unsigned int hposData;
+		ReferenceReadSpriteAttributes(spriteCacheBuffer, vramBuffer, spriteTableIndex, spriteTableEntryAddress, vposData, sizeAndLinkData, mappingData, hposData);
+
+		const S315_5313::SpriteAttributeCacheEntry& spriteCacheEntry = S315_5313::ReadCachedSpriteCacheEntry(cache, spriteCacheBuffer, spriteTableIndex);
+		REQUIRE(spriteCacheEntry.vposData == vposData);
+		REQUIRE(spriteCacheEntry.sizeAndLinkData == sizeAndLinkData);
+		const S315_5313::SpriteAttributeCacheEntry& spriteTableEntry = S315_5313::ReadCachedSpriteTableEntry(cache, vramBuffer, spriteTableIndex, spriteTableEntryAddress);
+		REQUIRE(spriteTableEntry.mappingData == mappingData);
+		REQUIRE(spriteTableEntry.hposData == hposData);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Buffers a write to each target VRAM address in the latest timeslice, one per access
+//slot, then steps through the timeslice one access slot at a time in the same way as the
+//digital render process, reading every sprite through the sprite attribute cache after
+//each slot.
+static void RenderSpritesAcrossVRAMWrites(S315_5313::SpriteAttributeCache& cache, TimedBufferInt& spriteCacheBuffer, TimedBufferInt& vramBuffer, unsigned int spriteTableBaseAddress, unsigned int spriteCount, const std::vector<unsigned int>& writeAddresses)
+{
+	static const unsigned int accessSlotInterval = 16;
+	unsigned int timesliceLength = ((unsigned int)writeAddresses.size() + 1) * accessSlotInterval;
+	vramBuffer.AddTimeslice(timesliceLength);
+	for(unsigned int i = 0; i < (unsigned int)writeAddresses.size(); ++i)
+	{
+		vramBuffer.Write(writeAddresses[i], (i + 1) * accessSlotInterval, (unsigned char)(0x80 + i));
+	}
+
+	ITimedBufferInt::Timeslice* timeslice = vramBuffer.GetLatestTimesliceReference();
+	ITimedBufferInt::AdvanceSession advanceSession(0);
+	vramBuffer.BeginAdvanceSession(advanceSession, timeslice, false);
+	for(unsigned int progress = 0; progress < timesliceLength; progress += accessSlotInterval)
+	{
+		S315_5313::AdvanceVRAMBySession(cache, vramBuffer, progress, advanceSession, timeslice);
+		CheckSpriteAttributeCache(cache, spriteCacheBuffer, vramBuffer, spriteTableBaseAddress, spriteCount);
+	}
+	vramBuffer.AdvancePastTimeslice(timeslice);
+	vramBuffer.FreeTimesliceReference(timeslice);
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::PaletteColorLookupTable", "")
+{
+	std::vector<S315_5313::ImageBufferColorEntry> paletteColorLookupTable;
+	S315_5313::BuildPaletteColorLookupTable(paletteColorLookupTable);
+	REQUIRE(paletteColorLookupTable.size() == S315_5313::paletteColorLookupTableSize);
+
+	//Resolve every possible CRAM word through both the lookup table and the original
+	//per-pixel path, under every combination of the palette select, shadow, and highlight
+	//states, and ensure the output colour and the recorded intensity values are identical.
+	unsigned int mismatchCount = 0;
+	for(unsigned int paletteWord = 0; paletteWord < 0x10000; ++paletteWord)
+	{
+		for(unsigned int state = 0; state < 8; ++state)
+		{
+			bool paletteSelect = (state & 0x1) != 0;
+			bool shadow = (state & 0x2) != 0;
+			bool highlight = (state & 0x4) != 0;
+
+			unsigned int referenceR;
+			unsigned int referenceG;
+			unsigned int referenceB;
+			S315_5313::ImageBufferColorEntry referenceColor = ReferenceResolvePaletteColor(paletteWord, paletteSelect, shadow, highlight, referenceR, referenceG, referenceB);
+
+			unsigned int colorValue = S315_5313::DecodePaletteColorValue(paletteWord, !paletteSelect);
+			const S315_5313::ImageBufferColorEntry& color = paletteColorLookupTable[S315_5313::CalculatePaletteColorLookupIndex(colorValue, shadow, highlight)];
+
+			bool colorMatches = (color.r == referenceColor.r) && (color.g == referenceColor.g) && (color.b == referenceColor.b) && (color.a == referenceColor.a);
+			bool intensityMatches = ((colorValue & 0x7) == referenceR) && (((colorValue >> 3) & 0x7) == referenceG) && (((colorValue >> 6) & 0x7) == referenceB);
+			if(!colorMatches || !intensityMatches)
+			{
+				++mismatchCount;
+			}
+		}
+	}
+	REQUIRE(mismatchCount == 0);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::LayerPriorityLookupTable", "")
+{
+	std::vector<unsigned int> layerPriorityLookupTable;
+	S315_5313::BuildLayerPriorityLookupTable(layerPriorityLookupTable);
+	REQUIRE(layerPriorityLookupTable.size() == S315_5313::layerPriorityLookupTableSize);
+
+	SECTION("Known cases", "")
+	{
+		//Each check gives the expected layer, shadow, and highlight result, followed by
+		//the shadowHighlightEnabled, spriteIsShadowOperator, spriteIsHighlightOperator,
+		//foundSpritePixel, foundLayerAPixel, foundLayerBPixel, prioritySprite,
+		//priorityLayerA, and priorityLayerB inputs.
+		//With no pixels found, the background is shown.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_BACKGROUND, false, false, false, false, false, false, false, false, false, false, false);
+		//A low priority sprite is above low priority layers, but below a high priority
+		//layer B pixel.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_SPRITE, false, false, false, false, false, true, true, true, false, false, false);
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_LAYERB, false, false, false, false, false, true, true, true, false, false, true);
+		//A high priority sprite is above high priority layers.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_SPRITE, false, false, false, false, false, true, true, true, true, true, true);
+		//Layer A is above layer B at equal priority.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_LAYERA, false, false, false, false, false, false, true, true, false, true, true);
+		//In shadow/highlight mode, a pixel with all layers at low priority is shadowed.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_LAYERA, true, false, true, false, false, false, true, true, false, false, false);
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_SPRITE, true, false, true, false, false, true, true, true, false, false, false);
+		//A high priority layer A pixel is not shadowed.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_LAYERA, false, false, true, false, false, false, true, true, false, true, false);
+		//A high priority shadow operator sprite shadows a high priority layer below it.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_LAYERB, true, false, true, true, false, true, false, true, true, false, true);
+		//A high priority highlight operator sprite highlights a high priority layer below it.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_LAYERA, false, true, true, false, true, true, true, false, true, true, false);
+		//A low priority shadow operator sprite is ignored by a high priority layer above it.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_LAYERA, false, false, true, true, false, true, true, false, false, true, false);
+		//A highlight operator over low priority layers cancels out the shadow, leaving
+		//the layer at normal intensity.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_LAYERB, false, false, true, false, true, true, false, true, false, false, false);
+		//A highlight operator over the background with a high priority layer elsewhere
+		//highlights the background.
+		CheckLayerPriorityLookup(layerPriorityLookupTable, S315_5313::LAYERINDEX_BACKGROUND, false, true, true, false, true, true, false, false, false, true, false);
+	}
+
+	SECTION("All combinations", "")
+	{
+		//Step through all 4096 combinations of the shadow/highlight enable state, the sprite
+		//palette line and index, the layer A and B transparency, and the three layer priority
+		//bits. We derive the priority inputs from these values in the same way as the render
+		//process, then ensure the table lookup gives the same layer, shadow, and highlight
+		//result as the branching priority calculation the render process used before the
+		//lookup table was introduced.
+		unsigned int mismatchCount = 0;
+		for(unsigned int combination = 0; combination < 0x1000; ++combination)
+		{
+			bool shadowHighlightEnabled = (combination & 0x800) != 0;
+			unsigned int spritePaletteLine = (combination >> 9) & 0x3;
+			unsigned int spritePaletteIndex = (combination >> 5) & 0xF;
+			bool foundLayerAPixel = (combination & 0x10) != 0;
+			bool foundLayerBPixel = (combination & 0x08) != 0;
+			bool prioritySprite = (combination & 0x04) != 0;
+			bool priorityLayerA = (combination & 0x02) != 0;
+			bool priorityLayerB = (combination & 0x01) != 0;
+			bool foundSpritePixel = (spritePaletteIndex != 0);
+			bool spriteIsShadowOperator = (spritePaletteLine == 3) && (spritePaletteIndex == 15);
+			bool spriteIsHighlightOperator = (spritePaletteLine == 3) && (spritePaletteIndex == 14);
+
+			unsigned int referenceLayerIndex;
+			bool referenceShadow;
+			bool referenceHighlight;
+			ReferenceCalculateLayerPriorityIndex(referenceLayerIndex, referenceShadow, referenceHighlight, shadowHighlightEnabled, spriteIsShadowOperator, spriteIsHighlightOperator, foundSpritePixel, foundLayerAPixel, foundLayerBPixel, prioritySprite, priorityLayerA, priorityLayerB);
+
+			unsigned int priorityIndex = S315_5313::CalculateLayerPriorityLookupIndex(shadowHighlightEnabled, spriteIsShadowOperator, spriteIsHighlightOperator, foundSpritePixel, foundLayerAPixel, foundLayerBPixel, prioritySprite, priorityLayerA, priorityLayerB);
+			unsigned int layerSelectionResult = layerPriorityLookupTable[priorityIndex];
+			unsigned int layerIndex = layerSelectionResult & 0x03;
+			bool shadow = (layerSelectionResult & 0x08) != 0;
+			bool highlight = (layerSelectionResult & 0x04) != 0;
+
+			if((layerIndex != referenceLayerIndex) || (shadow != referenceShadow) || (highlight != referenceHighlight))
+			{
+				++mismatchCount;
+			}
+		}
+		REQUIRE(mismatchCount == 0);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::CalculateVideoFrameRate", "")
+{
+	static const double ntscMasterClockFrequency = 53693175.0;
+	static const double palMasterClockFrequency = 53203424.0;
+	unsigned int frameRateNumerator;
+	unsigned int frameRateDenominator;
+
+	SECTION("NTSC", "")
+	{
+		//An NTSC frame is 262 lines of 3420 mclk ticks, in both H32 and H40 modes. The
+		//ratio must be exact, not just close.
+		S315_5313::CalculateVideoFrameRate(ntscMasterClockFrequency, false, false, false, false, false, frameRateNumerator, frameRateDenominator);
+		REQUIRE(((unsigned long long)frameRateNumerator * (3420 * 262)) == ((unsigned long long)frameRateDenominator * 53693175));
+		REQUIRE(((double)frameRateNumerator / (double)frameRateDenominator) == Approx(59.92).epsilon(0.0001));
+		S315_5313::CalculateVideoFrameRate(ntscMasterClockFrequency, true, true, false, false, false, frameRateNumerator, frameRateDenominator);
+		REQUIRE(((double)frameRateNumerator / (double)frameRateDenominator) == Approx(59.92).epsilon(0.0001));
+	}
+	SECTION("PAL", "")
+	{
+		//A PAL frame is 313 lines of 3420 mclk ticks, in both V28 and V30 modes.
+		S315_5313::CalculateVideoFrameRate(palMasterClockFrequency, false, false, false, true, false, frameRateNumerator, frameRateDenominator);
+		REQUIRE(((unsigned long long)frameRateNumerator * (3420 * 313)) == ((unsigned long long)frameRateDenominator * 53203424));
+		REQUIRE(((double)frameRateNumerator / (double)frameRateDenominator) == Approx(49.70).epsilon(0.0001));
+		S315_5313::CalculateVideoFrameRate(palMasterClockFrequency, true, true, true, true, false, frameRateNumerator, frameRateDenominator);
+		REQUIRE(((double)frameRateNumerator / (double)frameRateDenominator) == Approx(49.70).epsilon(0.0001));
+	}
+	SECTION("Interlace", "")
+	{
+		//In interlace mode, a frame is output for each field, with fields alternating
+		//between 262 and 263 lines on NTSC, and 312 and 313 lines on PAL.
+		S315_5313::CalculateVideoFrameRate(ntscMasterClockFrequency, false, false, false, false, true, frameRateNumerator, frameRateDenominator);
+		REQUIRE(((unsigned long long)frameRateNumerator * (3420 * 525)) == ((unsigned long long)frameRateDenominator * 53693175 * 2));
+		S315_5313::CalculateVideoFrameRate(palMasterClockFrequency, false, false, false, true, true, frameRateNumerator, frameRateDenominator);
+		REQUIRE(((unsigned long long)frameRateNumerator * (3420 * 625)) == ((unsigned long long)frameRateDenominator * 53203424 * 2));
+	}
+	SECTION("Nominal clock", "")
+	{
+		//If the mclk frequency isn't known, the nominal frequency for the mode is used.
+		unsigned int nominalFrameRateNumerator;
+		unsigned int nominalFrameRateDenominator;
+		S315_5313::CalculateVideoFrameRate(palMasterClockFrequency, false, false, false, true, false, nominalFrameRateNumerator, nominalFrameRateDenominator);
+		S315_5313::CalculateVideoFrameRate(0.0, false, false, false, true, false, frameRateNumerator, frameRateDenominator);
+		REQUIRE(frameRateNumerator == nominalFrameRateNumerator);
+		REQUIRE(frameRateDenominator == nominalFrameRateDenominator);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::CalculateAudioCaptureSampleCount", "")
+{
+	//The number of audio samples taken for each frame varies from frame to frame, but the
+	//total must never drift from the exact number of samples for the elapsed time.
+	unsigned int frameRateNumerator;
+	unsigned int frameRateDenominator;
+	S315_5313::CalculateVideoFrameRate(53693175.0, false, false, false, false, false, frameRateNumerator, frameRateDenominator);
+	unsigned long long sampleRemainder = 0;
+	unsigned long long totalSampleCount = 0;
+	unsigned int mismatchCount = 0;
+	for(unsigned int frameNo = 1; frameNo <= 10000; ++frameNo)
+	{
+		totalSampleCount += S315_5313::CalculateAudioCaptureSampleCount(48000, frameRateNumerator, frameRateDenominator, sampleRemainder);
+		unsigned long long expectedSampleCount = ((unsigned long long)48000 * frameRateDenominator * frameNo) / frameRateNumerator;
+		if(totalSampleCount != expectedSampleCount)
+		{
+			++mismatchCount;
+		}
+	}
+	REQUIRE(mismatchCount == 0);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::VideoCaptureThroughput", "")
+{
+	//Run ten seconds of NTSC H40 output through the same conversion and stream writing
+	//path as the capture writer thread, along with the audio from a stereo and a mono
+	//source mixed into a WAV file, and ensure the capture completes faster than real time.
+	static const unsigned int frameCount = 600;
+	static const unsigned int width = 320;
+	static const unsigned int height = 224;
+	static const unsigned int samplesPerSec = 48000;
+	std::wstring videoFilePath = PathCombinePaths(PathGetCurrentWorkingDirectory(), L"VideoCaptureThroughput.y4m");
+	std::wstring audioFilePath = PathCombinePaths(PathGetCurrentWorkingDirectory(), L"VideoCaptureThroughput.wav");
+	Stream::File videoFile;
+	Stream::WAVFile audioFile;
+	REQUIRE(videoFile.Open(videoFilePath, Stream::File::OpenMode::WriteOnly, Stream::File::CreateMode::Create));
+	audioFile.SetDataFormat(2, 16, samplesPerSec);
+	REQUIRE(audioFile.Open(audioFilePath, Stream::WAVFile::OpenMode::WriteOnly, Stream::WAVFile::CreateMode::Create));
+
+	AudioMixer mixer(2, samplesPerSec, samplesPerSec);
+	IAudioSink* stereoInput = mixer.CreateInput();
+	IAudioSink* monoInput = mixer.CreateInput();
+	REQUIRE(stereoInput->Open(2, 16, samplesPerSec));
+	REQUIRE(monoInput->Open(1, 16, samplesPerSec));
+
+	//Build a source frame with a different pattern on each line
+	S315_5313::VideoCaptureFrame frame;
+	frame.lineCount = height;
+	frame.lineWidth.assign(S315_5313::imageBufferHeight, width);
+	frame.pixelData.resize(S315_5313::imageBufferHeight * S315_5313::imageBufferWidth * 4);
+	for(unsigned int i = 0; i < (unsigned int)frame.pixelData.size(); ++i)
+	{
+		frame.pixelData[i] = (unsigned char)((i * 7) + (i / (S315_5313::imageBufferWidth * 4)));
+	}
+	S315_5313::CalculateVideoFrameRate(53693175.0, true, true, false, false, false, frame.frameRateNumerator, frame.frameRateDenominator);
+
+	std::vector<unsigned char> outputBuffer;
+	std::vector<short> sourceSamples(2 * 1024, 0x100);
+	std::vector<short> mixedSamples;
+	unsigned long long sampleRemainder = 0;
+	unsigned long long totalSampleCount = 0;
+	std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+	S315_5313::WriteVideoCaptureStreamHeader(videoFile, width, height, frame.frameRateNumerator, frame.frameRateDenominator);
+	for(unsigned int frameNo = 0; frameNo < frameCount; ++frameNo)
+	{
+		frame.frameNo = frameNo;
+		S315_5313::ConvertVideoCaptureFrame(frame, width, height, outputBuffer);
+		S315_5313::WriteVideoCaptureStreamFrame(videoFile, outputBuffer);
+
+		unsigned int sampleCount = S315_5313::CalculateAudioCaptureSampleCount(samplesPerSec, frame.frameRateNumerator, frame.frameRateDenominator, sampleRemainder);
+		stereoInput->WriteSamples(&sourceSamples[0], sampleCount);
+		monoInput->WriteSamples(&sourceSamples[0], sampleCount);
+		mixedSamples.resize(sampleCount * 2);
+		mixer.ReadMixedSamples(&mixedSamples[0], sampleCount);
+		audioFile.WriteData(&mixedSamples[0], (Stream::WAVFile::SizeType)mixedSamples.size());
+		totalSampleCount += sampleCount;
+	}
+	videoFile.Close();
+	audioFile.Close();
+	std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
+	double captureTimeInSeconds = std::chrono::duration<double>(endTime - startTime).count();
+	double realTimeInSeconds = ((double)frameCount * frame.frameRateDenominator) / frame.frameRateNumerator;
+	std::wcout << L"Captured " << frameCount << L" frames in " << captureTimeInSeconds << L"s (" << (realTimeInSeconds / captureTimeInSeconds) << L"x real time)\n";
+
+	CHECK(mixer.GetUnderrunCount() == 0);
+	CHECK(mixer.GetOverrunCount() == 0);
+	CHECK(totalSampleCount == (((unsigned long long)samplesPerSec * frame.frameRateDenominator * frameCount) / frame.frameRateNumerator));
+	REQUIRE(captureTimeInSeconds < realTimeInSeconds);
+
+	mixer.DeleteInput(stereoInput);
+	mixer.DeleteInput(monoInput);
+	DeleteFile(videoFilePath.c_str());
+	DeleteFile(audioFilePath.c_str());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::ImageBufferPlaneHandoff", "")
+{
+	//Publish frames as fast as possible while several consumers repeatedly pin the latest
+	//completed frame, and ensure no consumer ever sees a plane being drawn into, or a
+	//frame older than one it has already seen.
+	static const unsigned int frameCount = 2000;
+	static const unsigned int consumerCount = 4;
+	ImageBufferHandoffState state(1024);
+	RunImageBufferHandoff(state, frameCount, consumerCount);
+
+	CHECK(state.tornFrameCount == 0);
+	CHECK(state.outOfOrderFrameCount == 0);
+	CHECK(state.acquireCount > 0);
+	REQUIRE(state.planeData[state.completedPlaneNo][0] == frameCount);
+	for(unsigned int i = 0; i < S315_5313::imageBufferPlanes; ++i)
+	{
+		REQUIRE(state.referenceCounts[i] == 0);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::SelectFrameRenderSkip", "")
+{
+	std::atomic<bool> frameRenderRequested(false);
+	unsigned int frameSkipCounter = 0;
+
+	SECTION("Every frame is rendered with an interval of 1", "")
+	{
+		for(unsigned int i = 0; i < 10; ++i)
+		{
+			REQUIRE(!S315_5313::SelectFrameRenderSkip(1, frameRenderRequested, frameSkipCounter, false));
+		}
+	}
+
+	SECTION("Every Nth frame is rendered with an interval of N", "")
+	{
+		unsigned int renderedFrameCount = 0;
+		for(unsigned int i = 1; i <= 12; ++i)
+		{
+			bool skipped = S315_5313::SelectFrameRenderSkip(3, frameRenderRequested, frameSkipCounter, false);
+			REQUIRE(skipped == ((i % 3) != 0));
+			renderedFrameCount += skipped? 0: 1;
+		}
+		REQUIRE(renderedFrameCount == 4);
+	}
+
+	SECTION("Only requested frames are rendered with an interval of 0", "")
+	{
+		REQUIRE(S315_5313::SelectFrameRenderSkip(0, frameRenderRequested, frameSkipCounter, false));
+		frameRenderRequested = true;
+		REQUIRE(!S315_5313::SelectFrameRenderSkip(0, frameRenderRequested, frameSkipCounter, false));
+		REQUIRE(!frameRenderRequested);
+		REQUIRE(S315_5313::SelectFrameRenderSkip(0, frameRenderRequested, frameSkipCounter, false));
+	}
+
+	SECTION("A request renders the next frame and restarts the interval", "")
+	{
+		REQUIRE(S315_5313::SelectFrameRenderSkip(4, frameRenderRequested, frameSkipCounter, false));
+		frameRenderRequested = true;
+		REQUIRE(!S315_5313::SelectFrameRenderSkip(4, frameRenderRequested, frameSkipCounter, false));
+		REQUIRE(frameSkipCounter == 0);
+		REQUIRE(S315_5313::SelectFrameRenderSkip(4, frameRenderRequested, frameSkipCounter, false));
+		REQUIRE(S315_5313::SelectFrameRenderSkip(4, frameRenderRequested, frameSkipCounter, false));
+		REQUIRE(S315_5313::SelectFrameRenderSkip(4, frameRenderRequested, frameSkipCounter, false));
+		REQUIRE(!S315_5313::SelectFrameRenderSkip(4, frameRenderRequested, frameSkipCounter, false));
+	}
+
+	SECTION("A degraded render thread skips frames, but not requested frames", "")
+	{
+		REQUIRE(S315_5313::SelectFrameRenderSkip(1, frameRenderRequested, frameSkipCounter, true));
+		frameRenderRequested = true;
+		REQUIRE(!S315_5313::SelectFrameRenderSkip(1, frameRenderRequested, frameSkipCounter, true));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::SelectFrameRenderSkipConcurrentRequests", "")
+{
+	//Issue render requests from another thread while the render loop only renders
+	//requested frames, and ensure each request renders exactly one frame.
+	static const unsigned int requestCount = 1000;
+	std::atomic<bool> frameRenderRequested(false);
+	std::atomic<bool> requestsComplete(false);
+	unsigned int frameSkipCounter = 0;
+	unsigned int renderedFrameCount = 0;
+	std::thread requestThread(std::bind(FrameRenderRequestThread, std::ref(frameRenderRequested), std::ref(requestsComplete), requestCount));
+	while(!requestsComplete)
+	{
+		if(!S315_5313::SelectFrameRenderSkip(0, frameRenderRequested, frameSkipCounter, false))
+		{
+			++renderedFrameCount;
+		}
+	}
+	requestThread.join();
+	REQUIRE(renderedFrameCount == requestCount);
+	REQUIRE(!frameRenderRequested);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::ReadGenericDataBatch", "")
+{
+	S315_5313 vdp(L"315-5313", L"VDP", 0);
+
+	//Write a distinct value to every register, with mode 5 enabled so that the interpreted
+	//register values below decode through the mode 5 register layout.
+	unsigned int registerValues[IS315_5313::registerCount];
+	for(unsigned int registerNo = 0; registerNo < IS315_5313::registerCount; ++registerNo)
+	{
+		registerValues[registerNo] = ((registerNo * 0x3B) + 0x15) & 0xFF;
+	}
+	registerValues[1] |= 0x04;
+	for(unsigned int registerNo = 0; registerNo < IS315_5313::registerCount; ++registerNo)
+	{
+		IS315_5313::RegisterDataContext registerDataContext(registerNo);
+		GenericAccessDataValueUInt registerValue(registerValues[registerNo]);
+		REQUIRE(vdp.WriteGenericData((unsigned int)IS315_5313::IS315_5313DataSource::RawRegister, &registerDataContext, registerValue));
+	}
+
+	SECTION("Raw registers", "")
+	{
+		//Read every register as a block through a single batch, which reads from a snapshot
+		//of the register buffer, and ensure each value matches an individual read of the
+		//latest register state.
+		GenericAccessDataBlockReader<IS315_5313::RegisterDataContext> registerReader((unsigned int)IS315_5313::IS315_5313DataSource::RawRegister, 0, IS315_5313::registerCount);
+		REQUIRE(registerReader.Read(vdp));
+		REQUIRE(registerReader.GetValueCount() == IS315_5313::registerCount);
+		for(unsigned int registerNo = 0; registerNo < IS315_5313::registerCount; ++registerNo)
+		{
+			IS315_5313::RegisterDataContext registerDataContext(registerNo);
+			GenericAccessDataValueUInt registerValue;
+			REQUIRE(vdp.ReadGenericData((unsigned int)IS315_5313::IS315_5313DataSource::RawRegister, &registerDataContext, registerValue));
+			CHECK(registerValue.GetValue() == registerValues[registerNo]);
+			CHECK(registerReader.GetValue(registerNo) == registerValue.GetValue());
+		}
+	}
+	SECTION("Interpreted registers", "")
+	{
+		//Read a mix of flag and address values decoded from the registers in one batch, and
+		//ensure each result matches an individual read of the same data.
+		static const IS315_5313::IS315_5313DataSource boolDataSources[] = {
+			IS315_5313::IS315_5313DataSource::RegHSI,
+			IS315_5313::IS315_5313DataSource::RegLCB,
+			IS315_5313::IS315_5313DataSource::RegMode5,
+			IS315_5313::IS315_5313DataSource::RegSZ,
+			IS315_5313::IS315_5313DataSource::RegMAG};
+		static const IS315_5313::IS315_5313DataSource uintDataSources[] = {
+			IS315_5313::IS315_5313DataSource::RegNameTableBaseA,
+			IS315_5313::IS315_5313DataSource::RegNameTableBaseWindow,
+			IS315_5313::IS315_5313DataSource::RegNameTableBaseB,
+			IS315_5313::IS315_5313DataSource::RegNameTableBaseSprite,
+			IS315_5313::IS315_5313DataSource::RegHScrollDataBase,
+			IS315_5313::IS315_5313DataSource::RegAutoIncrementData,
+			IS315_5313::IS315_5313DataSource::RegDMASource};
+		static const unsigned int boolDataSourceCount = sizeof(boolDataSources) / sizeof(boolDataSources[0]);
+		static const unsigned int uintDataSourceCount = sizeof(uintDataSources) / sizeof(uintDataSources[0]);
+
+		GenericAccessDataValueBool boolBatchValues[boolDataSourceCount];
+		GenericAccessDataValueUInt uintBatchValues[uintDataSourceCount];
+		std::vector<IGenericAccess::DataReadRequest> requests;
+		for(unsigned int i = 0; i < boolDataSourceCount; ++i)
+		{
+			requests.push_back(IGenericAccess::DataReadRequest((unsigned int)boolDataSources[i], 0, &boolBatchValues[i]));
+		}
+		for(unsigned int i = 0; i < uintDataSourceCount; ++i)
+		{
+			requests.push_back(IGenericAccess::DataReadRequest((unsigned int)uintDataSources[i], 0, &uintBatchValues[i]));
+		}
+		REQUIRE(vdp.ReadGenericDataBatch(&requests[0], (unsigned int)requests.size()));
+
+		for(unsigned int i = 0; i < boolDataSourceCount; ++i)
+		{
+			GenericAccessDataValueBool dataValue;
+			REQUIRE(vdp.ReadGenericData((unsigned int)boolDataSources[i], 0, dataValue));
+			CHECK(requests[i].result);
+			CHECK(boolBatchValues[i].GetValue() == dataValue.GetValue());
+		}
+		for(unsigned int i = 0; i < uintDataSourceCount; ++i)
+		{
+			GenericAccessDataValueUInt dataValue;
+			REQUIRE(vdp.ReadGenericData((unsigned int)uintDataSources[i], 0, dataValue));
+			CHECK(requests[boolDataSourceCount + i].result);
+			CHECK(uintBatchValues[i].GetValue() == dataValue.GetValue());
+		}
+	}
+	SECTION("Snapshot refreshed for each batch", "")
+	{
+		//Change a register between two batches, and ensure the second batch sees the new
+		//value rather than the snapshot captured for the first.
+		GenericAccessDataBlockReader<IS315_5313::RegisterDataContext> registerReader((unsigned int)IS315_5313::IS315_5313DataSource::RawRegister, 0, IS315_5313::registerCount);
+		REQUIRE(registerReader.Read(vdp));
+		CHECK(registerReader.GetValue(7) == registerValues[7]);
+
+		IS315_5313::RegisterDataContext registerDataContext(7);
+		GenericAccessDataValueUInt registerValue(registerValues[7] ^ 0xFF);
+		REQUIRE(vdp.WriteGenericData((unsigned int)IS315_5313::IS315_5313DataSource::RawRegister, &registerDataContext, registerValue));
+		REQUIRE(registerReader.Read(vdp));
+		CHECK(registerReader.GetValue(7) == (registerValues[7] ^ 0xFF));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::SpriteAttributeCache", "")
+{
+	//Fill VRAM with distinct values, and load the first 4 bytes of each entry in the
+	//sprite attribute table into the sprite cache, as the VDP does as the table is written.
+	static const unsigned int spriteCount = 80;
+	static const unsigned int spriteTableEntrySize = 8;
+	static const unsigned int spriteTableBaseAddress = 0xD800;
+	TimedBufferInt vramBuffer;
+	TimedBufferInt spriteCacheBuffer;
+	vramBuffer.Resize(0x10000);
+	spriteCacheBuffer.Resize(IS315_5313::spriteCacheSize);
+	vramBuffer.Initialize();
+	spriteCacheBuffer.Initialize();
+	for(unsigned int address = 0; address < vramBuffer.Size(); ++address)
+	{
+		vramBuffer.ReferenceCommitted(address) = (unsigned char)((address * 0x3B) + (address >> 8));
+	}
+	for(unsigned int spriteCacheAddress = 0; spriteCacheAddress < spriteCacheBuffer.Size(); ++spriteCacheAddress)
+	{
+		unsigned int spriteTableAddress = spriteTableBaseAddress + ((spriteCacheAddress / 4) * spriteTableEntrySize) + (spriteCacheAddress % 4);
+		spriteCacheBuffer.ReferenceCommitted(spriteCacheAddress) = vramBuffer.ReadCommitted(spriteTableAddress);
+	}
+
+	//Decode every sprite once before any writes are made
+	S315_5313::SpriteAttributeCache cache(spriteCount);
+	CheckSpriteAttributeCache(cache, spriteCacheBuffer, vramBuffer, spriteTableBaseAddress, spriteCount);
+	unsigned int initialVRAMGeneration = cache.vramGeneration;
+
+	SECTION("Writes outside the sprite attribute table", "")
+	{
+		//Write to pattern data, to the bytes either side of the table, and to the first 4
+		//bytes of a table entry, which are read from the sprite cache rather than VRAM.
+		//None of these writes change the decoded data, so it should be kept.
+		std::vector<unsigned int> writeAddresses;
+		writeAddresses.push_back(0x0000);
+		writeAddresses.push_back(0x1234);
+		writeAddresses.push_back(spriteTableBaseAddress - 1);
+		writeAddresses.push_back(spriteTableBaseAddress + 3);
+		writeAddresses.push_back(spriteTableBaseAddress + (spriteCount * spriteTableEntrySize));
+		writeAddresses.push_back(0xFFFF);
+		RenderSpritesAcrossVRAMWrites(cache, spriteCacheBuffer, vramBuffer, spriteTableBaseAddress, spriteCount, writeAddresses);
+		CHECK(cache.vramGeneration == initialVRAMGeneration);
+	}
+	SECTION("Writes to the sprite attribute table", "")
+	{
+		//Modify the mapping and position data of sprites at the start, middle, and end of
+		//the table, interleaved with writes elsewhere in VRAM. Each write to the table must
+		//be visible to the next sprite read.
+		std::vector<unsigned int> writeAddresses;
+		writeAddresses.push_back(spriteTableBaseAddress + 4);
+		writeAddresses.push_back(0x2000);
+		writeAddresses.push_back(spriteTableBaseAddress + (40 * spriteTableEntrySize) + 7);
+		writeAddresses.push_back(spriteTableBaseAddress + (40 * spriteTableEntrySize) + 6);
+		writeAddresses.push_back(0x2001);
+		writeAddresses.push_back(spriteTableBaseAddress + ((spriteCount - 1) * spriteTableEntrySize) + 5);
+		RenderSpritesAcrossVRAMWrites(cache, spriteCacheBuffer, vramBuffer, spriteTableBaseAddress, spriteCount, writeAddresses);
+		CHECK(cache.vramGeneration != initialVRAMGeneration);
+	}
+	SECTION("Sprite attribute table moved", "")
+	{
+		//Move the table in a new timeslice, then write to the old table location while
+		//sprites are read from the new one. These writes are outside the range the cache
+		//now depends on, so they're skipped, but when the table is moved back, the
+		//entries decoded from the old location before the writes must not be reused.
+		static const unsigned int movedSpriteTableBaseAddress = 0xF000;
+		S315_5313::InvalidateSpriteAttributeCache(cache, true, true);
+		CheckSpriteAttributeCache(cache, spriteCacheBuffer, vramBuffer, movedSpriteTableBaseAddress, spriteCount);
+		unsigned int movedVRAMGeneration = cache.vramGeneration;
+		std::vector<unsigned int> writeAddresses;
+		writeAddresses.push_back(spriteTableBaseAddress + 4);
+		writeAddresses.push_back(spriteTableBaseAddress + (12 * spriteTableEntrySize) + 6);
+		RenderSpritesAcrossVRAMWrites(cache, spriteCacheBuffer, vramBuffer, movedSpriteTableBaseAddress, spriteCount, writeAddresses);
+		CHECK(cache.vramGeneration == movedVRAMGeneration);
+		CheckSpriteAttributeCache(cache, spriteCacheBuffer, vramBuffer, spriteTableBaseAddress, spriteCount);
+	}
+	SECTION("Sprite cache writes", "")
+	{
+		//Modify the sprite cache, and invalidate the decoded data in the same way as the
+		//digital render process does at an access slot where a sprite cache write is due.
+		spriteCacheBuffer.ReferenceCommitted(0) = 0x12;
+		S315_5313::InvalidateSpriteAttributeCache(cache, true, false);
+		CheckSpriteAttributeCache(cache, spriteCacheBuffer, vramBuffer, spriteTableBaseAddress, spriteCount);
+		CHECK(cache.vramGeneration == initialVRAMGeneration);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Benchmarks
+//----------------------------------------------------------------------------------------
+TEST_CASE("S315_5313::ImageBufferPlaneHandoff benchmark", "[.][benchmark]")
+{
+	//Measure the rate the render thread can publish full H40 frames at while an
+	//increasing number of consumers each pin the latest frame and read through it, as
+	//the image view and screenshot paths do.
+	static const unsigned int frameCount = 2000;
+	static const unsigned int planeSize = 320 * 224;
+	static const unsigned int consumerCounts[] = {0, 1, 2, 4, 8};
+	for(unsigned int i = 0; i < (unsigned int)(sizeof(consumerCounts) / sizeof(consumerCounts[0])); ++i)
+	{
+		ImageBufferHandoffState state(planeSize);
+		double renderTimeInSeconds = RunImageBufferHandoff(state, frameCount, consumerCounts[i]);
+		std::wcout << consumerCounts[i] << L" consumers: " << ((double)frameCount / renderTimeInSeconds) << L" frames/s published, " << ((double)state.acquireCount / renderTimeInSeconds) << L" frames/s acquired\n";
+		CHECK(state.tornFrameCount == 0);
+	}
+}
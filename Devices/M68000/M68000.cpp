@@ -8,7 +8,7 @@ namespace M68000 {
 
 //----------------------------------------------------------------------------------------
 M68000::M68000(const std::wstring& aimplementationName, const std::wstring& ainstanceName, unsigned int amoduleID)
-:Processor(aimplementationName, ainstanceName, amoduleID), opcodeTable(16), opcodeBuffer(0), memoryBus(0)
+:Processor(aimplementationName, ainstanceName, amoduleID), opcodeData(0), opcodeBuffer(0), memoryBus(0)
 {
 	//Set the default state for our device preferences
 	suspendWhenBusReleased = false;
@@ -23,6 +23,7 @@ M68000::M68000(const std::wstring& aimplementationName, const std::wstring& ains
 	ceLineMaskFCCPUSpace = 0;
 	ceLineMaskRMWCycleInProgress = 0;
 	ceLineMaskRMWCycleFirstOperation = 0;
+	BuildCELineStateTable();
 
 	//Initialize our debugger state
 	exceptionListEmpty = true;
@@ -36,12 +37,12 @@ M68000::M68000(const std::wstring& aimplementationName, const std::wstring& ains
 M68000::~M68000()
 {
 	//Delete the opcode buffer
-	delete opcodeBuffer;
+	delete[] (unsigned char*)opcodeBuffer;
 
-	//Delete all objects stored in the opcode list
-	for(std::list<M68000Instruction*>::const_iterator i = opcodeList.begin(); i != opcodeList.end(); ++i)
+	//Release our reference to the shared opcode table
+	if(opcodeData != 0)
 	{
-		delete *i;
+		ReleaseSharedOpcodeData(opcodeData);
 	}
 }
 
@@ -72,148 +73,25 @@ bool M68000::BuildDevice()
 {
 	bool result = Processor::BuildDevice();
 
-	//Initialize our opcode table
-	opcodeTable.InitializeOpcodeTable();
-
-	//Delete all objects stored in the opcode list
-	for(std::list<M68000Instruction*>::const_iterator i = opcodeList.begin(); i != opcodeList.end(); ++i)
+	//Obtain the opcode table. The opcode objects held in the table are immutable once
+	//registered, so a single table is shared between all M68000 instances in the process.
+	if(opcodeData == 0)
 	{
-		delete *i;
+		opcodeData = AcquireSharedOpcodeData();
 	}
-	opcodeList.clear();
-
-	//Add all defined opcodes for this device to the opcode list
-
-	//Arithmetic instructions
-	opcodeList.push_back(new ADD());
-	opcodeList.push_back(new ADDA());
-	opcodeList.push_back(new ADDI());
-	opcodeList.push_back(new ADDQ());
-	opcodeList.push_back(new ADDX());
-	opcodeList.push_back(new CLR());
-	opcodeList.push_back(new CMP());
-	opcodeList.push_back(new CMPA());
-	opcodeList.push_back(new CMPI());
-	opcodeList.push_back(new CMPM());
-	opcodeList.push_back(new DIVS());
-	opcodeList.push_back(new DIVU());
-	opcodeList.push_back(new EXT());
-	opcodeList.push_back(new MULS());
-	opcodeList.push_back(new MULU());
-	opcodeList.push_back(new NEG());
-	opcodeList.push_back(new NEGX());
-	opcodeList.push_back(new NOP());
-	opcodeList.push_back(new SUB());
-	opcodeList.push_back(new SUBA());
-	opcodeList.push_back(new SUBI());
-	opcodeList.push_back(new SUBQ());
-	opcodeList.push_back(new SUBX());
-
-	//BCD instructions
-	opcodeList.push_back(new ABCD());
-	opcodeList.push_back(new NBCD());
-	opcodeList.push_back(new SBCD());
-
-	//Logic instructions
-	opcodeList.push_back(new AND());
-	opcodeList.push_back(new ANDI());
-	opcodeList.push_back(new EOR());
-	opcodeList.push_back(new EORI());
-	opcodeList.push_back(new NOT());
-	opcodeList.push_back(new OR());
-	opcodeList.push_back(new ORI());
-	opcodeList.push_back(new Scc());
-	opcodeList.push_back(new TST());
-
-	//Shift and Rotate instructions
-	opcodeList.push_back(new ASL());
-	opcodeList.push_back(new ASR());
-	opcodeList.push_back(new LSL());
-	opcodeList.push_back(new LSR());
-	opcodeList.push_back(new ROL());
-	opcodeList.push_back(new ROR());
-	opcodeList.push_back(new ROXL());
-	opcodeList.push_back(new ROXR());
-	opcodeList.push_back(new SWAP());
-
-	//Bit Manipulation Instructions
-	opcodeList.push_back(new BCHG());
-	opcodeList.push_back(new BCLR());
-	opcodeList.push_back(new BSET());
-	opcodeList.push_back(new BTST());
-
-	//Data Transfer instructions
-	opcodeList.push_back(new EXG());
-	opcodeList.push_back(new LEA());
-	opcodeList.push_back(new LINK());
-	opcodeList.push_back(new MOVE());
-	opcodeList.push_back(new MOVEA());
-	opcodeList.push_back(new MOVEM());
-	opcodeList.push_back(new MOVEQ());
-	opcodeList.push_back(new MOVEP());
-	opcodeList.push_back(new PEA());
-	opcodeList.push_back(new UNLK());
-
-	//Flow Control instructions
-	opcodeList.push_back(new Bcc());
-	opcodeList.push_back(new BRA());
-	opcodeList.push_back(new BSR());
-	opcodeList.push_back(new DBcc());
-	opcodeList.push_back(new JMP());
-	opcodeList.push_back(new JSR());
-	opcodeList.push_back(new RTR());
-	opcodeList.push_back(new RTS());
-
-	//CCR Related instructions
-	opcodeList.push_back(new ANDI_to_CCR());
-	opcodeList.push_back(new EORI_to_CCR());
-	opcodeList.push_back(new MOVE_to_CCR());
-	opcodeList.push_back(new ORI_to_CCR());
-
-	//Exception instructions
-	opcodeList.push_back(new CHK());
-	opcodeList.push_back(new ILLEGAL());
-	opcodeList.push_back(new TRAP());
-	opcodeList.push_back(new TRAPV());
-
-	//Multiprocessor instructions
-	opcodeList.push_back(new TAS());
-
-	//Privileged instructions
-	opcodeList.push_back(new ANDI_to_SR());
-	opcodeList.push_back(new EORI_to_SR());
-	opcodeList.push_back(new MOVE_from_SR());
-	opcodeList.push_back(new MOVE_to_SR());
-	opcodeList.push_back(new MOVE_USP());
-	opcodeList.push_back(new ORI_to_SR());
-	opcodeList.push_back(new RESET());
-	opcodeList.push_back(new RTE());
-	opcodeList.push_back(new STOP());
-
-	//Register each constructed opcode object in the opcode table, and calculate the size
-	//of the largest opcode object.
-	size_t largestObjectSize = 0;
-	for(std::list<M68000Instruction*>::const_iterator i = opcodeList.begin(); i != opcodeList.end(); ++i)
+	for(std::list<std::wstring>::const_iterator i = opcodeData->failedOpcodeNames.begin(); i != opcodeData->failedOpcodeNames.end(); ++i)
 	{
-		//Register this opcode in the opcode table
-		M68000Instruction* opcodeObject = *i;
-		if(!opcodeObject->RegisterOpcode(opcodeTable))
-		{
-			//Log the event
-			LogEntry logEntry(LogEntry::EventLevel::Critical);
-			logEntry << L"Error registering opcode! Opcode name: " << opcodeObject->GetOpcodeName();
-			GetDeviceContext()->WriteLogEvent(logEntry);
-			result = false;
-		}
-
-		//Update our calculation of the largest opcode size
-		size_t currentOpcodeObjectSize = opcodeObject->GetOpcodeClassByteSize();
-		largestObjectSize = (currentOpcodeObjectSize > largestObjectSize)? currentOpcodeObjectSize: largestObjectSize;
+		//Log the event
+		LogEntry logEntry(LogEntry::EventLevel::Critical);
+		logEntry << L"Error registering opcode! Opcode name: " << *i;
+		GetDeviceContext()->WriteLogEvent(logEntry);
+		result = false;
 	}
 
 	//Allocate a new opcode buffer, which is large enough to hold an instance of the
 	//largest opcode object.
-	opcodeBuffer = (void*)new unsigned char[largestObjectSize];
+	delete[] (unsigned char*)opcodeBuffer;
+	opcodeBuffer = (void*)new unsigned char[opcodeData->largestObjectSize];
 
 	//Register each data source with the generic data access base class
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IM68000DataSource::RegisterSRX, IGenericAccessDataValue::DataType::Bool))->SetHighlightUsed(true));
@@ -271,6 +149,182 @@ bool M68000::BuildDevice()
 	return result;
 }
 
+//----------------------------------------------------------------------------------------
+//Shared opcode table functions
+//----------------------------------------------------------------------------------------
+std::mutex M68000::sharedOpcodeDataMutex;
+M68000::SharedOpcodeData* M68000::sharedOpcodeData = 0;
+
+//----------------------------------------------------------------------------------------
+M68000::SharedOpcodeData* M68000::AcquireSharedOpcodeData()
+{
+	std::unique_lock<std::mutex> lock(sharedOpcodeDataMutex);
+
+	//If the shared opcode table has already been built, add a reference to it and return
+	//it to the caller.
+	if(sharedOpcodeData != 0)
+	{
+		++sharedOpcodeData->referenceCount;
+		return sharedOpcodeData;
+	}
+
+	//Build a new opcode table
+	SharedOpcodeData* newData = new SharedOpcodeData();
+	newData->opcodeTable.InitializeOpcodeTable();
+
+	//Add all defined opcodes for this device to the opcode list
+
+	//Arithmetic instructions
+	newData->opcodeList.push_back(new ADD());
+	newData->opcodeList.push_back(new ADDA());
+	newData->opcodeList.push_back(new ADDI());
+	newData->opcodeList.push_back(new ADDQ());
+	newData->opcodeList.push_back(new ADDX());
+	newData->opcodeList.push_back(new CLR());
+	newData->opcodeList.push_back(new CMP());
+	newData->opcodeList.push_back(new CMPA());
+	newData->opcodeList.push_back(new CMPI());
+	newData->opcodeList.push_back(new CMPM());
+	newData->opcodeList.push_back(new DIVS());
+	newData->opcodeList.push_back(new DIVU());
+	newData->opcodeList.push_back(new EXT());
+	newData->opcodeList.push_back(new MULS());
+	newData->opcodeList.push_back(new MULU());
+	newData->opcodeList.push_back(new NEG());
+	newData->opcodeList.push_back(new NEGX());
+	newData->opcodeList.push_back(new NOP());
+	newData->opcodeList.push_back(new SUB());
+	newData->opcodeList.push_back(new SUBA());
+	newData->opcodeList.push_back(new SUBI());
+	newData->opcodeList.push_back(new SUBQ());
+	newData->opcodeList.push_back(new SUBX());
+
+	//BCD instructions
+	newData->opcodeList.push_back(new ABCD());
+	newData->opcodeList.push_back(new NBCD());
+	newData->opcodeList.push_back(new SBCD());
+
+	//Logic instructions
+	newData->opcodeList.push_back(new AND());
+	newData->opcodeList.push_back(new ANDI());
+	newData->opcodeList.push_back(new EOR());
+	newData->opcodeList.push_back(new EORI());
+	newData->opcodeList.push_back(new NOT());
+	newData->opcodeList.push_back(new OR());
+	newData->opcodeList.push_back(new ORI());
+	newData->opcodeList.push_back(new Scc());
+	newData->opcodeList.push_back(new TST());
+
+	//Shift and Rotate instructions
+	newData->opcodeList.push_back(new ASL());
+	newData->opcodeList.push_back(new ASR());
+	newData->opcodeList.push_back(new LSL());
+	newData->opcodeList.push_back(new LSR());
+	newData->opcodeList.push_back(new ROL());
+	newData->opcodeList.push_back(new ROR());
+	newData->opcodeList.push_back(new ROXL());
+	newData->opcodeList.push_back(new ROXR());
+	newData->opcodeList.push_back(new SWAP());
+
+	//Bit Manipulation Instructions
+	newData->opcodeList.push_back(new BCHG());
+	newData->opcodeList.push_back(new BCLR());
+	newData->opcodeList.push_back(new BSET());
+	newData->opcodeList.push_back(new BTST());
+
+	//Data Transfer instructions
+	newData->opcodeList.push_back(new EXG());
+	newData->opcodeList.push_back(new LEA());
+	newData->opcodeList.push_back(new LINK());
+	newData->opcodeList.push_back(new MOVE());
+	newData->opcodeList.push_back(new MOVEA());
+	newData->opcodeList.push_back(new MOVEM());
+	newData->opcodeList.push_back(new MOVEQ());
+	newData->opcodeList.push_back(new MOVEP());
+	newData->opcodeList.push_back(new PEA());
+	newData->opcodeList.push_back(new UNLK());
+
+	//Flow Control instructions
+	newData->opcodeList.push_back(new Bcc());
+	newData->opcodeList.push_back(new BRA());
+	newData->opcodeList.push_back(new BSR());
+	newData->opcodeList.push_back(new DBcc());
+	newData->opcodeList.push_back(new JMP());
+	newData->opcodeList.push_back(new JSR());
+	newData->opcodeList.push_back(new RTR());
+	newData->opcodeList.push_back(new RTS());
+
+	//CCR Related instructions
+	newData->opcodeList.push_back(new ANDI_to_CCR());
+	newData->opcodeList.push_back(new EORI_to_CCR());
+	newData->opcodeList.push_back(new MOVE_to_CCR());
+	newData->opcodeList.push_back(new ORI_to_CCR());
+
+	//Exception instructions
+	newData->opcodeList.push_back(new CHK());
+	newData->opcodeList.push_back(new ILLEGAL());
+	newData->opcodeList.push_back(new TRAP());
+	newData->opcodeList.push_back(new TRAPV());
+
+	//Multiprocessor instructions
+	newData->opcodeList.push_back(new TAS());
+
+	//Privileged instructions
+	newData->opcodeList.push_back(new ANDI_to_SR());
+	newData->opcodeList.push_back(new EORI_to_SR());
+	newData->opcodeList.push_back(new MOVE_from_SR());
+	newData->opcodeList.push_back(new MOVE_to_SR());
+	newData->opcodeList.push_back(new MOVE_USP());
+	newData->opcodeList.push_back(new ORI_to_SR());
+	newData->opcodeList.push_back(new RESET());
+	newData->opcodeList.push_back(new RTE());
+	newData->opcodeList.push_back(new STOP());
+
+	//Register each constructed opcode object in the opcode table, and calculate the
+	//size of the largest opcode object.
+	for(std::list<M68000Instruction*>::const_iterator i = newData->opcodeList.begin(); i != newData->opcodeList.end(); ++i)
+	{
+		//Register this opcode in the opcode table
+		M68000Instruction* opcodeObject = *i;
+		if(!opcodeObject->RegisterOpcode(newData->opcodeTable))
+		{
+			newData->failedOpcodeNames.push_back(opcodeObject->GetOpcodeName());
+		}
+
+		//Update our calculation of the largest opcode size
+		size_t currentOpcodeObjectSize = opcodeObject->GetOpcodeClassByteSize();
+		newData->largestObjectSize = (currentOpcodeObjectSize > newData->largestObjectSize)? currentOpcodeObjectSize: newData->largestObjectSize;
+	}
+
+	//Record the new opcode table as the shared opcode table
+	newData->referenceCount = 1;
+	sharedOpcodeData = newData;
+	return sharedOpcodeData;
+}
+
+//----------------------------------------------------------------------------------------
+void M68000::ReleaseSharedOpcodeData(SharedOpcodeData* data)
+{
+	std::unique_lock<std::mutex> lock(sharedOpcodeDataMutex);
+
+	//If there are still other references to this opcode table, we're done.
+	if(--data->referenceCount > 0)
+	{
+		return;
+	}
+
+	//Delete all objects stored in the opcode list, and the opcode table itself.
+	for(std::list<M68000Instruction*>::const_iterator i = data->opcodeList.begin(); i != data->opcodeList.end(); ++i)
+	{
+		delete *i;
+	}
+	if(sharedOpcodeData == data)
+	{
+		sharedOpcodeData = 0;
+	}
+	delete data;
+}
+
 //----------------------------------------------------------------------------------------
 bool M68000::ValidateDevice()
 {
@@ -915,7 +969,7 @@ double M68000::ExecuteStep()
 			additionalTime += ReadMemory(GetPC(), opcode, GetFunctionCode(false), GetPC(), false, 0, false, false);
 		}
 		wordIsPrefetched = false;
-		const M68000Instruction* nextOpcodeType = opcodeTable.GetInstruction(opcode.GetData());
+		const M68000Instruction* nextOpcodeType = opcodeData->opcodeTable.GetInstruction(opcode.GetData());
 		if(nextOpcodeType == 0)
 		{
 			//Generate an exception if we've encountered an unimplemented opcode
@@ -1244,7 +1298,7 @@ bool M68000::GetOpcodeInfo(unsigned int location, IOpcodeInfo& opcodeInfo) const
 	ReadMemoryTransparent(instructionLocation, opcode, FunctionCode::SupervisorProgram, false, false);
 
 	const M68000Instruction* targetOpcodeType = 0;
-	targetOpcodeType = opcodeTable.GetInstruction(opcode.GetData());
+	targetOpcodeType = opcodeData->opcodeTable.GetInstruction(opcode.GetData());
 	if(targetOpcodeType != 0)
 	{
 		M68000Instruction* targetOpcode = targetOpcodeType->Clone();
@@ -2315,6 +2369,43 @@ void M68000::SetCELineOutput(unsigned int lineID, bool lineMapped, unsigned int
 		ceLineMaskRMWCycleFirstOperation = !lineMapped? 0: 1 << lineStartBitNumber;
 		break;
 	}
+
+	//Rebuild our CE line state table to reflect the new line mapping
+	BuildCELineStateTable();
+}
+
+//----------------------------------------------------------------------------------------
+void M68000::BuildCELineStateTable()
+{
+	//Since the CE line state we output is purely a function of the access attributes in
+	//the CalculateCELineStateContext structure, we precalculate the CE line state for
+	//every combination of these attributes here, so that only a single table lookup is
+	//required when a bus access is performed.
+	for(unsigned int functionCodeNo = 0; functionCodeNo < 0x8; ++functionCodeNo)
+	{
+		for(unsigned int flags = 0; flags < (ceLineStateTableSize >> 3); ++flags)
+		{
+			FunctionCode functionCode = (FunctionCode)functionCodeNo;
+			bool upperDataStrobe = (flags & 0x01) != 0;
+			bool lowerDataStrobe = (flags & 0x02) != 0;
+			bool readHighWriteLow = (flags & 0x04) != 0;
+			bool rmwCycleInProgress = (flags & 0x08) != 0;
+			bool rmwCycleFirstOperation = (flags & 0x10) != 0;
+
+			unsigned int ceLineState = 0;
+			ceLineState |= upperDataStrobe? ceLineMaskUpperDataStrobe: 0x0;
+			ceLineState |= lowerDataStrobe? ceLineMaskLowerDataStrobe: 0x0;
+			ceLineState |= readHighWriteLow? ceLineMaskReadHighWriteLow: 0x0;
+			ceLineState |= ceLineMaskAddressStrobe;
+			ceLineState |= (functionCodeNo << ceLineBitNumberFunctionCode) & ceLineMaskFunctionCode;
+			ceLineState |= (functionCodeNo == 0x7)? ceLineMaskFCCPUSpace: 0x0;
+			ceLineState |= rmwCycleInProgress? ceLineMaskRMWCycleInProgress: 0x0;
+			ceLineState |= rmwCycleFirstOperation? ceLineMaskRMWCycleFirstOperation: 0x0;
+
+			unsigned int tableIndex = CalculateCELineStateContext::BuildTableIndex(functionCode, upperDataStrobe, lowerDataStrobe, readHighWriteLow, rmwCycleInProgress, rmwCycleFirstOperation);
+			ceLineStateTable[tableIndex] = ceLineState;
+		}
+	}
 }
 
 //----------------------------------------------------------------------------------------
@@ -2323,15 +2414,8 @@ unsigned int M68000::CalculateCELineStateMemory(unsigned int location, const Dat
 	unsigned int ceLineState = 0;
 	if((caller == GetDeviceContext()) && (calculateCELineStateContext != 0))
 	{
-		CalculateCELineStateContext& ceLineStateContext = *((CalculateCELineStateContext*)calculateCELineStateContext);
-		ceLineState |= ceLineStateContext.upperDataStrobe? ceLineMaskUpperDataStrobe: 0x0;
-		ceLineState |= ceLineStateContext.lowerDataStrobe? ceLineMaskLowerDataStrobe: 0x0;
-		ceLineState |= ceLineStateContext.readHighWriteLow? ceLineMaskReadHighWriteLow: 0x0;
-		ceLineState |= ceLineMaskAddressStrobe;
-		ceLineState |= ((unsigned int)ceLineStateContext.functionCode << ceLineBitNumberFunctionCode) & ceLineMaskFunctionCode;
-		ceLineState |= ((unsigned int)ceLineStateContext.functionCode == 0x7)? ceLineMaskFCCPUSpace: 0x0;
-		ceLineState |= ceLineStateContext.rmwCycleInProgress? ceLineMaskRMWCycleInProgress: 0x0;
-		ceLineState |= ceLineStateContext.rmwCycleFirstOperation? ceLineMaskRMWCycleFirstOperation: 0x0;
+		const CalculateCELineStateContext& ceLineStateContext = *((const CalculateCELineStateContext*)calculateCELineStateContext);
+		ceLineState = ceLineStateTable[ceLineStateContext.ceLineStateTableIndex];
 	}
 	return ceLineState;
 }
@@ -2379,7 +2463,7 @@ bool M68000::FormatOpcodeForDisassembly(unsigned int opcodeAddress, const LabelS
 	ReadMemoryTransparent(opcodeAddress, opcode, FunctionCode::SupervisorProgram, false, false);
 
 	const M68000Instruction* targetOpcodeType = 0;
-	targetOpcodeType = opcodeTable.GetInstruction(opcode.GetData());
+	targetOpcodeType = opcodeData->opcodeTable.GetInstruction(opcode.GetData());
 	if(targetOpcodeType == 0)
 	{
 		return false;
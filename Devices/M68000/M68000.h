@@ -78,6 +78,9 @@ public:
 	enum class FunctionCode;
 	enum class State;
 
+	//Structures
+	struct SharedOpcodeData;
+
 public:
 	//Constructors
 	M68000(const std::wstring& aimplementationName, const std::wstring& ainstanceName, unsigned int amoduleID);
@@ -277,6 +280,11 @@ private:
 	//Structures
 	struct LineAccess;
 	struct CalculateCELineStateContext;
+
+	//Constants
+	static const unsigned int ceLineStateTableSize = 1 << 8;
+
+	//Structures
 	struct RegisterDisassemblyInfo
 	{
 		RegisterDisassemblyInfo()
@@ -291,20 +299,29 @@ private:
 	};
 
 private:
+	//CE line state functions
+	void BuildCELineStateTable();
+
 	//Line functions
 	void ApplyLineStateChange(LineID targetLine, const Data& lineData, std::unique_lock<std::mutex>& lock);
 
 	//Clock source functions
 	void ApplyClockStateChange(ClockID targetClock, double clockRate);
 
+private:
+	//Shared opcode table functions
+	static SharedOpcodeData* AcquireSharedOpcodeData();
+	static void ReleaseSharedOpcodeData(SharedOpcodeData* data);
+
 private:
 	//Bus interface
 	mutable ReadWriteLock externalReferenceLock;
 	IBusInterface* memoryBus;
 
 	//Opcode decode table
-	std::list<M68000Instruction*> opcodeList;
-	OpcodeTable<M68000Instruction> opcodeTable;
+	SharedOpcodeData* opcodeData;
+	static std::mutex sharedOpcodeDataMutex;
+	static SharedOpcodeData* sharedOpcodeData;
 
 	//Opcode allocation buffer for placement new
 	void* opcodeBuffer;
@@ -401,6 +418,7 @@ private:
 	unsigned int ceLineMaskFCCPUSpace;
 	unsigned int ceLineMaskRMWCycleInProgress;
 	unsigned int ceLineMaskRMWCycleFirstOperation;
+	unsigned int ceLineStateTable[ceLineStateTableSize];
 
 	//Line access
 	std::mutex lineMutex;
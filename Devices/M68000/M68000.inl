@@ -30,6 +30,22 @@ enum class M68000::State
 	Halted    = 3
 };
 
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+struct M68000::SharedOpcodeData
+{
+	SharedOpcodeData()
+	:opcodeTable(16), largestObjectSize(0), referenceCount(0)
+	{}
+
+	std::list<M68000Instruction*> opcodeList;
+	OpcodeTable<M68000Instruction> opcodeTable;
+	std::list<std::wstring> failedOpcodeNames;
+	size_t largestObjectSize;
+	unsigned int referenceCount;
+};
+
 //----------------------------------------------------------------------------------------
 enum class M68000::CELineID
 {
@@ -106,7 +122,16 @@ struct M68000::CalculateCELineStateContext
 {
 	CalculateCELineStateContext(FunctionCode afunctionCode, bool aupperDataStrobe, bool alowerDataStrobe, bool areadHighWriteLow, bool armwCycleInProgress, bool armwCycleFirstOperation)
 	:functionCode(afunctionCode), upperDataStrobe(aupperDataStrobe), lowerDataStrobe(alowerDataStrobe), readHighWriteLow(areadHighWriteLow), rmwCycleInProgress(armwCycleInProgress), rmwCycleFirstOperation(armwCycleFirstOperation)
-	{}
+	{
+		ceLineStateTableIndex = BuildTableIndex(afunctionCode, aupperDataStrobe, alowerDataStrobe, areadHighWriteLow, armwCycleInProgress, armwCycleFirstOperation);
+	}
+
+	//Packs the access attributes into an index into the CE line state table. The
+	//function code occupies the lower 3 bits, with each flag in a single bit above it.
+	static unsigned int BuildTableIndex(FunctionCode afunctionCode, bool aupperDataStrobe, bool alowerDataStrobe, bool areadHighWriteLow, bool armwCycleInProgress, bool armwCycleFirstOperation)
+	{
+		return ((unsigned int)afunctionCode & 0x7) | (aupperDataStrobe? 0x08: 0x0) | (alowerDataStrobe? 0x10: 0x0) | (areadHighWriteLow? 0x20: 0x0) | (armwCycleInProgress? 0x40: 0x0) | (armwCycleFirstOperation? 0x80: 0x0);
+	}
 
 	FunctionCode functionCode;
 	bool upperDataStrobe;
@@ -114,6 +139,7 @@ struct M68000::CalculateCELineStateContext
 	bool readHighWriteLow;
 	bool rmwCycleInProgress;
 	bool rmwCycleFirstOperation;
+	unsigned int ceLineStateTableIndex;
 };
 
 //----------------------------------------------------------------------------------------
@@ -10,7 +10,8 @@ MDBusArbiter::MDBusArbiter(const std::wstring& aimplementationName, const std::w
 z80BankswitchDataCurrent(9),
 bz80BankswitchDataCurrent(9),
 z80BankswitchDataNew(9),
-bz80BankswitchDataNew(9)
+bz80BankswitchDataNew(9),
+bankWindowCache(bankWindowCacheSize)
 {
 	bootROM = 0;
 	m68kMemoryBus = 0;
@@ -33,6 +34,7 @@ bz80BankswitchDataNew(9)
 	ceLineMaskNOE = 0;
 	ceLineMaskZRAM = 0;
 	ceLineMaskSOUND = 0;
+	BuildCELineM68KLookupTables();
 }
 
 //----------------------------------------------------------------------------------------
@@ -64,6 +66,7 @@ void MDBusArbiter::Initialize()
 	z80BankswitchBitsWritten = 0;
 	z80BankswitchDataCurrent = 0;
 	z80BankswitchDataNew = 0;
+	bankWindowCache.assign(bankWindowCacheSize, BankWindowCacheEntry());
 
 	//Initialize the external line state
 	cartInLineState = false;
@@ -83,6 +86,9 @@ void MDBusArbiter::Initialize()
 	z80BusResetLineStateChangeTimeLatchEnable = false;
 	m68kBusRequestLineStateChangeTimeLatchEnable = false;
 	m68kBusGrantLineStateChangeTimeLatchEnable = false;
+
+	//Notify the M68000 bus that our CE line generation state has been reset
+	NotifyM68kCELineStateChanged();
 }
 
 //----------------------------------------------------------------------------------------
@@ -171,6 +177,9 @@ void MDBusArbiter::ExecuteRollback()
 	haltLineState = bhaltLineState;
 	sresLineState = bsresLineState;
 	wresLineState = bwresLineState;
+
+	//Notify the M68000 bus that our CE line generation state may have been reverted
+	NotifyM68kCELineStateChanged();
 }
 
 //----------------------------------------------------------------------------------------
@@ -354,7 +363,7 @@ IBusInterface::AccessResult MDBusArbiter::ReadInterface(unsigned int interfaceNu
 		Data m68kBusData(16);
 		double m68kBusAccessExecutionTime = 0.0;
 		IBusInterface::AccessResult m68kBusAccessResult(true);
-		if(!ReadZ80ToM68000(m68kMemoryAccessLocation, m68kBusData, caller, accessTime, accessContext, m68kBusAccessResult, m68kBusAccessExecutionTime))
+		if(!ReadZ80ToM68000(m68kMemoryAccessLocation, m68kBusData, caller, accessTime, accessContext, m68kBusAccessResult, m68kBusAccessExecutionTime, 0))
 		{
 			//##TODO## Trigger an assert
 			std::wcout << "-ReadZ80ToM68000 failed! " << location << '\t' << data.GetData() << '\n';
@@ -382,16 +391,24 @@ IBusInterface::AccessResult MDBusArbiter::ReadInterface(unsigned int interfaceNu
 	case MemoryInterface::Z80ToM68kMemoryWindow:{
 		//Calculate the target address in the M68000 memory space
 		std::unique_lock<std::mutex> lock(bankswitchAccessMutex);
-		unsigned int m68kMemoryAccessLocation = (z80BankswitchDataCurrent.GetData() << 15) | (location & 0x7FFF);
+		unsigned int bankswitchData = z80BankswitchDataCurrent.GetData();
 		lock.unlock();
+		unsigned int m68kMemoryAccessLocation = (bankswitchData << 15) | (location & 0x7FFF);
 		bool accessAtOddAddress = (m68kMemoryAccessLocation & 0x1) != 0;
 		m68kMemoryAccessLocation &= ~0x1;
 
+		//Attempt to resolve the current bank window directly to its target device on the
+		//M68000 bus. Sound drivers commonly stream sample data from the cartridge ROM
+		//through this window, so we avoid full CE line generation and address decoding
+		//on the M68000 bus where we can.
+		IBusInterface::MemoryTarget bankWindowTarget;
+		bool bankWindowTargetResolved = GetBankWindowTarget(bankswitchData, caller, bankWindowTarget);
+
 		//Perform the read operation
 		Data m68kBusData(16, 0xFFFF);
 		double m68kBusAccessExecutionTime = 0.0;
 		IBusInterface::AccessResult m68kBusAccessResult(true);
-		if(!ReadZ80ToM68000(m68kMemoryAccessLocation, m68kBusData, caller, accessTime, accessContext, m68kBusAccessResult, m68kBusAccessExecutionTime))
+		if(!ReadZ80ToM68000(m68kMemoryAccessLocation, m68kBusData, caller, accessTime, accessContext, m68kBusAccessResult, m68kBusAccessExecutionTime, (bankWindowTargetResolved? &bankWindowTarget: 0)))
 		{
 			//##TODO## Trigger an assert
 			std::wcout << "-ReadZ80ToM68000 failed! " << location << '\t' << data.GetData() << '\n';
@@ -602,18 +619,20 @@ IBusInterface::AccessResult MDBusArbiter::WriteInterface(unsigned int interfaceN
 		//active, and is cleared when a single mapped data line disables this setting by
 		//writing a value of 1 to it. This needs testing on the hardware.
 		vdpLockoutActive = !data.GetBit(0);
+		NotifyM68kCELineStateChanged();
 		break;
 	case MemoryInterface::TMSSBootROMSwitch:
 		//##TODO## Perform hardware tests to determine exactly which addresses this
 		//register is accessible from.
 		bootROMEnabled = !data.GetBit(0);
+		NotifyM68kCELineStateChanged();
 		break;
 	}
 	return accessResult;
 }
 
 //----------------------------------------------------------------------------------------
-bool MDBusArbiter::ReadZ80ToM68000(unsigned int m68kMemoryAccessLocation, Data& m68kBusData, IDeviceContext* caller, double accessTime, unsigned int accessContext, IBusInterface::AccessResult& m68kBusAccessResult, double& executionTime)
+bool MDBusArbiter::ReadZ80ToM68000(unsigned int m68kMemoryAccessLocation, Data& m68kBusData, IDeviceContext* caller, double accessTime, unsigned int accessContext, IBusInterface::AccessResult& m68kBusAccessResult, double& executionTime, const IBusInterface::MemoryTarget* cachedTarget)
 {
 	std::unique_lock<std::mutex> lock(lineMutex);
 
@@ -693,8 +712,18 @@ bool MDBusArbiter::ReadZ80ToM68000(unsigned int m68kMemoryAccessLocation, Data&
 	//Release lineMutex, now that we've finished working with the current line state.
 	lock.unlock();
 
-	//5. Perform the operation
-	m68kBusAccessResult = m68kMemoryBus->ReadMemory(m68kMemoryAccessLocation, m68kBusData, caller, accessTimeCurrent, accessContext);
+	//5. Perform the operation. If the target of this access has already been resolved,
+	//we pass the access directly to the target device. Note that the bus request and
+	//grant sequence above still applies in this case, so the timing of the operation is
+	//unaffected.
+	if(cachedTarget != 0)
+	{
+		m68kBusAccessResult = cachedTarget->device->ReadInterface(cachedTarget->interfaceNumber, cachedTarget->GetInterfaceOffset(m68kMemoryAccessLocation), m68kBusData, caller, accessTimeCurrent, accessContext);
+	}
+	else
+	{
+		m68kBusAccessResult = m68kMemoryBus->ReadMemory(m68kMemoryAccessLocation, m68kBusData, caller, accessTimeCurrent, accessContext);
+	}
 	accessTimeCurrent += m68kBusAccessResult.executionTime;
 
 	//6. Negate BR
@@ -800,6 +829,77 @@ bool MDBusArbiter::WriteZ80ToM68000(unsigned int m68kMemoryAccessLocation, const
 	return true;
 }
 
+//----------------------------------------------------------------------------------------
+//Z80 to M68K bank window functions
+//----------------------------------------------------------------------------------------
+bool MDBusArbiter::GetBankWindowTarget(unsigned int bankswitchData, IDeviceContext* caller, IBusInterface::MemoryTarget& target)
+{
+	//We only cache targets for banks which fall within the cartridge and boot ROM
+	//regions of the M68000 memory map. The CE line state we generate is constant across
+	//any single bank in this region, and we have no side effects from CE line generation
+	//here, unlike the VDP region for example where TMSS lockout can be triggered.
+	if(bankswitchData >= bankWindowCacheableBankCount)
+	{
+		return false;
+	}
+
+	//Look for an existing cache entry for this bank. Note that since the CE line state
+	//in this region depends on the cartridge, boot ROM enable, and boot ROM activation
+	//state, we record that state with each entry, and only use an entry when it matches
+	//the current state. This saves us explicitly invalidating the cache on rollback or
+	//savestate load.
+	unsigned int ceStateKey = GetBankWindowCEStateKey();
+	unsigned int mappingChangeCount = m68kMemoryBus->GetMemoryMappingChangeCount();
+	std::unique_lock<std::mutex> lock(bankswitchAccessMutex);
+	const BankWindowCacheEntry& existingEntry = bankWindowCache[bankswitchData];
+	if(existingEntry.populated && (existingEntry.ceStateKey == ceStateKey) && (existingEntry.target.mappingChangeCount == mappingChangeCount))
+	{
+		target = existingEntry.target;
+		return existingEntry.targetResolved;
+	}
+	lock.unlock();
+
+	//Attempt to resolve the bank window to a single target on the M68000 bus
+	BankWindowCacheEntry newEntry;
+	newEntry.populated = true;
+	newEntry.ceStateKey = ceStateKey;
+	newEntry.targetResolved = m68kMemoryBus->ResolveMemoryTarget(bankswitchData << 15, 0x8000, caller, newEntry.target);
+	if(!newEntry.targetResolved)
+	{
+		newEntry.target.mappingChangeCount = mappingChangeCount;
+	}
+
+	//Store the new entry in the cache, and return the result to the caller.
+	lock.lock();
+	bankWindowCache[bankswitchData] = newEntry;
+	lock.unlock();
+	target = newEntry.target;
+	return newEntry.targetResolved;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int MDBusArbiter::GetBankWindowCEStateKey()
+{
+	//Note that the cartridge and boot ROM activation state is modified under lineMutex
+	//as line state changes are applied, so we need to take the same lock here to obtain
+	//a consistent snapshot of the state.
+	std::unique_lock<std::mutex> lock(lineMutex);
+	return ((unsigned int)cartInLineState << 2) | ((unsigned int)bootROMEnabled << 1) | (unsigned int)activateBootROM;
+}
+
+//----------------------------------------------------------------------------------------
+void MDBusArbiter::NotifyM68kCELineStateChanged()
+{
+	//Memory targets resolved on the M68000 bus, such as the DMA source window of the
+	//VDP, depend on the CE line state we generate for the target region. We notify the
+	//bus whenever the cartridge, boot ROM, or TMSS state which feeds into our CE line
+	//generation is modified, so that any such resolved targets are discarded.
+	if(m68kMemoryBus != 0)
+	{
+		m68kMemoryBus->NotifyCELineStateChanged();
+	}
+}
+
 //----------------------------------------------------------------------------------------
 //CE line state functions
 //----------------------------------------------------------------------------------------
@@ -934,6 +1034,9 @@ void MDBusArbiter::SetCELineOutput(unsigned int lineID, bool lineMapped, unsigne
 		ceLineMaskSOUND = !lineMapped? 0: 1 << lineStartBitNumber;
 		break;
 	}
+
+	//Rebuild our CE line lookup tables to reflect the new line mapping
+	BuildCELineM68KLookupTables();
 }
 
 //----------------------------------------------------------------------------------------
@@ -969,36 +1072,21 @@ unsigned int MDBusArbiter::BuildCELineM68K(unsigned int targetAddress, bool writ
 	//particular, EOE and NOE can't be asserted, otherwise the RAM would respond to an
 	//interrupt vector request in the Mega Drive, since the RAS0 line would still be
 	//asserted by the VDP, which doesn't know what the FC lines are outputting.
-	//##TODO## Attempt to improve performance of CE line state generation, using a lookup
-	//table containing pre-calculated ceLineState values for every address and input line
-	//combination.
+	//Obtain the CE line state for the address decoded lines from our lookup tables. The
+	//address decoded lines are a function of the target 64KB page alone, except within
+	//the IO region at 0xA10000-0xA1FFFF, where decoding is performed to a 256 byte
+	//granularity. See BuildCELineM68KLookupTables for the decoding logic itself.
+	unsigned int tableVariant = (cartInLineAsserted? 0x2: 0x0) | ((bootROMEnabled && activateBootROM)? 0x1: 0x0);
+	unsigned int pageNo = (targetAddress >> 16) & (ceLineTableM68KPageCount - 1);
+	unsigned int ceLineState = ceLineTableM68K[tableVariant][pageNo];
+	if(pageNo == ceLineTableM68KIOPageNo)
+	{
+		ceLineState |= ceLineTableM68KIOPage[write? 1: 0][(targetAddress >> 8) & (ceLineTableM68KPageCount - 1)];
+	}
 
-	//Calculate the state of all the various CE lines
-	bool lineBootROM = cartInLineAsserted && bootROMEnabled && activateBootROM && (targetAddress <= 0x3FFFFF);
-	bool lineCE0 = cartInLineAsserted? !lineBootROM && (targetAddress <= 0x3FFFFF): (targetAddress >= 0x400000) && (targetAddress <= 0x7FFFFF);
-	bool lineROM = !cartInLineAsserted? (targetAddress <= 0x1FFFFF): (targetAddress >= 0x400000) && (targetAddress <= 0x5FFFFF);
-	bool lineASEL = !lineBootROM && (targetAddress <= 0x7FFFFF);
-	bool lineFDC = (targetAddress >= 0xA12000) && (targetAddress <= 0xA120FF);
-	bool lineFDWR = write && lineFDC;
-	bool lineTIME = (targetAddress >= 0xA13000) && (targetAddress <= 0xA130FF);
-	bool lineIO = (targetAddress >= 0xA10000) && (targetAddress <= 0xA100FF);
+	//Calculate the state of the CE lines which are derived from our input lines
 	bool lineEOE = ceLineOE0 && ceLineUDS;
 	bool lineNOE = ceLineOE0 && ceLineLDS;
-
-	//##TODO## Confirm the mapping of CAS2 and RAS2, and implement them here.
-	//bool lineCAS2 = (targetAddress <= 0x7FFFFF);
-	//bool lineRAS2 = (targetAddress >= 0xE00000) && (targetAddress <= 0xFFFFFF);
-
-	//Build the actual CE line state based on the asserted CE lines
-	unsigned int ceLineState = 0;
-	ceLineState |= lineCE0? ceLineMaskCE0: 0x0;
-	ceLineState |= lineBootROM? ceLineMaskBootROM: 0x0;
-	ceLineState |= lineROM? ceLineMaskROM: 0x0;
-	ceLineState |= lineASEL? ceLineMaskASEL: 0x0;
-	ceLineState |= lineFDC? ceLineMaskFDC: 0x0;
-	ceLineState |= lineFDWR? ceLineMaskFDWR: 0x0;
-	ceLineState |= lineTIME? ceLineMaskTIME: 0x0;
-	ceLineState |= lineIO? ceLineMaskIO: 0x0;
 	ceLineState |= lineEOE? ceLineMaskEOE: 0x0;
 	ceLineState |= lineNOE? ceLineMaskNOE: 0x0;
 
@@ -1017,6 +1105,63 @@ unsigned int MDBusArbiter::BuildCELineM68K(unsigned int targetAddress, bool writ
 	return ceLineState;
 }
 
+//----------------------------------------------------------------------------------------
+void MDBusArbiter::BuildCELineM68KLookupTables()
+{
+	//Build the CE line state for each 64KB page in the M68000 address space, for each
+	//combination of the cartridge and boot ROM state.
+	for(unsigned int tableVariant = 0; tableVariant < ceLineTableM68KVariantCount; ++tableVariant)
+	{
+		bool cartInLineAsserted = (tableVariant & 0x2) != 0;
+		bool bootROMActive = (tableVariant & 0x1) != 0;
+		for(unsigned int pageNo = 0; pageNo < ceLineTableM68KPageCount; ++pageNo)
+		{
+			//Calculate the state of all the various CE lines
+			unsigned int targetAddress = pageNo << 16;
+			bool lineBootROM = cartInLineAsserted && bootROMActive && (targetAddress <= 0x3FFFFF);
+			bool lineCE0 = cartInLineAsserted? !lineBootROM && (targetAddress <= 0x3FFFFF): (targetAddress >= 0x400000) && (targetAddress <= 0x7FFFFF);
+			bool lineROM = !cartInLineAsserted? (targetAddress <= 0x1FFFFF): (targetAddress >= 0x400000) && (targetAddress <= 0x5FFFFF);
+			bool lineASEL = !lineBootROM && (targetAddress <= 0x7FFFFF);
+
+			//##TODO## Confirm the mapping of CAS2 and RAS2, and implement them here.
+			//bool lineCAS2 = (targetAddress <= 0x7FFFFF);
+			//bool lineRAS2 = (targetAddress >= 0xE00000) && (targetAddress <= 0xFFFFFF);
+
+			//Build the actual CE line state based on the asserted CE lines
+			unsigned int ceLineState = 0;
+			ceLineState |= lineCE0? ceLineMaskCE0: 0x0;
+			ceLineState |= lineBootROM? ceLineMaskBootROM: 0x0;
+			ceLineState |= lineROM? ceLineMaskROM: 0x0;
+			ceLineState |= lineASEL? ceLineMaskASEL: 0x0;
+			ceLineTableM68K[tableVariant][pageNo] = ceLineState;
+		}
+	}
+
+	//Build the CE line state for each 256 byte block within the IO region, for both
+	//read and write operations.
+	for(unsigned int writeVariant = 0; writeVariant < 2; ++writeVariant)
+	{
+		bool write = (writeVariant != 0);
+		for(unsigned int blockNo = 0; blockNo < ceLineTableM68KPageCount; ++blockNo)
+		{
+			//Calculate the state of all the various CE lines
+			unsigned int targetAddress = (ceLineTableM68KIOPageNo << 16) | (blockNo << 8);
+			bool lineFDC = (targetAddress >= 0xA12000) && (targetAddress <= 0xA120FF);
+			bool lineFDWR = write && lineFDC;
+			bool lineTIME = (targetAddress >= 0xA13000) && (targetAddress <= 0xA130FF);
+			bool lineIO = (targetAddress >= 0xA10000) && (targetAddress <= 0xA100FF);
+
+			//Build the actual CE line state based on the asserted CE lines
+			unsigned int ceLineState = 0;
+			ceLineState |= lineFDC? ceLineMaskFDC: 0x0;
+			ceLineState |= lineFDWR? ceLineMaskFDWR: 0x0;
+			ceLineState |= lineTIME? ceLineMaskTIME: 0x0;
+			ceLineState |= lineIO? ceLineMaskIO: 0x0;
+			ceLineTableM68KIOPage[writeVariant][blockNo] = ceLineState;
+		}
+	}
+}
+
 //----------------------------------------------------------------------------------------
 unsigned int MDBusArbiter::BuildCELineZ80(unsigned int targetAddress) const
 {
@@ -1197,12 +1342,15 @@ void MDBusArbiter::SetLineState(unsigned int targetLine, const Data& lineData, I
 	{
 	case LineID::CART:
 		cartInLineState = lineData.NonZero();
+		NotifyM68kCELineStateChanged();
 		return;
 	case LineID::ActivateTMSS:
 		activateTMSS = lineData.NonZero();
+		NotifyM68kCELineStateChanged();
 		return;
 	case LineID::ActivateBootROM:
 		activateBootROM = lineData.NonZero();
+		NotifyM68kCELineStateChanged();
 		return;
 	case LineID::WRES:{
 		bool wresLineStateNew = lineData.LSB();
@@ -1593,6 +1741,9 @@ void MDBusArbiter::LoadState(IHierarchicalStorageNode& node)
 			lineAccessPending = !lineAccessBuffer.empty();
 		}
 	}
+
+	//Notify the M68000 bus that our CE line generation state has been replaced
+	NotifyM68kCELineStateChanged();
 }
 
 //----------------------------------------------------------------------------------------
@@ -3,6 +3,7 @@
 #include "DeviceInterface/DeviceInterface.pkg"
 #include "Device/Device.pkg"
 #include <mutex>
+#include <vector>
 
 class MDBusArbiter :public Device
 {
@@ -31,7 +32,7 @@ public:
 	//Memory interface functions
 	virtual IBusInterface::AccessResult ReadInterface(unsigned int interfaceNumber, unsigned int location, Data& data, IDeviceContext* caller, double accessTime, unsigned int accessContext);
 	virtual IBusInterface::AccessResult WriteInterface(unsigned int interfaceNumber, unsigned int location, const Data& data, IDeviceContext* caller, double accessTime, unsigned int accessContext);
-	bool ReadZ80ToM68000(unsigned int m68kMemoryAccessLocation, Data& m68kBusData, IDeviceContext* caller, double accessTime, unsigned int accessContext, IBusInterface::AccessResult& m68kBusAccessResult, double& executionTime);
+	bool ReadZ80ToM68000(unsigned int m68kMemoryAccessLocation, Data& m68kBusData, IDeviceContext* caller, double accessTime, unsigned int accessContext, IBusInterface::AccessResult& m68kBusAccessResult, double& executionTime, const IBusInterface::MemoryTarget* cachedTarget);
 	bool WriteZ80ToM68000(unsigned int m68kMemoryAccessLocation, const Data & m68kBusData, IDeviceContext* caller, double accessTime, unsigned int accessContext, IBusInterface::AccessResult& m68kBusAccessResult, double& executionTime);
 
 	//CE line state functions
@@ -63,11 +64,25 @@ private:
 
 	//Structures
 	struct LineAccess;
+	struct BankWindowCacheEntry;
+
+	//Constants
+	static const unsigned int bankWindowCacheSize = 1 << 9;
+	static const unsigned int bankWindowCacheableBankCount = 1 << 8;
+	static const unsigned int ceLineTableM68KVariantCount = 4;
+	static const unsigned int ceLineTableM68KPageCount = 0x100;
+	static const unsigned int ceLineTableM68KIOPageNo = 0xA1;
 
 private:
+	//Z80 to M68K bank window functions
+	bool GetBankWindowTarget(unsigned int bankswitchData, IDeviceContext* caller, IBusInterface::MemoryTarget& target);
+	unsigned int GetBankWindowCEStateKey();
+	void NotifyM68kCELineStateChanged();
+
 	//CE line state functions
 	unsigned int BuildCELineM68K(unsigned int targetAddress, bool write, bool ceLineUDS, bool ceLineLDS, bool ceLineOE0, bool cartInLineAsserted, IDeviceContext* caller, double accessTime) const;
 	unsigned int BuildCELineZ80(unsigned int targetAddress) const;
+	void BuildCELineM68KLookupTables();
 
 	//Line functions
 	void ApplyLineStateChange(LineID targetLine, const Data& lineData, double accessTime);
@@ -104,6 +119,7 @@ private:
 	Data bz80BankswitchDataNew;
 	unsigned int z80BankswitchBitsWritten;
 	unsigned int bz80BankswitchBitsWritten;
+	std::vector<BankWindowCacheEntry> bankWindowCache;
 
 	//CE line masks
 	unsigned int ceLineMaskReadHighWriteLow;
@@ -123,6 +139,10 @@ private:
 	unsigned int ceLineMaskZRAM;
 	unsigned int ceLineMaskSOUND;
 
+	//CE line lookup tables
+	unsigned int ceLineTableM68K[ceLineTableM68KVariantCount][ceLineTableM68KPageCount];
+	unsigned int ceLineTableM68KIOPage[2][ceLineTableM68KPageCount];
+
 	//Line access
 	std::mutex lineMutex;
 	mutable double lastLineCheckTime;
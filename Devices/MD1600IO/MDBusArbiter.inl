@@ -70,3 +70,16 @@ struct MDBusArbiter::LineAccess
 	Data state;
 	double accessTime;
 };
+
+//----------------------------------------------------------------------------------------
+struct MDBusArbiter::BankWindowCacheEntry
+{
+	BankWindowCacheEntry()
+	:populated(false), targetResolved(false), ceStateKey(0)
+	{}
+
+	bool populated;
+	bool targetResolved;
+	unsigned int ceStateKey;
+	IBusInterface::MemoryTarget target;
+};
@@ -31,6 +31,10 @@ void ROM16::TransparentReadInterface(unsigned int interfaceNumber, unsigned int
 //----------------------------------------------------------------------------------------
 void ROM16::TransparentWriteInterface(unsigned int interfaceNumber, unsigned int location, const Data& data, IDeviceContext* caller, unsigned int accessContext)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	memoryArray[location % memoryArraySize] = (unsigned short)data.GetData();
 }
 
@@ -45,5 +49,9 @@ unsigned int ROM16::ReadMemoryEntry(unsigned int location) const
 //----------------------------------------------------------------------------------------
 void ROM16::WriteMemoryEntry(unsigned int location, unsigned int data)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	memoryArray[location % memoryArraySize] = (unsigned short)data;
 }
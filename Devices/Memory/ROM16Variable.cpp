@@ -62,6 +62,10 @@ void ROM16Variable::TransparentReadInterface(unsigned int interfaceNumber, unsig
 //----------------------------------------------------------------------------------------
 void ROM16Variable::TransparentWriteInterface(unsigned int interfaceNumber, unsigned int location, const Data& data, IDeviceContext* caller, unsigned int accessContext)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	static const unsigned int arrayEntryByteSize = 2;
 	switch(interfaceNumber)
 	{
@@ -110,5 +114,9 @@ unsigned int ROM16Variable::ReadMemoryEntry(unsigned int location) const
 //----------------------------------------------------------------------------------------
 void ROM16Variable::WriteMemoryEntry(unsigned int location, unsigned int data)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	memoryArray[location % memoryArraySize] = (unsigned short)data;
 }
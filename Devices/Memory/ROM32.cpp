@@ -31,6 +31,10 @@ void ROM32::TransparentReadInterface(unsigned int interfaceNumber, unsigned int
 //----------------------------------------------------------------------------------------
 void ROM32::TransparentWriteInterface(unsigned int interfaceNumber, unsigned int location, const Data& data, IDeviceContext* caller, unsigned int accessContext)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	memoryArray[location % memoryArraySize] = (unsigned int)data.GetData();
 }
 
@@ -45,5 +49,9 @@ unsigned int ROM32::ReadMemoryEntry(unsigned int location) const
 //----------------------------------------------------------------------------------------
 void ROM32::WriteMemoryEntry(unsigned int location, unsigned int data)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	memoryArray[location % memoryArraySize] = data;
 }
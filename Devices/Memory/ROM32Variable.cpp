@@ -59,6 +59,10 @@ void ROM32Variable::TransparentReadInterface(unsigned int interfaceNumber, unsig
 //----------------------------------------------------------------------------------------
 void ROM32Variable::TransparentWriteInterface(unsigned int interfaceNumber, unsigned int location, const Data& data, IDeviceContext* caller, unsigned int accessContext)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	static const unsigned int arrayEntryByteSize = 4;
 	switch(interfaceNumber)
 	{
@@ -103,5 +107,9 @@ unsigned int ROM32Variable::ReadMemoryEntry(unsigned int location) const
 //----------------------------------------------------------------------------------------
 void ROM32Variable::WriteMemoryEntry(unsigned int location, unsigned int data)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	memoryArray[location % memoryArraySize] = data;
 }
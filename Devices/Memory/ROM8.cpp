@@ -31,6 +31,10 @@ void ROM8::TransparentReadInterface(unsigned int interfaceNumber, unsigned int l
 //----------------------------------------------------------------------------------------
 void ROM8::TransparentWriteInterface(unsigned int interfaceNumber, unsigned int location, const Data& data, IDeviceContext* caller, unsigned int accessContext)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	memoryArray[location % memoryArraySize] = (unsigned char)data.GetData();
 }
 
@@ -45,5 +49,9 @@ unsigned int ROM8::ReadMemoryEntry(unsigned int location) const
 //----------------------------------------------------------------------------------------
 void ROM8::WriteMemoryEntry(unsigned int location, unsigned int data)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	memoryArray[location % memoryArraySize] = (unsigned char)data;
 }
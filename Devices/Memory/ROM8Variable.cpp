@@ -53,6 +53,10 @@ void ROM8Variable::TransparentReadInterface(unsigned int interfaceNumber, unsign
 //----------------------------------------------------------------------------------------
 void ROM8Variable::TransparentWriteInterface(unsigned int interfaceNumber, unsigned int location, const Data& data, IDeviceContext* caller, unsigned int accessContext)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	static const unsigned int arrayEntryByteSize = 1;
 	switch(interfaceNumber)
 	{
@@ -93,5 +97,9 @@ unsigned int ROM8Variable::ReadMemoryEntry(unsigned int location) const
 //----------------------------------------------------------------------------------------
 void ROM8Variable::WriteMemoryEntry(unsigned int location, unsigned int data)
 {
+	//Since our memory array may be shared with other instances of this ROM, ensure
+	//we have our own copy of the data before modifying it.
+	MakeMemoryArrayUnique();
+
 	memoryArray[location % memoryArraySize] = (unsigned char)data;
 }
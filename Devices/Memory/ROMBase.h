@@ -1,6 +1,8 @@
 #ifndef __ROMBASE_H__
 #define __ROMBASE_H__
 #include "MemoryRead.h"
+#include <map>
+#include <mutex>
 
 template<class T> class ROMBase :public MemoryRead
 {
@@ -15,9 +17,32 @@ public:
 	//Memory size functions
 	virtual unsigned int GetMemoryEntrySizeInBytes() const;
 
+protected:
+	//Shared memory array functions
+	void MakeMemoryArrayUnique();
+
+private:
+	//Structures
+	struct SharedMemoryArray;
+
+	//Typedefs
+	typedef std::multimap<unsigned int, SharedMemoryArray*> SharedMemoryArrayList;
+
+private:
+	//Shared memory array functions
+	void ShareMemoryArray();
+	void ReleaseMemoryArray();
+	static void RemoveSharedMemoryArray(SharedMemoryArray* entry);
+	static unsigned int CalculateMemoryArrayHash(const T* memoryArray, unsigned int memoryArraySize);
+
 protected:
 	unsigned int memoryArraySize;
 	T* memoryArray;
+
+private:
+	SharedMemoryArray* sharedMemoryArray;
+	static std::mutex sharedMemoryArrayMutex;
+	static SharedMemoryArrayList sharedMemoryArrays;
 };
 
 #include "ROMBase.inl"
@@ -1,14 +1,35 @@
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+template<class T> struct ROMBase<T>::SharedMemoryArray
+{
+	SharedMemoryArray(T* amemoryArray, unsigned int amemoryArraySize, unsigned int ahash)
+	:memoryArray(amemoryArray), memoryArraySize(amemoryArraySize), hash(ahash), referenceCount(1)
+	{}
+
+	T* memoryArray;
+	unsigned int memoryArraySize;
+	unsigned int hash;
+	unsigned int referenceCount;
+};
+
+//----------------------------------------------------------------------------------------
+//Static members
+//----------------------------------------------------------------------------------------
+template<class T> std::mutex ROMBase<T>::sharedMemoryArrayMutex;
+template<class T> typename ROMBase<T>::SharedMemoryArrayList ROMBase<T>::sharedMemoryArrays;
+
 //----------------------------------------------------------------------------------------
 //Constructors
 //----------------------------------------------------------------------------------------
 template<class T> ROMBase<T>::ROMBase(const std::wstring& aimplementationName, const std::wstring& ainstanceName, unsigned int amoduleID)
-:MemoryRead(aimplementationName, ainstanceName, amoduleID), memoryArraySize(0), memoryArray(0)
+:MemoryRead(aimplementationName, ainstanceName, amoduleID), memoryArraySize(0), memoryArray(0), sharedMemoryArray(0)
 {}
 
 //----------------------------------------------------------------------------------------
 template<class T> ROMBase<T>::~ROMBase()
 {
-	delete memoryArray;
+	ReleaseMemoryArray();
 }
 
 //----------------------------------------------------------------------------------------
@@ -66,7 +87,7 @@ template<class T> bool ROMBase<T>::Construct(IHierarchicalStorageNode& node)
 
 		//Resize the internal memory array based on the calculated array size, and
 		//initialize all elements to 0.
-		delete memoryArray;
+		ReleaseMemoryArray();
 		memoryArray = new T[memoryArraySize];
 		memset(&memoryArray[0], 0, (memoryArraySize * memoryArrayEntryByteSize));
 
@@ -78,7 +99,13 @@ template<class T> bool ROMBase<T>::Construct(IHierarchicalStorageNode& node)
 			repeatData = repeatDataAttribute->ExtractValue<bool>();
 		}
 
-		//Read in the ROM data
+		//Read in the ROM data. Note that we decode the entire image into our memory array
+		//here rather than mapping the source file and decoding it on demand. By the time
+		//we're constructed, the system has already read the image into the binary data
+		//buffer for our node, possibly after extracting it from an archive, so there's no
+		//file available for us to map, and the read path would need to check whether a
+		//page had been decoded on every access. Duplicate images are instead shared after
+		//they've been decoded, through the ShareMemoryArray function.
 		unsigned int dataStreamByteSize = (unsigned int)dataStream.Size();
 		unsigned int entriesInDataStream = (dataStreamByteSize / memoryArrayEntryByteSize);
 		unsigned int entriesToRead = (memoryArraySize < entriesInDataStream)? memoryArraySize: entriesInDataStream;
@@ -132,11 +159,16 @@ template<class T> bool ROMBase<T>::Construct(IHierarchicalStorageNode& node)
 		{
 			return false;
 		}
-		delete memoryArray;
+		ReleaseMemoryArray();
 		memoryArray = new T[memoryArraySize];
 		memset(&memoryArray[0], 0, (memoryArraySize * memoryArrayEntryByteSize));
 	}
 
+	//Now that our memory array has been fully populated, share it with any other
+	//instances of this ROM which contain identical data. Where the same ROM image is
+	//loaded into multiple systems, this allows a single copy to be retained in memory.
+	ShareMemoryArray();
+
 	return result;
 }
 
@@ -147,3 +179,123 @@ template<class T> unsigned int ROMBase<T>::GetMemoryEntrySizeInBytes() const
 {
 	return sizeof(T);
 }
+
+//----------------------------------------------------------------------------------------
+//Shared memory array functions
+//----------------------------------------------------------------------------------------
+template<class T> void ROMBase<T>::MakeMemoryArrayUnique()
+{
+	//If our memory array isn't shared, abort any further processing.
+	if(sharedMemoryArray == 0)
+	{
+		return;
+	}
+
+	//If other instances are still referencing the shared memory array, take a private
+	//copy of the data, otherwise remove the memory array from the shared list and retain
+	//it as our own. Note that the memory array remains valid for the other instances
+	//until they release it, so there's no need to synchronize their read operations.
+	std::unique_lock<std::mutex> lock(sharedMemoryArrayMutex);
+	if(sharedMemoryArray->referenceCount > 1)
+	{
+		T* memoryArrayCopy = new T[memoryArraySize];
+		memcpy(&memoryArrayCopy[0], &memoryArray[0], (memoryArraySize * sizeof(T)));
+		--sharedMemoryArray->referenceCount;
+		memoryArray = memoryArrayCopy;
+	}
+	else
+	{
+		RemoveSharedMemoryArray(sharedMemoryArray);
+		delete sharedMemoryArray;
+	}
+	sharedMemoryArray = 0;
+}
+
+//----------------------------------------------------------------------------------------
+template<class T> void ROMBase<T>::ShareMemoryArray()
+{
+	//If we have no memory array, or it's already shared, abort any further processing.
+	if((memoryArray == 0) || (sharedMemoryArray != 0))
+	{
+		return;
+	}
+
+	//Search for an existing shared memory array with identical contents to our memory
+	//array. If one is found, discard our memory array and reference the shared one in
+	//its place.
+	unsigned int hash = CalculateMemoryArrayHash(memoryArray, memoryArraySize);
+	std::unique_lock<std::mutex> lock(sharedMemoryArrayMutex);
+	std::pair<typename SharedMemoryArrayList::iterator, typename SharedMemoryArrayList::iterator> sharedMemoryArrayRange = sharedMemoryArrays.equal_range(hash);
+	for(typename SharedMemoryArrayList::iterator i = sharedMemoryArrayRange.first; i != sharedMemoryArrayRange.second; ++i)
+	{
+		SharedMemoryArray* entry = i->second;
+		if((entry->memoryArraySize == memoryArraySize) && (memcmp(&entry->memoryArray[0], &memoryArray[0], (memoryArraySize * sizeof(T))) == 0))
+		{
+			++entry->referenceCount;
+			delete[] memoryArray;
+			memoryArray = entry->memoryArray;
+			sharedMemoryArray = entry;
+			return;
+		}
+	}
+
+	//Since no matching memory array was found, add our memory array to the shared list.
+	sharedMemoryArray = new SharedMemoryArray(memoryArray, memoryArraySize, hash);
+	sharedMemoryArrays.insert(typename SharedMemoryArrayList::value_type(hash, sharedMemoryArray));
+}
+
+//----------------------------------------------------------------------------------------
+template<class T> void ROMBase<T>::ReleaseMemoryArray()
+{
+	//If our memory array isn't shared, we own it, and can delete it directly, otherwise
+	//we remove our reference to the shared memory array, and delete it if we were the
+	//last instance using it.
+	if(sharedMemoryArray == 0)
+	{
+		delete[] memoryArray;
+	}
+	else
+	{
+		std::unique_lock<std::mutex> lock(sharedMemoryArrayMutex);
+		if(--sharedMemoryArray->referenceCount == 0)
+		{
+			RemoveSharedMemoryArray(sharedMemoryArray);
+			delete[] sharedMemoryArray->memoryArray;
+			delete sharedMemoryArray;
+		}
+		sharedMemoryArray = 0;
+	}
+	memoryArray = 0;
+}
+
+//----------------------------------------------------------------------------------------
+template<class T> void ROMBase<T>::RemoveSharedMemoryArray(SharedMemoryArray* entry)
+{
+	std::pair<typename SharedMemoryArrayList::iterator, typename SharedMemoryArrayList::iterator> sharedMemoryArrayRange = sharedMemoryArrays.equal_range(entry->hash);
+	for(typename SharedMemoryArrayList::iterator i = sharedMemoryArrayRange.first; i != sharedMemoryArrayRange.second; ++i)
+	{
+		if(i->second == entry)
+		{
+			sharedMemoryArrays.erase(i);
+			return;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+template<class T> unsigned int ROMBase<T>::CalculateMemoryArrayHash(const T* memoryArray, unsigned int memoryArraySize)
+{
+	//Calculate a 32-bit FNV-1a hash of the memory array contents. This is only used to
+	//quickly rule out non-matching arrays, with a full comparison being performed on any
+	//arrays with a matching hash.
+	static const unsigned int fnvOffsetBasis = 2166136261u;
+	static const unsigned int fnvPrime = 16777619u;
+	const unsigned char* byteArray = (const unsigned char*)memoryArray;
+	unsigned int byteCount = memoryArraySize * (unsigned int)sizeof(T);
+	unsigned int hash = fnvOffsetBasis;
+	for(unsigned int i = 0; i < byteCount; ++i)
+	{
+		hash = (hash ^ byteArray[i]) * fnvPrime;
+	}
+	return hash;
+}
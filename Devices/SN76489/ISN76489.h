@@ -58,6 +58,18 @@ public:
 	inline void SetAudioLoggingOutputPath(const std::wstring& adata);
 	inline std::wstring GetChannelAudioLoggingOutputPath(unsigned int channelNo) const;
 	inline void SetChannelAudioLoggingOutputPath(unsigned int channelNo, const std::wstring& adata);
+
+	//Render thread statistics
+	inline double GetRenderLatency() const;
+	inline double GetRenderDrainRate() const;
+	inline unsigned int GetRenderBlockedCount() const;
+
+	//Audio output functions
+	inline bool IsAudioOutputEnabled() const;
+	inline void SetAudioOutputEnabled(bool adata);
+	inline unsigned int GetAudioOutputQueuedSampleCount() const;
+	inline unsigned int GetAudioOutputOverrunCount() const;
+	inline unsigned int GetAudioOutputUnderrunCount() const;
 };
 
 #include "ISN76489.inl"
@@ -31,7 +31,14 @@ enum class ISN76489::ISN76489DataSource
 	Channel1AudioLoggingPath,
 	Channel2AudioLoggingPath,
 	Channel3AudioLoggingPath,
-	Channel4AudioLoggingPath
+	Channel4AudioLoggingPath,
+	RenderLatency,
+	RenderDrainRate,
+	RenderBlockedCount,
+	AudioOutputEnabled,
+	AudioOutputQueuedSampleCount,
+	AudioOutputOverrunCount,
+	AudioOutputUnderrunCount
 };
 
 //----------------------------------------------------------------------------------------
@@ -266,3 +273,70 @@ void ISN76489::SetChannelAudioLoggingOutputPath(unsigned int channelNo, const st
 	GenericAccessDataValueFilePath data(adata);
 	WriteGenericData((unsigned int)ISN76489DataSource::Channel1AudioLoggingPath + channelNo, 0, data);
 }
+
+//----------------------------------------------------------------------------------------
+//Render thread statistics
+//----------------------------------------------------------------------------------------
+double ISN76489::GetRenderLatency() const
+{
+	GenericAccessDataValueDouble data;
+	ReadGenericData((unsigned int)ISN76489DataSource::RenderLatency, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+double ISN76489::GetRenderDrainRate() const
+{
+	GenericAccessDataValueDouble data;
+	ReadGenericData((unsigned int)ISN76489DataSource::RenderDrainRate, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ISN76489::GetRenderBlockedCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)ISN76489DataSource::RenderBlockedCount, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+//Audio output functions
+//----------------------------------------------------------------------------------------
+bool ISN76489::IsAudioOutputEnabled() const
+{
+	GenericAccessDataValueBool data;
+	ReadGenericData((unsigned int)ISN76489DataSource::AudioOutputEnabled, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void ISN76489::SetAudioOutputEnabled(bool adata)
+{
+	GenericAccessDataValueBool data(adata);
+	WriteGenericData((unsigned int)ISN76489DataSource::AudioOutputEnabled, 0, data);
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ISN76489::GetAudioOutputQueuedSampleCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)ISN76489DataSource::AudioOutputQueuedSampleCount, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ISN76489::GetAudioOutputOverrunCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)ISN76489DataSource::AudioOutputOverrunCount, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ISN76489::GetAudioOutputUnderrunCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)ISN76489DataSource::AudioOutputUnderrunCount, 0, data);
+	return data.GetValue();
+}
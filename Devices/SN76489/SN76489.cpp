@@ -1,6 +1,7 @@
 #include "SN76489.h"
 #include <sstream>
 #include <thread>
+#include <algorithm>
 
 //----------------------------------------------------------------------------------------
 //Constructors
@@ -10,7 +11,8 @@ SN76489::SN76489(const std::wstring& aimplementationName, const std::wstring& ai
 {
 	//Initialize the audio output stream
 	outputSampleRate = 48000;	//44100;
-	outputStream.Open(1, 16, outputSampleRate, outputSampleRate/4, outputSampleRate/20);
+	audioOutputEnabled = true;
+	OpenAudioOutputStream();
 
 	//Initialize the locked register state
 	for(unsigned int i = 0; i < channelCount; ++i)
@@ -21,6 +23,9 @@ SN76489::SN76489(const std::wstring& aimplementationName, const std::wstring& ai
 	noiseChannelTypeLocked = false;
 	noiseChannelPeriodLocked = false;
 
+	//Build the table of output amplitudes for each attenuation register value
+	BuildAttenuationTable(attenuationTable);
+
 	//##TODO## Provide a way for these properties to be defined externally, and provide
 	//debug windows which can modify them on the fly.
 	externalClockRate = 0.0;
@@ -94,6 +99,13 @@ bool SN76489::BuildDevice()
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::Channel2AudioLoggingPath, IGenericAccessDataValue::DataType::FilePath))->SetFilePathExtensionFilter(audioLogExtensionFilter)->SetFilePathDefaultExtension(audioLogDefaultExtension)->SetFilePathCreatingTarget(true));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::Channel3AudioLoggingPath, IGenericAccessDataValue::DataType::FilePath))->SetFilePathExtensionFilter(audioLogExtensionFilter)->SetFilePathDefaultExtension(audioLogDefaultExtension)->SetFilePathCreatingTarget(true));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::Channel4AudioLoggingPath, IGenericAccessDataValue::DataType::FilePath))->SetFilePathExtensionFilter(audioLogExtensionFilter)->SetFilePathDefaultExtension(audioLogDefaultExtension)->SetFilePathCreatingTarget(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::RenderLatency, IGenericAccessDataValue::DataType::Double))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::RenderDrainRate, IGenericAccessDataValue::DataType::Double))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::RenderBlockedCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::AudioOutputEnabled, IGenericAccessDataValue::DataType::Bool)));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::AudioOutputQueuedSampleCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::AudioOutputOverrunCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(ISN76489DataSource::AudioOutputUnderrunCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
 
 	//Save references to the data info structures which contain values that need to have
 	//their limits changed when the bitcount for the shift register is changed.
@@ -150,7 +162,16 @@ bool SN76489::BuildDevice()
 	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::ShiftRegisterBitCount, L"Shift Register Bit Count"))
 	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::ShiftRegisterDefaultValue, L"Shift Register Default Value"))
 	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::WhiteNoiseTappedBitMask, L"White Noise Tapped Bit Mask"))
-	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::PeriodicNoiseTappedBitMask, L"Periodic Noise Tapped Bit Mask")));
+	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::PeriodicNoiseTappedBitMask, L"Periodic Noise Tapped Bit Mask")))
+	              ->AddEntry((new GenericAccessGroup(L"Render Thread"))
+	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::RenderLatency, L"Backlog (ms)"))
+	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::RenderDrainRate, L"Drain Rate"))
+	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::RenderBlockedCount, L"Stall Events")))
+	              ->AddEntry((new GenericAccessGroup(L"Audio Output"))
+	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::AudioOutputEnabled, L"Output Enabled"))
+	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::AudioOutputQueuedSampleCount, L"Queued Samples"))
+	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::AudioOutputOverrunCount, L"Overruns"))
+	                  ->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::AudioOutputUnderrunCount, L"Underruns")));
 	result &= AddGenericAccessPage(parametersPage);
 	GenericAccessPage* audioLoggingPage = new GenericAccessPage(L"Audio Logging", L"Audio Logging");
 	audioLoggingPage->AddEntry(new GenericAccessGroupDataEntry(ISN76489DataSource::AudioLoggingEnabled, L"Log Enabled"))
@@ -281,8 +302,8 @@ void SN76489::TransparentSetClockSourceRate(unsigned int clockInput, double cloc
 void SN76489::BeginExecution()
 {
 	//Initialize the worker thread state
-	pendingRenderOperationCount = 0;
-	renderThreadLagging = false;
+	renderBackpressure.Reset();
+	uncommittedRenderTime = 0;
 	regTimesliceList.clear();
 
 	//Start the render worker thread
@@ -322,6 +343,7 @@ void SN76489::NotifyUpcomingTimeslice(double nanoseconds)
 	//Add references to the new timeslice entry from our timed buffers to the uncommitted
 	//timeslice lists for the buffers
 	regTimesliceListUncommitted.push_back(reg.GetLatestTimeslice());
+	uncommittedRenderTime += nanoseconds;
 }
 
 //----------------------------------------------------------------------------------------
@@ -333,17 +355,10 @@ Device::UpdateMethod SN76489::GetUpdateMethod() const
 //----------------------------------------------------------------------------------------
 void SN76489::ExecuteTimeslice(double nanoseconds)
 {
-	//If the render thread is lagging, pause here until it has caught up, so we don't
-	//leave the render thread behind with an ever-increasing workload it will never be
-	//able to complete.
-	if(renderThreadLagging)
-	{
-		std::unique_lock<std::mutex> lock(timesliceMutex);
-		while(renderThreadLagging)
-		{
-			renderThreadLaggingStateChange.wait(lock);
-		}
-	}
+	//If the render thread has fallen too far behind, pause here until it has caught up,
+	//so we don't leave the render thread behind with an ever-increasing workload it will
+	//never be able to complete.
+	renderBackpressure.WaitWhileBlocked();
 }
 
 //----------------------------------------------------------------------------------------
@@ -356,6 +371,7 @@ void SN76489::ExecuteRollback()
 	latchedVolume = blatchedVolume;
 
 	//Clear any uncommitted timeslices from our render timeslice buffers
+	uncommittedRenderTime = 0;
 	regTimesliceListUncommitted.clear();
 }
 
@@ -376,9 +392,10 @@ void SN76489::ExecuteCommit()
 		//Obtain a timeslice lock so we can update the data we feed to the render thread
 		std::unique_lock<std::mutex> lock(timesliceMutex);
 
-		//Add the number of timeslices we are about to commit to the count of pending
-		//render operations. This is used to track if the render thread is lagging.
-		pendingRenderOperationCount += (unsigned int)regTimesliceListUncommitted.size();
+		//Add the timeslices we are about to commit to the pending work for the render
+		//thread. This is used to track if the render thread is lagging.
+		renderBackpressure.QueueWork((unsigned int)regTimesliceListUncommitted.size(), uncommittedRenderTime);
+		uncommittedRenderTime = 0;
 
 		//Move all timeslices in our uncommitted timeslice lists over to the committed
 		//timeslice lists, for processing by the render thread.
@@ -410,9 +427,7 @@ void SN76489::RenderThread()
 			if(!regTimesliceList.empty())
 			{
 				//Update the lagging state for the render thread
-				--pendingRenderOperationCount;
-				renderThreadLagging = (pendingRenderOperationCount > maxPendingRenderOperationCount);
-				renderThreadLaggingStateChange.notify_all();
+				renderBackpressure.BeginOperation();
 
 				//Grab the next completed timeslice from the timeslice list
 				regTimesliceCopy = *regTimesliceList.begin();
@@ -533,6 +548,13 @@ void SN76489::RenderThread()
 		{
 			unsigned int internalSampleCount = (unsigned int)outputBuffer.size();
 			unsigned int outputSampleCount = (unsigned int)((double)internalSampleCount * ((double)outputSampleRate / outputFrequency));
+			//If audio output has been enabled or disabled since the output stream was
+			//opened, reopen it now. We do this here because the render thread is the only
+			//user of the output stream while it's running.
+			if(audioOutputEnabled != outputStreamOpenedWithOutputEnabled)
+			{
+				OpenAudioOutputStream();
+			}
 			AudioStream::AudioBuffer* outputBufferFinal = outputStream.CreateAudioBuffer(outputSampleCount, 1);
 			if(outputBufferFinal != 0)
 			{
@@ -548,6 +570,9 @@ void SN76489::RenderThread()
 			std::unique_lock<std::mutex> lock(timesliceMutex);
 			reg.AdvancePastTimeslice(regTimesliceCopy);
 		}
+
+		//Record that we've finished rendering this timeslice
+		renderBackpressure.EndOperation();
 	}
 	renderThreadStopped.notify_all();
 }
@@ -555,29 +580,10 @@ void SN76489::RenderThread()
 //----------------------------------------------------------------------------------------
 void SN76489::UpdateChannel(unsigned int channelNo, unsigned int outputSampleCount, std::vector<float>& outputBuffer)
 {
-	ChannelRenderData* renderData = &channelRenderData[channelNo];
-
 	//Read current register data, and calculate half-frequency and amplitude
 	Data volumeRegisterData(GetVolumeRegister(channelNo, AccessTarget().AccessCommitted()));
 	Data toneRegisterData(GetToneRegister(channelNo, AccessTarget().AccessCommitted()));
-	float amplitude = 0.0;
-	if(volumeRegisterData.GetData() < 0xF)
-	{
-		//##NOTE## There is an error in SN76489.txt regarding attenuation. The document
-		//correctly states that each step of the volume register corresponds with 2db of
-		//attenuation (as stated by the SN76489 datasheet), however the math that follows
-		//is erroneous. A decibel is a 10th of a bel(0.1 bels), not 10 bels, and a 2db
-		//drop corresponds to the ratio 10^(-0.2), not 10^(-0.1).
-		//##NOTE## There might be more to this. Remember that we had to divide the
-		//attenuation power in the YM2612 core by 2 to get the correct result. Maybe
-		//Maxim is right afterall, and you have to halve the attenuation power in the
-		//YM2612 core, and this core, in order to get the correct result. Examine the
-		//math he provided and do some more research. Maybe we're wrong about our
-		//conversion from db to linear.
-//		float attenuationInBels = (float)(volumeRegisterData.GetData() * 2) / 10.0f;
-		float attenuationInBels = (float)volumeRegisterData.GetData() / 10.0f;
-		amplitude = pow(10.0f, -attenuationInBels);
-	}
+	float amplitude = attenuationTable[volumeRegisterData.GetData() & ((1 << volumeRegisterBitCount) - 1)];
 
 	//If we're updating the noise register, decode the noise register data.
 	bool whiteNoiseSelected = false;
@@ -610,25 +616,75 @@ void SN76489::UpdateChannel(unsigned int channelNo, unsigned int outputSampleCou
 		}
 	}
 
+	//Render the channel output, passing through the noise shift register state if this
+	//is the noise channel.
+	if(channelNo == noiseChannelNo)
+	{
+		NoiseRenderData noiseRenderData;
+		noiseRenderData.shiftRegister = noiseShiftRegister;
+		noiseRenderData.shiftRegisterBitCount = shiftRegisterBitCount;
+		noiseRenderData.tappedBitMask = whiteNoiseSelected? noiseWhiteTappedBitMask: noisePeriodicTappedBitMask;
+		noiseRenderData.outputMasked = noiseOutputMasked;
+		RenderChannel(channelRenderData[channelNo], &noiseRenderData, amplitude, toneRegisterData.GetData(), outputSampleCount, outputBuffer);
+		noiseShiftRegister = noiseRenderData.shiftRegister;
+		noiseOutputMasked = noiseRenderData.outputMasked;
+	}
+	else
+	{
+		RenderChannel(channelRenderData[channelNo], 0, amplitude, toneRegisterData.GetData(), outputSampleCount, outputBuffer);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void SN76489::BuildAttenuationTable(float (&attenuationTable)[attenuationTableSize])
+{
+	//Build the table of output amplitudes for each attenuation register value. A value
+	//of 0xF in the volume register mutes the channel.
+	//##NOTE## There is an error in SN76489.txt regarding attenuation. The document
+	//correctly states that each step of the volume register corresponds with 2db of
+	//attenuation (as stated by the SN76489 datasheet), however the math that follows
+	//is erroneous. A decibel is a 10th of a bel(0.1 bels), not 10 bels, and a 2db
+	//drop corresponds to the ratio 10^(-0.2), not 10^(-0.1).
+	//##NOTE## There might be more to this. Remember that we had to divide the
+	//attenuation power in the YM2612 core by 2 to get the correct result. Maybe
+	//Maxim is right afterall, and you have to halve the attenuation power in the
+	//YM2612 core, and this core, in order to get the correct result. Examine the
+	//math he provided and do some more research. Maybe we're wrong about our
+	//conversion from db to linear.
+	for(unsigned int i = 0; i < (attenuationTableSize - 1); ++i)
+	{
+//		float attenuationInBels = (float)(i * 2) / 10.0f;
+		float attenuationInBels = (float)i / 10.0f;
+		attenuationTable[i] = pow(10.0f, -attenuationInBels);
+	}
+	attenuationTable[attenuationTableSize - 1] = 0.0f;
+}
+
+//----------------------------------------------------------------------------------------
+void SN76489::RenderChannel(ChannelRenderData& renderData, NoiseRenderData* noiseRenderData, float amplitude, unsigned int toneRegisterValue, unsigned int outputSampleCount, std::vector<float>& outputBuffer)
+{
 	//If we were partway through a cycle on this channel when we rendered the last step,
-	//resume the last cycle.
+	//resume the last cycle. Since the output level is constant for the remainder of the
+	//cycle, we output the remaining samples as a single block.
 	unsigned int samplesWritten = 0;
-	while((renderData->remainingToneCycles > 0) && (samplesWritten < outputSampleCount))
+	if(renderData.remainingToneCycles > 0)
 	{
 		//If we're starting the output on a negative cycle, negate the output data.
-		float writeData = (renderData->polarityNegative)? -amplitude: amplitude;
+		float writeData = (renderData.polarityNegative)? -amplitude: amplitude;
 
 		//If we're updating the noise register, calculate the output data based on
 		//the shift register.
-		if(channelNo == noiseChannelNo)
+		if(noiseRenderData != 0)
 		{
 			//Use the current noise bit to calculate the output data
-			writeData = (noiseOutputMasked)? 0: amplitude;
+			writeData = (noiseRenderData->outputMasked)? 0: amplitude;
 		}
 
-		//Write the sample to the output buffer
-		outputBuffer[samplesWritten++] = writeData;
-		--renderData->remainingToneCycles;
+		//Write the samples to the output buffer
+		unsigned int samplesToWrite = (renderData.remainingToneCycles < outputSampleCount)? renderData.remainingToneCycles: outputSampleCount;
+		std::fill_n(outputBuffer.begin(), samplesToWrite, writeData);
+		samplesWritten += samplesToWrite;
+		renderData.remainingToneCycles -= samplesToWrite;
 	}
 
 	//##NOTE## Hardware tests on the SEGA integrated chip have shown that when the tone
@@ -644,42 +700,37 @@ void SN76489::UpdateChannel(unsigned int channelNo, unsigned int outputSampleCou
 	//that "After Burner II" uses a tone value of 0 in all PSG channels for its audio,
 	//causing distorted sound on the system. The PSG sound emulation for this game is
 	//fundamentally inaccurate when we hold the output at +1.
-	if(toneRegisterData == 0)
+	if(toneRegisterValue == 0)
 	{
-		toneRegisterData = 1;
+		toneRegisterValue = 1;
 	}
 
-	//Output repeating oscillations of the wave at the target frequency and amplitude
+	//Output repeating oscillations of the wave at the target frequency and amplitude.
+	//Each iteration of this loop jumps directly to the next polarity change in the
+	//output, and fills the samples up to that point as a single block.
 	while(samplesWritten < outputSampleCount)
 	{
-		unsigned int samplesToWrite = toneRegisterData.GetData();
+		unsigned int samplesToWrite = toneRegisterValue;
 
 		//Invert the polarity of the wave in preparation for the new cycle
-		renderData->polarityNegative = !renderData->polarityNegative;
+		renderData.polarityNegative = !renderData.polarityNegative;
 
 		//If we're starting the output on a negative cycle, negate the output data.
-		float writeData = (renderData->polarityNegative)? -amplitude: amplitude;
+		float writeData = (renderData.polarityNegative)? -amplitude: amplitude;
 
 		//If we're updating the noise register, calculate the output data based on
 		//the shift register.
-		if(channelNo == noiseChannelNo)
+		if(noiseRenderData != 0)
 		{
-			unsigned int tappedBitMask = whiteNoiseSelected? noiseWhiteTappedBitMask: noisePeriodicTappedBitMask;
-
 			//If the polarity has shifted from -1 to +1, read a new output bit
 			//and adjust the shift register.
-			if(!renderData->polarityNegative)
+			if(!renderData.polarityNegative)
 			{
-				Data shiftRegister(shiftRegisterBitCount, noiseShiftRegister);
-				noiseOutputMasked = !shiftRegister.GetBit(0);
-				bool newUpperBit = !((shiftRegister & tappedBitMask).ParityEven());
-				shiftRegister >>= 1;
-				shiftRegister.SetBit(shiftRegister.GetBitCount() - 1, newUpperBit);
-				noiseShiftRegister = shiftRegister.GetData();
+				AdvanceNoiseShiftRegister(*noiseRenderData);
 			}
 
 			//Use the current noise bit to calculate the output data
-			writeData = (noiseOutputMasked)? 0: amplitude;
+			writeData = (noiseRenderData->outputMasked)? 0: amplitude;
 		}
 
 		if(samplesToWrite > (outputSampleCount - samplesWritten))
@@ -687,16 +738,14 @@ void SN76489::UpdateChannel(unsigned int channelNo, unsigned int outputSampleCou
 			//If we don't have enough samples remaining in this step to complete
 			//the next cycle, clamp the number of samples to write, and save the
 			//number of additional samples we need to complete for the next step.
-			renderData->initialToneCycles = samplesToWrite;
-			renderData->remainingToneCycles = samplesToWrite - (outputSampleCount - samplesWritten);
+			renderData.initialToneCycles = samplesToWrite;
+			renderData.remainingToneCycles = samplesToWrite - (outputSampleCount - samplesWritten);
 			samplesToWrite = (outputSampleCount - samplesWritten);
 		}
 
 		//Write a block of samples to the output buffer
-		for(unsigned int i = 0; i < samplesToWrite; ++i)
-		{
-			outputBuffer[samplesWritten++] = writeData;
-		}
+		std::fill_n(outputBuffer.begin() + samplesWritten, samplesToWrite, writeData);
+		samplesWritten += samplesToWrite;
 	}
 }
 
@@ -1012,6 +1061,20 @@ bool SN76489::ReadGenericData(unsigned int dataID, const DataContext* dataContex
 		return dataValue.SetValue(wavLoggingChannelPath[2]);
 	case ISN76489DataSource::Channel4AudioLoggingPath:
 		return dataValue.SetValue(wavLoggingChannelPath[3]);
+	case ISN76489DataSource::RenderLatency:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().estimatedDrainTimeInNanoseconds / 1000000.0);
+	case ISN76489DataSource::RenderDrainRate:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().drainRate);
+	case ISN76489DataSource::RenderBlockedCount:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().blockedCount);
+	case ISN76489DataSource::AudioOutputEnabled:
+		return dataValue.SetValue(audioOutputEnabled);
+	case ISN76489DataSource::AudioOutputQueuedSampleCount:
+		return dataValue.SetValue(outputStream.GetOutputStatistics().queuedSampleCount);
+	case ISN76489DataSource::AudioOutputOverrunCount:
+		return dataValue.SetValue(outputStream.GetOutputStatistics().overrunCount);
+	case ISN76489DataSource::AudioOutputUnderrunCount:
+		return dataValue.SetValue(outputStream.GetOutputStatistics().underrunCount);
 	}
 	return false;
 }
@@ -1112,6 +1175,9 @@ bool SN76489::WriteGenericData(unsigned int dataID, const DataContext* dataConte
 		case ISN76489DataSource::Channel4AudioLoggingEnabled:
 			SetChannelAudioLoggingEnabled(3, dataValueAsBool.GetValue());
 			return true;
+		case ISN76489DataSource::AudioOutputEnabled:
+			audioOutputEnabled = dataValueAsBool.GetValue();
+			return true;
 		}
 	}
 	else if(dataType == IGenericAccessDataValue::DataType::Double)
@@ -1224,6 +1290,37 @@ bool SN76489::SetGenericDataLocked(unsigned int dataID, const DataContext* dataC
 	return false;
 }
 
+//----------------------------------------------------------------------------------------
+//Audio capture functions
+//----------------------------------------------------------------------------------------
+bool SN76489::SetAudioCaptureSink(IAudioSink* sink)
+{
+	//Open the capture sink with the format of our output stream, then attach it to the
+	//stream, which passes it a copy of every buffer we play from this point on.
+	if((sink != 0) && !sink->Open(1, 16, outputSampleRate))
+	{
+		return false;
+	}
+	outputStream.SetCaptureSink(sink);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+//Audio output functions
+//----------------------------------------------------------------------------------------
+void SN76489::OpenAudioOutputStream()
+{
+	//Open the default audio output device if audio output is enabled. If audio output
+	//has been disabled, or there's no audio output device available on this host, we
+	//send the output to a null sink instead. This keeps the complete audio generation
+	//path running, and allows the system to run unthrottled without an audio device.
+	outputStreamOpenedWithOutputEnabled = audioOutputEnabled;
+	if(!audioOutputEnabled || !outputStream.Open(1, 16, outputSampleRate, outputSampleRate/4, outputSampleRate/20))
+	{
+		outputStream.Open(outputNullSink, 1, 16, outputSampleRate);
+	}
+}
+
 //----------------------------------------------------------------------------------------
 //Audio logging functions
 //----------------------------------------------------------------------------------------
@@ -1235,8 +1332,7 @@ void SN76489::SetAudioLoggingEnabled(bool state)
 		if(state)
 		{
 			double outputFrequency = externalClockRate / externalClockDivider;
-			wavLog.SetDataFormat(1, 16, (unsigned int)outputFrequency);
-			wavLog.Open(wavLoggingPath, Stream::WAVFile::OpenMode::WriteOnly, Stream::WAVFile::CreateMode::Create);
+			wavLog.Open(wavLogWriter, wavLoggingPath, 1, 16, (unsigned int)outputFrequency);
 		}
 		else
 		{
@@ -1255,8 +1351,7 @@ void SN76489::SetChannelAudioLoggingEnabled(unsigned int channelNo, bool state)
 		if(state)
 		{
 			double outputFrequency = externalClockRate / externalClockDivider;
-			wavLogChannel[channelNo].SetDataFormat(1, 16, (unsigned int)outputFrequency);
-			wavLogChannel[channelNo].Open(wavLoggingChannelPath[channelNo], Stream::WAVFile::OpenMode::WriteOnly, Stream::WAVFile::CreateMode::Create);
+			wavLogChannel[channelNo].Open(wavLogWriter, wavLoggingChannelPath[channelNo], 1, 16, (unsigned int)outputFrequency);
 		}
 		else
 		{
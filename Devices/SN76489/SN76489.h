@@ -52,7 +52,7 @@ References:
 #include <mutex>
 #include <condition_variable>
 
-class SN76489 :public Device, public GenericAccessBase<ISN76489>
+class SN76489 :public Device, public GenericAccessBase<ISN76489>, public IAudioCaptureSource
 {
 public:
 	//Constructors
@@ -99,10 +99,10 @@ public:
 	virtual bool GetGenericDataLocked(unsigned int dataID, const DataContext* dataContext) const;
 	virtual bool SetGenericDataLocked(unsigned int dataID, const DataContext* dataContext, bool state);
 
-private:
-	//Enumerations
-	enum class ClockID;
+	//Audio capture functions
+	virtual bool SetAudioCaptureSink(IAudioSink* sink);
 
+public:
 	//Structures
 	struct ChannelRenderData
 	{
@@ -110,6 +110,25 @@ private:
 		unsigned int remainingToneCycles;
 		bool polarityNegative;
 	};
+	struct NoiseRenderData
+	{
+		unsigned int shiftRegister;
+		unsigned int shiftRegisterBitCount;
+		unsigned int tappedBitMask;
+		bool outputMasked;
+	};
+
+	//Constants
+	static const unsigned int attenuationTableSize = 1 << volumeRegisterBitCount;
+
+	//Render functions
+	static void BuildAttenuationTable(float (&attenuationTable)[attenuationTableSize]);
+	static void RenderChannel(ChannelRenderData& renderData, NoiseRenderData* noiseRenderData, float amplitude, unsigned int toneRegisterValue, unsigned int outputSampleCount, std::vector<float>& outputBuffer);
+	static inline void AdvanceNoiseShiftRegister(NoiseRenderData& noiseRenderData);
+
+private:
+	//Enumerations
+	enum class ClockID;
 
 	//Typedefs
 	typedef RandomTimeAccessBuffer<Data, double>::AccessTarget AccessTarget;
@@ -125,6 +144,9 @@ private:
 	inline Data GetToneRegister(unsigned int channelNo, const AccessTarget& accessTarget) const;
 	inline void SetToneRegister(unsigned int channelNo, const Data& adata, const AccessTarget& accessTarget);
 
+	//Audio output functions
+	void OpenAudioOutputStream();
+
 	//Audio logging functions
 	void SetAudioLoggingEnabled(bool state);
 	void SetChannelAudioLoggingEnabled(unsigned int channelNo, bool state);
@@ -145,18 +167,20 @@ private:
 	std::condition_variable renderThreadUpdate;
 	std::condition_variable renderThreadStopped;
 	bool renderThreadActive;
-	static const unsigned int maxPendingRenderOperationCount = 4;
-	bool renderThreadLagging;
-	std::condition_variable renderThreadLaggingStateChange;
-	unsigned int pendingRenderOperationCount;
+	RenderBackpressure renderBackpressure;
+	double uncommittedRenderTime;
 	std::list<RandomTimeAccessBuffer<Data, double>::Timeslice> regTimesliceList;
 	std::list<RandomTimeAccessBuffer<Data, double>::Timeslice> regTimesliceListUncommitted;
 	double remainingRenderTime;
 	unsigned int outputSampleRate;
+	NullAudioSink outputNullSink;
 	AudioStream outputStream;
+	volatile bool audioOutputEnabled;
+	bool outputStreamOpenedWithOutputEnabled;
 	std::vector<short> outputBuffer;
 
 	//Render data
+	float attenuationTable[attenuationTableSize];
 	ChannelRenderData channelRenderData[channelCount];
 	unsigned int noiseShiftRegister;
 	bool noiseOutputMasked;
@@ -182,8 +206,9 @@ private:
 	bool wavLoggingChannelEnabled[channelCount];
 	std::wstring wavLoggingPath;
 	std::wstring wavLoggingChannelPath[channelCount];
-	Stream::WAVFile wavLog;
-	Stream::WAVFile wavLogChannel[channelCount];
+	Stream::WAVFileWriter wavLogWriter;
+	Stream::BufferedWAVFile wavLog;
+	Stream::BufferedWAVFile wavLogChannel[channelCount];
 };
 
 #include "SN76489.inl"
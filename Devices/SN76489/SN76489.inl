@@ -6,6 +6,25 @@ enum class SN76489::ClockID
 	Clock = 1
 };
 
+//----------------------------------------------------------------------------------------
+//Render functions
+//----------------------------------------------------------------------------------------
+void SN76489::AdvanceNoiseShiftRegister(NoiseRenderData& noiseRenderData)
+{
+	//Latch the output bit, then shift the register right by one bit, feeding in the
+	//parity of the tapped bits as the new upper bit. Note that the shift register value
+	//never contains bits above the configured shift register width, so we don't need to
+	//mask the register here.
+	noiseRenderData.outputMasked = (noiseRenderData.shiftRegister & 0x1) == 0;
+	unsigned int tappedBits = noiseRenderData.shiftRegister & noiseRenderData.tappedBitMask;
+	tappedBits ^= tappedBits >> 16;
+	tappedBits ^= tappedBits >> 8;
+	tappedBits ^= tappedBits >> 4;
+	tappedBits ^= tappedBits >> 2;
+	tappedBits ^= tappedBits >> 1;
+	noiseRenderData.shiftRegister = (noiseRenderData.shiftRegister >> 1) | ((tappedBits & 0x1) << (noiseRenderData.shiftRegisterBitCount - 1));
+}
+
 //----------------------------------------------------------------------------------------
 //Raw register functions
 //----------------------------------------------------------------------------------------
@@ -0,0 +1,344 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "SN76489.h"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <cmath>
+
+//----------------------------------------------------------------------------------------
+//Helper structures
+//----------------------------------------------------------------------------------------
+//The render state of a single channel, including the noise shift register state, which
+//is only used when rendering the noise channel.
+struct ChannelState
+{
+	SN76489::ChannelRenderData renderData;
+	SN76489::NoiseRenderData noiseRenderData;
+};
+
+//A single step of register settings for one channel, along with the number of samples to
+//render before the next register change.
+struct ChannelStep
+{
+	unsigned int volumeRegister;
+	unsigned int toneRegisterValue;
+	bool noiseChannel;
+	bool whiteNoiseSelected;
+	unsigned int outputSampleCount;
+};
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+static const unsigned int shiftRegisterBitCount = 16;
+static const unsigned int shiftRegisterDefaultValue = 0x8000;
+static const unsigned int noiseWhiteTappedBitMask = 0x0009;
+static const unsigned int noisePeriodicTappedBitMask = 0x0001;
+
+//----------------------------------------------------------------------------------------
+static ChannelState CreateInitialChannelState()
+{
+	ChannelState state;
+	state.renderData.initialToneCycles = 0;
+	state.renderData.remainingToneCycles = 0;
+	state.renderData.polarityNegative = false;
+	state.noiseRenderData.shiftRegister = shiftRegisterDefaultValue;
+	state.noiseRenderData.shiftRegisterBitCount = shiftRegisterBitCount;
+	state.noiseRenderData.tappedBitMask = noiseWhiteTappedBitMask;
+	state.noiseRenderData.outputMasked = false;
+	return state;
+}
+
+//----------------------------------------------------------------------------------------
+//Renders a channel in the same way as the render process did before block rendering was
+//introduced, with the amplitude calculated on each call, each sample written one at a
+//time, and the noise shift register advanced through a Data object.
+static void ReferenceRenderChannel(ChannelState& state, const ChannelStep& step, std::vector<float>& outputBuffer)
+{
+	float amplitude = 0.0;
+	if(step.volumeRegister < 0xF)
+	{
+		float attenuationInBels = (float)step.volumeRegister / 10.0f;
+		amplitude = pow(10.0f, -attenuationInBels);
+	}
+
+	unsigned int samplesWritten = 0;
+	while((state.renderData.remainingToneCycles > 0) && (samplesWritten < step.outputSampleCount))
+	{
+		float writeData = (state.renderData.polarityNegative)? -amplitude: amplitude;
+		if(step.noiseChannel)
+		{
+			writeData = (state.noiseRenderData.outputMasked)? 0: amplitude;
+		}
+		outputBuffer[samplesWritten++] = writeData;
+		--state.renderData.remainingToneCycles;
+	}
+
+	Data toneRegisterData(SN76489::toneRegisterBitCount, step.toneRegisterValue);
+	if(toneRegisterData == 0)
+	{
+		toneRegisterData = 1;
+	}
+
+	while(samplesWritten < step.outputSampleCount)
+	{
+		unsigned int samplesToWrite = toneRegisterData.GetData();
+		state.renderData.polarityNegative = !state.renderData.polarityNegative;
+		float writeData = (state.renderData.polarityNegative)? -amplitude: amplitude;
+		if(step.noiseChannel)
+		{
+			unsigned int tappedBitMask = step.whiteNoiseSelected? noiseWhiteTappedBitMask: noisePeriodicTappedBitMask;
+			if(!state.renderData.polarityNegative)
+			{
+				Data shiftRegister(shiftRegisterBitCount, state.noiseRenderData.shiftRegister);
+				state.noiseRenderData.outputMasked = !shiftRegister.GetBit(0);
+				bool newUpperBit = !((shiftRegister & tappedBitMask).ParityEven());
+				shiftRegister >>= 1;
+				shiftRegister.SetBit(shiftRegister.GetBitCount() - 1, newUpperBit);
+				state.noiseRenderData.shiftRegister = shiftRegister.GetData();
+			}
+			writeData = (state.noiseRenderData.outputMasked)? 0: amplitude;
+		}
+
+		if(samplesToWrite > (step.outputSampleCount - samplesWritten))
+		{
+			state.renderData.initialToneCycles = samplesToWrite;
+			state.renderData.remainingToneCycles = samplesToWrite - (step.outputSampleCount - samplesWritten);
+			samplesToWrite = (step.outputSampleCount - samplesWritten);
+		}
+
+		for(unsigned int i = 0; i < samplesToWrite; ++i)
+		{
+			outputBuffer[samplesWritten++] = writeData;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Renders a channel through the block render path used by the device
+static void RenderChannel(ChannelState& state, const ChannelStep& step, const float (&attenuationTable)[SN76489::attenuationTableSize], std::vector<float>& outputBuffer)
+{
+	float amplitude = attenuationTable[step.volumeRegister];
+	if(step.noiseChannel)
+	{
+		state.noiseRenderData.tappedBitMask = step.whiteNoiseSelected? noiseWhiteTappedBitMask: noisePeriodicTappedBitMask;
+		SN76489::RenderChannel(state.renderData, &state.noiseRenderData, amplitude, step.toneRegisterValue, step.outputSampleCount, outputBuffer);
+	}
+	else
+	{
+		SN76489::RenderChannel(state.renderData, 0, amplitude, step.toneRegisterValue, step.outputSampleCount, outputBuffer);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Builds a random sequence of register settings for a channel. Tone values are biased
+//towards short periods, so that most steps contain many polarity changes, and a step
+//often ends partway through a cycle which the next step has to resume. Noise steps select
+//their period in the same way as the noise register, including taking it from the
+//channel 2 tone data.
+static std::vector<ChannelStep> BuildChannelTrace(bool noiseChannel, unsigned int stepCount, unsigned int maxSampleCount, unsigned int seed)
+{
+	std::mt19937 generator(seed);
+	std::vector<ChannelStep> trace;
+	for(unsigned int i = 0; i < stepCount; ++i)
+	{
+		ChannelStep step;
+		step.volumeRegister = generator() % SN76489::attenuationTableSize;
+		step.noiseChannel = noiseChannel;
+		step.whiteNoiseSelected = (generator() & 0x1) != 0;
+		step.outputSampleCount = generator() % (maxSampleCount + 1);
+		unsigned int toneRange = ((generator() % 4) == 0)? (1 << SN76489::toneRegisterBitCount): 0x10;
+		step.toneRegisterValue = generator() % toneRange;
+		if(noiseChannel)
+		{
+			static const unsigned int noisePeriods[3] = {0x10, 0x20, 0x40};
+			unsigned int periodSelect = generator() % 4;
+			if(periodSelect < 3)
+			{
+				step.toneRegisterValue = noisePeriods[periodSelect];
+			}
+		}
+		trace.push_back(step);
+	}
+	return trace;
+}
+
+//----------------------------------------------------------------------------------------
+static bool ChannelStatesMatch(const ChannelState& stateA, const ChannelState& stateB, bool noiseChannel)
+{
+	bool renderDataMatches = (stateA.renderData.remainingToneCycles == stateB.renderData.remainingToneCycles) && (stateA.renderData.polarityNegative == stateB.renderData.polarityNegative);
+	bool noiseRenderDataMatches = !noiseChannel || ((stateA.noiseRenderData.shiftRegister == stateB.noiseRenderData.shiftRegister) && (stateA.noiseRenderData.outputMasked == stateB.noiseRenderData.outputMasked));
+	return renderDataMatches && noiseRenderDataMatches;
+}
+
+//----------------------------------------------------------------------------------------
+//Renders a trace through both the reference and the block render paths, and returns the
+//number of steps where the output samples or the channel state differ.
+static unsigned int CompareChannelTrace(const std::vector<ChannelStep>& trace)
+{
+	float attenuationTable[SN76489::attenuationTableSize];
+	SN76489::BuildAttenuationTable(attenuationTable);
+
+	ChannelState referenceState = CreateInitialChannelState();
+	ChannelState state = CreateInitialChannelState();
+	unsigned int mismatchCount = 0;
+	for(unsigned int i = 0; i < (unsigned int)trace.size(); ++i)
+	{
+		const ChannelStep& step = trace[i];
+		std::vector<float> referenceOutput(step.outputSampleCount);
+		std::vector<float> output(step.outputSampleCount);
+		ReferenceRenderChannel(referenceState, step, referenceOutput);
+		RenderChannel(state, step, attenuationTable, output);
+		if((output != referenceOutput) || !ChannelStatesMatch(referenceState, state, step.noiseChannel))
+		{
+			++mismatchCount;
+		}
+	}
+	return mismatchCount;
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("SN76489::BuildAttenuationTable", "")
+{
+	//Ensure the table holds exactly the amplitude the render process used to calculate
+	//for each volume register value.
+	float attenuationTable[SN76489::attenuationTableSize];
+	SN76489::BuildAttenuationTable(attenuationTable);
+	for(unsigned int i = 0; i < SN76489::attenuationTableSize; ++i)
+	{
+		float amplitude = (i < 0xF)? pow(10.0f, -((float)i / 10.0f)): 0.0f;
+		REQUIRE(attenuationTable[i] == amplitude);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("SN76489::AdvanceNoiseShiftRegister", "")
+{
+	//Step the shift register through a full period with both the white and periodic noise
+	//feedback, and ensure each output bit and register value matches the Data based shift
+	//the render process originally used.
+	SECTION("White noise", "")
+	{
+		ChannelState state = CreateInitialChannelState();
+		unsigned int referenceShiftRegister = state.noiseRenderData.shiftRegister;
+		unsigned int mismatchCount = 0;
+		for(unsigned int i = 0; i < 0x10000; ++i)
+		{
+			Data shiftRegister(shiftRegisterBitCount, referenceShiftRegister);
+			bool referenceOutputMasked = !shiftRegister.GetBit(0);
+			bool newUpperBit = !((shiftRegister & noiseWhiteTappedBitMask).ParityEven());
+			shiftRegister >>= 1;
+			shiftRegister.SetBit(shiftRegister.GetBitCount() - 1, newUpperBit);
+			referenceShiftRegister = shiftRegister.GetData();
+
+			SN76489::AdvanceNoiseShiftRegister(state.noiseRenderData);
+			if((state.noiseRenderData.shiftRegister != referenceShiftRegister) || (state.noiseRenderData.outputMasked != referenceOutputMasked))
+			{
+				++mismatchCount;
+			}
+		}
+		REQUIRE(mismatchCount == 0);
+	}
+	SECTION("Periodic noise", "")
+	{
+		ChannelState state = CreateInitialChannelState();
+		state.noiseRenderData.tappedBitMask = noisePeriodicTappedBitMask;
+		for(unsigned int i = 0; i < shiftRegisterBitCount; ++i)
+		{
+			SN76489::AdvanceNoiseShiftRegister(state.noiseRenderData);
+			REQUIRE(state.noiseRenderData.outputMasked == (i != (shiftRegisterBitCount - 1)));
+		}
+		REQUIRE(state.noiseRenderData.shiftRegister == shiftRegisterDefaultValue);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("SN76489::RenderChannel", "")
+{
+	//Render random register traces through both the original per-sample render path and
+	//the block render path, and ensure every output sample is bit-identical, and the
+	//carried over cycle and shift register state match after every step.
+	SECTION("Tone channel", "")
+	{
+		std::vector<ChannelStep> trace = BuildChannelTrace(false, 2000, 256, 1);
+		REQUIRE(CompareChannelTrace(trace) == 0);
+	}
+	SECTION("Noise channel", "")
+	{
+		std::vector<ChannelStep> trace = BuildChannelTrace(true, 2000, 256, 2);
+		REQUIRE(CompareChannelTrace(trace) == 0);
+	}
+	SECTION("Zero length steps", "")
+	{
+		std::vector<ChannelStep> trace = BuildChannelTrace(true, 2000, 1, 3);
+		REQUIRE(CompareChannelTrace(trace) == 0);
+	}
+	SECTION("Frame length steps", "")
+	{
+		std::vector<ChannelStep> trace = BuildChannelTrace(true, 200, 4000, 4);
+		REQUIRE(CompareChannelTrace(trace) == 0);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Benchmarks
+//----------------------------------------------------------------------------------------
+TEST_CASE("SN76489::RenderChannel benchmark", "[.][benchmark]")
+{
+	//Render one second of output for a tone channel and the noise channel, at the internal
+	//sample rate of the PSG on an NTSC system, in steps of one frame each. This is the
+	//same workload the render thread has with no register writes during a frame.
+	static const unsigned int sampleRate = 3579545 / 16;
+	static const unsigned int samplesPerStep = sampleRate / 60;
+	static const unsigned int stepCount = 60;
+	static const unsigned int iterationCount = 20;
+	float attenuationTable[SN76489::attenuationTableSize];
+	SN76489::BuildAttenuationTable(attenuationTable);
+	std::vector<float> outputBuffer(samplesPerStep);
+
+	for(unsigned int channelType = 0; channelType < 2; ++channelType)
+	{
+		bool noiseChannel = (channelType != 0);
+		std::vector<ChannelStep> trace = BuildChannelTrace(noiseChannel, stepCount, 0, 5);
+		for(unsigned int i = 0; i < (unsigned int)trace.size(); ++i)
+		{
+			trace[i].outputSampleCount = samplesPerStep;
+			trace[i].volumeRegister &= 0x7;
+			if(!noiseChannel)
+			{
+				trace[i].toneRegisterValue = 0x80 + ((trace[i].toneRegisterValue & 0x3F) * 0x8);
+			}
+		}
+
+		ChannelState referenceState = CreateInitialChannelState();
+		std::chrono::high_resolution_clock::time_point referenceStartTime = std::chrono::high_resolution_clock::now();
+		for(unsigned int iteration = 0; iteration < iterationCount; ++iteration)
+		{
+			for(unsigned int i = 0; i < (unsigned int)trace.size(); ++i)
+			{
+				ReferenceRenderChannel(referenceState, trace[i], outputBuffer);
+			}
+		}
+		std::chrono::high_resolution_clock::duration referenceTime = std::chrono::high_resolution_clock::now() - referenceStartTime;
+
+		ChannelState state = CreateInitialChannelState();
+		std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+		for(unsigned int iteration = 0; iteration < iterationCount; ++iteration)
+		{
+			for(unsigned int i = 0; i < (unsigned int)trace.size(); ++i)
+			{
+				RenderChannel(state, trace[i], attenuationTable, outputBuffer);
+			}
+		}
+		std::chrono::high_resolution_clock::duration time = std::chrono::high_resolution_clock::now() - startTime;
+
+		double sampleCount = (double)samplesPerStep * (double)stepCount * (double)iterationCount;
+		double referenceNanosecondsPerSample = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(referenceTime).count() / sampleCount;
+		double nanosecondsPerSample = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() / sampleCount;
+		std::wcout << (noiseChannel? L"Noise channel: ": L"Tone channel: ") << L"per-sample " << referenceNanosecondsPerSample << L"ns/sample, block " << nanosecondsPerSample << L"ns/sample\n";
+	}
+}
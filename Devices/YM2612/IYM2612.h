@@ -163,6 +163,18 @@ public:
 	inline void SetChannelAudioLoggingOutputPath(unsigned int channelNo, const std::wstring& adata);
 	inline std::wstring GetOperatorAudioLoggingOutputPath(unsigned int channelNo, unsigned int operatorNo) const;
 	inline void SetOperatorAudioLoggingOutputPath(unsigned int channelNo, unsigned int operatorNo, const std::wstring& adata);
+
+	//Render thread statistics
+	inline double GetRenderLatency() const;
+	inline double GetRenderDrainRate() const;
+	inline unsigned int GetRenderBlockedCount() const;
+
+	//Audio output functions
+	inline bool IsAudioOutputEnabled() const;
+	inline void SetAudioOutputEnabled(bool adata);
+	inline unsigned int GetAudioOutputQueuedSampleCount() const;
+	inline unsigned int GetAudioOutputOverrunCount() const;
+	inline unsigned int GetAudioOutputUnderrunCount() const;
 };
 
 #include "IYM2612.inl"
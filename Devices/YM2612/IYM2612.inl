@@ -68,7 +68,14 @@ enum class IYM2612::IYM2612DataSource
 	ChannelAudioLoggingEnabled,
 	ChannelAudioLoggingPath,
 	OperatorAudioLoggingEnabled,
-	OperatorAudioLoggingPath
+	OperatorAudioLoggingPath,
+	RenderLatency,
+	RenderDrainRate,
+	RenderBlockedCount,
+	AudioOutputEnabled,
+	AudioOutputQueuedSampleCount,
+	AudioOutputOverrunCount,
+	AudioOutputUnderrunCount
 };
 
 //----------------------------------------------------------------------------------------
@@ -1084,3 +1091,70 @@ void IYM2612::SetOperatorAudioLoggingOutputPath(unsigned int channelNo, unsigned
 	OperatorDataContext dataContext(channelNo, operatorNo);
 	WriteGenericData((unsigned int)IYM2612DataSource::OperatorAudioLoggingPath, &dataContext, data);
 }
+
+//----------------------------------------------------------------------------------------
+//Render thread statistics
+//----------------------------------------------------------------------------------------
+double IYM2612::GetRenderLatency() const
+{
+	GenericAccessDataValueDouble data;
+	ReadGenericData((unsigned int)IYM2612DataSource::RenderLatency, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+double IYM2612::GetRenderDrainRate() const
+{
+	GenericAccessDataValueDouble data;
+	ReadGenericData((unsigned int)IYM2612DataSource::RenderDrainRate, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int IYM2612::GetRenderBlockedCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)IYM2612DataSource::RenderBlockedCount, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+//Audio output functions
+//----------------------------------------------------------------------------------------
+bool IYM2612::IsAudioOutputEnabled() const
+{
+	GenericAccessDataValueBool data;
+	ReadGenericData((unsigned int)IYM2612DataSource::AudioOutputEnabled, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+void IYM2612::SetAudioOutputEnabled(bool adata)
+{
+	GenericAccessDataValueBool data(adata);
+	WriteGenericData((unsigned int)IYM2612DataSource::AudioOutputEnabled, 0, data);
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int IYM2612::GetAudioOutputQueuedSampleCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)IYM2612DataSource::AudioOutputQueuedSampleCount, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int IYM2612::GetAudioOutputOverrunCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)IYM2612DataSource::AudioOutputOverrunCount, 0, data);
+	return data.GetValue();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int IYM2612::GetAudioOutputUnderrunCount() const
+{
+	GenericAccessDataValueUInt data;
+	ReadGenericData((unsigned int)IYM2612DataSource::AudioOutputUnderrunCount, 0, data);
+	return data.GetValue();
+}
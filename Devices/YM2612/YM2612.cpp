@@ -145,7 +145,8 @@ timerAOverflowTimes(false)
 
 	//Initialize the audio output stream
 	outputSampleRate = 48000;	//44100;
-	outputStream.Open(2, 16, outputSampleRate, outputSampleRate/4, outputSampleRate/20);
+	audioOutputEnabled = true;
+	OpenAudioOutputStream();
 
 	//Initialize the raw register locking state
 	for(unsigned int registerNo = 0; registerNo < registerCountTotal; ++registerNo)
@@ -336,6 +337,13 @@ bool YM2612::BuildDevice()
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::ChannelAudioLoggingPath, IGenericAccessDataValue::DataType::FilePath))->SetFilePathExtensionFilter(audioLogExtensionFilter)->SetFilePathDefaultExtension(audioLogDefaultExtension)->SetFilePathCreatingTarget(true));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::OperatorAudioLoggingEnabled, IGenericAccessDataValue::DataType::Bool)));
 	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::OperatorAudioLoggingPath, IGenericAccessDataValue::DataType::FilePath))->SetFilePathExtensionFilter(audioLogExtensionFilter)->SetFilePathDefaultExtension(audioLogDefaultExtension)->SetFilePathCreatingTarget(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::RenderLatency, IGenericAccessDataValue::DataType::Double))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::RenderDrainRate, IGenericAccessDataValue::DataType::Double))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::RenderBlockedCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::AudioOutputEnabled, IGenericAccessDataValue::DataType::Bool)));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::AudioOutputQueuedSampleCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::AudioOutputOverrunCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
+	result &= AddGenericDataInfo((new GenericAccessDataInfo(IYM2612DataSource::AudioOutputUnderrunCount, IGenericAccessDataValue::DataType::UInt))->SetReadOnly(true));
 
 	//Register page layouts for generic access to this device
 	GenericAccessPage* audioLoggingPage = new GenericAccessPage(L"Audio Logging", L"Audio Logging");
@@ -378,6 +386,17 @@ bool YM2612::BuildDevice()
 	}
 	audioLoggingPage->AddEntry(operatorGroup);
 	result &= AddGenericAccessPage(audioLoggingPage);
+	GenericAccessPage* renderThreadPage = new GenericAccessPage(L"Render Thread", L"Render Thread");
+	renderThreadPage->AddEntry(new GenericAccessGroupDataEntry(IYM2612DataSource::RenderLatency, L"Backlog (ms)"))
+	                ->AddEntry(new GenericAccessGroupDataEntry(IYM2612DataSource::RenderDrainRate, L"Drain Rate"))
+	                ->AddEntry(new GenericAccessGroupDataEntry(IYM2612DataSource::RenderBlockedCount, L"Stall Events"));
+	result &= AddGenericAccessPage(renderThreadPage);
+	GenericAccessPage* audioOutputPage = new GenericAccessPage(L"Audio Output", L"Audio Output");
+	audioOutputPage->AddEntry(new GenericAccessGroupDataEntry(IYM2612DataSource::AudioOutputEnabled, L"Output Enabled"))
+	               ->AddEntry(new GenericAccessGroupDataEntry(IYM2612DataSource::AudioOutputQueuedSampleCount, L"Queued Samples"))
+	               ->AddEntry(new GenericAccessGroupDataEntry(IYM2612DataSource::AudioOutputOverrunCount, L"Overruns"))
+	               ->AddEntry(new GenericAccessGroupDataEntry(IYM2612DataSource::AudioOutputUnderrunCount, L"Underruns"));
+	result &= AddGenericAccessPage(audioOutputPage);
 
 	return result;
 }
@@ -676,8 +695,8 @@ void YM2612::TransparentSetClockSourceRate(unsigned int clockInput, double clock
 void YM2612::BeginExecution()
 {
 	//Initialize the worker thread state
-	pendingRenderOperationCount = 0;
-	renderThreadLagging = false;
+	renderBackpressure.Reset();
+	uncommittedRenderTime = 0;
 	regTimesliceList.clear();
 	timerATimesliceList.clear();
 
@@ -739,22 +758,16 @@ void YM2612::NotifyUpcomingTimeslice(double nanoseconds)
 	//timeslice lists for the buffers
 	regTimesliceListUncommitted.push_back(reg.GetLatestTimeslice());
 	timerATimesliceListUncommitted.push_back(timerAOverflowTimes.GetLatestTimeslice());
+	uncommittedRenderTime += nanoseconds;
 }
 
 //----------------------------------------------------------------------------------------
 void YM2612::ExecuteTimeslice(double nanoseconds)
 {
-	//If the render thread is lagging, pause here until it has caught up, so we don't
-	//leave the render thread behind with an ever-increasing workload it will never be
-	//able to complete.
-	if(renderThreadLagging)
-	{
-		std::unique_lock<std::mutex> lock(timesliceMutex);
-		while(renderThreadLagging)
-		{
-			renderThreadLaggingStateChange.wait(lock);
-		}
-	}
+	//If the render thread has fallen too far behind, pause here until it has caught up,
+	//so we don't leave the render thread behind with an ever-increasing workload it will
+	//never be able to complete.
+	renderBackpressure.WaitWhileBlocked();
 }
 
 //----------------------------------------------------------------------------------------
@@ -801,6 +814,7 @@ void YM2612::ExecuteRollback()
 	irqLineState = birqLineState;
 
 	//Clear any uncommitted timeslices from our render timeslice buffers
+	uncommittedRenderTime = 0;
 	regTimesliceListUncommitted.clear();
 	timerATimesliceListUncommitted.clear();
 }
@@ -857,9 +871,10 @@ void YM2612::ExecuteCommit()
 		//thread
 		std::unique_lock<std::mutex> lock(timesliceMutex);
 
-		//Add the number of timeslices we are about to commit to the count of pending
-		//render operations. This is used to track if the render thread is lagging.
-		pendingRenderOperationCount += (unsigned int)regTimesliceListUncommitted.size();
+		//Add the timeslices we are about to commit to the pending work for the render
+		//thread. This is used to track if the render thread is lagging.
+		renderBackpressure.QueueWork((unsigned int)regTimesliceListUncommitted.size(), uncommittedRenderTime);
+		uncommittedRenderTime = 0;
 
 		//Move all timeslices in our uncommitted timeslice lists over to the committed
 		//timeslice lists, for processing by the render thread.
@@ -892,9 +907,7 @@ void YM2612::RenderThread()
 			if(!regTimesliceList.empty() && !timerATimesliceList.empty())
 			{
 				//Update the lagging state for the render thread
-				--pendingRenderOperationCount;
-				renderThreadLagging = (pendingRenderOperationCount > maxPendingRenderOperationCount);
-				renderThreadLaggingStateChange.notify_all();
+				renderBackpressure.BeginOperation();
 
 				//Grab the next completed timeslice from the timeslice list
 				regTimesliceCopy = *regTimesliceList.begin();
@@ -936,6 +949,8 @@ void YM2612::RenderThread()
 
 		//Render the YM2612 output
 		size_t outputBufferPos = outputBuffer.size();
+		size_t wavLogOutputBufferPos = outputBufferPos;
+		bool wavLogDataPending = false;
 //		unsigned int outputBufferMultiplexedPos = 0;
 //		std::vector<short> outputBufferMultiplexed(0);
 		bool moreSamplesRemaining = true;
@@ -1125,16 +1140,16 @@ void YM2612::RenderThread()
 								feedbackBuffer[channelNo][1] = result;
 							}
 
-							//Write to the wav log
+							//Add the sample to the wav log buffer for this operator
 							if(wavLoggingOperatorEnabled[channelNo][operatorNo])
 							{
-								std::unique_lock<std::mutex> lock(waveLoggingMutex);
 								short outputSample;
 								float operatorOutputNormalized = (float)operatorOutput[channelNo][operatorNo] / ((1 << (operatorOutputBitCount - 1)) - 1);
 								//We halve the amplitude of the operator output just to
 								//make it a little easier to work with.
 								outputSample = (short)(operatorOutputNormalized * (32767.0f/2));
-								wavLogOperator[channelNo][operatorNo].WriteData(outputSample);
+								wavLogOperatorBuffer[channelNo][operatorNo].push_back(outputSample);
+								wavLogDataPending = true;
 							}
 						}
 
@@ -1264,10 +1279,9 @@ void YM2612::RenderThread()
 						channelOutput[channelNo][0] = GetOutputLeft(channelAddressOffset, accessTarget)? combinedChannelOutput: 0;
 						channelOutput[channelNo][1] = GetOutputRight(channelAddressOffset, accessTarget)? combinedChannelOutput: 0;
 
-						//Write to the wave log
+						//Add the sample to the wave log buffer for this channel
 						if(wavLoggingChannelEnabled[channelNo])
 						{
-							std::unique_lock<std::mutex> lock(waveLoggingMutex);
 							short outputSampleLeft;
 							short outputSampleRight;
 							float channelOutputLeftNormalized = (float)channelOutput[channelNo][0] / ((1 << (accumulatorOutputBitCount - 1)) - 1);
@@ -1276,8 +1290,9 @@ void YM2612::RenderThread()
 							//make it a little easier to work with.
 							outputSampleLeft = (short)(channelOutputLeftNormalized * (32767.0f/2));
 							outputSampleRight = (short)(channelOutputRightNormalized * (32767.0f/2));
-							wavLogChannel[channelNo].WriteData(outputSampleLeft);
-							wavLogChannel[channelNo].WriteData(outputSampleRight);
+							wavLogChannelBuffer[channelNo].push_back(outputSampleLeft);
+							wavLogChannelBuffer[channelNo].push_back(outputSampleRight);
+							wavLogDataPending = true;
 						}
 					}
 
@@ -1325,15 +1340,6 @@ void YM2612::RenderThread()
 					outputBuffer[outputBufferPos++] = outputSampleLeft;
 					outputBuffer[outputBufferPos++] = outputSampleRight;
 
-					//Write to the wave log
-					if(wavLoggingEnabled)
-					{
-						std::unique_lock<std::mutex> lock(waveLoggingMutex);
-						Stream::ViewBinary wavlogStream(wavLog);
-						wavlogStream << outputSampleLeft;
-						wavlogStream << outputSampleRight;
-					}
-
 					////Calculate the true multiplexed output for the YM2612
 					//for(unsigned int i = 0; i < channelCount; ++i)
 					//{
@@ -1442,6 +1448,28 @@ void YM2612::RenderThread()
 			moreSamplesRemaining = reg.AdvanceByStep(regTimesliceCopy);
 		}
 
+		//Output the wave logs for this timeslice. The mixed output is already held in the
+		//output buffer, and the channel and operator output has been collected into a
+		//buffer for each log, so we only need to take the wave logging lock once here.
+		if(wavLoggingEnabled || wavLogDataPending)
+		{
+			std::unique_lock<std::mutex> lock(waveLoggingMutex);
+			if(wavLoggingEnabled && (outputBufferPos > wavLogOutputBufferPos))
+			{
+				wavLog.WriteData(&outputBuffer[wavLogOutputBufferPos], (unsigned int)(outputBufferPos - wavLogOutputBufferPos));
+			}
+			for(unsigned int channelNo = 0; channelNo < channelCount; ++channelNo)
+			{
+				wavLogChannel[channelNo].WriteData(wavLogChannelBuffer[channelNo]);
+				wavLogChannelBuffer[channelNo].clear();
+				for(unsigned int operatorNo = 0; operatorNo < operatorCount; ++operatorNo)
+				{
+					wavLogOperator[channelNo][operatorNo].WriteData(wavLogOperatorBuffer[channelNo][operatorNo]);
+					wavLogOperatorBuffer[channelNo][operatorNo].clear();
+				}
+			}
+		}
+
 		//Play the mixed audio stream. Note that we fold samples from successive render
 		//operations together, ensuring that we only send data to the output audio stream
 		//when we have a significant number of samples to send.
@@ -1451,6 +1479,13 @@ void YM2612::RenderThread()
 		{
 			unsigned int internalSampleCount = (unsigned int)outputBuffer.size() / 2;
 			unsigned int outputSampleCount = (unsigned int)((double)internalSampleCount * ((double)outputSampleRate / (double)outputFrequency));
+			//If audio output has been enabled or disabled since the output stream was
+			//opened, reopen it now. We do this here because the render thread is the only
+			//user of the output stream while it's running.
+			if(audioOutputEnabled != outputStreamOpenedWithOutputEnabled)
+			{
+				OpenAudioOutputStream();
+			}
 			AudioStream::AudioBuffer* outputBufferFinal = outputStream.CreateAudioBuffer(outputSampleCount, 2);
 			if(outputBufferFinal != 0)
 			{
@@ -1484,6 +1519,9 @@ void YM2612::RenderThread()
 			reg.AdvancePastTimeslice(regTimesliceCopy);
 			timerAOverflowTimes.AdvancePastTimeslice(timerATimesliceCopy);
 		}
+
+		//Record that we've finished rendering this timeslice
+		renderBackpressure.EndOperation();
 	}
 	renderThreadStopped.notify_all();
 }
@@ -3216,30 +3254,36 @@ void YM2612::SaveDebuggerState(IHierarchicalStorageNode& node) const
 //Data read/write functions
 //----------------------------------------------------------------------------------------
 bool YM2612::ReadGenericData(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue) const
+{
+	return ReadGenericData(dataID, dataContext, dataValue, AccessTarget().AccessLatest());
+}
+
+//----------------------------------------------------------------------------------------
+bool YM2612::ReadGenericData(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue, const AccessTarget& accessTarget) const
 {
 	ApplyGenericDataValueDisplaySettings(dataID, dataValue);
 	switch((IYM2612DataSource)dataID)
 	{
 	case IYM2612DataSource::RawRegister:{
 		const RegisterDataContext& registerDataContext = *((RegisterDataContext*)dataContext);
-		Data registerData = GetRegisterData(registerDataContext.registerNo, AccessTarget().AccessLatest());
+		Data registerData = GetRegisterData(registerDataContext.registerNo, accessTarget);
 		return dataValue.SetValue(registerData.GetData());}
 	case IYM2612DataSource::TestData:
-		return dataValue.SetValue(GetTestData(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetTestData(accessTarget));
 	case IYM2612DataSource::LFOEnabled:
-		return dataValue.SetValue(GetLFOEnabled(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetLFOEnabled(accessTarget));
 	case IYM2612DataSource::LFOData:
-		return dataValue.SetValue(GetLFOData(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetLFOData(accessTarget));
 	case IYM2612DataSource::TimerAData:
-		return dataValue.SetValue(GetTimerAData(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetTimerAData(accessTarget));
 	case IYM2612DataSource::TimerBData:
-		return dataValue.SetValue(GetTimerBData(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetTimerBData(accessTarget));
 	case IYM2612DataSource::CH3Mode:
-		return dataValue.SetValue(GetCH3Mode(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetCH3Mode(accessTarget));
 	case IYM2612DataSource::TimerBReset:
-		return dataValue.SetValue(GetTimerBReset(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetTimerBReset(accessTarget));
 	case IYM2612DataSource::TimerAReset:
-		return dataValue.SetValue(GetTimerAReset(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetTimerAReset(accessTarget));
 	case IYM2612DataSource::TimerBEnable:
 		return dataValue.SetValue(timerBEnable);
 	case IYM2612DataSource::TimerAEnable:
@@ -3249,107 +3293,107 @@ bool YM2612::ReadGenericData(unsigned int dataID, const DataContext* dataContext
 	case IYM2612DataSource::TimerALoad:
 		return dataValue.SetValue(timerALoad);
 	case IYM2612DataSource::DACData:
-		return dataValue.SetValue(GetDACData(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetDACData(accessTarget));
 	case IYM2612DataSource::DACEnabled:
-		return dataValue.SetValue(GetDACEnabled(AccessTarget().AccessLatest()));
+		return dataValue.SetValue(GetDACEnabled(accessTarget));
 	case IYM2612DataSource::DetuneData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetDetuneData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetDetuneData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::MultipleData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetMultipleData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetMultipleData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::TotalLevelData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetTotalLevelData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetTotalLevelData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::KeyScaleData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetKeyScaleData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetKeyScaleData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::AttackRateData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetAttackRateData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetAttackRateData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::AmplitudeModulationEnabled:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetAmplitudeModulationEnabled(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetAmplitudeModulationEnabled(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::DecayRateData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetDecayRateData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetDecayRateData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::SustainRateData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetSustainRateData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetSustainRateData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::SustainLevelData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetSustainLevelData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetSustainLevelData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::ReleaseRateData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetReleaseRateData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetReleaseRateData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::SSGData:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetSSGData(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetSSGData(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::SSGEnabled:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetSSGEnabled(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetSSGEnabled(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::SSGAttack:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetSSGAttack(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetSSGAttack(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::SSGAlternate:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetSSGAlternate(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetSSGAlternate(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::SSGHold:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		unsigned int operatorAddressOffset = GetOperatorBlockAddressOffset(operatorDataContext.channelNo, operatorDataContext.operatorNo);
-		return dataValue.SetValue(GetSSGHold(operatorAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetSSGHold(operatorAddressOffset, accessTarget));}
 	case IYM2612DataSource::FrequencyData:{
 		const ChannelDataContext& channelDataContext = *((ChannelDataContext*)dataContext);
 		unsigned int channelAddressOffset = GetChannelBlockAddressOffset(channelDataContext.channelNo);
-		return dataValue.SetValue(GetFrequencyData(channelAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetFrequencyData(channelAddressOffset, accessTarget));}
 	case IYM2612DataSource::BlockData:{
 		const ChannelDataContext& channelDataContext = *((ChannelDataContext*)dataContext);
 		unsigned int channelAddressOffset = GetChannelBlockAddressOffset(channelDataContext.channelNo);
-		return dataValue.SetValue(GetBlockData(channelAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetBlockData(channelAddressOffset, accessTarget));}
 	case IYM2612DataSource::FrequencyDataChannel3:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
-		return dataValue.SetValue(GetFrequencyDataChannel3(operatorDataContext.operatorNo, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetFrequencyDataChannel3(operatorDataContext.operatorNo, accessTarget));}
 	case IYM2612DataSource::BlockDataChannel3:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
-		return dataValue.SetValue(GetBlockDataChannel3(operatorDataContext.operatorNo, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetBlockDataChannel3(operatorDataContext.operatorNo, accessTarget));}
 	case IYM2612DataSource::FeedbackData:{
 		const ChannelDataContext& channelDataContext = *((ChannelDataContext*)dataContext);
 		unsigned int channelAddressOffset = GetChannelBlockAddressOffset(channelDataContext.channelNo);
-		return dataValue.SetValue(GetFeedbackData(channelAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetFeedbackData(channelAddressOffset, accessTarget));}
 	case IYM2612DataSource::AlgorithmData:{
 		const ChannelDataContext& channelDataContext = *((ChannelDataContext*)dataContext);
 		unsigned int channelAddressOffset = GetChannelBlockAddressOffset(channelDataContext.channelNo);
-		return dataValue.SetValue(GetAlgorithmData(channelAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetAlgorithmData(channelAddressOffset, accessTarget));}
 	case IYM2612DataSource::OutputLeft:{
 		const ChannelDataContext& channelDataContext = *((ChannelDataContext*)dataContext);
 		unsigned int channelAddressOffset = GetChannelBlockAddressOffset(channelDataContext.channelNo);
-		return dataValue.SetValue(GetOutputLeft(channelAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetOutputLeft(channelAddressOffset, accessTarget));}
 	case IYM2612DataSource::OutputRight:{
 		const ChannelDataContext& channelDataContext = *((ChannelDataContext*)dataContext);
 		unsigned int channelAddressOffset = GetChannelBlockAddressOffset(channelDataContext.channelNo);
-		return dataValue.SetValue(GetOutputRight(channelAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetOutputRight(channelAddressOffset, accessTarget));}
 	case IYM2612DataSource::AMSData:{
 		const ChannelDataContext& channelDataContext = *((ChannelDataContext*)dataContext);
 		unsigned int channelAddressOffset = GetChannelBlockAddressOffset(channelDataContext.channelNo);
-		return dataValue.SetValue(GetAMSData(channelAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetAMSData(channelAddressOffset, accessTarget));}
 	case IYM2612DataSource::PMSData:{
 		const ChannelDataContext& channelDataContext = *((ChannelDataContext*)dataContext);
 		unsigned int channelAddressOffset = GetChannelBlockAddressOffset(channelDataContext.channelNo);
-		return dataValue.SetValue(GetPMSData(channelAddressOffset, AccessTarget().AccessLatest()));}
+		return dataValue.SetValue(GetPMSData(channelAddressOffset, accessTarget));}
 	case IYM2612DataSource::KeyState:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		return dataValue.SetValue(operatorData[operatorDataContext.channelNo][operatorDataContext.operatorNo].keyon);}
@@ -3393,6 +3437,20 @@ bool YM2612::ReadGenericData(unsigned int dataID, const DataContext* dataContext
 	case IYM2612DataSource::OperatorAudioLoggingPath:{
 		const OperatorDataContext& operatorDataContext = *((OperatorDataContext*)dataContext);
 		return dataValue.SetValue(wavLoggingOperatorPath[operatorDataContext.channelNo][operatorDataContext.operatorNo]);}
+	case IYM2612DataSource::RenderLatency:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().estimatedDrainTimeInNanoseconds / 1000000.0);
+	case IYM2612DataSource::RenderDrainRate:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().drainRate);
+	case IYM2612DataSource::RenderBlockedCount:
+		return dataValue.SetValue(renderBackpressure.GetTelemetry().blockedCount);
+	case IYM2612DataSource::AudioOutputEnabled:
+		return dataValue.SetValue(audioOutputEnabled);
+	case IYM2612DataSource::AudioOutputQueuedSampleCount:
+		return dataValue.SetValue(outputStream.GetOutputStatistics().queuedSampleCount);
+	case IYM2612DataSource::AudioOutputOverrunCount:
+		return dataValue.SetValue(outputStream.GetOutputStatistics().overrunCount);
+	case IYM2612DataSource::AudioOutputUnderrunCount:
+		return dataValue.SetValue(outputStream.GetOutputStatistics().underrunCount);
 	}
 	return false;
 }
@@ -3733,6 +3791,11 @@ bool YM2612::WriteGenericData(unsigned int dataID, const DataContext* dataContex
 		IGenericAccessDataValueBool& dataValueAsBool = (IGenericAccessDataValueBool&)dataValue;
 		SetAudioLoggingEnabled(dataValueAsBool.GetValue());
 		return true;}
+	case IYM2612DataSource::AudioOutputEnabled:{
+		if(dataType != IGenericAccessDataValue::DataType::Bool) return false;
+		IGenericAccessDataValueBool& dataValueAsBool = (IGenericAccessDataValueBool&)dataValue;
+		audioOutputEnabled = dataValueAsBool.GetValue();
+		return true;}
 	case IYM2612DataSource::ChannelAudioLoggingEnabled:{
 		if(dataType != IGenericAccessDataValue::DataType::Bool) return false;
 		IGenericAccessDataValueBool& dataValueAsBool = (IGenericAccessDataValueBool&)dataValue;
@@ -3766,6 +3829,23 @@ bool YM2612::WriteGenericData(unsigned int dataID, const DataContext* dataContex
 	return false;
 }
 
+//----------------------------------------------------------------------------------------
+//Batch read functions
+//----------------------------------------------------------------------------------------
+void YM2612::BeginGenericDataBatch() const
+{
+	//Take a single copy of the register buffer for the whole batch, so that the register
+	//reads in the batch only take the buffer lock once, and all see the same register
+	//state. The copy is retained between batches to avoid reallocating it each time.
+	reg.GetBufferCopy(genericDataBatchRegisterSnapshot, AccessTarget().AccessLatest());
+}
+
+//----------------------------------------------------------------------------------------
+bool YM2612::ReadGenericDataBatchEntry(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue) const
+{
+	return ReadGenericData(dataID, dataContext, dataValue, AccessTarget().AccessSnapshot(genericDataBatchRegisterSnapshot));
+}
+
 //----------------------------------------------------------------------------------------
 //Data locking functions
 //----------------------------------------------------------------------------------------
@@ -4016,11 +4096,43 @@ bool YM2612::SetGenericDataLocked(unsigned int dataID, const DataContext* dataCo
 	return false;
 }
 
+//----------------------------------------------------------------------------------------
+//Audio capture functions
+//----------------------------------------------------------------------------------------
+bool YM2612::SetAudioCaptureSink(IAudioSink* sink)
+{
+	//Open the capture sink with the format of our output stream, then attach it to the
+	//stream, which passes it a copy of every buffer we play from this point on.
+	if((sink != 0) && !sink->Open(2, 16, outputSampleRate))
+	{
+		return false;
+	}
+	outputStream.SetCaptureSink(sink);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+//Audio output functions
+//----------------------------------------------------------------------------------------
+void YM2612::OpenAudioOutputStream()
+{
+	//Open the default audio output device if audio output is enabled. If audio output
+	//has been disabled, or there's no audio output device available on this host, we
+	//send the output to a null sink instead. This keeps the complete audio generation
+	//path running, and allows the system to run unthrottled without an audio device.
+	outputStreamOpenedWithOutputEnabled = audioOutputEnabled;
+	if(!audioOutputEnabled || !outputStream.Open(2, 16, outputSampleRate, outputSampleRate/4, outputSampleRate/20))
+	{
+		outputStream.Open(outputNullSink, 2, 16, outputSampleRate);
+	}
+}
+
 //----------------------------------------------------------------------------------------
 //Audio logging functions
 //----------------------------------------------------------------------------------------
 void YM2612::SetAudioLoggingEnabled(bool state)
 {
+	std::unique_lock<std::mutex> lock(waveLoggingMutex);
 	double fmClock = (externalClockRate / fmClockDivider) / outputClockDivider;
 	ToggleLoggingEnabledState(wavLog, wavLoggingPath, wavLoggingEnabled, state, 2, 16, (unsigned int)fmClock);
 	wavLoggingEnabled = state;
@@ -4029,6 +4141,7 @@ void YM2612::SetAudioLoggingEnabled(bool state)
 //----------------------------------------------------------------------------------------
 void YM2612::SetChannelAudioLoggingEnabled(unsigned int channelNo, bool state)
 {
+	std::unique_lock<std::mutex> lock(waveLoggingMutex);
 	double fmClock = (externalClockRate / fmClockDivider) / outputClockDivider;
 	ToggleLoggingEnabledState(wavLogChannel[channelNo], wavLoggingChannelPath[channelNo], wavLoggingChannelEnabled[channelNo], state, 2, 16, (unsigned int)fmClock);
 	wavLoggingChannelEnabled[channelNo] = state;
@@ -4037,20 +4150,20 @@ void YM2612::SetChannelAudioLoggingEnabled(unsigned int channelNo, bool state)
 //----------------------------------------------------------------------------------------
 void YM2612::SetOperatorAudioLoggingEnabled(unsigned int channelNo, unsigned int operatorNo, bool state)
 {
+	std::unique_lock<std::mutex> lock(waveLoggingMutex);
 	double fmClock = (externalClockRate / fmClockDivider) / outputClockDivider;
 	ToggleLoggingEnabledState(wavLogOperator[channelNo][operatorNo], wavLoggingOperatorPath[channelNo][operatorNo], wavLoggingOperatorEnabled[channelNo][operatorNo], state, 1, 16, (unsigned int)fmClock);
 	wavLoggingOperatorEnabled[channelNo][operatorNo] = state;
 }
 
 //----------------------------------------------------------------------------------------
-bool YM2612::ToggleLoggingEnabledState(Stream::WAVFile& wavFile, const std::wstring& fileName, bool currentState, bool newState, unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec)
+bool YM2612::ToggleLoggingEnabledState(Stream::BufferedWAVFile& wavFile, const std::wstring& fileName, bool currentState, bool newState, unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec)
 {
 	if(newState != currentState)
 	{
 		if(newState)
 		{
-			wavFile.SetDataFormat(channelCount, bitsPerSample, samplesPerSec);
-			wavFile.Open(fileName, Stream::WAVFile::OpenMode::WriteOnly, Stream::WAVFile::CreateMode::Create);
+			wavFile.Open(wavLogWriter, fileName, channelCount, bitsPerSample, samplesPerSec);
 		}
 		else
 		{
@@ -63,7 +63,7 @@ References:
 #include "AudioStream/AudioStream.pkg"
 #include "Stream/Stream.pkg"
 
-class YM2612 :public Device, public GenericAccessBase<IYM2612>
+class YM2612 :public Device, public GenericAccessBase<IYM2612>, public IAudioCaptureSource
 {
 public:
 	//Constructors
@@ -126,6 +126,14 @@ public:
 	virtual bool GetGenericDataLocked(unsigned int dataID, const DataContext* dataContext) const;
 	virtual bool SetGenericDataLocked(unsigned int dataID, const DataContext* dataContext, bool state);
 
+	//Audio capture functions
+	virtual bool SetAudioCaptureSink(IAudioSink* sink);
+
+protected:
+	//Batch read functions
+	virtual void BeginGenericDataBatch() const;
+	virtual bool ReadGenericDataBatchEntry(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue) const;
+
 private:
 	//Enumerations
 	enum class LineID;
@@ -201,6 +209,9 @@ private:
 	typedef RandomTimeAccessBuffer<Data, double>::AccessTarget AccessTarget;
 
 private:
+	//Data read functions
+	bool ReadGenericData(unsigned int dataID, const DataContext* dataContext, IGenericAccessDataValue& dataValue, const AccessTarget& accessTarget) const;
+
 	//Execute functions
 	void RenderThread();
 
@@ -336,11 +347,14 @@ private:
 	inline bool GetTimerAOverflow() const;
 	inline void SetTimerAOverflow(bool astate);
 
+	//Audio output functions
+	void OpenAudioOutputStream();
+
 	//Audio logging functions
 	void SetAudioLoggingEnabled(bool state);
 	void SetChannelAudioLoggingEnabled(unsigned int channelNo, bool state);
 	void SetOperatorAudioLoggingEnabled(unsigned int channelNo, unsigned int operatorNo, bool state);
-	static bool ToggleLoggingEnabledState(Stream::WAVFile& wavFile, const std::wstring& fileName, bool currentState, bool newState, unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec);
+	bool ToggleLoggingEnabledState(Stream::BufferedWAVFile& wavFile, const std::wstring& fileName, bool currentState, bool newState, unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec);
 
 private:
 	//Constants
@@ -393,6 +407,7 @@ private:
 	mutable std::mutex accessMutex;
 	double lastAccessTime;
 	RandomTimeAccessBuffer<Data, double> reg;
+	mutable std::vector<Data> genericDataBatchRegisterSnapshot;
 	unsigned int currentReg;
 	unsigned int bcurrentReg;
 	Data status;
@@ -446,10 +461,8 @@ private:
 	std::condition_variable renderThreadUpdate;
 	std::condition_variable renderThreadStopped;
 	bool renderThreadActive;
-	static const unsigned int maxPendingRenderOperationCount = 4;
-	bool renderThreadLagging;
-	std::condition_variable renderThreadLaggingStateChange;
-	unsigned int pendingRenderOperationCount;
+	RenderBackpressure renderBackpressure;
+	double uncommittedRenderTime;
 	std::list<RandomTimeAccessBuffer<Data, double>::Timeslice> regTimesliceList;
 	std::list<RandomTimeAccessValue<bool, double>::Timeslice> timerATimesliceList;
 	std::list<RandomTimeAccessBuffer<Data, double>::Timeslice> regTimesliceListUncommitted;
@@ -457,7 +470,10 @@ private:
 	double remainingRenderTime;
 	int egRemainingRenderCycles;
 	unsigned int outputSampleRate;
+	NullAudioSink outputNullSink;
 	AudioStream outputStream;
+	volatile bool audioOutputEnabled;
+	bool outputStreamOpenedWithOutputEnabled;
 	std::vector<short> outputBuffer;
 
 	//Render data
@@ -484,9 +500,12 @@ private:
 	std::wstring wavLoggingPath;
 	std::wstring wavLoggingChannelPath[channelCount];
 	std::wstring wavLoggingOperatorPath[channelCount][operatorCount];
-	Stream::WAVFile wavLog;
-	Stream::WAVFile wavLogChannel[channelCount];
-	Stream::WAVFile wavLogOperator[channelCount][operatorCount];
+	Stream::WAVFileWriter wavLogWriter;
+	Stream::BufferedWAVFile wavLog;
+	Stream::BufferedWAVFile wavLogChannel[channelCount];
+	Stream::BufferedWAVFile wavLogOperator[channelCount][operatorCount];
+	std::vector<short> wavLogChannelBuffer[channelCount];
+	std::vector<short> wavLogOperatorBuffer[channelCount][operatorCount];
 };
 
 #include "YM2612.inl"
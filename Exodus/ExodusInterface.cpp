@@ -113,6 +113,7 @@ bool ExodusInterface::InitializePrefs()
 	SetGlobalPreferencePathCaptures(L"Captures");
 	SetGlobalPreferencePathAssemblies(L"Plugins");
 	SetGlobalPreferenceEnableThrottling(true);
+	SetGlobalPreferenceThrottlingSleepOnly(false);
 	SetGlobalPreferenceRunWhenProgramModuleLoaded(true);
 	SetGlobalPreferenceEnablePersistentState(true);
 	SetGlobalPreferenceLoadWorkspaceWithDebugState(true);
@@ -1282,6 +1283,10 @@ bool ExodusInterface::LoadPrefs(const std::wstring& filePath)
 		{
 			SetGlobalPreferenceEnableThrottling((*i)->ExtractData<bool>());
 		}
+		else if((*i)->GetName() == L"ThrottlingSleepOnly")
+		{
+			SetGlobalPreferenceThrottlingSleepOnly((*i)->ExtractData<bool>());
+		}
 		else if((*i)->GetName() == L"RunWhenProgramModuleLoaded")
 		{
 			SetGlobalPreferenceRunWhenProgramModuleLoaded((*i)->ExtractData<bool>());
@@ -1318,6 +1323,7 @@ void ExodusInterface::SavePrefs(const std::wstring& filePath)
 	rootNode.CreateChild(L"DefaultSystem").SetData(PathRemoveBasePath(prefs.pathModules, prefs.loadSystem));
 	rootNode.CreateChild(L"DefaultWorkspace").SetData(PathRemoveBasePath(prefs.pathWorkspaces, prefs.loadWorkspace));
 	rootNode.CreateChild(L"EnableThrottling").SetData(prefs.enableThrottling);
+	rootNode.CreateChild(L"ThrottlingSleepOnly").SetData(prefs.throttlingSleepOnly);
 	rootNode.CreateChild(L"RunWhenProgramModuleLoaded").SetData(prefs.runWhenProgramModuleLoaded);
 	rootNode.CreateChild(L"EnablePersistentState").SetData(prefs.enablePersistentState);
 	rootNode.CreateChild(L"LoadWorkspaceWithDebugState").SetData(prefs.loadWorkspaceWithDebugState);
@@ -1391,6 +1397,12 @@ bool ExodusInterface::GetGlobalPreferenceEnableThrottling() const
 	return prefs.enableThrottling;
 }
 
+//----------------------------------------------------------------------------------------
+bool ExodusInterface::GetGlobalPreferenceThrottlingSleepOnly() const
+{
+	return prefs.throttlingSleepOnly;
+}
+
 //----------------------------------------------------------------------------------------
 bool ExodusInterface::GetGlobalPreferenceRunWhenProgramModuleLoaded() const
 {
@@ -1557,6 +1569,14 @@ void ExodusInterface::SetGlobalPreferenceEnableThrottling(bool state)
 	system->SetThrottlingState(prefs.enableThrottling);
 }
 
+//----------------------------------------------------------------------------------------
+void ExodusInterface::SetGlobalPreferenceThrottlingSleepOnly(bool state)
+{
+	//Apply the new preference setting
+	prefs.throttlingSleepOnly = state;
+	system->SetThrottlingSleepOnlyState(prefs.throttlingSleepOnly);
+}
+
 //----------------------------------------------------------------------------------------
 void ExodusInterface::SetGlobalPreferenceRunWhenProgramModuleLoaded(bool state)
 {
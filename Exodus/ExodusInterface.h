@@ -136,6 +136,7 @@ public:
 	virtual bool GetGlobalPreferenceEnablePersistentState() const;
 	virtual bool GetGlobalPreferenceLoadWorkspaceWithDebugState() const;
 	virtual bool GetGlobalPreferenceShowDebugConsole() const;
+	bool GetGlobalPreferenceThrottlingSleepOnly() const;
 	void SetGlobalPreferencePathModules(const std::wstring& state);
 	void SetGlobalPreferencePathSavestates(const std::wstring& state);
 	void SetGlobalPreferencePathPersistentState(const std::wstring& state);
@@ -145,6 +146,7 @@ public:
 	void SetGlobalPreferenceInitialSystem(const std::wstring& state);
 	void SetGlobalPreferenceInitialWorkspace(const std::wstring& state);
 	void SetGlobalPreferenceEnableThrottling(bool state);
+	void SetGlobalPreferenceThrottlingSleepOnly(bool state);
 	void SetGlobalPreferenceRunWhenProgramModuleLoaded(bool state);
 	void SetGlobalPreferenceEnablePersistentState(bool state);
 	void SetGlobalPreferenceLoadWorkspaceWithDebugState(bool state);
@@ -182,6 +184,7 @@ private:
 		std::wstring loadSystem;
 		std::wstring loadWorkspace;
 		bool enableThrottling;
+		bool throttlingSleepOnly;
 		bool runWhenProgramModuleLoaded;
 		bool enablePersistentState;
 		bool loadWorkspaceWithDebugState;
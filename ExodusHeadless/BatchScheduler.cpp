@@ -0,0 +1,95 @@
+#include "BatchScheduler.h"
+#include <thread>
+#include <functional>
+#include <limits>
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+BatchScheduler::BatchScheduler(unsigned int aworkerCount, unsigned int aframesPerSlice)
+:workerCount((aworkerCount > 0)? aworkerCount: 1), framesPerSlice(aframesPerSlice), sliceCount(0)
+{}
+
+//----------------------------------------------------------------------------------------
+//Execution functions
+//----------------------------------------------------------------------------------------
+void BatchScheduler::Run(const std::vector<IBatchTask*>& tasks)
+{
+	//Queue all the tasks in the order they were given
+	std::unique_lock<std::mutex> lock(queueMutex);
+	taskQueue.clear();
+	for(unsigned int i = 0; i < (unsigned int)tasks.size(); ++i)
+	{
+		taskQueue.push_back(TaskState(tasks[i]));
+	}
+	sliceCount = 0;
+	lock.unlock();
+
+	//Run the worker threads until the queue is empty. There's no point starting more
+	//workers than there are tasks.
+	unsigned int threadCount = ((unsigned int)tasks.size() < workerCount)? (unsigned int)tasks.size(): workerCount;
+	std::vector<std::thread> workerThreads;
+	for(unsigned int i = 0; i < threadCount; ++i)
+	{
+		workerThreads.push_back(std::thread(std::bind(std::mem_fn(&BatchScheduler::WorkerThread), this)));
+	}
+	for(unsigned int i = 0; i < (unsigned int)workerThreads.size(); ++i)
+	{
+		workerThreads[i].join();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void BatchScheduler::WorkerThread()
+{
+	unsigned int sliceFrameCount = (framesPerSlice > 0)? framesPerSlice: std::numeric_limits<unsigned int>::max();
+	std::unique_lock<std::mutex> lock(queueMutex);
+	while(!taskQueue.empty())
+	{
+		//Take the next task from the front of the queue
+		TaskState taskState = taskQueue.front();
+		taskQueue.pop_front();
+		++sliceCount;
+		lock.unlock();
+
+		//Start the task if this is its first slice. A task which fails to start is
+		//finished immediately, so that it can report the failure in its result.
+		bool taskDone = false;
+		if(!taskState.started)
+		{
+			taskState.started = true;
+			if(!taskState.task->Start())
+			{
+				taskState.task->Finish();
+				taskDone = true;
+			}
+		}
+
+		//Advance the task by one slice, and finish it if it's reached its frame budget.
+		if(!taskDone)
+		{
+			taskState.task->ExecuteFrames(sliceFrameCount);
+			if(taskState.task->IsComplete())
+			{
+				taskState.task->Finish();
+				taskDone = true;
+			}
+		}
+
+		//Return the task to the back of the queue if it still has frames to run
+		lock.lock();
+		if(!taskDone)
+		{
+			taskQueue.push_back(taskState);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Statistics functions
+//----------------------------------------------------------------------------------------
+unsigned int BatchScheduler::GetSliceCount() const
+{
+	std::unique_lock<std::mutex> lock(queueMutex);
+	return sliceCount;
+}
@@ -0,0 +1,43 @@
+#ifndef __BATCHSCHEDULER_H__
+#define __BATCHSCHEDULER_H__
+#include "IBatchTask.h"
+#include <vector>
+#include <list>
+#include <mutex>
+
+//The batch scheduler runs a set of batch tasks across a fixed number of worker threads,
+//which is the core budget for the batch. Each task runs until it has executed its own
+//frame budget. If a slice length is given, tasks are time-shared: a worker advances a
+//task by at most one slice of frames, then returns it to the back of the queue, so that
+//every task in the batch makes progress even when there are more tasks than workers.
+//With no slice length, each task runs to completion once it's been picked up.
+class BatchScheduler
+{
+public:
+	//Constructors
+	BatchScheduler(unsigned int aworkerCount, unsigned int aframesPerSlice = 0);
+
+	//Execution functions
+	void Run(const std::vector<IBatchTask*>& tasks);
+
+	//Statistics functions
+	unsigned int GetSliceCount() const;
+
+private:
+	//Structures
+	struct TaskState;
+
+private:
+	//Execution functions
+	void WorkerThread();
+
+private:
+	unsigned int workerCount;
+	unsigned int framesPerSlice;
+	mutable std::mutex queueMutex;
+	std::list<TaskState> taskQueue;
+	unsigned int sliceCount;
+};
+
+#include "BatchScheduler.inl"
+#endif
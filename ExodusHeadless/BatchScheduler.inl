@@ -0,0 +1,12 @@
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+struct BatchScheduler::TaskState
+{
+	TaskState(IBatchTask* atask)
+	:task(atask), started(false)
+	{}
+
+	IBatchTask* task;
+	bool started;
+};
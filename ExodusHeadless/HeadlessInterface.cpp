@@ -0,0 +1,430 @@
+#include "HeadlessInterface.h"
+#include "ZIP/ZIP.pkg"
+#include "Stream/Stream.pkg"
+#include "../Exodus/DeviceInfo.h"
+#include "../Exodus/ExtensionInfo.h"
+#include <list>
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+HeadlessInterface::HeadlessInterface(const std::wstring& apathAssemblies, const std::wstring& apathModules)
+:system(0), pathAssemblies(apathAssemblies), pathModules(apathModules)
+{}
+
+//----------------------------------------------------------------------------------------
+//Interface version functions
+//----------------------------------------------------------------------------------------
+unsigned int HeadlessInterface::GetIGUIExtensionInterfaceVersion() const
+{
+	return ThisIGUIExtensionInterfaceVersion();
+}
+
+//----------------------------------------------------------------------------------------
+//System interface functions
+//----------------------------------------------------------------------------------------
+void HeadlessInterface::BindToSystem(ISystemGUIInterface* asystem)
+{
+	system = asystem;
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessInterface::UnbindFromSystem()
+{
+	system = 0;
+}
+
+//----------------------------------------------------------------------------------------
+//View manager functions
+//----------------------------------------------------------------------------------------
+IViewManager& HeadlessInterface::GetViewManager() const
+{
+	return viewManager;
+}
+
+//----------------------------------------------------------------------------------------
+//Window functions
+//----------------------------------------------------------------------------------------
+void* HeadlessInterface::GetMainWindowHandle() const
+{
+	return NULL;
+}
+
+//----------------------------------------------------------------------------------------
+//Module functions
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::CanModuleBeLoaded(const MarshalSupport::Marshal::In<std::wstring>& filePath) const
+{
+	ISystemGUIInterface::ConnectorMappingList connectorMappings;
+	return BuildConnectorMappings(filePath, connectorMappings);
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::LoadModuleFromFile(const MarshalSupport::Marshal::In<std::wstring>& filePath)
+{
+	//Map all imported connectors to available connectors in the system. There's nobody
+	//to ask which connector to use when more than one is compatible, so we always map
+	//the first free compatible connector. This gives the same mappings on every run for
+	//the same sequence of loaded modules.
+	std::wstring filePathResolved = filePath;
+	ISystemGUIInterface::ConnectorMappingList connectorMappings;
+	if(!BuildConnectorMappings(filePathResolved, connectorMappings))
+	{
+		LogEntry logEntry(LogEntry::EventLevel::Error, L"System", L"");
+		logEntry << L"Could not map the connectors imported by module \"" << filePathResolved << L"\".";
+		system->WriteLogEvent(logEntry);
+		return false;
+	}
+
+	//Load the module
+	return system->LoadModule(filePathResolved, connectorMappings);
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessInterface::UnloadModule(unsigned int moduleID)
+{
+	system->UnloadModule(moduleID);
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessInterface::UnloadAllModules()
+{
+	system->UnloadAllModules();
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::BuildConnectorMappings(const std::wstring& filePath, ISystemGUIInterface::ConnectorMappingList& connectorMappings) const
+{
+	//Read the connector info for the module
+	ISystemGUIInterface::ConnectorImportList connectorsImported;
+	ISystemGUIInterface::ConnectorExportList connectorsExported;
+	std::wstring systemClassName;
+	if(!system->ReadModuleConnectorInfo(filePath, systemClassName, connectorsImported, connectorsExported))
+	{
+		return false;
+	}
+
+	//Map each imported connector to the first free compatible connector in the system
+	std::list<unsigned int> loadedConnectorIDList = system->GetConnectorIDs();
+	for(ISystemGUIInterface::ConnectorImportList::const_iterator i = connectorsImported.begin(); i != connectorsImported.end(); ++i)
+	{
+		bool connectorMapped = false;
+		std::list<unsigned int>::const_iterator loadedConnectorID = loadedConnectorIDList.begin();
+		while(!connectorMapped && (loadedConnectorID != loadedConnectorIDList.end()))
+		{
+			ConnectorInfo connectorInfo;
+			if(system->GetConnectorInfo(*loadedConnectorID, connectorInfo))
+			{
+				if(!connectorInfo.GetIsConnectorUsed() && (connectorInfo.GetSystemClassName() == systemClassName) && (i->className == connectorInfo.GetConnectorClassName()))
+				{
+					ISystemGUIInterface::ConnectorMapping connectorMapping;
+					connectorMapping.connectorID = connectorInfo.GetConnectorID();
+					connectorMapping.importingModuleConnectorInstanceName = i->instanceName;
+					connectorMappings.push_back(connectorMapping);
+					connectorMapped = true;
+				}
+			}
+			++loadedConnectorID;
+		}
+
+		//Ensure that a compatible connector was found
+		if(!connectorMapped)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+//Global preference functions
+//----------------------------------------------------------------------------------------
+//Headless runs must not pick up or leave behind any state outside the job they were
+//asked to perform, so persistent state is disabled, and every path other than the module
+//and assembly paths is left empty.
+//----------------------------------------------------------------------------------------
+MarshalSupport::Marshal::Ret<std::wstring> HeadlessInterface::GetGlobalPreferencePathModules() const
+{
+	return pathModules;
+}
+
+//----------------------------------------------------------------------------------------
+MarshalSupport::Marshal::Ret<std::wstring> HeadlessInterface::GetGlobalPreferencePathSavestates() const
+{
+	return std::wstring();
+}
+
+//----------------------------------------------------------------------------------------
+MarshalSupport::Marshal::Ret<std::wstring> HeadlessInterface::GetGlobalPreferencePathPersistentState() const
+{
+	return std::wstring();
+}
+
+//----------------------------------------------------------------------------------------
+MarshalSupport::Marshal::Ret<std::wstring> HeadlessInterface::GetGlobalPreferencePathWorkspaces() const
+{
+	return std::wstring();
+}
+
+//----------------------------------------------------------------------------------------
+MarshalSupport::Marshal::Ret<std::wstring> HeadlessInterface::GetGlobalPreferencePathCaptures() const
+{
+	return std::wstring();
+}
+
+//----------------------------------------------------------------------------------------
+MarshalSupport::Marshal::Ret<std::wstring> HeadlessInterface::GetGlobalPreferencePathAssemblies() const
+{
+	return pathAssemblies;
+}
+
+//----------------------------------------------------------------------------------------
+MarshalSupport::Marshal::Ret<std::wstring> HeadlessInterface::GetGlobalPreferenceInitialSystem() const
+{
+	return std::wstring();
+}
+
+//----------------------------------------------------------------------------------------
+MarshalSupport::Marshal::Ret<std::wstring> HeadlessInterface::GetGlobalPreferenceInitialWorkspace() const
+{
+	return std::wstring();
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::GetGlobalPreferenceEnableThrottling() const
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::GetGlobalPreferenceRunWhenProgramModuleLoaded() const
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::GetGlobalPreferenceEnablePersistentState() const
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::GetGlobalPreferenceLoadWorkspaceWithDebugState() const
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::GetGlobalPreferenceShowDebugConsole() const
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+//Assembly functions
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::LoadAssembliesFromFolder(const std::wstring& folder)
+{
+	//Begin the folder search
+	std::wstring fileSearchString = PathCombinePaths(folder, L"*.dll");
+	WIN32_FIND_DATA findData;
+	HANDLE findFileHandle;
+	findFileHandle = FindFirstFile(fileSearchString.c_str(), &findData);
+	if(findFileHandle == INVALID_HANDLE_VALUE)
+	{
+		return (GetLastError() == ERROR_FILE_NOT_FOUND);
+	}
+
+	//Build a list of all possible plugins in the target folder. We sort the list before
+	//loading, so that devices and extensions are always registered in the same order.
+	std::list<std::wstring> pluginPaths;
+	bool foundFile = true;
+	while(foundFile)
+	{
+		std::wstring entryName = findData.cFileName;
+		if((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+		{
+			pluginPaths.push_back(PathCombinePaths(folder, entryName));
+		}
+		foundFile = FindNextFile(findFileHandle, &findData) != 0;
+	}
+	FindClose(findFileHandle);
+	pluginPaths.sort();
+
+	//Attempt to load all possible plugins found in the target path
+	bool result = true;
+	for(std::list<std::wstring>::const_iterator i = pluginPaths.begin(); i != pluginPaths.end(); ++i)
+	{
+		result &= LoadAssembly(*i);
+	}
+	return result;
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::LoadAssembly(const MarshalSupport::Marshal::In<std::wstring>& filePath)
+{
+	//Attempt to load the target assembly and retrieve information on its plugin interface
+	std::wstring filePathResolved = filePath;
+	PluginInfo pluginInfo;
+	if(!LoadAssemblyInfo(filePathResolved, pluginInfo))
+	{
+		LogEntry logEntry(LogEntry::EventLevel::Error, L"System", L"");
+		logEntry << L"Error loading assembly \"" << filePathResolved << "\"! The assembly is not a valid plugin for this version.";
+		system->WriteLogEvent(logEntry);
+		return false;
+	}
+
+	//Register each device in the assembly
+	bool result = true;
+	if(pluginInfo.GetDeviceEntry != 0)
+	{
+		unsigned int entryNo = 0;
+		DeviceInfo entry;
+		while(pluginInfo.GetDeviceEntry(entryNo++, entry))
+		{
+			result &= system->RegisterDevice(entry, pluginInfo.assemblyHandle);
+		}
+	}
+
+	//Register each extension in the assembly
+	if(pluginInfo.GetExtensionEntry != 0)
+	{
+		unsigned int entryNo = 0;
+		ExtensionInfo entry;
+		while(pluginInfo.GetExtensionEntry(entryNo++, entry))
+		{
+			result &= system->RegisterExtension(entry, pluginInfo.assemblyHandle);
+		}
+	}
+
+	//Write an entry in the event log if any plugins failed to register
+	if(!result)
+	{
+		LogEntry logEntry(LogEntry::EventLevel::Warning, L"System", L"");
+		logEntry << L"One or more plugins failed to load from assembly \"" << filePathResolved << "\"!";
+		system->WriteLogEvent(logEntry);
+	}
+	return result;
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::LoadAssemblyInfo(const std::wstring& filePath, PluginInfo& pluginInfo)
+{
+	//Attach the assembly to the process
+	HMODULE dllHandle = LoadLibrary(filePath.c_str());
+	if(dllHandle == NULL)
+	{
+		return false;
+	}
+
+	//Ensure the assembly is a plugin with a compatible interface version
+	unsigned int (*GetInterfaceVersion)();
+	GetInterfaceVersion = (unsigned int (*)())GetProcAddress(dllHandle, "GetInterfaceVersion");
+	if((GetInterfaceVersion == 0) || (GetInterfaceVersion() < EXODUS_INTERFACEVERSION))
+	{
+		FreeLibrary(dllHandle);
+		return false;
+	}
+
+	//Obtain pointers to all the interface functions for the assembly
+	bool (*GetDeviceEntry)(unsigned int entryNo, IDeviceInfo& entry);
+	bool (*GetExtensionEntry)(unsigned int entryNo, IExtensionInfo& entry);
+	bool (*GetSystemEntry)(unsigned int entryNo, ISystemInfo& entry);
+	GetDeviceEntry = (bool (*)(unsigned int entryNo, IDeviceInfo& entry))GetProcAddress(dllHandle, "GetDeviceEntry");
+	GetExtensionEntry = (bool (*)(unsigned int entryNo, IExtensionInfo& entry))GetProcAddress(dllHandle, "GetExtensionEntry");
+	GetSystemEntry = (bool (*)(unsigned int entryNo, ISystemInfo& entry))GetProcAddress(dllHandle, "GetSystemEntry");
+	if((GetDeviceEntry == 0) && (GetExtensionEntry == 0) && (GetSystemEntry == 0))
+	{
+		FreeLibrary(dllHandle);
+		return false;
+	}
+
+	//Return information on this plugin to the caller
+	pluginInfo.assemblyHandle = (AssemblyHandle)dllHandle;
+	pluginInfo.interfaceVersion = GetInterfaceVersion();
+	pluginInfo.GetDeviceEntry = GetDeviceEntry;
+	pluginInfo.GetExtensionEntry = GetExtensionEntry;
+	pluginInfo.GetSystemEntry = GetSystemEntry;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+//File selection functions
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::SelectExistingFile(const MarshalSupport::Marshal::In<std::wstring>& selectionTypeString, const MarshalSupport::Marshal::In<std::wstring>& defaultExtension, const MarshalSupport::Marshal::In<std::wstring>& initialFilePath, const MarshalSupport::Marshal::In<std::wstring>& initialDirectory, bool scanIntoArchives, const MarshalSupport::Marshal::Out<std::wstring>& selectedFilePath) const
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessInterface::SelectNewFile(const MarshalSupport::Marshal::In<std::wstring>& selectionTypeString, const MarshalSupport::Marshal::In<std::wstring>& defaultExtension, const MarshalSupport::Marshal::In<std::wstring>& initialFilePath, const MarshalSupport::Marshal::In<std::wstring>& initialDirectory, const MarshalSupport::Marshal::Out<std::wstring>& selectedFilePath) const
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+MarshalSupport::Marshal::Ret<std::vector<std::wstring>> HeadlessInterface::PathSplitElements(const MarshalSupport::Marshal::In<std::wstring>& path) const
+{
+	//Paths to files within archives are separated from the path to the archive by a "|"
+	//character.
+	std::wstring pathTemp = path;
+	std::vector<std::wstring> pathElements;
+	std::wstring::size_type currentPos = 0;
+	while(currentPos != std::wstring::npos)
+	{
+		std::wstring::size_type separatorPos = pathTemp.find(L'|', currentPos);
+		std::wstring::size_type pathElementLength = (separatorPos != std::wstring::npos)? separatorPos - currentPos: std::wstring::npos;
+		pathElements.push_back(pathTemp.substr(currentPos, pathElementLength));
+		currentPos = (separatorPos != std::wstring::npos)? (separatorPos + 1): std::wstring::npos;
+	}
+	return pathElements;
+}
+
+//----------------------------------------------------------------------------------------
+Stream::IStream* HeadlessInterface::OpenExistingFileForRead(const MarshalSupport::Marshal::In<std::wstring>& path) const
+{
+	//Open the first path element as a file, then open each following path element as a
+	//file within the ZIP archive opened by the previous element.
+	std::vector<std::wstring> pathElements = PathSplitElements(path);
+	Stream::IStream* tempStream = 0;
+	for(unsigned int i = 0; i < pathElements.size(); ++i)
+	{
+		if(tempStream == 0)
+		{
+			Stream::File* file = new Stream::File();
+			tempStream = file;
+			if(!file->Open(pathElements[i], Stream::File::OpenMode::ReadOnly, Stream::File::CreateMode::Open))
+			{
+				delete tempStream;
+				return 0;
+			}
+		}
+		else
+		{
+			ZIPArchive archive;
+			ZIPFileEntry* entry = 0;
+			if(!archive.LoadFromStream(*tempStream) || ((entry = archive.GetFileEntry(pathElements[i])) == 0))
+			{
+				delete tempStream;
+				return 0;
+			}
+			Stream::Buffer* buffer = new Stream::Buffer(0);
+			if(!entry->Decompress(*buffer))
+			{
+				delete buffer;
+				delete tempStream;
+				return 0;
+			}
+			buffer->SetStreamPos(0);
+			delete tempStream;
+			tempStream = buffer;
+		}
+	}
+	return tempStream;
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessInterface::DeleteFileStream(Stream::IStream* stream) const
+{
+	delete stream;
+}
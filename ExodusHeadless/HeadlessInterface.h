@@ -0,0 +1,81 @@
+#ifndef __HEADLESSINTERFACE_H__
+#define __HEADLESSINTERFACE_H__
+#include "WindowsSupport/WindowsSupport.pkg"
+#include "ExtensionInterface/ExtensionInterface.pkg"
+#include "SystemInterface/SystemInterface.pkg"
+#include "HeadlessViewManager.h"
+#include <string>
+#include <vector>
+
+//The headless interface stands in for the main Exodus window when a system is driven
+//without a user interface. It loads plugin assemblies and modules on request, answers
+//preference queries with fixed values, and refuses anything which would need a window.
+class HeadlessInterface :public IGUIExtensionInterface
+{
+public:
+	//Structures
+	struct PluginInfo;
+
+public:
+	//Constructors
+	HeadlessInterface(const std::wstring& apathAssemblies, const std::wstring& apathModules);
+
+	//Interface version functions
+	virtual unsigned int GetIGUIExtensionInterfaceVersion() const;
+
+	//System interface functions
+	void BindToSystem(ISystemGUIInterface* asystem);
+	void UnbindFromSystem();
+
+	//View manager functions
+	virtual IViewManager& GetViewManager() const;
+
+	//Window functions
+	virtual void* GetMainWindowHandle() const;
+
+	//Module functions
+	virtual bool CanModuleBeLoaded(const MarshalSupport::Marshal::In<std::wstring>& filePath) const;
+	virtual bool LoadModuleFromFile(const MarshalSupport::Marshal::In<std::wstring>& filePath);
+	virtual void UnloadModule(unsigned int moduleID);
+	virtual void UnloadAllModules();
+
+	//Global preference functions
+	virtual MarshalSupport::Marshal::Ret<std::wstring> GetGlobalPreferencePathModules() const;
+	virtual MarshalSupport::Marshal::Ret<std::wstring> GetGlobalPreferencePathSavestates() const;
+	virtual MarshalSupport::Marshal::Ret<std::wstring> GetGlobalPreferencePathPersistentState() const;
+	virtual MarshalSupport::Marshal::Ret<std::wstring> GetGlobalPreferencePathWorkspaces() const;
+	virtual MarshalSupport::Marshal::Ret<std::wstring> GetGlobalPreferencePathCaptures() const;
+	virtual MarshalSupport::Marshal::Ret<std::wstring> GetGlobalPreferencePathAssemblies() const;
+	virtual MarshalSupport::Marshal::Ret<std::wstring> GetGlobalPreferenceInitialSystem() const;
+	virtual MarshalSupport::Marshal::Ret<std::wstring> GetGlobalPreferenceInitialWorkspace() const;
+	virtual bool GetGlobalPreferenceEnableThrottling() const;
+	virtual bool GetGlobalPreferenceRunWhenProgramModuleLoaded() const;
+	virtual bool GetGlobalPreferenceEnablePersistentState() const;
+	virtual bool GetGlobalPreferenceLoadWorkspaceWithDebugState() const;
+	virtual bool GetGlobalPreferenceShowDebugConsole() const;
+
+	//Assembly functions
+	bool LoadAssembliesFromFolder(const std::wstring& folder);
+	virtual bool LoadAssembly(const MarshalSupport::Marshal::In<std::wstring>& filePath);
+	static bool LoadAssemblyInfo(const std::wstring& filePath, PluginInfo& pluginInfo);
+
+	//File selection functions
+	virtual bool SelectExistingFile(const MarshalSupport::Marshal::In<std::wstring>& selectionTypeString, const MarshalSupport::Marshal::In<std::wstring>& defaultExtension, const MarshalSupport::Marshal::In<std::wstring>& initialFilePath, const MarshalSupport::Marshal::In<std::wstring>& initialDirectory, bool scanIntoArchives, const MarshalSupport::Marshal::Out<std::wstring>& selectedFilePath) const;
+	virtual bool SelectNewFile(const MarshalSupport::Marshal::In<std::wstring>& selectionTypeString, const MarshalSupport::Marshal::In<std::wstring>& defaultExtension, const MarshalSupport::Marshal::In<std::wstring>& initialFilePath, const MarshalSupport::Marshal::In<std::wstring>& initialDirectory, const MarshalSupport::Marshal::Out<std::wstring>& selectedFilePath) const;
+	virtual MarshalSupport::Marshal::Ret<std::vector<std::wstring>> PathSplitElements(const MarshalSupport::Marshal::In<std::wstring>& path) const;
+	virtual Stream::IStream* OpenExistingFileForRead(const MarshalSupport::Marshal::In<std::wstring>& path) const;
+	virtual void DeleteFileStream(Stream::IStream* stream) const;
+
+private:
+	//Module functions
+	bool BuildConnectorMappings(const std::wstring& filePath, ISystemGUIInterface::ConnectorMappingList& connectorMappings) const;
+
+private:
+	ISystemGUIInterface* system;
+	mutable HeadlessViewManager viewManager;
+	std::wstring pathAssemblies;
+	std::wstring pathModules;
+};
+
+#include "HeadlessInterface.inl"
+#endif
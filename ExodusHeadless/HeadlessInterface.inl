@@ -0,0 +1,11 @@
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+struct HeadlessInterface::PluginInfo
+{
+	AssemblyHandle assemblyHandle;
+	unsigned int interfaceVersion;
+	bool (*GetDeviceEntry)(unsigned int entryNo, IDeviceInfo& entry);
+	bool (*GetExtensionEntry)(unsigned int entryNo, IExtensionInfo& entry);
+	bool (*GetSystemEntry)(unsigned int entryNo, ISystemInfo& entry);
+};
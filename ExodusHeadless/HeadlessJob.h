@@ -0,0 +1,53 @@
+#ifndef __HEADLESSJOB_H__
+#define __HEADLESSJOB_H__
+#include "StateHashLog.h"
+#include <string>
+#include <vector>
+#include <map>
+
+//----------------------------------------------------------------------------------------
+//Describes one headless run. The modules are loaded in order, so the system module must
+//come before any program modules which import its connectors. A frame is a fixed length
+//of emulated time rather than a VDP frame, so runs step in the same way regardless of
+//which devices are present.
+//----------------------------------------------------------------------------------------
+struct HeadlessJob
+{
+	HeadlessJob()
+	:frameCount(0), frameTimeInNanoseconds(0.0), hashInterval(1), frameRenderInterval(1)
+	{}
+
+	std::wstring name;
+	std::wstring assemblyPath;
+	std::wstring modulePath;
+	std::vector<std::wstring> moduleFilePaths;
+	unsigned int frameCount;
+	double frameTimeInNanoseconds;
+	unsigned int hashInterval;
+	unsigned int frameRenderInterval;
+	std::wstring outputLogPath;
+	std::wstring comparisonLogPath;
+};
+
+//----------------------------------------------------------------------------------------
+//Results collected from one headless run. The final state hashes are those recorded for
+//the last hashed frame. The log holds the system event log at the end of the run.
+//----------------------------------------------------------------------------------------
+struct HeadlessResult
+{
+	HeadlessResult()
+	:succeeded(false), compared(false), diverged(false), framesExecuted(0), executionTimeInSeconds(0.0)
+	{}
+
+	bool succeeded;
+	bool compared;
+	bool diverged;
+	unsigned int framesExecuted;
+	double executionTimeInSeconds;
+	std::wstring errorString;
+	StateHashLog::Divergence divergence;
+	std::map<std::wstring, unsigned long long> finalStateHashes;
+	std::vector<std::wstring> log;
+};
+
+#endif
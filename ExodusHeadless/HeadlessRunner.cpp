@@ -0,0 +1,320 @@
+#include "HeadlessRunner.h"
+#include "HierarchicalStorage/HierarchicalStorage.pkg"
+#include "ThreadLib/ThreadLib.pkg"
+#include "Stream/Stream.pkg"
+#include "YM2612/IYM2612.h"
+#include "SN76489/ISN76489.h"
+#include <sstream>
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+HeadlessRunner::HeadlessRunner(ISystemInfo::AllocatorPointer asystemAllocator, ISystemInfo::DestructorPointer asystemDestructor, const HeadlessJob& ajob)
+:systemAllocator(asystemAllocator), systemDestructor(asystemDestructor), system(0), headlessInterface(ajob.assemblyPath, ajob.modulePath), job(ajob), started(false), nextFrameNo(0), executionTime(0)
+{
+	//A comparison run still needs to record its own log to compare against the golden
+	//file, so if no output path has been given, we write it next to the golden file.
+	if(job.outputLogPath.empty() && !job.comparisonLogPath.empty())
+	{
+		job.outputLogPath = job.comparisonLogPath + L".actual";
+	}
+	if(job.hashInterval == 0)
+	{
+		job.hashInterval = 1;
+	}
+	if(job.frameTimeInNanoseconds <= 0.0)
+	{
+		job.frameTimeInNanoseconds = GetFrameTimeInNanoseconds(false);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+HeadlessRunner::~HeadlessRunner()
+{
+	DestroySystem();
+}
+
+//----------------------------------------------------------------------------------------
+//Execution functions
+//----------------------------------------------------------------------------------------
+bool HeadlessRunner::Start()
+{
+	//Create a new system instance bound to our headless interface. Nothing is run in the
+	//background, and nothing is saved or restored between runs.
+	system = systemAllocator(headlessInterface);
+	headlessInterface.BindToSystem(system);
+	system->SetEnablePersistentState(false);
+	system->SetRunWhenProgramModuleLoadedState(false);
+	system->SetThrottlingState(false);
+
+	//Register all the devices and extensions in the plugin folder. Not every assembly in
+	//the folder has to be a plugin, so a failure here isn't fatal. Any device a module
+	//needs which failed to register will cause the module load to fail below.
+	headlessInterface.LoadAssembliesFromFolder(job.assemblyPath);
+
+	//Load each module in order
+	for(unsigned int i = 0; i < (unsigned int)job.moduleFilePaths.size(); ++i)
+	{
+		if(!headlessInterface.LoadModuleFromFile(job.moduleFilePaths[i]))
+		{
+			result.errorString = L"Failed to load module " + job.moduleFilePaths[i];
+			return false;
+		}
+	}
+
+	//Disable audio output from any sound devices, so that batch runs don't play sound.
+	//The devices still render their output into a null sink at the same rate. We also
+	//apply the frame render interval to each VDP, which allows runs that only need the
+	//state of the system to skip generating the pixel output of most frames.
+	std::list<IDevice*> devices = system->GetLoadedDevices();
+	for(std::list<IDevice*>::const_iterator i = devices.begin(); i != devices.end(); ++i)
+	{
+		IS315_5313* vdp = dynamic_cast<IS315_5313*>(*i);
+		if(vdp != 0)
+		{
+			vdp->SetVideoFrameRenderInterval(job.frameRenderInterval);
+		}
+		IYM2612* ym2612 = dynamic_cast<IYM2612*>(*i);
+		if(ym2612 != 0)
+		{
+			ym2612->SetAudioOutputEnabled(false);
+		}
+		ISN76489* sn76489 = dynamic_cast<ISN76489*>(*i);
+		if(sn76489 != 0)
+		{
+			sn76489->SetAudioOutputEnabled(false);
+		}
+	}
+
+	//Enable video hash logging, then initialize the system. Each VDP counts frames from
+	//the point logging is enabled, so the video hashes line up with power-on.
+	EnableVideoHashLogging();
+	system->Initialize();
+	started = true;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessRunner::ExecuteFrames(unsigned int frameCount)
+{
+	if(!started)
+	{
+		return;
+	}
+
+	//Advance the system by one frame of emulated time at a time, up to the requested
+	//frame count or the end of the frame budget for this job, whichever comes first.
+	//The system is idle between each step, so the committed state of every device is
+	//stable while we hash it.
+	long long sliceStartTime = GetHighResolutionTimeInNanoseconds();
+	unsigned int framesRemaining = job.frameCount - nextFrameNo;
+	unsigned int framesToExecute = (frameCount < framesRemaining)? frameCount: framesRemaining;
+	for(unsigned int i = 0; i < framesToExecute; ++i)
+	{
+		system->ExecuteSystemStep(job.frameTimeInNanoseconds);
+		if((nextFrameNo % job.hashInterval) == 0)
+		{
+			RecordStateHashes(nextFrameNo);
+		}
+		++nextFrameNo;
+	}
+	executionTime += GetHighResolutionTimeInNanoseconds() - sliceStartTime;
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessRunner::IsComplete() const
+{
+	return !started || (nextFrameNo >= job.frameCount);
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessRunner::Finish()
+{
+	result.framesExecuted = nextFrameNo;
+	result.executionTimeInSeconds = (double)executionTime / 1000000000.0;
+	if(started)
+	{
+		//Merge the video hashes into the state hash log, and save it.
+		MergeVideoHashLogs();
+		if(!job.outputLogPath.empty() && !stateHashLog.SaveToFile(job.outputLogPath))
+		{
+			result.errorString = L"Failed to save state hash log to " + job.outputLogPath;
+		}
+
+		//Compare the state hash log against the golden file, if one was given.
+		if(!job.comparisonLogPath.empty())
+		{
+			StateHashLog expectedLog;
+			if(!expectedLog.LoadFromFile(job.comparisonLogPath))
+			{
+				result.errorString = L"Failed to load state hash log from " + job.comparisonLogPath;
+			}
+			else
+			{
+				result.compared = true;
+				result.diverged = StateHashLog::FindFirstDivergence(expectedLog, stateHashLog, result.divergence);
+			}
+		}
+	}
+
+	//Collect the event log from the system, oldest entry first, then destroy the system.
+	if(system != 0)
+	{
+		std::vector<ISystemGUIInterface::SystemLogEntry> eventLog = system->GetEventLog();
+		for(std::vector<ISystemGUIInterface::SystemLogEntry>::const_reverse_iterator i = eventLog.rbegin(); i != eventLog.rend(); ++i)
+		{
+			result.log.push_back(i->eventTimeString + L" " + i->eventLevelString + L" " + i->source + L": " + i->text);
+		}
+	}
+	DestroySystem();
+	result.succeeded = started && result.errorString.empty();
+}
+
+//----------------------------------------------------------------------------------------
+//Result functions
+//----------------------------------------------------------------------------------------
+const HeadlessResult& HeadlessRunner::GetResult() const
+{
+	return result;
+}
+
+//----------------------------------------------------------------------------------------
+//Frame timing functions
+//----------------------------------------------------------------------------------------
+double HeadlessRunner::GetFrameTimeInNanoseconds(bool palTiming)
+{
+	//The Mega Drive VDP runs each line for 3420 master clock cycles, with 262 lines in
+	//each frame on an NTSC system, and 313 lines on a PAL system. This gives frame rates
+	//of around 59.92Hz and 49.70Hz respectively.
+	static const double ntscMasterClockFrequency = 53693175.0;
+	static const double palMasterClockFrequency = 53203424.0;
+	static const double masterClockCyclesPerLine = 3420.0;
+	return palTiming? (1000000000.0 * masterClockCyclesPerLine * 313.0) / palMasterClockFrequency: (1000000000.0 * masterClockCyclesPerLine * 262.0) / ntscMasterClockFrequency;
+}
+
+//----------------------------------------------------------------------------------------
+//State hash functions
+//----------------------------------------------------------------------------------------
+void HeadlessRunner::RecordStateHashes(unsigned int frameNo)
+{
+	//Hash the saved state of every device in the system. This covers the processor
+	//registers, the contents of each memory device, and the register state of each
+	//sound device, using the same data a savestate would contain.
+	result.finalStateHashes.clear();
+	std::list<IDevice*> devices = system->GetLoadedDevices();
+	for(std::list<IDevice*>::const_iterator i = devices.begin(); i != devices.end(); ++i)
+	{
+		HierarchicalStorageTree tree;
+		IHierarchicalStorageNode& node = tree.GetRootNode();
+		(*i)->SaveState(node);
+		unsigned long long hash = StateHashLog::CalculateNodeHash(StateHashLog::InitialHashValue, node);
+		std::wstring componentName = (*i)->GetFullyQualifiedDeviceInstanceName();
+		stateHashLog.AddEntry(frameNo, componentName, hash);
+		result.finalStateHashes[componentName] = hash;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessRunner::EnableVideoHashLogging()
+{
+	//Video hashes are written by each VDP from its render thread into a log file of its
+	//own, which we merge into the state hash log at the end of the run.
+	if(job.outputLogPath.empty())
+	{
+		return;
+	}
+	std::list<IDevice*> devices = system->GetLoadedDevices();
+	for(std::list<IDevice*>::const_iterator i = devices.begin(); i != devices.end(); ++i)
+	{
+		IS315_5313* vdp = dynamic_cast<IS315_5313*>(*i);
+		if(vdp == 0)
+		{
+			continue;
+		}
+		std::wstringstream filePathStream;
+		filePathStream << job.outputLogPath << L".video" << (unsigned int)videoHashLogs.size();
+		VideoHashLogInfo videoHashLogInfo;
+		videoHashLogInfo.device = *i;
+		videoHashLogInfo.vdp = vdp;
+		videoHashLogInfo.componentNamePrefix = (*i)->GetFullyQualifiedDeviceInstanceName();
+		videoHashLogInfo.filePath = filePathStream.str();
+		vdp->SetFrameHashInterval(job.hashInterval);
+		vdp->SetFrameHashComparisonPath(L"");
+		vdp->SetFrameHashLoggingPath(videoHashLogInfo.filePath);
+		vdp->SetFrameHashLoggingEnabled(true);
+		videoHashLogs.push_back(videoHashLogInfo);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessRunner::MergeVideoHashLogs()
+{
+	//Stop video hash logging, which closes each log file, then merge each log into the
+	//state hash log. Video hashes are keyed by the VDP frame number rather than the step
+	//number, which is why the step length defaults to one VDP frame. Since the frames are
+	//hashed by the render thread, we suspend execution of each VDP first, which only
+	//returns once the render thread has processed every committed timeslice. This ensures
+	//each log holds every frame the run completed, so logs from separate runs can be
+	//compared frame for frame.
+	for(unsigned int i = 0; i < (unsigned int)videoHashLogs.size(); ++i)
+	{
+		const VideoHashLogInfo& videoHashLogInfo = videoHashLogs[i];
+		videoHashLogInfo.device->SuspendExecution();
+		videoHashLogInfo.vdp->SetFrameHashLoggingEnabled(false);
+		if(!LoadVideoHashLog(videoHashLogInfo.filePath, videoHashLogInfo.componentNamePrefix, stateHashLog))
+		{
+			result.errorString = L"Failed to load video hash log from " + videoHashLogInfo.filePath;
+		}
+		DeleteFile(videoHashLogInfo.filePath.c_str());
+	}
+	videoHashLogs.clear();
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessRunner::LoadVideoHashLog(const std::wstring& filePath, const std::wstring& componentNamePrefix, StateHashLog& stateHashLog)
+{
+	//Each line of a VDP frame hash log holds the frame number, followed by the hashes of
+	//the image, VRAM, CRAM, and VSRAM in that order.
+	Stream::File source;
+	if(!source.Open(filePath, Stream::File::OpenMode::ReadOnly, Stream::File::CreateMode::Open))
+	{
+		return false;
+	}
+	source.SetTextEncoding(Stream::IStream::TextEncoding::UTF8);
+	Stream::ViewText sourceView(source);
+	while(!sourceView.IsAtEnd())
+	{
+		std::wstring line;
+		if(!sourceView.ReadTextString(line))
+		{
+			break;
+		}
+		std::wstringstream lineStream(line);
+		unsigned int frameNo;
+		unsigned long long imageHash;
+		unsigned long long vramHash;
+		unsigned long long cramHash;
+		unsigned long long vsramHash;
+		if(lineStream >> frameNo >> imageHash >> vramHash >> cramHash >> vsramHash)
+		{
+			stateHashLog.AddEntry(frameNo, componentNamePrefix + L".Image", imageHash);
+			stateHashLog.AddEntry(frameNo, componentNamePrefix + L".VRAM", vramHash);
+			stateHashLog.AddEntry(frameNo, componentNamePrefix + L".CRAM", cramHash);
+			stateHashLog.AddEntry(frameNo, componentNamePrefix + L".VSRAM", vsramHash);
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+//System functions
+//----------------------------------------------------------------------------------------
+void HeadlessRunner::DestroySystem()
+{
+	if(system != 0)
+	{
+		headlessInterface.UnbindFromSystem();
+		systemDestructor(system);
+		system = 0;
+	}
+}
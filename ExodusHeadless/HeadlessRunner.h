@@ -0,0 +1,68 @@
+#ifndef __HEADLESSRUNNER_H__
+#define __HEADLESSRUNNER_H__
+#include "SystemInterface/SystemInterface.pkg"
+#include "315-5313/IS315_5313.h"
+#include "HeadlessInterface.h"
+#include "StateHashLog.h"
+#include "IBatchTask.h"
+#include "HeadlessJob.h"
+#include <string>
+#include <vector>
+#include <map>
+
+//A headless runner drives one system instance without a user interface. It loads a set of
+//modules, initializes the system, then advances it one frame of emulated time at a time
+//for a fixed number of frames, with no input applied. After every Nth frame the saved
+//state of each device is hashed into a state hash log, alongside the per-frame video
+//hashes recorded by any VDP in the system. The log can be saved as a golden file, or
+//compared against a golden file from an earlier run to find the first frame and the
+//components where the two runs diverged.
+class HeadlessRunner :public IBatchTask
+{
+public:
+	//Constructors
+	HeadlessRunner(ISystemInfo::AllocatorPointer asystemAllocator, ISystemInfo::DestructorPointer asystemDestructor, const HeadlessJob& ajob);
+	virtual ~HeadlessRunner();
+
+	//Execution functions
+	virtual bool Start();
+	virtual void ExecuteFrames(unsigned int frameCount);
+	virtual bool IsComplete() const;
+	virtual void Finish();
+
+	//Result functions
+	const HeadlessResult& GetResult() const;
+
+	//Frame timing functions
+	static double GetFrameTimeInNanoseconds(bool palTiming);
+
+private:
+	//Structures
+	struct VideoHashLogInfo;
+
+private:
+	//State hash functions
+	void RecordStateHashes(unsigned int frameNo);
+	void EnableVideoHashLogging();
+	void MergeVideoHashLogs();
+	static bool LoadVideoHashLog(const std::wstring& filePath, const std::wstring& componentNamePrefix, StateHashLog& stateHashLog);
+
+	//System functions
+	void DestroySystem();
+
+private:
+	ISystemInfo::AllocatorPointer systemAllocator;
+	ISystemInfo::DestructorPointer systemDestructor;
+	ISystemGUIInterface* system;
+	HeadlessInterface headlessInterface;
+	HeadlessJob job;
+	HeadlessResult result;
+	StateHashLog stateHashLog;
+	std::vector<VideoHashLogInfo> videoHashLogs;
+	bool started;
+	unsigned int nextFrameNo;
+	long long executionTime;
+};
+
+#include "HeadlessRunner.inl"
+#endif
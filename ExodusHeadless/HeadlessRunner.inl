@@ -0,0 +1,10 @@
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+struct HeadlessRunner::VideoHashLogInfo
+{
+	IDevice* device;
+	IS315_5313* vdp;
+	std::wstring componentNamePrefix;
+	std::wstring filePath;
+};
@@ -0,0 +1,49 @@
+#include "HeadlessViewManager.h"
+
+//----------------------------------------------------------------------------------------
+//Interface version functions
+//----------------------------------------------------------------------------------------
+unsigned int HeadlessViewManager::GetIViewManagerVersion() const
+{
+	return ThisIViewManagerVersion();
+}
+
+//----------------------------------------------------------------------------------------
+//View management functions
+//----------------------------------------------------------------------------------------
+bool HeadlessViewManager::OpenView(IViewPresenter& aviewPresenter, bool waitToClose)
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessViewManager::OpenView(IViewPresenter& aviewPresenter, IHierarchicalStorageNode& viewState, bool waitToClose)
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessViewManager::CloseView(IViewPresenter& aviewPresenter, bool waitToClose)
+{}
+
+//----------------------------------------------------------------------------------------
+void HeadlessViewManager::ShowView(IViewPresenter& aviewPresenter)
+{}
+
+//----------------------------------------------------------------------------------------
+void HeadlessViewManager::HideView(IViewPresenter& aviewPresenter)
+{}
+
+//----------------------------------------------------------------------------------------
+void HeadlessViewManager::ActivateView(IViewPresenter& aviewPresenter)
+{}
+
+//----------------------------------------------------------------------------------------
+bool HeadlessViewManager::WaitUntilViewOpened(IViewPresenter& aviewPresenter)
+{
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+void HeadlessViewManager::WaitUntilViewClosed(IViewPresenter& aviewPresenter)
+{}
@@ -0,0 +1,25 @@
+#ifndef __HEADLESSVIEWMANAGER_H__
+#define __HEADLESSVIEWMANAGER_H__
+#include "ExtensionInterface/ExtensionInterface.pkg"
+
+//The headless view manager refuses every request to open a view. Extensions still hold a
+//view manager reference for their menu handlers, but no menus are built when running
+//headless, so no views are ever requested through them.
+class HeadlessViewManager :public IViewManager
+{
+public:
+	//Interface version functions
+	virtual unsigned int GetIViewManagerVersion() const;
+
+	//View management functions
+	virtual bool OpenView(IViewPresenter& aviewPresenter, bool waitToClose = true);
+	virtual bool OpenView(IViewPresenter& aviewPresenter, IHierarchicalStorageNode& viewState, bool waitToClose = true);
+	virtual void CloseView(IViewPresenter& aviewPresenter, bool waitToClose = true);
+	virtual void ShowView(IViewPresenter& aviewPresenter);
+	virtual void HideView(IViewPresenter& aviewPresenter);
+	virtual void ActivateView(IViewPresenter& aviewPresenter);
+	virtual bool WaitUntilViewOpened(IViewPresenter& aviewPresenter);
+	virtual void WaitUntilViewClosed(IViewPresenter& aviewPresenter);
+};
+
+#endif
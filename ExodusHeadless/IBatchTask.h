@@ -0,0 +1,21 @@
+#ifndef __IBATCHTASK_H__
+#define __IBATCHTASK_H__
+
+//A batch task is a unit of work which advances in frames, such as one headless system
+//running a ROM. The batch scheduler starts each task, advances it in slices of frames
+//until it reports that it's complete, then finishes it. All calls for a given task are
+//made from one worker thread at a time, but not necessarily from the same thread.
+class IBatchTask
+{
+public:
+	//Constructors
+	virtual ~IBatchTask() = 0 {}
+
+	//Execution functions
+	virtual bool Start() = 0;
+	virtual void ExecuteFrames(unsigned int frameCount) = 0;
+	virtual bool IsComplete() const = 0;
+	virtual void Finish() = 0;
+};
+
+#endif
@@ -0,0 +1,282 @@
+#include "StateHashLog.h"
+#include "Stream/Stream.pkg"
+#include <sstream>
+#include <iomanip>
+
+//----------------------------------------------------------------------------------------
+//Log functions
+//----------------------------------------------------------------------------------------
+void StateHashLog::Clear()
+{
+	frames.clear();
+}
+
+//----------------------------------------------------------------------------------------
+bool StateHashLog::IsEmpty() const
+{
+	return frames.empty();
+}
+
+//----------------------------------------------------------------------------------------
+void StateHashLog::AddEntry(unsigned int frameNo, const std::wstring& componentName, unsigned long long hash)
+{
+	frames[frameNo][componentName] = hash;
+}
+
+//----------------------------------------------------------------------------------------
+bool StateHashLog::GetEntry(unsigned int frameNo, const std::wstring& componentName, unsigned long long& hash) const
+{
+	FrameMap::const_iterator frameIterator = frames.find(frameNo);
+	if(frameIterator == frames.end())
+	{
+		return false;
+	}
+	ComponentHashMap::const_iterator componentIterator = frameIterator->second.find(componentName);
+	if(componentIterator == frameIterator->second.end())
+	{
+		return false;
+	}
+	hash = componentIterator->second;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool StateHashLog::GetFrameEntries(unsigned int frameNo, std::map<std::wstring, unsigned long long>& componentHashes) const
+{
+	FrameMap::const_iterator frameIterator = frames.find(frameNo);
+	if(frameIterator == frames.end())
+	{
+		return false;
+	}
+	componentHashes = frameIterator->second;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int StateHashLog::GetFrameCount() const
+{
+	return (unsigned int)frames.size();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int StateHashLog::GetLastFrameNo() const
+{
+	return frames.empty()? 0: frames.rbegin()->first;
+}
+
+//----------------------------------------------------------------------------------------
+//Save/Load functions
+//----------------------------------------------------------------------------------------
+bool StateHashLog::SaveToFile(const std::wstring& filePath) const
+{
+	Stream::File target;
+	if(!target.Open(filePath, Stream::File::OpenMode::ReadAndWrite, Stream::File::CreateMode::Create))
+	{
+		return false;
+	}
+	target.SetTextEncoding(Stream::IStream::TextEncoding::UTF8);
+	return Save(target);
+}
+
+//----------------------------------------------------------------------------------------
+bool StateHashLog::LoadFromFile(const std::wstring& filePath)
+{
+	Stream::File source;
+	if(!source.Open(filePath, Stream::File::OpenMode::ReadOnly, Stream::File::CreateMode::Open))
+	{
+		return false;
+	}
+	source.SetTextEncoding(Stream::IStream::TextEncoding::UTF8);
+	return Load(source);
+}
+
+//----------------------------------------------------------------------------------------
+bool StateHashLog::Save(Stream::IStream& target) const
+{
+	//Each line of the log holds the frame number, the component name, and the hash value
+	//in hex, separated by tabs. Entries are written in frame order, and within each frame
+	//in component name order, so that logs from two runs can also be compared as text.
+	Stream::ViewText targetView(target);
+	for(FrameMap::const_iterator frameIterator = frames.begin(); frameIterator != frames.end(); ++frameIterator)
+	{
+		for(ComponentHashMap::const_iterator componentIterator = frameIterator->second.begin(); componentIterator != frameIterator->second.end(); ++componentIterator)
+		{
+			std::wstringstream lineStream;
+			lineStream << frameIterator->first << L'\t' << componentIterator->first << L'\t' << std::hex << std::setw(16) << std::setfill(L'0') << componentIterator->second << L'\n';
+			targetView << lineStream.str();
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool StateHashLog::Load(Stream::IStream& source)
+{
+	frames.clear();
+	Stream::ViewText sourceView(source);
+	while(!sourceView.IsAtEnd())
+	{
+		std::wstring line;
+		if(!sourceView.ReadTextString(line))
+		{
+			break;
+		}
+		if(line.empty())
+		{
+			continue;
+		}
+
+		//Split the line into its frame number, component name, and hash value fields.
+		//Component names are fully qualified device names, which may contain spaces, so we
+		//only split on tabs here.
+		std::wstring::size_type firstSeparatorPos = line.find(L'\t');
+		std::wstring::size_type lastSeparatorPos = line.rfind(L'\t');
+		if((firstSeparatorPos == std::wstring::npos) || (firstSeparatorPos == lastSeparatorPos))
+		{
+			return false;
+		}
+		unsigned int frameNo;
+		unsigned long long hash;
+		std::wstringstream frameNoStream(line.substr(0, firstSeparatorPos));
+		std::wstringstream hashStream(line.substr(lastSeparatorPos + 1));
+		if(!(frameNoStream >> frameNo) || !(hashStream >> std::hex >> hash))
+		{
+			return false;
+		}
+		frames[frameNo][line.substr(firstSeparatorPos + 1, lastSeparatorPos - (firstSeparatorPos + 1))] = hash;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+//Comparison functions
+//----------------------------------------------------------------------------------------
+bool StateHashLog::FindFirstDivergence(const StateHashLog& expectedLog, const StateHashLog& actualLog, Divergence& divergence)
+{
+	//Step through the frames recorded in either log in order. A frame or component which
+	//was recorded in only one of the logs counts as a divergence, just like a hash
+	//mismatch, so a run which ends early, skips a frame, or stops recording a component
+	//is reported at the first frame where this occurs.
+	static const ComponentHashMap emptyComponents;
+	FrameMap::const_iterator expectedFrameIterator = expectedLog.frames.begin();
+	FrameMap::const_iterator actualFrameIterator = actualLog.frames.begin();
+	while((expectedFrameIterator != expectedLog.frames.end()) || (actualFrameIterator != actualLog.frames.end()))
+	{
+		//Select the next frame number to compare, and the components recorded for that
+		//frame in each log.
+		bool expectedFramePresent = (expectedFrameIterator != expectedLog.frames.end()) && ((actualFrameIterator == actualLog.frames.end()) || (expectedFrameIterator->first <= actualFrameIterator->first));
+		bool actualFramePresent = (actualFrameIterator != actualLog.frames.end()) && ((expectedFrameIterator == expectedLog.frames.end()) || (actualFrameIterator->first <= expectedFrameIterator->first));
+		unsigned int frameNo = expectedFramePresent? expectedFrameIterator->first: actualFrameIterator->first;
+		const ComponentHashMap& expectedComponents = expectedFramePresent? expectedFrameIterator->second: emptyComponents;
+		const ComponentHashMap& actualComponents = actualFramePresent? actualFrameIterator->second: emptyComponents;
+
+		//Merge the two sorted component lists, recording each component which is missing
+		//from either log, or which has a different hash value.
+		std::vector<std::wstring> divergentComponentNames;
+		ComponentHashMap::const_iterator expectedComponentIterator = expectedComponents.begin();
+		ComponentHashMap::const_iterator actualComponentIterator = actualComponents.begin();
+		while((expectedComponentIterator != expectedComponents.end()) || (actualComponentIterator != actualComponents.end()))
+		{
+			if((actualComponentIterator == actualComponents.end()) || ((expectedComponentIterator != expectedComponents.end()) && (expectedComponentIterator->first < actualComponentIterator->first)))
+			{
+				divergentComponentNames.push_back(expectedComponentIterator->first);
+				++expectedComponentIterator;
+			}
+			else if((expectedComponentIterator == expectedComponents.end()) || (actualComponentIterator->first < expectedComponentIterator->first))
+			{
+				divergentComponentNames.push_back(actualComponentIterator->first);
+				++actualComponentIterator;
+			}
+			else
+			{
+				if(expectedComponentIterator->second != actualComponentIterator->second)
+				{
+					divergentComponentNames.push_back(expectedComponentIterator->first);
+				}
+				++expectedComponentIterator;
+				++actualComponentIterator;
+			}
+		}
+
+		if(!divergentComponentNames.empty())
+		{
+			divergence.frameNo = frameNo;
+			divergence.componentNames = divergentComponentNames;
+			return true;
+		}
+
+		if(expectedFramePresent)
+		{
+			++expectedFrameIterator;
+		}
+		if(actualFramePresent)
+		{
+			++actualFrameIterator;
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+//Hash functions
+//----------------------------------------------------------------------------------------
+unsigned long long StateHashLog::CalculateHash(unsigned long long hash, const unsigned char* data, size_t dataSize)
+{
+	//Accumulate the data into a 64-bit FNV-1a hash
+	static const unsigned long long hashPrime = 1099511628211ULL;
+	for(size_t i = 0; i < dataSize; ++i)
+	{
+		hash = (hash ^ data[i]) * hashPrime;
+	}
+	return hash;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned long long StateHashLog::CalculateHash(unsigned long long hash, const std::wstring& data)
+{
+	//Include the length of the string, so that adjacent strings can't be shifted between
+	//each other without changing the hash.
+	unsigned int length = (unsigned int)data.size();
+	hash = CalculateHash(hash, (const unsigned char*)&length, sizeof(length));
+	return (length > 0)? CalculateHash(hash, (const unsigned char*)data.data(), data.size() * sizeof(wchar_t)): hash;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned long long StateHashLog::CalculateNodeHash(unsigned long long hash, IHierarchicalStorageNode& node)
+{
+	//Hash the name, attributes, and data of this node
+	hash = CalculateHash(hash, node.GetName());
+	std::list<IHierarchicalStorageAttribute*> attributeList = node.GetAttributeList();
+	for(std::list<IHierarchicalStorageAttribute*>::const_iterator i = attributeList.begin(); i != attributeList.end(); ++i)
+	{
+		hash = CalculateHash(hash, (*i)->GetName());
+		hash = CalculateHash(hash, (*i)->GetValue());
+	}
+	hash = CalculateHash(hash, node.GetData());
+
+	//Hash any binary data attached to this node. Devices save their memory buffers as
+	//binary data, so this is where the bulk of the state for RAM devices lives.
+	if(node.GetBinaryDataPresent())
+	{
+		Stream::IStream& binaryDataStream = node.GetBinaryDataBufferStream();
+		Stream::IStream::SizeType binaryDataSize = binaryDataStream.Size();
+		if(binaryDataSize > 0)
+		{
+			std::vector<unsigned char> binaryData((size_t)binaryDataSize);
+			binaryDataStream.SetStreamPos(0);
+			if(binaryDataStream.ReadData(&binaryData[0], binaryDataSize))
+			{
+				hash = CalculateHash(hash, &binaryData[0], binaryData.size());
+			}
+			binaryDataStream.SetStreamPos(0);
+		}
+	}
+
+	//Hash each child node in order
+	std::list<IHierarchicalStorageNode*> childList = node.GetChildList();
+	for(std::list<IHierarchicalStorageNode*>::const_iterator i = childList.begin(); i != childList.end(); ++i)
+	{
+		hash = CalculateNodeHash(hash, *(*i));
+	}
+	return hash;
+}
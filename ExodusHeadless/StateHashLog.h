@@ -0,0 +1,56 @@
+#ifndef __STATEHASHLOG_H__
+#define __STATEHASHLOG_H__
+#include "StreamInterface/StreamInterface.pkg"
+#include "HierarchicalStorageInterface/HierarchicalStorageInterface.pkg"
+#include <string>
+#include <vector>
+#include <map>
+
+//A state hash log records a 64-bit FNV-1a hash for each named component of an emulated
+//system, for a series of numbered frames. A log captured from a known good build can be
+//compared against a log generated by a new build, to find the first frame and the
+//components where the two runs diverged.
+class StateHashLog
+{
+public:
+	//Structures
+	struct Divergence;
+
+	//Constants
+	static const unsigned long long InitialHashValue = 14695981039346656037ULL;
+
+public:
+	//Log functions
+	void Clear();
+	bool IsEmpty() const;
+	void AddEntry(unsigned int frameNo, const std::wstring& componentName, unsigned long long hash);
+	bool GetEntry(unsigned int frameNo, const std::wstring& componentName, unsigned long long& hash) const;
+	bool GetFrameEntries(unsigned int frameNo, std::map<std::wstring, unsigned long long>& componentHashes) const;
+	unsigned int GetFrameCount() const;
+	unsigned int GetLastFrameNo() const;
+
+	//Save/Load functions
+	bool SaveToFile(const std::wstring& filePath) const;
+	bool LoadFromFile(const std::wstring& filePath);
+	bool Save(Stream::IStream& target) const;
+	bool Load(Stream::IStream& source);
+
+	//Comparison functions
+	static bool FindFirstDivergence(const StateHashLog& expectedLog, const StateHashLog& actualLog, Divergence& divergence);
+
+	//Hash functions
+	static unsigned long long CalculateHash(unsigned long long hash, const unsigned char* data, size_t dataSize);
+	static unsigned long long CalculateHash(unsigned long long hash, const std::wstring& data);
+	static unsigned long long CalculateNodeHash(unsigned long long hash, IHierarchicalStorageNode& node);
+
+private:
+	//Typedefs
+	typedef std::map<std::wstring, unsigned long long> ComponentHashMap;
+	typedef std::map<unsigned int, ComponentHashMap> FrameMap;
+
+private:
+	FrameMap frames;
+};
+
+#include "StateHashLog.inl"
+#endif
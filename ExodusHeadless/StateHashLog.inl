@@ -0,0 +1,12 @@
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+struct StateHashLog::Divergence
+{
+	Divergence()
+	:frameNo(0)
+	{}
+
+	unsigned int frameNo;
+	std::vector<std::wstring> componentNames;
+};
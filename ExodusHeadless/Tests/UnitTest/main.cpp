@@ -0,0 +1,338 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "StateHashLog.h"
+#include "BatchScheduler.h"
+#include "Stream/Stream.pkg"
+#include "HierarchicalStorage/HierarchicalStorage.pkg"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+//----------------------------------------------------------------------------------------
+//Helper classes
+//----------------------------------------------------------------------------------------
+//A batch task which counts the frames it's asked to execute, and records how many tasks
+//were executing at once across all tasks sharing the same counters.
+class TestBatchTask :public IBatchTask
+{
+public:
+	TestBatchTask(unsigned int aframeCount, bool astartSucceeds, std::mutex& acounterMutex, unsigned int& aactiveTaskCount, unsigned int& amaxActiveTaskCount, std::vector<TestBatchTask*>& asliceOrder)
+	:frameCount(aframeCount), startSucceeds(astartSucceeds), counterMutex(acounterMutex), activeTaskCount(aactiveTaskCount), maxActiveTaskCount(amaxActiveTaskCount), sliceOrder(asliceOrder), startCount(0), finishCount(0), executeCount(0), framesExecuted(0)
+	{}
+
+	virtual bool Start()
+	{
+		++startCount;
+		return startSucceeds;
+	}
+	virtual void ExecuteFrames(unsigned int aframeCount)
+	{
+		{
+			std::unique_lock<std::mutex> lock(counterMutex);
+			sliceOrder.push_back(this);
+			++activeTaskCount;
+			maxActiveTaskCount = (activeTaskCount > maxActiveTaskCount)? activeTaskCount: maxActiveTaskCount;
+		}
+		++executeCount;
+		unsigned int framesRemaining = frameCount - framesExecuted;
+		framesExecuted += (aframeCount < framesRemaining)? aframeCount: framesRemaining;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		{
+			std::unique_lock<std::mutex> lock(counterMutex);
+			--activeTaskCount;
+		}
+	}
+	virtual bool IsComplete() const
+	{
+		return !startSucceeds || (framesExecuted >= frameCount);
+	}
+	virtual void Finish()
+	{
+		++finishCount;
+	}
+
+public:
+	unsigned int frameCount;
+	bool startSucceeds;
+	std::mutex& counterMutex;
+	unsigned int& activeTaskCount;
+	unsigned int& maxActiveTaskCount;
+	std::vector<TestBatchTask*>& sliceOrder;
+	unsigned int startCount;
+	unsigned int finishCount;
+	unsigned int executeCount;
+	unsigned int framesExecuted;
+};
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+//Builds a small storage tree resembling a saved device state, with a register attribute,
+//some text data, and a binary memory buffer.
+static void BuildTestStateTree(IHierarchicalStorageNode& rootNode, unsigned int registerValue, const std::wstring& data, unsigned char memoryByte)
+{
+	rootNode.SetName(L"State");
+	rootNode.CreateChild(L"Register", data).CreateAttribute(L"name", L"PC").CreateAttribute(L"value", registerValue);
+	std::vector<unsigned char> memory(256, 0);
+	memory[0x80] = memoryByte;
+	rootNode.CreateChildBinary(L"Memory", memory, L"Memory");
+}
+
+//----------------------------------------------------------------------------------------
+static unsigned long long CalculateTestStateTreeHash(unsigned int registerValue, const std::wstring& data, unsigned char memoryByte)
+{
+	HierarchicalStorageTree tree;
+	BuildTestStateTree(tree.GetRootNode(), registerValue, data, memoryByte);
+	return StateHashLog::CalculateNodeHash(StateHashLog::InitialHashValue, tree.GetRootNode());
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("StateHashLog::SaveLoad", "")
+{
+	StateHashLog log;
+	log.AddEntry(0, L"System.M68000", 0x0123456789ABCDEFULL);
+	log.AddEntry(0, L"System.Main RAM", 0x0000000000000001ULL);
+	log.AddEntry(10, L"System.M68000", 0xFEDCBA9876543210ULL);
+	log.AddEntry(10, L"System.VDP.Image", 0xFFFFFFFFFFFFFFFFULL);
+
+	//Save the log to a buffer, and load it back into a new log
+	Stream::Buffer buffer(Stream::IStream::TextEncoding::UTF8, 0);
+	REQUIRE(log.Save(buffer));
+	buffer.SetStreamPos(0);
+	StateHashLog loadedLog;
+	REQUIRE(loadedLog.Load(buffer));
+
+	//Ensure every entry survived the round trip, including names with spaces in them.
+	REQUIRE(loadedLog.GetFrameCount() == 2);
+	REQUIRE(loadedLog.GetLastFrameNo() == 10);
+	unsigned long long hash;
+	REQUIRE(loadedLog.GetEntry(0, L"System.M68000", hash));
+	REQUIRE(hash == 0x0123456789ABCDEFULL);
+	REQUIRE(loadedLog.GetEntry(0, L"System.Main RAM", hash));
+	REQUIRE(hash == 0x0000000000000001ULL);
+	REQUIRE(loadedLog.GetEntry(10, L"System.M68000", hash));
+	REQUIRE(hash == 0xFEDCBA9876543210ULL);
+	REQUIRE(loadedLog.GetEntry(10, L"System.VDP.Image", hash));
+	REQUIRE(hash == 0xFFFFFFFFFFFFFFFFULL);
+	REQUIRE(!loadedLog.GetEntry(5, L"System.M68000", hash));
+	StateHashLog::Divergence divergence;
+	REQUIRE(!StateHashLog::FindFirstDivergence(log, loadedLog, divergence));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("StateHashLog::FindFirstDivergence", "")
+{
+	StateHashLog expectedLog;
+	StateHashLog actualLog;
+	for(unsigned int frameNo = 0; frameNo < 100; frameNo += 10)
+	{
+		expectedLog.AddEntry(frameNo, L"CPU", frameNo);
+		expectedLog.AddEntry(frameNo, L"RAM", frameNo * 2);
+		expectedLog.AddEntry(frameNo, L"PSG", frameNo * 3);
+		actualLog.AddEntry(frameNo, L"CPU", frameNo);
+		actualLog.AddEntry(frameNo, L"RAM", frameNo * 2);
+		actualLog.AddEntry(frameNo, L"PSG", frameNo * 3);
+	}
+
+	SECTION("Identical logs", "")
+	{
+		StateHashLog::Divergence divergence;
+		REQUIRE(!StateHashLog::FindFirstDivergence(expectedLog, actualLog, divergence));
+	}
+
+	SECTION("Reports the first divergent frame and every divergent component in it", "")
+	{
+		actualLog.AddEntry(70, L"CPU", 1);
+		actualLog.AddEntry(40, L"RAM", 1);
+		actualLog.AddEntry(40, L"PSG", 1);
+		StateHashLog::Divergence divergence;
+		REQUIRE(StateHashLog::FindFirstDivergence(expectedLog, actualLog, divergence));
+		REQUIRE(divergence.frameNo == 40);
+		REQUIRE(divergence.componentNames.size() == 2);
+		REQUIRE(divergence.componentNames[0] == L"PSG");
+		REQUIRE(divergence.componentNames[1] == L"RAM");
+	}
+
+	SECTION("Frames missing from either log are divergent", "")
+	{
+		//Drop a frame from the middle of the log, and ensure it's reported in both
+		//directions, along with every component recorded for it.
+		StateHashLog gapLog;
+		for(unsigned int frameNo = 0; frameNo < 100; frameNo += 10)
+		{
+			if(frameNo != 30)
+			{
+				gapLog.AddEntry(frameNo, L"CPU", frameNo);
+				gapLog.AddEntry(frameNo, L"RAM", frameNo * 2);
+				gapLog.AddEntry(frameNo, L"PSG", frameNo * 3);
+			}
+		}
+		StateHashLog::Divergence divergence;
+		REQUIRE(StateHashLog::FindFirstDivergence(expectedLog, gapLog, divergence));
+		REQUIRE(divergence.frameNo == 30);
+		REQUIRE(divergence.componentNames.size() == 3);
+		StateHashLog::Divergence reverseDivergence;
+		REQUIRE(StateHashLog::FindFirstDivergence(gapLog, expectedLog, reverseDivergence));
+		REQUIRE(reverseDivergence.frameNo == 30);
+		REQUIRE(reverseDivergence.componentNames == divergence.componentNames);
+	}
+
+	SECTION("Logs which end on different frames are divergent", "")
+	{
+		StateHashLog extendedLog;
+		for(unsigned int frameNo = 0; frameNo < 100; frameNo += 10)
+		{
+			extendedLog.AddEntry(frameNo, L"CPU", frameNo);
+			extendedLog.AddEntry(frameNo, L"RAM", frameNo * 2);
+			extendedLog.AddEntry(frameNo, L"PSG", frameNo * 3);
+		}
+		extendedLog.AddEntry(500, L"CPU", 1);
+		StateHashLog::Divergence divergence;
+		REQUIRE(StateHashLog::FindFirstDivergence(expectedLog, extendedLog, divergence));
+		REQUIRE(divergence.frameNo == 500);
+		REQUIRE(divergence.componentNames.size() == 1);
+		REQUIRE(divergence.componentNames[0] == L"CPU");
+		REQUIRE(StateHashLog::FindFirstDivergence(extendedLog, expectedLog, divergence));
+		REQUIRE(divergence.frameNo == 500);
+	}
+
+	SECTION("Components missing from either log are divergent", "")
+	{
+		//Record an extra component in one log and drop a component from the other, in
+		//the same frame, and ensure both are reported along with a hash mismatch.
+		actualLog.AddEntry(20, L"VDP.Image", 1234);
+		StateHashLog partialLog;
+		for(unsigned int frameNo = 0; frameNo < 100; frameNo += 10)
+		{
+			partialLog.AddEntry(frameNo, L"CPU", (frameNo == 20)? 1: frameNo);
+			if(frameNo != 20)
+			{
+				partialLog.AddEntry(frameNo, L"RAM", frameNo * 2);
+			}
+			partialLog.AddEntry(frameNo, L"PSG", frameNo * 3);
+		}
+		StateHashLog::Divergence divergence;
+		REQUIRE(StateHashLog::FindFirstDivergence(partialLog, actualLog, divergence));
+		REQUIRE(divergence.frameNo == 20);
+		REQUIRE(divergence.componentNames.size() == 3);
+		REQUIRE(divergence.componentNames[0] == L"CPU");
+		REQUIRE(divergence.componentNames[1] == L"RAM");
+		REQUIRE(divergence.componentNames[2] == L"VDP.Image");
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("StateHashLog::CalculateNodeHash", "")
+{
+	unsigned long long baseHash = CalculateTestStateTreeHash(0x200, L"Data", 0x55);
+	REQUIRE(baseHash == CalculateTestStateTreeHash(0x200, L"Data", 0x55));
+	REQUIRE(baseHash != CalculateTestStateTreeHash(0x202, L"Data", 0x55));
+	REQUIRE(baseHash != CalculateTestStateTreeHash(0x200, L"Date", 0x55));
+	REQUIRE(baseHash != CalculateTestStateTreeHash(0x200, L"Data", 0x56));
+
+	//Ensure hashing a node leaves its binary data readable from the start
+	HierarchicalStorageTree tree;
+	BuildTestStateTree(tree.GetRootNode(), 0x200, L"Data", 0x55);
+	StateHashLog::CalculateNodeHash(StateHashLog::InitialHashValue, tree.GetRootNode());
+	REQUIRE(baseHash == StateHashLog::CalculateNodeHash(StateHashLog::InitialHashValue, tree.GetRootNode()));
+
+	//Ensure strings can't be shifted between adjacent fields without changing the hash
+	unsigned long long splitHash1 = StateHashLog::CalculateHash(StateHashLog::CalculateHash(StateHashLog::InitialHashValue, std::wstring(L"AB")), std::wstring(L"C"));
+	unsigned long long splitHash2 = StateHashLog::CalculateHash(StateHashLog::CalculateHash(StateHashLog::InitialHashValue, std::wstring(L"A")), std::wstring(L"BC"));
+	REQUIRE(splitHash1 != splitHash2);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("BatchScheduler::Run", "")
+{
+	std::mutex counterMutex;
+	unsigned int activeTaskCount = 0;
+	unsigned int maxActiveTaskCount = 0;
+	std::vector<TestBatchTask*> sliceOrder;
+	std::vector<TestBatchTask*> testTasks;
+	std::vector<IBatchTask*> tasks;
+	static const unsigned int taskCount = 6;
+	for(unsigned int i = 0; i < taskCount; ++i)
+	{
+		TestBatchTask* task = new TestBatchTask(100 + (i * 7), true, counterMutex, activeTaskCount, maxActiveTaskCount, sliceOrder);
+		testTasks.push_back(task);
+		tasks.push_back(task);
+	}
+
+	SECTION("Tasks run to completion without slicing", "")
+	{
+		BatchScheduler scheduler(2);
+		scheduler.Run(tasks);
+		for(unsigned int i = 0; i < taskCount; ++i)
+		{
+			REQUIRE(testTasks[i]->startCount == 1);
+			REQUIRE(testTasks[i]->finishCount == 1);
+			REQUIRE(testTasks[i]->executeCount == 1);
+			REQUIRE(testTasks[i]->framesExecuted == testTasks[i]->frameCount);
+		}
+		REQUIRE(maxActiveTaskCount <= 2);
+		REQUIRE(scheduler.GetSliceCount() == taskCount);
+	}
+
+	SECTION("Sliced tasks are time-shared in round-robin order", "")
+	{
+		BatchScheduler scheduler(1, 25);
+		scheduler.Run(tasks);
+		unsigned int expectedSliceCount = 0;
+		for(unsigned int i = 0; i < taskCount; ++i)
+		{
+			unsigned int expectedExecuteCount = (testTasks[i]->frameCount + 24) / 25;
+			REQUIRE(testTasks[i]->startCount == 1);
+			REQUIRE(testTasks[i]->finishCount == 1);
+			REQUIRE(testTasks[i]->executeCount == expectedExecuteCount);
+			REQUIRE(testTasks[i]->framesExecuted == testTasks[i]->frameCount);
+			expectedSliceCount += expectedExecuteCount;
+		}
+		REQUIRE(maxActiveTaskCount == 1);
+		REQUIRE(scheduler.GetSliceCount() == expectedSliceCount);
+
+		//With a single worker, the first round of slices must visit every task once, in
+		//order, before any task gets a second slice.
+		REQUIRE(sliceOrder.size() == expectedSliceCount);
+		for(unsigned int i = 0; i < taskCount; ++i)
+		{
+			REQUIRE(sliceOrder[i] == testTasks[i]);
+			REQUIRE(sliceOrder[i + taskCount] == testTasks[i]);
+		}
+	}
+
+	SECTION("Concurrency is limited to the worker count", "")
+	{
+		BatchScheduler scheduler(3, 10);
+		scheduler.Run(tasks);
+		for(unsigned int i = 0; i < taskCount; ++i)
+		{
+			REQUIRE(testTasks[i]->finishCount == 1);
+			REQUIRE(testTasks[i]->framesExecuted == testTasks[i]->frameCount);
+		}
+		REQUIRE(maxActiveTaskCount <= 3);
+	}
+
+	SECTION("Tasks which fail to start are still finished", "")
+	{
+		testTasks[2]->startSucceeds = false;
+		BatchScheduler scheduler(2, 10);
+		scheduler.Run(tasks);
+		REQUIRE(testTasks[2]->startCount == 1);
+		REQUIRE(testTasks[2]->finishCount == 1);
+		REQUIRE(testTasks[2]->executeCount == 0);
+		for(unsigned int i = 0; i < taskCount; ++i)
+		{
+			REQUIRE(testTasks[i]->finishCount == 1);
+		}
+	}
+
+	for(unsigned int i = 0; i < taskCount; ++i)
+	{
+		delete testTasks[i];
+	}
+}
@@ -0,0 +1,275 @@
+#include "WindowsSupport/WindowsSupport.pkg"
+#include "Debug/Debug.pkg"
+#include "SystemInterface/SystemInterface.pkg"
+#include "../Exodus/SystemInfo.h"
+#include "HeadlessInterface.h"
+#include "HeadlessRunner.h"
+#include "BatchScheduler.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+//----------------------------------------------------------------------------------------
+//Usage text
+//----------------------------------------------------------------------------------------
+static const wchar_t* usageText =
+L"Usage: ExodusHeadless [options] moduleFile... [-job name [options] moduleFile...]...\n"
+L"\n"
+L"Runs one or more systems without a user interface for a fixed number of frames, with\n"
+L"no input, recording a hash of the state of each device after every Nth frame. Options\n"
+L"given before the first -job apply to every job.\n"
+L"\n"
+L"  -plugins path       Folder to load device and extension plugins from\n"
+L"  -modules path       Folder to search for modules\n"
+L"  -frames count       Number of frames to run (default 600)\n"
+L"  -pal                Step by PAL frames rather than NTSC frames\n"
+L"  -hashinterval N     Record state hashes every N frames (default 1)\n"
+L"  -renderinterval N   Render the pixel output of every Nth VDP frame, or none if 0\n"
+L"                      (default 1). Video hashes are only recorded for rendered frames.\n"
+L"  -output path        Save the state hash log to this file\n"
+L"  -compare path       Compare the state hash log against this golden file\n"
+L"  -job name           Begin a new job\n"
+L"  -cores count        Maximum number of jobs to run at once\n"
+L"  -slice count        Time-share jobs, running each for this many frames at a time\n"
+L"  -verbose            Print the final state hashes and event log of every job\n";
+
+//----------------------------------------------------------------------------------------
+//Command line functions
+//----------------------------------------------------------------------------------------
+static bool ParseUnsignedInt(const std::wstring& text, unsigned int& value)
+{
+	std::wstringstream textStream(text);
+	return (textStream >> value) && textStream.eof();
+}
+
+//----------------------------------------------------------------------------------------
+static bool ParseCommandLine(int argc, wchar_t* argv[], std::vector<HeadlessJob>& jobs, unsigned int& workerCount, unsigned int& framesPerSlice, bool& verbose)
+{
+	//Set the default settings which all jobs start from. Plugins and modules are found
+	//relative to the working directory, in the same way as the main interface.
+	std::wstring workingDirectory = PathGetCurrentWorkingDirectory();
+	HeadlessJob defaultJob;
+	defaultJob.name = L"Default";
+	defaultJob.assemblyPath = PathCombinePaths(workingDirectory, L"Plugins");
+	defaultJob.modulePath = PathCombinePaths(workingDirectory, L"Modules");
+	defaultJob.frameCount = 600;
+	defaultJob.frameTimeInNanoseconds = HeadlessRunner::GetFrameTimeInNanoseconds(false);
+
+	//Process each argument in order. Options before the first job apply to the default
+	//settings, and options after it apply to the most recently started job.
+	HeadlessJob* currentJob = &defaultJob;
+	jobs.clear();
+	for(int i = 1; i < argc; ++i)
+	{
+		std::wstring argument = argv[i];
+		bool hasValue = (i + 1) < argc;
+		if((argument == L"-plugins") && hasValue)
+		{
+			currentJob->assemblyPath = argv[++i];
+		}
+		else if((argument == L"-modules") && hasValue)
+		{
+			currentJob->modulePath = argv[++i];
+		}
+		else if((argument == L"-frames") && hasValue)
+		{
+			if(!ParseUnsignedInt(argv[++i], currentJob->frameCount))
+			{
+				return false;
+			}
+		}
+		else if(argument == L"-pal")
+		{
+			currentJob->frameTimeInNanoseconds = HeadlessRunner::GetFrameTimeInNanoseconds(true);
+		}
+		else if((argument == L"-hashinterval") && hasValue)
+		{
+			if(!ParseUnsignedInt(argv[++i], currentJob->hashInterval) || (currentJob->hashInterval == 0))
+			{
+				return false;
+			}
+		}
+		else if((argument == L"-renderinterval") && hasValue)
+		{
+			if(!ParseUnsignedInt(argv[++i], currentJob->frameRenderInterval))
+			{
+				return false;
+			}
+		}
+		else if((argument == L"-output") && hasValue)
+		{
+			currentJob->outputLogPath = argv[++i];
+		}
+		else if((argument == L"-compare") && hasValue)
+		{
+			currentJob->comparisonLogPath = argv[++i];
+		}
+		else if((argument == L"-job") && hasValue)
+		{
+			HeadlessJob newJob = defaultJob;
+			newJob.name = argv[++i];
+			jobs.push_back(newJob);
+			currentJob = &jobs.back();
+		}
+		else if((argument == L"-cores") && hasValue)
+		{
+			if(!ParseUnsignedInt(argv[++i], workerCount) || (workerCount == 0))
+			{
+				return false;
+			}
+		}
+		else if((argument == L"-slice") && hasValue)
+		{
+			if(!ParseUnsignedInt(argv[++i], framesPerSlice))
+			{
+				return false;
+			}
+		}
+		else if(argument == L"-verbose")
+		{
+			verbose = true;
+		}
+		else if(!argument.empty() && (argument[0] == L'-'))
+		{
+			return false;
+		}
+		else
+		{
+			currentJob->moduleFilePaths.push_back(argument);
+		}
+	}
+
+	//If no jobs were explicitly started, run the default settings as a single job.
+	if(jobs.empty())
+	{
+		jobs.push_back(defaultJob);
+	}
+
+	//Every job needs at least one module to load
+	for(unsigned int i = 0; i < (unsigned int)jobs.size(); ++i)
+	{
+		if(jobs[i].moduleFilePaths.empty())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+//Output functions
+//----------------------------------------------------------------------------------------
+static void PrintResult(const HeadlessJob& job, const HeadlessResult& result, bool verbose)
+{
+	//Print the outcome of the job
+	std::wcout << job.name << L": ";
+	if(!result.succeeded)
+	{
+		std::wcout << L"FAILED - " << result.errorString << L"\n";
+	}
+	else if(result.diverged)
+	{
+		std::wcout << L"DIVERGED at frame " << result.divergence.frameNo << L" in";
+		for(unsigned int i = 0; i < (unsigned int)result.divergence.componentNames.size(); ++i)
+		{
+			std::wcout << L" \"" << result.divergence.componentNames[i] << L"\"";
+		}
+		std::wcout << L"\n";
+	}
+	else
+	{
+		std::wcout << (result.compared? L"MATCHED": L"COMPLETED") << L"\n";
+	}
+
+	//Print the execution statistics for the job
+	double framesPerSecond = (result.executionTimeInSeconds > 0.0)? ((double)result.framesExecuted / result.executionTimeInSeconds): 0.0;
+	std::wcout << L"  " << result.framesExecuted << L" frames in " << std::fixed << std::setprecision(3) << result.executionTimeInSeconds << L"s (" << std::setprecision(1) << framesPerSecond << L" frames/s)\n";
+
+	//Print the final state hashes and the event log, if requested. The event log is
+	//always printed for a failed job, since it holds the reason for the failure.
+	if(verbose)
+	{
+		for(std::map<std::wstring, unsigned long long>::const_iterator i = result.finalStateHashes.begin(); i != result.finalStateHashes.end(); ++i)
+		{
+			std::wcout << L"  " << std::hex << std::setw(16) << std::setfill(L'0') << i->second << std::dec << std::setfill(L' ') << L" " << i->first << L"\n";
+		}
+	}
+	if(verbose || !result.succeeded)
+	{
+		for(unsigned int i = 0; i < (unsigned int)result.log.size(); ++i)
+		{
+			std::wcout << L"  " << result.log[i] << L"\n";
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//wmain function
+//----------------------------------------------------------------------------------------
+int wmain(int argc, wchar_t* argv[])
+{
+	//Register our minidump exception handler
+	RegisterMinidumpExceptionHandler(L"ExodusHeadless", L"Crash Reports", false);
+
+	//Parse the command line into a list of jobs
+	std::vector<HeadlessJob> jobs;
+	unsigned int workerCount = std::thread::hardware_concurrency();
+	unsigned int framesPerSlice = 0;
+	bool verbose = false;
+	if(!ParseCommandLine(argc, argv, jobs, workerCount, framesPerSlice, verbose))
+	{
+		std::wcout << usageText;
+		return 1;
+	}
+
+	//Load the system assembly
+	HeadlessInterface::PluginInfo systemPluginInfo;
+	if(!HeadlessInterface::LoadAssemblyInfo(L"System.dll", systemPluginInfo) || (systemPluginInfo.GetSystemEntry == 0))
+	{
+		std::wcout << L"Failed to load the system assembly\n";
+		return 10;
+	}
+
+	//Retrieve information on the system plugin from the system assembly
+	SystemInfo systemInfo;
+	if(!systemPluginInfo.GetSystemEntry(0, systemInfo))
+	{
+		std::wcout << L"Failed to retrieve the system plugin\n";
+		return 20;
+	}
+
+	//Create a runner for each job. Each runner creates its own system object from the
+	//system plugin, so jobs share nothing but the loaded assemblies.
+	std::vector<HeadlessRunner*> runners;
+	std::vector<IBatchTask*> tasks;
+	for(unsigned int i = 0; i < (unsigned int)jobs.size(); ++i)
+	{
+		HeadlessRunner* runner = new HeadlessRunner(systemInfo.GetAllocator(), systemInfo.GetDestructor(), jobs[i]);
+		runners.push_back(runner);
+		tasks.push_back(runner);
+	}
+
+	//Run all the jobs
+	BatchScheduler scheduler((workerCount > 0)? workerCount: 1, framesPerSlice);
+	scheduler.Run(tasks);
+
+	//Print the results of each job, and destroy the runners
+	bool allJobsSucceeded = true;
+	bool anyJobsDiverged = false;
+	for(unsigned int i = 0; i < (unsigned int)runners.size(); ++i)
+	{
+		const HeadlessResult& result = runners[i]->GetResult();
+		PrintResult(jobs[i], result, verbose);
+		allJobsSucceeded &= result.succeeded;
+		anyJobsDiverged |= result.diverged;
+		delete runners[i];
+	}
+
+	//Return a non-zero exit code if any job failed or diverged from its golden file
+	if(!allJobsSucceeded)
+	{
+		return 2;
+	}
+	return anyJobsDiverged? 3: 0;
+}
@@ -2,6 +2,7 @@
 #define __IBUSINTERFACE_H__
 class IDeviceContext;
 class IClockSource;
+class IDevice;
 class Data;
 
 class IBusInterface
@@ -9,13 +10,14 @@ class IBusInterface
 public:
 	//Structures
 	struct AccessResult;
+	struct MemoryTarget;
 
 public:
 	//Constructors
 	virtual ~IBusInterface() = 0 {}
 
 	//Interface version functions
-	static inline unsigned int ThisIBusInterfaceVersion() { return 1; }
+	static inline unsigned int ThisIBusInterfaceVersion() { return 2; }
 	virtual unsigned int GetIBusInterfaceVersion() const = 0;
 
 	//Memory interface functions
@@ -50,6 +52,26 @@ public:
 	//Clock source functions
 	virtual void SetClockRate(double newClockRate, const IClockSource* sourceClock, IDeviceContext* callingDevice, double accessTime, unsigned int accessContext) = 0;
 	virtual void TransparentSetClockRate(double newClockRate, const IClockSource* sourceClock) = 0;
+
+	//Memory target resolution functions
+	//These functions allow a device which repeatedly accesses a fixed window of the bus
+	//to resolve the window down to its target device once, and then pass accesses
+	//directly to that device. A window can only be resolved if the CE line state is
+	//constant across it, and every address in it maps through a single plain mapping
+	//with no address or data line remapping. The memory mapping change count is
+	//incremented whenever a mapping on the bus is added or removed, and any resolved
+	//target which was obtained under a different count must be discarded.
+	virtual bool ResolveMemoryTarget(unsigned int location, unsigned int windowSize, IDeviceContext* caller, MemoryTarget& target) const = 0;
+	virtual unsigned int GetMemoryMappingChangeCount() const = 0;
+
+	//CE line state change functions
+	//A device which generates CE line state for the bus must notify the bus whenever
+	//internal state which affects the CE line state it generates is modified. Resolved
+	//memory targets record the CE line state change count at the time they were
+	//resolved, and any target which was obtained under a different count must be
+	//discarded, just as for the memory mapping change count.
+	virtual unsigned int GetCELineStateChangeCount() const = 0;
+	virtual void NotifyCELineStateChanged() = 0;
 };
 
 #include "IBusInterface.inl"
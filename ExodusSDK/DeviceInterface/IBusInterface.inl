@@ -68,6 +68,30 @@ struct IBusInterface::AccessResult
 	double executionTime;
 };
 
+//----------------------------------------------------------------------------------------
+struct IBusInterface::MemoryTarget
+{
+	MemoryTarget()
+	:device(0), interfaceNumber(0), address(0), addressMask(0), addressDiscardLowerBitCount(0), interfaceOffset(0), mappingChangeCount(0), ceLineStateChangeCount(0)
+	{}
+
+	//Calculates the interface offset for the specified bus address within the resolved
+	//window. This matches the address decoding performed by the bus for the mapping.
+	unsigned int GetInterfaceOffset(unsigned int location) const
+	{
+		return (((location - address) & addressMask) >> addressDiscardLowerBitCount) + interfaceOffset;
+	}
+
+	IDevice* device;
+	unsigned int interfaceNumber;
+	unsigned int address;
+	unsigned int addressMask;
+	unsigned int addressDiscardLowerBitCount;
+	unsigned int interfaceOffset;
+	unsigned int mappingChangeCount;
+	unsigned int ceLineStateChangeCount;
+};
+
 //##TODO## Revise our interface based on the above changes, so that our memory access
 //functions now look like this:
 //bool ReadMemory(const Data& address, Data& data, Data& assertedBitMask, IDeviceContext* caller, double accessTime, unsigned int accessContext = 0, void* calculateCELineStateContext = 0);
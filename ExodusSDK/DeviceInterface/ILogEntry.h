@@ -14,7 +14,7 @@ public:
 	virtual ~ILogEntry() = 0 {}
 
 	//Interface version functions
-	static inline unsigned int ThisILogEntryVersion() { return 1; }
+	static inline unsigned int ThisILogEntryVersion() { return 2; }
 	virtual unsigned int GetILogEntryVersion() const = 0;
 
 	//Getters
@@ -29,6 +29,9 @@ public:
 
 	//Version functions
 	virtual unsigned int GetInterfaceVersion() const = 0;
+
+	//Time functions
+	virtual void GetTime(int& hour, int& minute, int& second, int& millisecond) const = 0;
 };
 
 #include "ILogEntry.inl"
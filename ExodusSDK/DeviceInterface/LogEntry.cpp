@@ -79,29 +79,13 @@ MarshalSupport::Marshal::Ret<std::wstring> LogEntry::GetSource() const
 //----------------------------------------------------------------------------------------
 MarshalSupport::Marshal::Ret<std::wstring> LogEntry::GetEventLevelString() const
 {
-	switch(eventLevel)
-	{
-	case EventLevel::Info:
-		return L"1 - Information";
-	case EventLevel::Debug:
-		return L"2 - Debug";
-	case EventLevel::Warning:
-		return L"3 - Warning";
-	case EventLevel::Error:
-		return L"4 - Error";
-	case EventLevel::Critical:
-		return L"5 - Critical";
-	default:
-		return L"";
-	}
+	return FormatEventLevelString(eventLevel);
 }
 
 //----------------------------------------------------------------------------------------
 MarshalSupport::Marshal::Ret<std::wstring> LogEntry::GetTimeString() const
 {
-	std::wstringstream stream;
-	stream << std::setw(2) << std::setfill(L'0') << hour << L':' << minute << L':' << second << L'.' << millisecond;
-	return stream.str();
+	return FormatTimeString(hour, minute, second, millisecond);
 }
 
 //----------------------------------------------------------------------------------------
@@ -119,3 +103,44 @@ unsigned int LogEntry::GetInterfaceVersion() const
 {
 	return 1;
 }
+
+//----------------------------------------------------------------------------------------
+//Time functions
+//----------------------------------------------------------------------------------------
+void LogEntry::GetTime(int& ahour, int& aminute, int& asecond, int& amillisecond) const
+{
+	ahour = hour;
+	aminute = minute;
+	asecond = second;
+	amillisecond = millisecond;
+}
+
+//----------------------------------------------------------------------------------------
+//Formatting functions
+//----------------------------------------------------------------------------------------
+std::wstring LogEntry::FormatEventLevelString(EventLevel alevel)
+{
+	switch(alevel)
+	{
+	case EventLevel::Info:
+		return L"1 - Information";
+	case EventLevel::Debug:
+		return L"2 - Debug";
+	case EventLevel::Warning:
+		return L"3 - Warning";
+	case EventLevel::Error:
+		return L"4 - Error";
+	case EventLevel::Critical:
+		return L"5 - Critical";
+	default:
+		return L"";
+	}
+}
+
+//----------------------------------------------------------------------------------------
+std::wstring LogEntry::FormatTimeString(int ahour, int aminute, int asecond, int amillisecond)
+{
+	std::wstringstream stream;
+	stream << std::setw(2) << std::setfill(L'0') << ahour << L':' << aminute << L':' << asecond << L'.' << amillisecond;
+	return stream.str();
+}
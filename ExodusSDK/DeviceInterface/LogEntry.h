@@ -33,6 +33,13 @@ public:
 	//Version functions
 	virtual unsigned int GetInterfaceVersion() const;
 
+	//Time functions
+	virtual void GetTime(int& ahour, int& aminute, int& asecond, int& amillisecond) const;
+
+	//Formatting functions
+	static std::wstring FormatEventLevelString(EventLevel alevel);
+	static std::wstring FormatTimeString(int ahour, int aminute, int asecond, int amillisecond);
+
 	//Text-based stream functions
 	template<class T> inline LogEntry& operator>>(T& data);
 	template<class T> inline LogEntry& operator<<(const T& data);
@@ -3,6 +3,7 @@
 #include "IGenericAccess.h"
 #include <map>
 #include <vector>
+#include <mutex>
 
 template<class B> class GenericAccessBase :public B
 {
@@ -46,7 +47,16 @@ public:
 	//Command execution functions
 	virtual bool ExecuteGenericCommand(unsigned int commandID, const typename B::DataContext* dataContext);
 
+	//Batch read functions
+	virtual bool ReadGenericDataBatch(typename B::DataReadRequest* requests, unsigned int requestCount) const;
+
+protected:
+	//Batch read functions
+	virtual void BeginGenericDataBatch() const;
+	virtual bool ReadGenericDataBatchEntry(unsigned int dataID, const typename B::DataContext* dataContext, IGenericAccessDataValue& dataValue) const;
+
 private:
+	mutable std::mutex genericDataBatchMutex;
 	std::map<unsigned int, const IGenericAccessDataInfo*> genericDataList;
 	std::map<unsigned int, const IGenericAccessCommandInfo*> genericCommandList;
 	std::vector<const IGenericAccessPage*> genericPageList;
@@ -510,3 +510,35 @@ template<class B> bool GenericAccessBase<B>::ExecuteGenericCommand(unsigned int
 {
 	return false;
 }
+
+//----------------------------------------------------------------------------------------
+//Batch read functions
+//----------------------------------------------------------------------------------------
+template<class B> bool GenericAccessBase<B>::ReadGenericDataBatch(typename B::DataReadRequest* requests, unsigned int requestCount) const
+{
+	//Give the device the chance to capture its state once for the whole batch, then read
+	//each requested data value in turn. Devices which hold their state in timed buffers
+	//use this to service every read in the batch from a single snapshot of each buffer,
+	//rather than locking and searching the buffer once per read. Since the snapshot is
+	//held by the device between these calls, only one batch can be in progress at a time.
+	std::unique_lock<std::mutex> lock(genericDataBatchMutex);
+	BeginGenericDataBatch();
+	bool allReadsSucceeded = true;
+	for(unsigned int i = 0; i < requestCount; ++i)
+	{
+		typename B::DataReadRequest& request = requests[i];
+		request.result = ReadGenericDataBatchEntry(request.dataID, request.dataContext, *request.dataValue);
+		allReadsSucceeded &= request.result;
+	}
+	return allReadsSucceeded;
+}
+
+//----------------------------------------------------------------------------------------
+template<class B> void GenericAccessBase<B>::BeginGenericDataBatch() const
+{}
+
+//----------------------------------------------------------------------------------------
+template<class B> bool GenericAccessBase<B>::ReadGenericDataBatchEntry(unsigned int dataID, const typename B::DataContext* dataContext, IGenericAccessDataValue& dataValue) const
+{
+	return ReadGenericData(dataID, dataContext, dataValue);
+}
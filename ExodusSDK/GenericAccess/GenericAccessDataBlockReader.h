@@ -0,0 +1,36 @@
+#ifndef __GENERICACCESSDATABLOCKREADER_H__
+#define __GENERICACCESSDATABLOCKREADER_H__
+#include "IGenericAccess.h"
+#include "GenericAccessDataValueUInt.h"
+#include <vector>
+
+//A data block reader reads a contiguous block of indexed unsigned integer values from a
+//generic access object, such as a block of raw registers, in a single batch operation.
+//The data contexts, data values, and read requests for the block are built once when the
+//reader is constructed, so a reader can be held by a view and reused on each refresh
+//without reallocating. Each data context is constructed from the index of the value it
+//selects.
+template<class DataContextType> class GenericAccessDataBlockReader
+{
+public:
+	//Constructors
+	GenericAccessDataBlockReader(unsigned int adataID, unsigned int afirstIndex, unsigned int acount);
+
+	//Read functions
+	bool Read(const IGenericAccess& source);
+	unsigned int GetValueCount() const;
+	unsigned int GetValue(unsigned int valueNo) const;
+
+protected:
+	//The read requests refer to the data contexts and data values held by this object,
+	//so copying is disabled.
+	GenericAccessDataBlockReader(const GenericAccessDataBlockReader& source) {}
+
+private:
+	std::vector<DataContextType> dataContexts;
+	std::vector<GenericAccessDataValueUInt> dataValues;
+	std::vector<IGenericAccess::DataReadRequest> requests;
+};
+
+#include "GenericAccessDataBlockReader.inl"
+#endif
@@ -0,0 +1,43 @@
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+template<class DataContextType> GenericAccessDataBlockReader<DataContextType>::GenericAccessDataBlockReader(unsigned int adataID, unsigned int afirstIndex, unsigned int acount)
+:dataValues(acount), requests(acount)
+{
+	//Build the data context and read request for each value in the block. Note that the
+	//contexts are fully populated before we take their addresses, since the vector must
+	//not be resized once the requests refer to its elements.
+	dataContexts.reserve(acount);
+	for(unsigned int i = 0; i < acount; ++i)
+	{
+		dataContexts.push_back(DataContextType(afirstIndex + i));
+	}
+	for(unsigned int i = 0; i < acount; ++i)
+	{
+		requests[i] = IGenericAccess::DataReadRequest(adataID, &dataContexts[i], &dataValues[i]);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Read functions
+//----------------------------------------------------------------------------------------
+template<class DataContextType> bool GenericAccessDataBlockReader<DataContextType>::Read(const IGenericAccess& source)
+{
+	if(requests.empty())
+	{
+		return true;
+	}
+	return source.ReadGenericDataBatch(&requests[0], (unsigned int)requests.size());
+}
+
+//----------------------------------------------------------------------------------------
+template<class DataContextType> unsigned int GenericAccessDataBlockReader<DataContextType>::GetValueCount() const
+{
+	return (unsigned int)dataValues.size();
+}
+
+//----------------------------------------------------------------------------------------
+template<class DataContextType> unsigned int GenericAccessDataBlockReader<DataContextType>::GetValue(unsigned int valueNo) const
+{
+	return dataValues[valueNo].GetValue();
+}
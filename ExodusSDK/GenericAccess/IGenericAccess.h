@@ -16,13 +16,27 @@ public:
 	public:
 		virtual ~DataContext() = 0 {}
 	};
+	struct DataReadRequest
+	{
+		DataReadRequest()
+		:dataID(0), dataContext(0), dataValue(0), result(false)
+		{}
+		DataReadRequest(unsigned int adataID, const DataContext* adataContext, IGenericAccessDataValue* adataValue)
+		:dataID(adataID), dataContext(adataContext), dataValue(adataValue), result(false)
+		{}
+
+		unsigned int dataID;
+		const DataContext* dataContext;
+		IGenericAccessDataValue* dataValue;
+		bool result;
+	};
 
 public:
 	//Constructors
 	virtual ~IGenericAccess() = 0 {}
 
 	//Interface version functions
-	static inline unsigned int ThisIGenericAccessVersion() { return 1; }
+	static inline unsigned int ThisIGenericAccessVersion() { return 2; }
 	virtual unsigned int GetIGenericAccessVersion() const = 0;
 
 	//Data info functions
@@ -54,6 +68,9 @@ public:
 
 	//Command execution functions
 	virtual bool ExecuteGenericCommand(unsigned int commandID, const DataContext* dataContext) = 0;
+
+	//Batch read functions
+	virtual bool ReadGenericDataBatch(DataReadRequest* requests, unsigned int requestCount) const = 0;
 };
 
 #endif
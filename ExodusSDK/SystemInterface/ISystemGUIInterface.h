@@ -27,6 +27,7 @@ public:
 	struct ConnectorDefinitionImport;
 	struct ConnectorDefinitionExport;
 	struct SystemLogEntry;
+	struct ThrottlingStatistics;
 
 	//Typedefs
 	typedef std::map<unsigned int, ModuleRelationship> ModuleRelationshipMap;
@@ -40,7 +41,7 @@ public:
 
 public:
 	//Interface version functions
-	static inline unsigned int ThisISystemGUIInterfaceVersion() { return 1; }
+	static inline unsigned int ThisISystemGUIInterfaceVersion() { return 2; }
 	virtual unsigned int GetISystemGUIInterfaceVersion() const = 0;
 
 	//Path functions
@@ -143,6 +144,11 @@ public:
 	virtual bool RestoreViewStateForDevice(const MarshalSupport::Marshal::In<std::wstring>& viewGroupName, const MarshalSupport::Marshal::In<std::wstring>& viewName, IHierarchicalStorageNode& viewState, IViewPresenter** restoredViewPresenter, unsigned int moduleID, const MarshalSupport::Marshal::In<std::wstring>& deviceInstanceName) const = 0;
 	virtual bool RestoreViewStateForExtension(const MarshalSupport::Marshal::In<std::wstring>& viewGroupName, const MarshalSupport::Marshal::In<std::wstring>& viewName, IHierarchicalStorageNode& viewState, IViewPresenter** restoredViewPresenter, const MarshalSupport::Marshal::In<std::wstring>& extensionInstanceName) const = 0;
 	virtual bool RestoreViewStateForExtension(const MarshalSupport::Marshal::In<std::wstring>& viewGroupName, const MarshalSupport::Marshal::In<std::wstring>& viewName, IHierarchicalStorageNode& viewState, IViewPresenter** restoredViewPresenter, unsigned int moduleID, const MarshalSupport::Marshal::In<std::wstring>& extensionInstanceName) const = 0;
+
+	//Throttling functions
+	virtual bool GetThrottlingSleepOnlyState() const = 0;
+	virtual void SetThrottlingSleepOnlyState(bool state) = 0;
+	virtual ThrottlingStatistics GetThrottlingStatistics() const = 0;
 };
 
 #include "ISystemGUIInterface.inl"
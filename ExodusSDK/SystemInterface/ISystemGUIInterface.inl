@@ -288,6 +288,36 @@ public:
 	std::wstring eventTimeString;
 };
 
+//----------------------------------------------------------------------------------------
+//Note that this structure only contains primitive types, so it can be passed between
+//assemblies directly without marshalling.
+struct ISystemGUIInterface::ThrottlingStatistics
+{
+public:
+	//Constructors
+	ThrottlingStatistics()
+	:syncCount(0), resyncCount(0), meanErrorInNanoseconds(0), errorStandardDeviationInNanoseconds(0), minErrorInNanoseconds(0), maxErrorInNanoseconds(0), sleepMarginInNanoseconds(0), spinTimeInNanoseconds(0)
+	{}
+
+public:
+	//The number of sync points which have been measured since the system was last
+	//started, and the number of those where execution was running too far behind to
+	//catch up.
+	unsigned int syncCount;
+	unsigned int resyncCount;
+
+	//The difference between the time execution resumed and the target time for each
+	//sync point. Positive values indicate execution resumed late.
+	double meanErrorInNanoseconds;
+	double errorStandardDeviationInNanoseconds;
+	long long minErrorInNanoseconds;
+	long long maxErrorInNanoseconds;
+
+	//The current sleep margin, and the total time spent spinning.
+	long long sleepMarginInNanoseconds;
+	long long spinTimeInNanoseconds;
+};
+
 //Restore the disabled warnings
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -91,6 +91,7 @@ public:
 	void WriteLatest(unsigned int address, const DataType& data);
 	void GetLatestBufferCopy(std::vector<DataType>& buffer) const;
 	void GetLatestBufferCopy(DataType* buffer, unsigned int bufferSize) const;
+	void GetBufferCopy(std::vector<DataType>& buffer, const AccessTarget& accessTarget) const;
 
 	//Time management functions
 	void Initialize();
@@ -128,6 +128,8 @@ template<class DataType, class TimesliceType> DataType RandomTimeAccessBuffer<Da
 		return ReadLatest(address);
 	case accessTarget.TARGET_TIME:
 		return Read(address, accessTarget.time);
+	case accessTarget.TARGET_SNAPSHOT:
+		return (*accessTarget.snapshot)[address];
 	}
 	DebugAssert(false);
 	return DataType(defaultValue);
@@ -430,6 +432,33 @@ template<class DataType, class TimesliceType> void RandomTimeAccessBuffer<DataTy
 	}
 }
 
+//----------------------------------------------------------------------------------------
+template<class DataType, class TimesliceType> void RandomTimeAccessBuffer<DataType, TimesliceType>::GetBufferCopy(std::vector<DataType>& buffer, const AccessTarget& accessTarget) const
+{
+	switch(accessTarget.target)
+	{
+	case accessTarget.TARGET_COMMITTED:{
+		//Populate the target buffer with the committed memory state
+		std::unique_lock<std::mutex> lock(accessLock);
+		buffer.assign(memory.begin(), memory.end());
+		return;}
+	case accessTarget.TARGET_LATEST:
+		GetLatestBufferCopy(buffer);
+		return;
+	case accessTarget.TARGET_SNAPSHOT:
+		buffer.assign(accessTarget.snapshot->begin(), accessTarget.snapshot->end());
+		return;
+	}
+
+	//For timed targets, there's no faster way to build the buffer state than reading
+	//each element in turn.
+	buffer.resize(memory.size());
+	for(unsigned int i = 0; i < (unsigned int)buffer.size(); ++i)
+	{
+		buffer[i] = Read(i, accessTarget);
+	}
+}
+
 //----------------------------------------------------------------------------------------
 //Time management functions
 //----------------------------------------------------------------------------------------
@@ -1,5 +1,6 @@
 #ifndef __ITIMEDBUFFERACCESSTARGET_H__
 #define __ITIMEDBUFFERACCESSTARGET_H__
+#include <vector>
 
 template<class DataType, class TimesliceType> struct TimedBufferAccessTarget
 {
@@ -10,7 +11,8 @@ public:
 		TARGET_COMMITTED,
 		TARGET_COMMITTED_TIME,
 		TARGET_LATEST,
-		TARGET_TIME
+		TARGET_TIME,
+		TARGET_SNAPSHOT
 	};
 
 public:
@@ -22,11 +24,13 @@ public:
 	inline TimedBufferAccessTarget& AccessCommitted(TimesliceType atime);
 	inline TimedBufferAccessTarget& AccessLatest();
 	inline TimedBufferAccessTarget& AccessTime(TimesliceType atime);
+	inline TimedBufferAccessTarget& AccessSnapshot(const std::vector<DataType>& asnapshot);
 
 public:
 	//Data members
 	Target target;
 	TimesliceType time;
+	const std::vector<DataType>* snapshot;
 };
 
 #include "TimedBufferAccessTarget.inl"
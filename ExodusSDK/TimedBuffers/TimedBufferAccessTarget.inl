@@ -35,3 +35,17 @@ template<class DataType, class TimesliceType> TimedBufferAccessTarget<DataType,
 	time = atime;
 	return *this;
 }
+
+//----------------------------------------------------------------------------------------
+//Reads through a snapshot target are serviced from a copy of the buffer taken earlier
+//with GetBufferCopy, rather than the buffer itself. This allows a group of related reads
+//to see one consistent state, without locking the buffer for each read. Note that the
+//snapshot must remain valid for as long as this target is in use, and that writes can't
+//be made through a snapshot target.
+//----------------------------------------------------------------------------------------
+template<class DataType, class TimesliceType> TimedBufferAccessTarget<DataType, TimesliceType>& TimedBufferAccessTarget<DataType, TimesliceType>::AccessSnapshot(const std::vector<DataType>& asnapshot)
+{
+	target = TARGET_SNAPSHOT;
+	snapshot = &asnapshot;
+	return *this;
+}
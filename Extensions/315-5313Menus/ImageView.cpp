@@ -405,13 +405,16 @@ LRESULT ImageView::msgRenderWM_MOUSEMOVE(HWND hwnd, WPARAM wparam, LPARAM lparam
 		return 0;
 	}
 
-	//Determine the index of the current image plane that is being used for display
-	unsigned int displayingImageBufferPlane = model.GetImageCompletedBufferPlaneNo();
+	//Pin the latest completed image plane, so that the line count and line width we read
+	//below both come from the same frame, and can't be overwritten by the render thread
+	//while we're reading them.
+	unsigned int displayingImageBufferPlane = model.AcquireLatestImageBufferPlane();
 
 	//Obtain the number of rows in this frame
 	unsigned int rowCount = model.GetImageBufferLineCount(displayingImageBufferPlane);
 	if(rowCount <= 0)
 	{
+		model.ReleaseImageBufferPlane(displayingImageBufferPlane);
 		HidePixelInfoWindow();
 		return 0;
 	}
@@ -423,6 +426,9 @@ LRESULT ImageView::msgRenderWM_MOUSEMOVE(HWND hwnd, WPARAM wparam, LPARAM lparam
 	unsigned int lineWidth = model.GetImageBufferLineWidth(displayingImageBufferPlane, pixelInfoTargetBufferPosY);
 	pixelInfoTargetBufferPosX = (int)((float)(xpos - imageRegionPosX) * ((float)lineWidth / imageRegionWidth));
 
+	//Release our reference to the image plane
+	model.ReleaseImageBufferPlane(displayingImageBufferPlane);
+
 	//Retrieve the rectangle representing the work area of the target monitor
 	POINT cursorPoint;
 	cursorPoint.x = xpos;
@@ -530,13 +536,16 @@ void ImageView::UpdateImage()
 		--windowPendingClearCount;
 	}
 
-	//Determine the index of the current image plane that is being used for display
-	unsigned int displayingImageBufferPlane = model.GetImageCompletedBufferPlaneNo();
+	//Obtain a reference to the current image plane that is being used for display. The
+	//pixel data and line information in this plane will remain stable until we release
+	//it.
+	unsigned int displayingImageBufferPlane = model.AcquireLatestImageBufferPlane();
 
 	//Obtain the number of rows in this frame
 	unsigned int rowCount = model.GetImageBufferLineCount(displayingImageBufferPlane);
 	if(rowCount <= 0)
 	{
+		model.ReleaseImageBufferPlane(displayingImageBufferPlane);
 		return;
 	}
 
@@ -552,9 +561,7 @@ void ImageView::UpdateImage()
 	if(model.GetVideoSingleBuffering() || (lastRenderedFrameTokenCached != latestLastRenderedFrameToken))
 	{
 		//Copy the contents of the image buffer into our image texture for rendering
-		model.LockImageBufferData(displayingImageBufferPlane);
 		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, model.imageBufferWidth, rowCount, GL_RGBA, GL_UNSIGNED_BYTE, model.GetImageBufferData(displayingImageBufferPlane));
-		model.UnlockImageBufferData(displayingImageBufferPlane);
 
 		//Update our cached last rendered frame token
 		unsigned int framesCompletedDrawing = latestLastRenderedFrameToken - lastRenderedFrameTokenCached;
@@ -765,6 +772,9 @@ void ImageView::UpdateImage()
 		}
 	}
 
+	//Release our reference to the image plane
+	model.ReleaseImageBufferPlane(displayingImageBufferPlane);
+
 	//Signal the OpenGL drawing operations to start as quickly as possible
 	glFlush();
 }
@@ -973,15 +983,19 @@ INT_PTR ImageView::msgPixelInfoWM_TIMER(HWND hwnd, WPARAM wparam, LPARAM lparam)
 		return TRUE;
 	}
 
-	//Determine the index of the current image plane that is being used for display
-	unsigned int displayingImageBufferPlane = model.GetImageCompletedBufferPlaneNo();
-
-	//Retrieve info for the target pixel
-	const IS315_5313::ImageBufferInfo* pixelInfo = model.GetImageBufferInfo(displayingImageBufferPlane, pixelInfoTargetBufferPosY, pixelInfoTargetBufferPosX);
-	if(pixelInfo == 0)
+	//Obtain a reference to the current image plane that is being used for display, and
+	//take a copy of the info for the target pixel. Pixel info is only captured while
+	//full image buffer info is enabled, so it may not be present for this frame yet.
+	unsigned int displayingImageBufferPlane = model.AcquireLatestImageBufferPlane();
+	const IS315_5313::ImageBufferInfo* capturedPixelInfo = model.GetImageBufferInfo(displayingImageBufferPlane, pixelInfoTargetBufferPosY, pixelInfoTargetBufferPosX);
+	if(capturedPixelInfo == 0)
 	{
+		model.ReleaseImageBufferPlane(displayingImageBufferPlane);
 		return TRUE;
 	}
+	IS315_5313::ImageBufferInfo pixelInfoCopy = *capturedPixelInfo;
+	model.ReleaseImageBufferPlane(displayingImageBufferPlane);
+	const IS315_5313::ImageBufferInfo* pixelInfo = &pixelInfoCopy;
 
 	//Retrieve source-specific settings for this pixel info
 	std::wstring pixelSourceString;
@@ -5,7 +5,7 @@
 //Constructors
 //----------------------------------------------------------------------------------------
 RegistersView::RegistersView(IUIManager& auiManager, RegistersViewPresenter& apresenter, IS315_5313& amodel)
-:ViewBase(auiManager, apresenter), presenter(apresenter), model(amodel), initializedDialog(false), currentControlFocus(0), activeTabWindow(NULL)
+:ViewBase(auiManager, apresenter), presenter(apresenter), model(amodel), rawRegisterReader((unsigned int)IS315_5313::IS315_5313DataSource::RawRegister, 0, IS315_5313::registerCount), initializedDialog(false), currentControlFocus(0), activeTabWindow(NULL)
 {
 	lockedColor = RGB(255,127,127);
 	lockedBrush = CreateSolidBrush(lockedColor);
@@ -327,9 +327,10 @@ INT_PTR RegistersView::msgRawRegistersWM_TIMER(HWND hwnd, WPARAM wparam, LPARAM
 	initializedDialog = true;
 
 	//Update raw registers
+	rawRegisterReader.Read(model);
 	for(unsigned int i = 0; i < IS315_5313::registerCount; ++i)
 	{
-		if(currentControlFocus != (IDC_REG_0 + i))	UpdateDlgItemHex(hwnd, IDC_REG_0 + i, 2, model.GetRegisterData(i));
+		if(currentControlFocus != (IDC_REG_0 + i))	UpdateDlgItemHex(hwnd, IDC_REG_0 + i, 2, rawRegisterReader.GetValue(i));
 	}
 
 	//Port registers
@@ -79,6 +79,7 @@ private:
 private:
 	RegistersViewPresenter& presenter;
 	IS315_5313& model;
+	GenericAccessDataBlockReader<IS315_5313::RegisterDataContext> rawRegisterReader;
 	bool initializedDialog;
 	std::wstring previousText;
 	unsigned int currentControlFocus;
@@ -107,6 +107,13 @@ INT_PTR DeviceControlView::msgWM_TIMER(HWND hwnd, WPARAM wparam, LPARAM lparam)
 		}
 	}
 
+	//Update the throttling statistics
+	ISystemGUIInterface::ThrottlingStatistics throttlingStatistics = model.GetThrottlingStatistics();
+	UpdateDlgItemDouble(hwnd, IDC_DEVICECONTROL_THROTTLING_MEANERROR, throttlingStatistics.meanErrorInNanoseconds / 1000.0);
+	UpdateDlgItemDouble(hwnd, IDC_DEVICECONTROL_THROTTLING_DEVIATION, throttlingStatistics.errorStandardDeviationInNanoseconds / 1000.0);
+	UpdateDlgItemDouble(hwnd, IDC_DEVICECONTROL_THROTTLING_MAXERROR, (double)throttlingStatistics.maxErrorInNanoseconds / 1000.0);
+	UpdateDlgItemBin(hwnd, IDC_DEVICECONTROL_THROTTLING_RESYNCCOUNT, throttlingStatistics.resyncCount);
+
 	return TRUE;
 }
 
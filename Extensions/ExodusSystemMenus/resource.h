@@ -58,6 +58,10 @@
 #define IDC_SETTINGS_LOADSYSTEMCHANGE   1330
 #define IDC_EDIT5                       1331
 #define IDC_SETTINGS_PATHCAPTURES       1331
+#define IDC_DEVICECONTROL_THROTTLING_MEANERROR 1340
+#define IDC_DEVICECONTROL_THROTTLING_DEVIATION 1341
+#define IDC_DEVICECONTROL_THROTTLING_MAXERROR 1342
+#define IDC_DEVICECONTROL_THROTTLING_RESYNCCOUNT 1343
 #define IDC_EDIT6                       1332
 #define IDC_SETTINGS_PATHCAPTURESCHANGE 1332
 #define IDC_VDP_SPRITELIST_DETAILS_COMPLETE 1333
@@ -5,7 +5,7 @@
 //Constructors
 //----------------------------------------------------------------------------------------
 RegistersView::RegistersView(IUIManager& auiManager, RegistersViewPresenter& apresenter, IYM2612& amodel)
-:ViewBase(auiManager, apresenter), presenter(apresenter), model(amodel), initializedDialog(false), currentControlFocus(0)
+:ViewBase(auiManager, apresenter), presenter(apresenter), model(amodel), registerReader((unsigned int)IYM2612::IYM2612DataSource::RawRegister, 0, IYM2612::registerCountTotal), initializedDialog(false), currentControlFocus(0)
 {
 	SetDialogTemplateSettings(apresenter.GetUnqualifiedViewTitle(), GetAssemblyHandle(), MAKEINTRESOURCE(IDD_YM2612_REGISTERS));
 	SetDialogViewType();
@@ -60,11 +60,12 @@ INT_PTR RegistersView::msgWM_TIMER(HWND hwnd, WPARAM wparam, LPARAM lparam)
 		UpdateDlgItemHex(hwnd, IDC_YM2612_REGISTERS_STATUS, 2, model.GetStatusRegister());
 	}
 
+	registerReader.Read(model);
 	for(unsigned int i = 0; i <= 0xB7; ++i)
 	{
 		if(currentControlFocus != (IDC_YM2612_REGISTERS_00 + i))
 		{
-			UpdateDlgItemHex(hwnd, IDC_YM2612_REGISTERS_00 + i, 2, model.GetRegisterData(i));
+			UpdateDlgItemHex(hwnd, IDC_YM2612_REGISTERS_00 + i, 2, registerReader.GetValue(i));
 		}
 	}
 
@@ -72,7 +73,7 @@ INT_PTR RegistersView::msgWM_TIMER(HWND hwnd, WPARAM wparam, LPARAM lparam)
 	{
 		if(currentControlFocus != (IDC_YM2612_REGISTERS_P2_00 + i))
 		{
-			UpdateDlgItemHex(hwnd, IDC_YM2612_REGISTERS_P2_00 + i, 2, model.GetRegisterData(IYM2612::registerCountPerPart + i));
+			UpdateDlgItemHex(hwnd, IDC_YM2612_REGISTERS_P2_00 + i, 2, registerReader.GetValue(IYM2612::registerCountPerPart + i));
 		}
 	}
 
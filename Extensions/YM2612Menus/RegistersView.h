@@ -25,6 +25,7 @@ private:
 private:
 	RegistersViewPresenter& presenter;
 	IYM2612& model;
+	GenericAccessDataBlockReader<IYM2612::RegisterDataContext> registerReader;
 	bool initializedDialog;
 	std::wstring previousText;
 	unsigned int currentControlFocus;
@@ -0,0 +1,138 @@
+#include "AudioMixer.h"
+#include <algorithm>
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+AudioMixer::AudioMixer(unsigned int achannelCount, unsigned int asamplesPerSec, unsigned int ainputCapacityInSamples)
+:channelCount(achannelCount), samplesPerSec(asamplesPerSec), inputCapacityInSamples(ainputCapacityInSamples)
+{}
+
+//----------------------------------------------------------------------------------------
+AudioMixer::~AudioMixer()
+{
+	for(std::list<Input*>::iterator i = inputs.begin(); i != inputs.end(); ++i)
+	{
+		delete *i;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Input functions
+//----------------------------------------------------------------------------------------
+IAudioSink* AudioMixer::CreateInput()
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	Input* input = new Input(samplesPerSec, inputCapacityInSamples);
+	inputs.push_back(input);
+	return input;
+}
+
+//----------------------------------------------------------------------------------------
+void AudioMixer::DeleteInput(IAudioSink* input)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	for(std::list<Input*>::iterator i = inputs.begin(); i != inputs.end(); ++i)
+	{
+		if(*i == input)
+		{
+			delete *i;
+			inputs.erase(i);
+			return;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Format functions
+//----------------------------------------------------------------------------------------
+unsigned int AudioMixer::GetChannelCount() const
+{
+	return channelCount;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int AudioMixer::GetSamplesPerSec() const
+{
+	return samplesPerSec;
+}
+
+//----------------------------------------------------------------------------------------
+//Mixed output functions
+//----------------------------------------------------------------------------------------
+void AudioMixer::ReadMixedSamples(short* data, unsigned int sampleCount)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+
+	//Sum the queued samples from each input into the mix buffer. Note that the mix and
+	//input buffers are retained between calls, so that they only need to grow when a
+	//larger block than any before it is requested.
+	mixBuffer.assign(sampleCount * channelCount, 0);
+	for(std::list<Input*>::const_iterator i = inputs.begin(); i != inputs.end(); ++i)
+	{
+		Input* input = *i;
+		unsigned int inputChannelCount = input->GetChannelCount();
+		if(inputBuffer.size() < (sampleCount * inputChannelCount))
+		{
+			inputBuffer.resize(sampleCount * inputChannelCount);
+		}
+		unsigned int samplesRead = input->ReadSamples(&inputBuffer[0], sampleCount);
+		for(unsigned int sampleNo = 0; sampleNo < samplesRead; ++sampleNo)
+		{
+			const short* inputSample = &inputBuffer[sampleNo * inputChannelCount];
+			int* mixSample = &mixBuffer[sampleNo * channelCount];
+			if(inputChannelCount == channelCount)
+			{
+				for(unsigned int channelNo = 0; channelNo < channelCount; ++channelNo)
+				{
+					mixSample[channelNo] += inputSample[channelNo];
+				}
+			}
+			else
+			{
+				int downmixedSample = 0;
+				for(unsigned int channelNo = 0; channelNo < inputChannelCount; ++channelNo)
+				{
+					downmixedSample += inputSample[channelNo];
+				}
+				downmixedSample /= (int)inputChannelCount;
+				for(unsigned int channelNo = 0; channelNo < channelCount; ++channelNo)
+				{
+					mixSample[channelNo] += downmixedSample;
+				}
+			}
+		}
+	}
+
+	//Clamp the mixed samples to the output range
+	for(unsigned int i = 0; i < (sampleCount * channelCount); ++i)
+	{
+		data[i] = (short)std::min(std::max(mixBuffer[i], -32768), 32767);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Statistics functions
+//----------------------------------------------------------------------------------------
+unsigned int AudioMixer::GetOverrunCount() const
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	unsigned int overrunCount = 0;
+	for(std::list<Input*>::const_iterator i = inputs.begin(); i != inputs.end(); ++i)
+	{
+		overrunCount += (*i)->GetOverrunCount();
+	}
+	return overrunCount;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int AudioMixer::GetUnderrunCount() const
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	unsigned int underrunCount = 0;
+	for(std::list<Input*>::const_iterator i = inputs.begin(); i != inputs.end(); ++i)
+	{
+		underrunCount += (*i)->GetUnderrunCount();
+	}
+	return underrunCount;
+}
@@ -0,0 +1,54 @@
+#ifndef __AUDIOMIXER_H__
+#define __AUDIOMIXER_H__
+#include "IAudioSink.h"
+#include "RingBufferAudioSink.h"
+#include <list>
+#include <vector>
+#include <mutex>
+
+//The AudioMixer class combines the output of several independent audio sources into a
+//single stream. Each source writes to its own input sink, which holds its samples in a
+//bounded queue, so a source never blocks on the consumer. The consumer reads the mixed
+//output in blocks of any length. A source which hasn't supplied enough samples for a
+//block is padded with silence, and an underrun is recorded against it. All inputs must
+//use the sample rate of the mixer, but may use any number of channels. Mono inputs are
+//output on every channel, and inputs with a different number of channels to the mixer
+//are downmixed to mono first.
+class AudioMixer
+{
+public:
+	//Constructors
+	AudioMixer(unsigned int achannelCount, unsigned int asamplesPerSec, unsigned int ainputCapacityInSamples);
+	~AudioMixer();
+
+	//Input functions
+	IAudioSink* CreateInput();
+	void DeleteInput(IAudioSink* input);
+
+	//Format functions
+	unsigned int GetChannelCount() const;
+	unsigned int GetSamplesPerSec() const;
+
+	//Mixed output functions
+	void ReadMixedSamples(short* data, unsigned int sampleCount);
+
+	//Statistics functions
+	unsigned int GetOverrunCount() const;
+	unsigned int GetUnderrunCount() const;
+
+private:
+	//Structures
+	class Input;
+
+private:
+	mutable std::mutex accessMutex;
+	unsigned int channelCount;
+	unsigned int samplesPerSec;
+	unsigned int inputCapacityInSamples;
+	std::list<Input*> inputs;
+	std::vector<short> inputBuffer;
+	std::vector<int> mixBuffer;
+};
+
+#include "AudioMixer.inl"
+#endif
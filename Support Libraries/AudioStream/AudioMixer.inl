@@ -0,0 +1,34 @@
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+class AudioMixer::Input :public RingBufferAudioSink
+{
+public:
+	//Constructors
+	Input(unsigned int asamplesPerSec, unsigned int acapacityInSamples)
+	:RingBufferAudioSink(acapacityInSamples), samplesPerSec(asamplesPerSec), channelCount(1)
+	{}
+
+	//Sink binding
+	virtual bool Open(unsigned int achannelCount, unsigned int bitsPerSample, unsigned int asamplesPerSec)
+	{
+		//We don't perform sample rate conversion on inputs to the mixer, so we refuse any
+		//input which doesn't match our format.
+		if((bitsPerSample != 16) || (asamplesPerSec != samplesPerSec) || !RingBufferAudioSink::Open(achannelCount, bitsPerSample, asamplesPerSec))
+		{
+			return false;
+		}
+		channelCount = achannelCount;
+		return true;
+	}
+
+	//Format functions
+	unsigned int GetChannelCount() const
+	{
+		return channelCount;
+	}
+
+private:
+	unsigned int samplesPerSec;
+	unsigned int channelCount;
+};
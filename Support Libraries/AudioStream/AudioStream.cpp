@@ -9,7 +9,7 @@
 //Constructors
 //----------------------------------------------------------------------------------------
 AudioStream::AudioStream()
-:workerThreadRunning(false), completedBufferSlots(0)
+:sink(0), captureSink(0), workerThreadRunning(false), completedBufferSlots(0), submittedSampleCount(0), overrunCount(0), droppedSampleCount(0), underrunCount(0), fillerSampleCount(0)
 {
 	//Create our critical section object
 	InitializeCriticalSection(&waveMutex);
@@ -49,12 +49,13 @@ bool AudioStream::Open(unsigned int achannelCount, unsigned int abitsPerSample,
 	{
 		maxPendingSamples = samplesPerSec / 4;
 	}
+
+	//Note that a minimum playing sample count of 0 disables the insertion of filler
+	//samples when the output runs low. Callers which want underruns to be padded must
+	//request it explicitly.
 	minPlayingSamples = aminPlayingSamples;
-	if(minPlayingSamples == 0)
-	{
-		minPlayingSamples = minPlayingSamples / 20;
-	}
 	currentPlayingSamples = 0;
+	ResetOutputStatistics();
 
 	//Create the worker thread, and boost priority.
 	ResetEvent(startupCompleteEventHandle);
@@ -87,6 +88,33 @@ bool AudioStream::Open(unsigned int achannelCount, unsigned int abitsPerSample,
 	return true;
 }
 
+//----------------------------------------------------------------------------------------
+bool AudioStream::Open(IAudioSink& asink, unsigned int achannelCount, unsigned int abitsPerSample, unsigned int asamplesPerSec)
+{
+	//If the stream is already open, close it.
+	Close();
+
+	//Set the properties of the audio output stream. Note that when the output is directed
+	//to an audio sink, buffers are passed directly to the sink as soon as playback is
+	//requested, so no worker thread is required, and the pending sample limits don't
+	//apply.
+	channelCount = achannelCount;
+	bitsPerSample = abitsPerSample;
+	samplesPerSec = asamplesPerSec;
+	maxPendingSamples = 0;
+	minPlayingSamples = 0;
+	currentPlayingSamples = 0;
+	ResetOutputStatistics();
+
+	//Open the audio sink
+	if(!asink.Open(channelCount, bitsPerSample, samplesPerSec))
+	{
+		return false;
+	}
+	sink = &asink;
+	return true;
+}
+
 //----------------------------------------------------------------------------------------
 void AudioStream::Close()
 {
@@ -99,6 +127,13 @@ void AudioStream::Close()
 		ResetEvent(shutdownCompleteEventHandle);
 	}
 
+	//If the output is directed to an audio sink, close the sink.
+	if(sink != 0)
+	{
+		sink->Close();
+		sink = 0;
+	}
+
 	//Verify that all playing buffer objects have been deleted. This should always be the
 	//case by this point anyway.
 	if(playingBuffers.size() > 0)
@@ -127,7 +162,7 @@ AudioStream::AudioBuffer* AudioStream::CreateAudioBuffer(unsigned int sampleCoun
 {
 	//Ensure that the audio output stream has been opened, and that valid number of
 	//samples and channels have been specified for this buffer.
-	if(!workerThreadRunning || (sampleCount <= 0) || (achannelCount <= 0))
+	if((!workerThreadRunning && (sink == 0)) || (sampleCount <= 0) || (achannelCount <= 0))
 	{
 		return 0;
 	}
@@ -165,7 +200,10 @@ AudioStream::AudioBuffer* AudioStream::CreateAudioBuffer(unsigned int sampleCoun
 		}
 
 		//Remove this buffer entry
-		pendingSampleCount -= ((unsigned int)entryToRemove->buffer.size() / channelCount);
+		unsigned int samplesInBufferEntry = ((unsigned int)entryToRemove->buffer.size() / channelCount);
+		pendingSampleCount -= samplesInBufferEntry;
+		droppedSampleCount += samplesInBufferEntry;
+		++overrunCount;
 		delete entryToRemove;
 		pendingBuffers.erase(pendingBufferIterator);
 		pendingBufferIterator = pendingBuffers.begin();
@@ -193,6 +231,10 @@ void AudioStream::DeleteAudioBuffer(AudioBuffer* buffer)
 			delete buffer;
 			done = true;
 		}
+		else
+		{
+			++pendingBufferIterator;
+		}
 	}
 	LeaveCriticalSection(&waveMutex);
 }
@@ -200,6 +242,37 @@ void AudioStream::DeleteAudioBuffer(AudioBuffer* buffer)
 //----------------------------------------------------------------------------------------
 void AudioStream::PlayBuffer(AudioBuffer* buffer)
 {
+	//If a capture sink has been attached, pass a copy of the sample data to it.
+	{
+		std::unique_lock<std::mutex> lock(captureSinkMutex);
+		if((captureSink != 0) && !buffer->buffer.empty())
+		{
+			captureSink->WriteSamples(&buffer->buffer[0], ((unsigned int)buffer->buffer.size() / channelCount));
+		}
+	}
+
+	//If the output is directed to an audio sink, remove the buffer from the pending
+	//buffer queue, pass the sample data directly to the sink, and delete the buffer.
+	if(sink != 0)
+	{
+		unsigned int samplesInBuffer = ((unsigned int)buffer->buffer.size() / channelCount);
+		EnterCriticalSection(&waveMutex);
+		std::list<AudioBuffer*>::iterator pendingBufferIterator = pendingBuffers.begin();
+		while((pendingBufferIterator != pendingBuffers.end()) && (*pendingBufferIterator != buffer))
+		{
+			++pendingBufferIterator;
+		}
+		if(pendingBufferIterator != pendingBuffers.end())
+		{
+			pendingBuffers.erase(pendingBufferIterator);
+		}
+		submittedSampleCount += samplesInBuffer;
+		LeaveCriticalSection(&waveMutex);
+		sink->WriteSamples(&buffer->buffer[0], samplesInBuffer);
+		delete buffer;
+		return;
+	}
+
 	EnterCriticalSection(&waveMutex);
 	buffer->playBuffer = true;
 	LeaveCriticalSection(&waveMutex);
@@ -226,6 +299,7 @@ void AudioStream::AddPendingBuffers(HWAVEOUT deviceHandle)
 		//samples
 		unsigned int samplesInBufferEntry = ((unsigned int)entry->buffer.size() / channelCount);
 		currentPlayingSamples += samplesInBufferEntry;
+		submittedSampleCount += samplesInBufferEntry;
 
 		//Add this buffer to the list of playing buffers
 		playingBuffers.push_back(entry);
@@ -249,6 +323,7 @@ void AudioStream::AddPendingBuffers(HWAVEOUT deviceHandle)
 		if(!addPendingBufferReturn)
 		{
 			currentPlayingSamples -= samplesInBufferEntry;
+			submittedSampleCount -= samplesInBufferEntry;
 			playingBuffers.pop_back();
 			delete entry;
 		}
@@ -266,6 +341,9 @@ void AudioStream::AddPendingBuffers(HWAVEOUT deviceHandle)
 	//the queue using the last sample of the last playing buffer.
 	if(!playingBuffers.empty() && (currentPlayingSamples < minPlayingSamples))
 	{
+		//Record that the output has underrun
+		++underrunCount;
+
 		//Extract the last sample values from the last buffer in the playback queue
 		AudioBuffer* lastPlayingBuffer = *playingBuffers.rbegin();
 		std::vector<short> sampleBuffer(channelCount);
@@ -308,6 +386,7 @@ void AudioStream::AddPendingBuffers(HWAVEOUT deviceHandle)
 			//Add the number of inserted samples in the filler buffer to the total count
 			//of playing samples
 			currentPlayingSamples += sampleCountToAdd;
+			fillerSampleCount += sampleCountToAdd;
 
 			//Add this buffer to the list of playing buffers
 			playingBuffers.push_back(fillerBuffer);
@@ -331,6 +410,7 @@ void AudioStream::AddPendingBuffers(HWAVEOUT deviceHandle)
 			if(!addPendingBufferReturn)
 			{
 				currentPlayingSamples -= sampleCountToAdd;
+				fillerSampleCount -= sampleCountToAdd;
 				playingBuffers.pop_back();
 				delete fillerBuffer;
 			}
@@ -415,6 +495,60 @@ void AudioStream::ClearCompletedBuffers(HWAVEOUT deviceHandle)
 	LeaveCriticalSection(&waveMutex);
 }
 
+//----------------------------------------------------------------------------------------
+//Statistics functions
+//----------------------------------------------------------------------------------------
+AudioStream::OutputStatistics AudioStream::GetOutputStatistics() const
+{
+	OutputStatistics statistics;
+	EnterCriticalSection(&waveMutex);
+
+	//Calculate the number of samples which are currently queued for output, and the
+	//number of samples which are waiting to be sent to the output.
+	statistics.queuedSampleCount = (sink != 0)? sink->GetQueuedSampleCount(): currentPlayingSamples;
+	for(std::list<AudioBuffer*>::const_iterator i = pendingBuffers.begin(); i != pendingBuffers.end(); ++i)
+	{
+		if((*i)->playBuffer && !(*i)->bufferSentToAudioDevice)
+		{
+			statistics.pendingSampleCount += (unsigned int)((*i)->buffer.size() / channelCount);
+		}
+	}
+	statistics.maxPendingSampleCount = maxPendingSamples;
+
+	//Return the accumulated output statistics
+	statistics.submittedSampleCount = submittedSampleCount;
+	statistics.overrunCount = overrunCount;
+	statistics.droppedSampleCount = droppedSampleCount;
+	statistics.underrunCount = underrunCount;
+	statistics.fillerSampleCount = fillerSampleCount;
+
+	LeaveCriticalSection(&waveMutex);
+	return statistics;
+}
+
+//----------------------------------------------------------------------------------------
+void AudioStream::ResetOutputStatistics()
+{
+	EnterCriticalSection(&waveMutex);
+	submittedSampleCount = 0;
+	overrunCount = 0;
+	droppedSampleCount = 0;
+	underrunCount = 0;
+	fillerSampleCount = 0;
+	LeaveCriticalSection(&waveMutex);
+}
+
+//----------------------------------------------------------------------------------------
+//Capture functions
+//----------------------------------------------------------------------------------------
+void AudioStream::SetCaptureSink(IAudioSink* acaptureSink)
+{
+	//Note that the capture sink is retained when the stream is closed and reopened, and
+	//that once this returns, the previous capture sink will receive no further samples.
+	std::unique_lock<std::mutex> lock(captureSinkMutex);
+	captureSink = acaptureSink;
+}
+
 //----------------------------------------------------------------------------------------
 //Worker thread functions
 //----------------------------------------------------------------------------------------
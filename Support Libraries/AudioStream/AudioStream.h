@@ -1,14 +1,17 @@
 #ifndef __AUDIOSTREAM_H__
 #define __AUDIOSTREAM_H__
 #include "WindowsSupport/WindowsSupport.pkg"
+#include "IAudioSink.h"
 #include <list>
 #include <vector>
+#include <mutex>
 
 class AudioStream
 {
 public:
 	//Structures
 	struct AudioBuffer;
+	struct OutputStatistics;
 
 	//Constructors
 	AudioStream();
@@ -16,6 +19,7 @@ public:
 
 	//Audio stream binding
 	bool Open(unsigned int achannelCount, unsigned int abitsPerSample, unsigned int asamplesPerSec, unsigned int amaxPendingSamples = 0, unsigned int aminPlayingSamples = 0);
+	bool Open(IAudioSink& asink, unsigned int achannelCount, unsigned int abitsPerSample, unsigned int asamplesPerSec);
 	void Close();
 
 	//Buffer management functions
@@ -23,6 +27,13 @@ public:
 	void DeleteAudioBuffer(AudioBuffer* buffer);
 	void PlayBuffer(AudioBuffer* buffer);
 
+	//Statistics functions
+	OutputStatistics GetOutputStatistics() const;
+	void ResetOutputStatistics();
+
+	//Capture functions
+	void SetCaptureSink(IAudioSink* acaptureSink);
+
 	//Sample rate conversion
 	static void ConvertSampleRate(const std::vector<short>& sourceData, unsigned int sourceSampleCount, unsigned int achannelCount, std::vector<short>& targetData, unsigned int targetSampleCount);
 
@@ -43,6 +54,13 @@ private:
 	unsigned int samplesPerSec;
 	unsigned int maxPendingSamples;
 
+	//Audio sink settings
+	IAudioSink* sink;
+
+	//Capture settings
+	std::mutex captureSinkMutex;
+	IAudioSink* captureSink;
+
 	//Worker thread event information
 	static const unsigned int EVENT_SHUTDOWN = 0;
 	static const unsigned int EVENT_PLAYBUFFER = 1;
@@ -53,12 +71,19 @@ private:
 	volatile bool workerThreadRunning;
 
 	//Audio buffer data
-	CRITICAL_SECTION waveMutex;
+	mutable CRITICAL_SECTION waveMutex;
 	unsigned int minPlayingSamples;
 	volatile unsigned int currentPlayingSamples;
 	std::list<AudioBuffer*> pendingBuffers;
 	std::list<AudioBuffer*> playingBuffers;
 	volatile unsigned int completedBufferSlots;
+
+	//Output statistics
+	unsigned long long submittedSampleCount;
+	unsigned int overrunCount;
+	unsigned long long droppedSampleCount;
+	unsigned int underrunCount;
+	unsigned long long fillerSampleCount;
 };
 
 #include "AudioStream.inl"
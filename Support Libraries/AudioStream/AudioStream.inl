@@ -12,3 +12,20 @@ struct AudioStream::AudioBuffer
 	bool playBuffer;
 	bool bufferSentToAudioDevice;
 };
+
+//----------------------------------------------------------------------------------------
+struct AudioStream::OutputStatistics
+{
+	OutputStatistics()
+	:queuedSampleCount(0), pendingSampleCount(0), maxPendingSampleCount(0), submittedSampleCount(0), overrunCount(0), droppedSampleCount(0), underrunCount(0), fillerSampleCount(0)
+	{}
+
+	unsigned int queuedSampleCount;           //Samples sent to the output device or sink which haven't yet been played
+	unsigned int pendingSampleCount;          //Samples waiting to be sent to the output device
+	unsigned int maxPendingSampleCount;       //Limit on buffered samples before the oldest are dropped
+	unsigned long long submittedSampleCount;  //Total samples sent to the output device or sink
+	unsigned int overrunCount;                //Number of times pending buffers were dropped because the output was falling behind
+	unsigned long long droppedSampleCount;    //Total samples dropped due to overruns
+	unsigned int underrunCount;               //Number of times the output ran low, and filler samples were inserted
+	unsigned long long fillerSampleCount;     //Total filler samples inserted due to underruns
+};
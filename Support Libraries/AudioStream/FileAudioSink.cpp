@@ -0,0 +1,40 @@
+#include "FileAudioSink.h"
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+FileAudioSink::FileAudioSink(const std::wstring& afilePath)
+:filePath(afilePath), channelCount(0)
+{}
+
+//----------------------------------------------------------------------------------------
+//Sink binding
+//----------------------------------------------------------------------------------------
+bool FileAudioSink::Open(unsigned int achannelCount, unsigned int bitsPerSample, unsigned int samplesPerSec)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	channelCount = achannelCount;
+	return wavFile.Open(wavFileWriter, filePath, channelCount, bitsPerSample, samplesPerSec);
+}
+
+//----------------------------------------------------------------------------------------
+void FileAudioSink::Close()
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	wavFile.Close();
+}
+
+//----------------------------------------------------------------------------------------
+//Sample output functions
+//----------------------------------------------------------------------------------------
+void FileAudioSink::WriteSamples(const short* data, unsigned int sampleCount)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	wavFile.WriteData(data, sampleCount * channelCount);
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int FileAudioSink::GetQueuedSampleCount() const
+{
+	return 0;
+}
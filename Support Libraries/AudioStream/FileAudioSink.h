@@ -0,0 +1,32 @@
+#ifndef __FILEAUDIOSINK_H__
+#define __FILEAUDIOSINK_H__
+#include "IAudioSink.h"
+#include "Stream/Stream.pkg"
+#include <string>
+#include <mutex>
+
+//The FileAudioSink class writes all audio data it receives to a WAV file. File writes are
+//performed on a background thread, so writing samples never blocks on the file system.
+class FileAudioSink :public IAudioSink
+{
+public:
+	//Constructors
+	FileAudioSink(const std::wstring& afilePath);
+
+	//Sink binding
+	virtual bool Open(unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec);
+	virtual void Close();
+
+	//Sample output functions
+	virtual void WriteSamples(const short* data, unsigned int sampleCount);
+	virtual unsigned int GetQueuedSampleCount() const;
+
+private:
+	std::mutex accessMutex;
+	std::wstring filePath;
+	unsigned int channelCount;
+	Stream::WAVFileWriter wavFileWriter;
+	Stream::BufferedWAVFile wavFile;
+};
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef __IAUDIOCAPTURESOURCE_H__
+#define __IAUDIOCAPTURESOURCE_H__
+#include "IAudioSink.h"
+
+//The IAudioCaptureSource interface is implemented by any device which can send a copy of
+//its audio output to a capture sink, alongside its normal audio output. The device opens
+//the sink with the format of its output before it begins writing to it. Passing a null
+//sink stops the capture.
+class IAudioCaptureSource
+{
+public:
+	//Constructors
+	virtual ~IAudioCaptureSource() = 0 {}
+
+	//Capture functions
+	virtual bool SetAudioCaptureSink(IAudioSink* sink) = 0;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef __IAUDIOSINK_H__
+#define __IAUDIOSINK_H__
+
+//The IAudioSink interface is implemented by any target which can consume the output of
+//an AudioStream in place of the audio output device. Sample data is always supplied as
+//interleaved signed 16-bit samples, with the sample counts given in sample frames, where
+//each frame contains one sample for each channel.
+class IAudioSink
+{
+public:
+	//Constructors
+	virtual ~IAudioSink() = 0 {}
+
+	//Sink binding
+	virtual bool Open(unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec) = 0;
+	virtual void Close() = 0;
+
+	//Sample output functions
+	virtual void WriteSamples(const short* data, unsigned int sampleCount) = 0;
+	virtual unsigned int GetQueuedSampleCount() const = 0;
+};
+
+#endif
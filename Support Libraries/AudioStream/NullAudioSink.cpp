@@ -0,0 +1,58 @@
+#include "NullAudioSink.h"
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+NullAudioSink::NullAudioSink()
+:receivedSampleCount(0), openTime(std::chrono::steady_clock::now())
+{}
+
+//----------------------------------------------------------------------------------------
+//Sink binding
+//----------------------------------------------------------------------------------------
+bool NullAudioSink::Open(unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	receivedSampleCount = 0;
+	openTime = std::chrono::steady_clock::now();
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+void NullAudioSink::Close()
+{}
+
+//----------------------------------------------------------------------------------------
+//Sample output functions
+//----------------------------------------------------------------------------------------
+void NullAudioSink::WriteSamples(const short* data, unsigned int sampleCount)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	receivedSampleCount += sampleCount;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int NullAudioSink::GetQueuedSampleCount() const
+{
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------
+//Statistics functions
+//----------------------------------------------------------------------------------------
+unsigned long long NullAudioSink::GetReceivedSampleCount() const
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	return receivedSampleCount;
+}
+
+//----------------------------------------------------------------------------------------
+double NullAudioSink::GetReceivedSampleRate() const
+{
+	//Calculate the average number of sample frames received per second since the sink
+	//was opened. If the system is running faster than realtime, this will exceed the
+	//nominal sample rate of the stream.
+	std::unique_lock<std::mutex> lock(accessMutex);
+	double elapsedTimeInSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - openTime).count();
+	return (elapsedTimeInSeconds > 0.0)? ((double)receivedSampleCount / elapsedTimeInSeconds): 0.0;
+}
@@ -0,0 +1,35 @@
+#ifndef __NULLAUDIOSINK_H__
+#define __NULLAUDIOSINK_H__
+#include "IAudioSink.h"
+#include <mutex>
+#include <chrono>
+
+//The NullAudioSink class discards all audio data it receives. This allows the system to
+//run unthrottled, or without an audio output device, while still exercising the complete
+//audio generation path. The sink keeps a count of the received samples, and reports the
+//rate at which samples are being produced.
+class NullAudioSink :public IAudioSink
+{
+public:
+	//Constructors
+	NullAudioSink();
+
+	//Sink binding
+	virtual bool Open(unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec);
+	virtual void Close();
+
+	//Sample output functions
+	virtual void WriteSamples(const short* data, unsigned int sampleCount);
+	virtual unsigned int GetQueuedSampleCount() const;
+
+	//Statistics functions
+	unsigned long long GetReceivedSampleCount() const;
+	double GetReceivedSampleRate() const;
+
+private:
+	mutable std::mutex accessMutex;
+	unsigned long long receivedSampleCount;
+	std::chrono::steady_clock::time_point openTime;
+};
+
+#endif
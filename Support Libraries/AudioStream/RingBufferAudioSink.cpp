@@ -0,0 +1,138 @@
+#include "RingBufferAudioSink.h"
+#include <algorithm>
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+RingBufferAudioSink::RingBufferAudioSink(unsigned int acapacityInSamples)
+:channelCount(1), capacityInSamples(acapacityInSamples), readPos(0), queuedSampleCount(0), overrunCount(0), underrunCount(0), droppedSampleCount(0)
+{}
+
+//----------------------------------------------------------------------------------------
+//Sink binding
+//----------------------------------------------------------------------------------------
+bool RingBufferAudioSink::Open(unsigned int achannelCount, unsigned int bitsPerSample, unsigned int samplesPerSec)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	if((achannelCount == 0) || (capacityInSamples == 0))
+	{
+		return false;
+	}
+	channelCount = achannelCount;
+	buffer.assign(capacityInSamples * channelCount, 0);
+	readPos = 0;
+	queuedSampleCount = 0;
+	overrunCount = 0;
+	underrunCount = 0;
+	droppedSampleCount = 0;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+void RingBufferAudioSink::Close()
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	std::vector<short>().swap(buffer);
+	readPos = 0;
+	queuedSampleCount = 0;
+}
+
+//----------------------------------------------------------------------------------------
+//Sample output functions
+//----------------------------------------------------------------------------------------
+void RingBufferAudioSink::WriteSamples(const short* data, unsigned int sampleCount)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	if(buffer.empty())
+	{
+		return;
+	}
+
+	//If the new samples won't fit in the buffer, discard the oldest samples to make room.
+	//If more samples were supplied than the buffer can hold at all, only the most recent
+	//samples from the supplied data are retained.
+	if(sampleCount > capacityInSamples)
+	{
+		droppedSampleCount += (sampleCount - capacityInSamples);
+		data += (sampleCount - capacityInSamples) * channelCount;
+		sampleCount = capacityInSamples;
+		++overrunCount;
+	}
+	if((queuedSampleCount + sampleCount) > capacityInSamples)
+	{
+		unsigned int samplesToDiscard = (queuedSampleCount + sampleCount) - capacityInSamples;
+		readPos = (readPos + samplesToDiscard) % capacityInSamples;
+		queuedSampleCount -= samplesToDiscard;
+		droppedSampleCount += samplesToDiscard;
+		++overrunCount;
+	}
+
+	//Copy the samples into the buffer, wrapping around at the end of the buffer.
+	unsigned int writePos = (readPos + queuedSampleCount) % capacityInSamples;
+	while(sampleCount > 0)
+	{
+		unsigned int samplesToWrite = std::min(sampleCount, capacityInSamples - writePos);
+		std::copy(data, data + (samplesToWrite * channelCount), buffer.begin() + (writePos * channelCount));
+		data += samplesToWrite * channelCount;
+		sampleCount -= samplesToWrite;
+		queuedSampleCount += samplesToWrite;
+		writePos = (writePos + samplesToWrite) % capacityInSamples;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int RingBufferAudioSink::GetQueuedSampleCount() const
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	return queuedSampleCount;
+}
+
+//----------------------------------------------------------------------------------------
+//Sample input functions
+//----------------------------------------------------------------------------------------
+unsigned int RingBufferAudioSink::ReadSamples(short* data, unsigned int sampleCount)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+
+	//If fewer samples are available than were requested, record an underrun.
+	if(sampleCount > queuedSampleCount)
+	{
+		sampleCount = queuedSampleCount;
+		++underrunCount;
+	}
+
+	//Copy the samples out of the buffer, wrapping around at the end of the buffer.
+	unsigned int samplesRead = 0;
+	while(samplesRead < sampleCount)
+	{
+		unsigned int samplesToRead = std::min(sampleCount - samplesRead, capacityInSamples - readPos);
+		std::copy(buffer.begin() + (readPos * channelCount), buffer.begin() + ((readPos + samplesToRead) * channelCount), data + (samplesRead * channelCount));
+		samplesRead += samplesToRead;
+		readPos = (readPos + samplesToRead) % capacityInSamples;
+	}
+	queuedSampleCount -= samplesRead;
+	return samplesRead;
+}
+
+//----------------------------------------------------------------------------------------
+//Statistics functions
+//----------------------------------------------------------------------------------------
+unsigned int RingBufferAudioSink::GetOverrunCount() const
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	return overrunCount;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int RingBufferAudioSink::GetUnderrunCount() const
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	return underrunCount;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned long long RingBufferAudioSink::GetDroppedSampleCount() const
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	return droppedSampleCount;
+}
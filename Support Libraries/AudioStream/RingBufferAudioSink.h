@@ -0,0 +1,46 @@
+#ifndef __RINGBUFFERAUDIOSINK_H__
+#define __RINGBUFFERAUDIOSINK_H__
+#include "IAudioSink.h"
+#include <vector>
+#include <mutex>
+
+//The RingBufferAudioSink class holds the most recent audio data it receives in a fixed
+//size circular buffer in memory, where it can be retrieved by a consumer. If the buffer
+//fills, the oldest samples are discarded, and an overrun is recorded. If the consumer
+//requests more samples than are currently held, the available samples are returned, and
+//an underrun is recorded.
+class RingBufferAudioSink :public IAudioSink
+{
+public:
+	//Constructors
+	RingBufferAudioSink(unsigned int acapacityInSamples);
+
+	//Sink binding
+	virtual bool Open(unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec);
+	virtual void Close();
+
+	//Sample output functions
+	virtual void WriteSamples(const short* data, unsigned int sampleCount);
+	virtual unsigned int GetQueuedSampleCount() const;
+
+	//Sample input functions
+	unsigned int ReadSamples(short* data, unsigned int sampleCount);
+
+	//Statistics functions
+	unsigned int GetOverrunCount() const;
+	unsigned int GetUnderrunCount() const;
+	unsigned long long GetDroppedSampleCount() const;
+
+private:
+	mutable std::mutex accessMutex;
+	unsigned int channelCount;
+	unsigned int capacityInSamples;
+	std::vector<short> buffer;
+	unsigned int readPos;
+	unsigned int queuedSampleCount;
+	unsigned int overrunCount;
+	unsigned int underrunCount;
+	unsigned long long droppedSampleCount;
+};
+
+#endif
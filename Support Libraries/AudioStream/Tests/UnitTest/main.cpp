@@ -0,0 +1,266 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "AudioStream/AudioStream.pkg"
+#include <vector>
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+static std::vector<short> BuildSampleRamp(unsigned int sampleCount, unsigned int channelCount, short firstValue)
+{
+	std::vector<short> samples(sampleCount * channelCount);
+	for(unsigned int i = 0; i < (unsigned int)samples.size(); ++i)
+	{
+		samples[i] = (short)(firstValue + (short)i);
+	}
+	return samples;
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("RingBufferAudioSink", "")
+{
+	static const unsigned int channelCount = 2;
+	static const unsigned int capacityInSamples = 16;
+	RingBufferAudioSink sink(capacityInSamples);
+	REQUIRE(sink.Open(channelCount, 16, 48000));
+
+	SECTION("Write and read", "")
+	{
+		std::vector<short> samples = BuildSampleRamp(10, channelCount, 0);
+		sink.WriteSamples(&samples[0], 10);
+		REQUIRE(sink.GetQueuedSampleCount() == 10);
+
+		std::vector<short> readBuffer(10 * channelCount);
+		REQUIRE(sink.ReadSamples(&readBuffer[0], 10) == 10);
+		CHECK(readBuffer == samples);
+		CHECK(sink.GetQueuedSampleCount() == 0);
+		CHECK(sink.GetOverrunCount() == 0);
+		CHECK(sink.GetUnderrunCount() == 0);
+	}
+	SECTION("Wrap around", "")
+	{
+		//Advance the read position part way through the buffer, so the next write wraps
+		//around the end of the buffer.
+		std::vector<short> samples = BuildSampleRamp(12, channelCount, 0);
+		std::vector<short> readBuffer(12 * channelCount);
+		sink.WriteSamples(&samples[0], 12);
+		REQUIRE(sink.ReadSamples(&readBuffer[0], 12) == 12);
+
+		samples = BuildSampleRamp(12, channelCount, 100);
+		sink.WriteSamples(&samples[0], 12);
+		REQUIRE(sink.ReadSamples(&readBuffer[0], 12) == 12);
+		CHECK(readBuffer == samples);
+	}
+	SECTION("Overrun", "")
+	{
+		//Writing past the capacity of the buffer discards the oldest samples.
+		std::vector<short> samples = BuildSampleRamp(12, channelCount, 0);
+		sink.WriteSamples(&samples[0], 12);
+		sink.WriteSamples(&samples[0], 12);
+		CHECK(sink.GetQueuedSampleCount() == capacityInSamples);
+		CHECK(sink.GetOverrunCount() == 1);
+		CHECK(sink.GetDroppedSampleCount() == 8);
+
+		std::vector<short> readBuffer(capacityInSamples * channelCount);
+		REQUIRE(sink.ReadSamples(&readBuffer[0], capacityInSamples) == capacityInSamples);
+		CHECK(std::vector<short>(readBuffer.begin(), readBuffer.begin() + (4 * channelCount)) == std::vector<short>(samples.begin() + (8 * channelCount), samples.end()));
+		CHECK(std::vector<short>(readBuffer.begin() + (4 * channelCount), readBuffer.end()) == samples);
+	}
+	SECTION("Underrun", "")
+	{
+		std::vector<short> samples = BuildSampleRamp(4, channelCount, 0);
+		sink.WriteSamples(&samples[0], 4);
+		std::vector<short> readBuffer(8 * channelCount);
+		CHECK(sink.ReadSamples(&readBuffer[0], 8) == 4);
+		CHECK(sink.GetUnderrunCount() == 1);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("NullAudioSink", "")
+{
+	NullAudioSink sink;
+	REQUIRE(sink.Open(2, 16, 48000));
+	std::vector<short> samples = BuildSampleRamp(100, 2, 0);
+	sink.WriteSamples(&samples[0], 100);
+	sink.WriteSamples(&samples[0], 50);
+	CHECK(sink.GetReceivedSampleCount() == 150);
+	CHECK(sink.GetQueuedSampleCount() == 0);
+	CHECK(sink.GetReceivedSampleRate() > 0.0);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("AudioStream", "")
+{
+	static const unsigned int channelCount = 2;
+	RingBufferAudioSink sink(4096);
+	AudioStream audioStream;
+	REQUIRE(audioStream.Open(sink, channelCount, 16, 48000));
+
+	SECTION("Sink output", "")
+	{
+		//Buffers played through a stream bound to a sink must arrive at the sink
+		//unchanged, in the order they were played.
+		std::vector<short> firstSamples = BuildSampleRamp(800, channelCount, 0);
+		std::vector<short> secondSamples = BuildSampleRamp(400, channelCount, 5000);
+		AudioStream::AudioBuffer* firstBuffer = audioStream.CreateAudioBuffer(800, channelCount);
+		AudioStream::AudioBuffer* secondBuffer = audioStream.CreateAudioBuffer(400, channelCount);
+		REQUIRE(firstBuffer != 0);
+		REQUIRE(secondBuffer != 0);
+		firstBuffer->buffer = firstSamples;
+		secondBuffer->buffer = secondSamples;
+		audioStream.PlayBuffer(firstBuffer);
+		audioStream.PlayBuffer(secondBuffer);
+
+		std::vector<short> readBuffer(1200 * channelCount);
+		REQUIRE(sink.ReadSamples(&readBuffer[0], 1200) == 1200);
+		CHECK(std::vector<short>(readBuffer.begin(), readBuffer.begin() + firstSamples.size()) == firstSamples);
+		CHECK(std::vector<short>(readBuffer.begin() + firstSamples.size(), readBuffer.end()) == secondSamples);
+
+		AudioStream::OutputStatistics statistics = audioStream.GetOutputStatistics();
+		CHECK(statistics.submittedSampleCount == 1200);
+		CHECK(statistics.pendingSampleCount == 0);
+		CHECK(statistics.overrunCount == 0);
+		CHECK(statistics.underrunCount == 0);
+	}
+	SECTION("Queued sample count", "")
+	{
+		AudioStream::AudioBuffer* buffer = audioStream.CreateAudioBuffer(256, channelCount);
+		REQUIRE(buffer != 0);
+		audioStream.PlayBuffer(buffer);
+		CHECK(audioStream.GetOutputStatistics().queuedSampleCount == 256);
+	}
+	SECTION("Close", "")
+	{
+		audioStream.Close();
+		CHECK(audioStream.CreateAudioBuffer(256, channelCount) == 0);
+	}
+	SECTION("Capture sink", "")
+	{
+		//A capture sink receives a copy of every buffer played while it's attached, and
+		//nothing once it's been detached, without affecting the normal output.
+		RingBufferAudioSink captureSink(4096);
+		REQUIRE(captureSink.Open(channelCount, 16, 48000));
+		audioStream.SetCaptureSink(&captureSink);
+		std::vector<short> samples = BuildSampleRamp(300, channelCount, 0);
+		AudioStream::AudioBuffer* buffer = audioStream.CreateAudioBuffer(300, channelCount);
+		REQUIRE(buffer != 0);
+		buffer->buffer = samples;
+		audioStream.PlayBuffer(buffer);
+		audioStream.SetCaptureSink(0);
+		buffer = audioStream.CreateAudioBuffer(300, channelCount);
+		REQUIRE(buffer != 0);
+		audioStream.PlayBuffer(buffer);
+
+		std::vector<short> readBuffer(300 * channelCount);
+		REQUIRE(captureSink.ReadSamples(&readBuffer[0], 300) == 300);
+		CHECK(readBuffer == samples);
+		CHECK(captureSink.GetQueuedSampleCount() == 0);
+		CHECK(sink.GetQueuedSampleCount() == 600);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("AudioMixer", "")
+{
+	static const unsigned int channelCount = 2;
+	static const unsigned int samplesPerSec = 48000;
+	AudioMixer mixer(channelCount, samplesPerSec, 1024);
+
+	SECTION("Input format", "")
+	{
+		//Inputs must match the sample rate of the mixer, but may have any channel count.
+		IAudioSink* input = mixer.CreateInput();
+		CHECK(input->Open(1, 16, samplesPerSec));
+		CHECK(input->Open(2, 16, samplesPerSec));
+		CHECK(!input->Open(2, 16, 44100));
+		CHECK(!input->Open(2, 8, samplesPerSec));
+		mixer.DeleteInput(input);
+	}
+	SECTION("Mix", "")
+	{
+		//A stereo input is mixed channel for channel, and a mono input is output on both
+		//channels.
+		IAudioSink* stereoInput = mixer.CreateInput();
+		IAudioSink* monoInput = mixer.CreateInput();
+		REQUIRE(stereoInput->Open(2, 16, samplesPerSec));
+		REQUIRE(monoInput->Open(1, 16, samplesPerSec));
+		std::vector<short> stereoSamples = BuildSampleRamp(100, 2, 0);
+		std::vector<short> monoSamples = BuildSampleRamp(100, 1, 1000);
+		stereoInput->WriteSamples(&stereoSamples[0], 100);
+		monoInput->WriteSamples(&monoSamples[0], 100);
+
+		std::vector<short> mixedSamples(100 * channelCount);
+		mixer.ReadMixedSamples(&mixedSamples[0], 100);
+		unsigned int mismatchCount = 0;
+		for(unsigned int sampleNo = 0; sampleNo < 100; ++sampleNo)
+		{
+			for(unsigned int channelNo = 0; channelNo < channelCount; ++channelNo)
+			{
+				short expectedSample = (short)(stereoSamples[(sampleNo * 2) + channelNo] + monoSamples[sampleNo]);
+				if(mixedSamples[(sampleNo * channelCount) + channelNo] != expectedSample)
+				{
+					++mismatchCount;
+				}
+			}
+		}
+		CHECK(mismatchCount == 0);
+		CHECK(mixer.GetUnderrunCount() == 0);
+	}
+	SECTION("Underrun", "")
+	{
+		//An input which falls behind is padded with silence, and an underrun recorded.
+		IAudioSink* input = mixer.CreateInput();
+		REQUIRE(input->Open(channelCount, 16, samplesPerSec));
+		std::vector<short> samples = BuildSampleRamp(50, channelCount, 1);
+		input->WriteSamples(&samples[0], 50);
+
+		std::vector<short> mixedSamples(100 * channelCount, 1);
+		mixer.ReadMixedSamples(&mixedSamples[0], 100);
+		CHECK(std::vector<short>(mixedSamples.begin(), mixedSamples.begin() + samples.size()) == samples);
+		CHECK(std::vector<short>(mixedSamples.begin() + samples.size(), mixedSamples.end()) == std::vector<short>(50 * channelCount, 0));
+		CHECK(mixer.GetUnderrunCount() == 1);
+	}
+	SECTION("Overrun", "")
+	{
+		//An input which isn't read keeps only the most recent samples which fit in its
+		//queue, and never blocks the writer.
+		IAudioSink* input = mixer.CreateInput();
+		REQUIRE(input->Open(channelCount, 16, samplesPerSec));
+		std::vector<short> samples = BuildSampleRamp(1000, channelCount, 0);
+		input->WriteSamples(&samples[0], 1000);
+		input->WriteSamples(&samples[0], 1000);
+		CHECK(input->GetQueuedSampleCount() == 1024);
+		CHECK(mixer.GetOverrunCount() == 1);
+	}
+	SECTION("Clamp", "")
+	{
+		//Mixed samples are clamped to the output range rather than wrapping.
+		IAudioSink* firstInput = mixer.CreateInput();
+		IAudioSink* secondInput = mixer.CreateInput();
+		REQUIRE(firstInput->Open(1, 16, samplesPerSec));
+		REQUIRE(secondInput->Open(1, 16, samplesPerSec));
+		short loudSamples[2] = {30000, -30000};
+		firstInput->WriteSamples(&loudSamples[0], 2);
+		secondInput->WriteSamples(&loudSamples[0], 2);
+
+		std::vector<short> mixedSamples(2 * channelCount);
+		mixer.ReadMixedSamples(&mixedSamples[0], 2);
+		CHECK(mixedSamples[0] == 32767);
+		CHECK(mixedSamples[1] == 32767);
+		CHECK(mixedSamples[2] == -32768);
+		CHECK(mixedSamples[3] == -32768);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("AudioStream::ConvertSampleRate", "")
+{
+	//Converting to the same sample count must reproduce the source data exactly.
+	std::vector<short> sourceData = BuildSampleRamp(1000, 2, -500);
+	std::vector<short> targetData(sourceData.size());
+	AudioStream::ConvertSampleRate(sourceData, 1000, 2, targetData, 1000);
+	CHECK(targetData == sourceData);
+}
@@ -1,15 +1,16 @@
 #include "HierarchicalStorageNode.h"
+#include <algorithm>
 
 //----------------------------------------------------------------------------------------
 //Constructors
 //----------------------------------------------------------------------------------------
 HierarchicalStorageNode::HierarchicalStorageNode()
-:parent(0), binaryDataPresent(false), inlineBinaryData(false), dataStream(Stream::IStream::TextEncoding::UTF16, Stream::IStream::NewLineEncoding::Unix, Stream::IStream::ByteOrder::BigEndian, 0)
+:parent(0), childIndexValid(false), attributeIndexValid(false), binaryDataPresent(false), inlineBinaryData(false), dataStream(Stream::IStream::TextEncoding::UTF16, Stream::IStream::NewLineEncoding::Unix, Stream::IStream::ByteOrder::BigEndian, 0)
 {}
 
 //----------------------------------------------------------------------------------------
 HierarchicalStorageNode::HierarchicalStorageNode(const std::wstring& aname)
-:name(aname), parent(0), binaryDataPresent(false), inlineBinaryData(false), dataStream(Stream::IStream::TextEncoding::UTF16, Stream::IStream::NewLineEncoding::Unix, Stream::IStream::ByteOrder::BigEndian, 0)
+:name(aname), parent(0), childIndexValid(false), attributeIndexValid(false), binaryDataPresent(false), inlineBinaryData(false), dataStream(Stream::IStream::TextEncoding::UTF16, Stream::IStream::NewLineEncoding::Unix, Stream::IStream::ByteOrder::BigEndian, 0)
 {}
 
 //----------------------------------------------------------------------------------------
@@ -31,6 +32,8 @@ void HierarchicalStorageNode::Initialize()
 	}
 	children.clear();
 	attributes.clear();
+	UpdateChildIndex();
+	UpdateAttributeIndex();
 	binaryDataName.clear();
 	binaryDataPresent = false;
 }
@@ -46,7 +49,15 @@ MarshalSupport::Marshal::Ret<std::wstring> HierarchicalStorageNode::GetName() co
 //----------------------------------------------------------------------------------------
 void HierarchicalStorageNode::SetName(const MarshalSupport::Marshal::In<std::wstring>& aname)
 {
+	std::wstring oldName = name;
 	name = aname;
+
+	//Since our parent may index its children by name, move our entry in its index over
+	//to the new name.
+	if(parent != 0)
+	{
+		parent->RenameChildIndexEntry(this, oldName);
+	}
 }
 
 //----------------------------------------------------------------------------------------
@@ -93,6 +104,14 @@ IHierarchicalStorageNode& HierarchicalStorageNode::CreateChild()
 	HierarchicalStorageNode* child = new HierarchicalStorageNode();
 	child->SetParent(this);
 	children.push_back(child);
+	if(childIndexValid)
+	{
+		childIndex[child->name].push_back((unsigned int)(children.size() - 1));
+	}
+	else
+	{
+		UpdateChildIndex();
+	}
 	return *child;
 }
 
@@ -102,6 +121,14 @@ IHierarchicalStorageNode& HierarchicalStorageNode::CreateChild(const MarshalSupp
 	HierarchicalStorageNode* child = new HierarchicalStorageNode(aname);
 	child->SetParent(this);
 	children.push_back(child);
+	if(childIndexValid)
+	{
+		childIndex[child->name].push_back((unsigned int)(children.size() - 1));
+	}
+	else
+	{
+		UpdateChildIndex();
+	}
 	return *child;
 }
 
@@ -114,6 +141,7 @@ void HierarchicalStorageNode::DeleteChild(IHierarchicalStorageNode& node)
 		if(*childListIterator == &node)
 		{
 			children.erase(childListIterator);
+			UpdateChildIndex();
 			return;
 		}
 		++childListIterator;
@@ -134,31 +162,52 @@ MarshalSupport::Marshal::Ret<std::list<IHierarchicalStorageNode*>> HierarchicalS
 //----------------------------------------------------------------------------------------
 bool HierarchicalStorageNode::IsChildPresent(const MarshalSupport::Marshal::In<std::wstring>& name) const
 {
-	std::wstring nameResolved = name.Get();
-	for(ChildList::const_iterator i = children.begin(); i != children.end(); ++i)
-	{
-		HierarchicalStorageNode* childNode = *i;
-		if(childNode->GetName() == nameResolved)
-		{
-			return true;
-		}
-	}
-	return false;
+	return (GetChild(name) != 0);
 }
 
 //----------------------------------------------------------------------------------------
 IHierarchicalStorageNode* HierarchicalStorageNode::GetChild(const MarshalSupport::Marshal::In<std::wstring>& name, const IHierarchicalStorageNode* searchAfterChildNode) const
 {
 	std::wstring nameResolved = name.Get();
-	bool foundSearchStartNode = (searchAfterChildNode == 0);
-	for(ChildList::const_iterator i = children.begin(); i != children.end(); ++i)
+
+	//If we don't have an index for our children, perform a linear search for the target
+	//child.
+	if(!childIndexValid)
+	{
+		bool foundSearchStartNode = (searchAfterChildNode == 0);
+		for(ChildList::const_iterator i = children.begin(); i != children.end(); ++i)
+		{
+			HierarchicalStorageNode* childNode = *i;
+			if(foundSearchStartNode && (childNode->name == nameResolved))
+			{
+				return childNode;
+			}
+			foundSearchStartNode |= (childNode == searchAfterChildNode);
+		}
+		return 0;
+	}
+
+	//Retrieve the list of children with the target name from the index
+	ChildIndex::const_iterator childIndexIterator = childIndex.find(nameResolved);
+	if(childIndexIterator == childIndex.end())
+	{
+		return 0;
+	}
+	const std::vector<unsigned int>& matchingChildren = childIndexIterator->second;
+	if(searchAfterChildNode == 0)
+	{
+		return children[matchingChildren.front()];
+	}
+
+	//Locate the child we've been asked to start the search after, and return the first
+	//matching child after it.
+	for(unsigned int searchStartIndex = 0; searchStartIndex < (unsigned int)children.size(); ++searchStartIndex)
 	{
-		HierarchicalStorageNode* childNode = *i;
-		if(foundSearchStartNode && (childNode->GetName() == nameResolved))
+		if(children[searchStartIndex] == searchAfterChildNode)
 		{
-			return childNode;
+			std::vector<unsigned int>::const_iterator matchingChildIterator = std::upper_bound(matchingChildren.begin(), matchingChildren.end(), searchStartIndex);
+			return (matchingChildIterator != matchingChildren.end())? children[*matchingChildIterator]: 0;
 		}
-		foundSearchStartNode |= (childNode == searchAfterChildNode);
 	}
 	return 0;
 }
@@ -168,21 +217,22 @@ IHierarchicalStorageNode* HierarchicalStorageNode::GetChild(const MarshalSupport
 //----------------------------------------------------------------------------------------
 bool HierarchicalStorageNode::IsAttributePresent(const MarshalSupport::Marshal::In<std::wstring>& name) const
 {
-	std::wstring nameResolved = name.Get();
-	for(AttributeList::const_iterator i = attributes.begin(); i != attributes.end(); ++i)
-	{
-		if(i->first == nameResolved)
-		{
-			return true;
-		}
-	}
-	return false;
+	return (GetAttribute(name) != 0);
 }
 
 //----------------------------------------------------------------------------------------
 IHierarchicalStorageAttribute* HierarchicalStorageNode::GetAttribute(const MarshalSupport::Marshal::In<std::wstring>& name) const
 {
 	std::wstring nameResolved = name.Get();
+
+	//If we have an index for our attributes, use it to locate the target attribute.
+	if(attributeIndexValid)
+	{
+		AttributeIndex::const_iterator attributeIndexIterator = attributeIndex.find(nameResolved);
+		return (attributeIndexIterator != attributeIndex.end())? attributes[attributeIndexIterator->second].second: 0;
+	}
+
+	//Perform a linear search for the target attribute
 	for(AttributeList::const_iterator i = attributes.begin(); i != attributes.end(); ++i)
 	{
 		if(i->first == nameResolved)
@@ -196,12 +246,21 @@ IHierarchicalStorageAttribute* HierarchicalStorageNode::GetAttribute(const Marsh
 //----------------------------------------------------------------------------------------
 IHierarchicalStorageAttribute& HierarchicalStorageNode::CreateAttribute(const MarshalSupport::Marshal::In<std::wstring>& name)
 {
-	IHierarchicalStorageAttribute* attribute = GetAttribute(name);
+	std::wstring nameResolved = name.Get();
+	IHierarchicalStorageAttribute* attribute = GetAttribute(nameResolved);
 	if(attribute == 0)
 	{
-		HierarchicalStorageAttribute* newAttribute = new HierarchicalStorageAttribute(name);
+		HierarchicalStorageAttribute* newAttribute = new HierarchicalStorageAttribute(nameResolved);
 		attribute = newAttribute;
-		attributes.push_back(AttributeListEntry(name, newAttribute));
+		attributes.push_back(AttributeListEntry(nameResolved, newAttribute));
+		if(attributeIndexValid)
+		{
+			attributeIndex.insert(AttributeIndex::value_type(nameResolved, (unsigned int)(attributes.size() - 1)));
+		}
+		else
+		{
+			UpdateAttributeIndex();
+		}
 	}
 	return *attribute;
 }
@@ -215,8 +274,10 @@ void HierarchicalStorageNode::DeleteAttribute(IHierarchicalStorageAttribute& att
 		if(attributeIterator->second == &attribute)
 		{
 			attributes.erase(attributeIterator);
+			UpdateAttributeIndex();
 			return;
 		}
+		++attributeIterator;
 	}
 }
 
@@ -231,6 +292,81 @@ MarshalSupport::Marshal::Ret<std::list<IHierarchicalStorageAttribute*>> Hierarch
 	return attributeList;
 }
 
+//----------------------------------------------------------------------------------------
+//Lookup index functions
+//----------------------------------------------------------------------------------------
+void HierarchicalStorageNode::UpdateChildIndex()
+{
+	//Discard the current index, and if we now have enough children to warrant an index,
+	//build a list of the indexes of the children with each name, in the order they appear
+	//in our child list. Note that we rebuild the index in full here, since removing a
+	//child shifts the position of every child after it.
+	childIndex.clear();
+	childIndexValid = false;
+	if(children.size() <= lookupIndexThreshold)
+	{
+		return;
+	}
+	for(unsigned int i = 0; i < (unsigned int)children.size(); ++i)
+	{
+		childIndex[children[i]->name].push_back(i);
+	}
+	childIndexValid = true;
+}
+
+//----------------------------------------------------------------------------------------
+void HierarchicalStorageNode::UpdateAttributeIndex()
+{
+	//Discard the current index, and if we now have enough attributes to warrant an
+	//index, build the index of attribute names. Note that since attribute names are
+	//unique, there's only ever one attribute with each name.
+	attributeIndex.clear();
+	attributeIndexValid = false;
+	if(attributes.size() <= lookupIndexThreshold)
+	{
+		return;
+	}
+	for(unsigned int i = 0; i < (unsigned int)attributes.size(); ++i)
+	{
+		attributeIndex.insert(AttributeIndex::value_type(attributes[i].first, i));
+	}
+	attributeIndexValid = true;
+}
+
+//----------------------------------------------------------------------------------------
+void HierarchicalStorageNode::RenameChildIndexEntry(const HierarchicalStorageNode* child, const std::wstring& oldName)
+{
+	if(!childIndexValid)
+	{
+		return;
+	}
+
+	//Remove the entry for the child from the list of children with its old name
+	ChildIndex::iterator childIndexIterator = childIndex.find(oldName);
+	if(childIndexIterator == childIndex.end())
+	{
+		return;
+	}
+	std::vector<unsigned int>& oldNameChildren = childIndexIterator->second;
+	for(std::vector<unsigned int>::iterator i = oldNameChildren.begin(); i != oldNameChildren.end(); ++i)
+	{
+		if(children[*i] == child)
+		{
+			//Insert the entry into the list of children with the new name, keeping the
+			//list in the order the children appear in our child list.
+			unsigned int childListIndex = *i;
+			oldNameChildren.erase(i);
+			if(oldNameChildren.empty())
+			{
+				childIndex.erase(childIndexIterator);
+			}
+			std::vector<unsigned int>& newNameChildren = childIndex[child->name];
+			newNameChildren.insert(std::lower_bound(newNameChildren.begin(), newNameChildren.end(), childListIndex), childListIndex);
+			return;
+		}
+	}
+}
+
 //----------------------------------------------------------------------------------------
 //Common data functions
 //----------------------------------------------------------------------------------------
@@ -298,3 +434,17 @@ void HierarchicalStorageNode::AddBinaryDataEntitiesToList(std::list<IHierarchica
 		(*i)->AddBinaryDataEntitiesToList(binaryEntityList);
 	}
 }
+
+//----------------------------------------------------------------------------------------
+//Child index functions
+//----------------------------------------------------------------------------------------
+unsigned int HierarchicalStorageNode::GetChildCount() const
+{
+	return (unsigned int)children.size();
+}
+
+//----------------------------------------------------------------------------------------
+IHierarchicalStorageNode* HierarchicalStorageNode::GetChildAtIndex(unsigned int index) const
+{
+	return (index < (unsigned int)children.size())? children[index]: 0;
+}
@@ -5,6 +5,7 @@
 #include "Stream/Stream.pkg"
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <string>
 
 class HierarchicalStorageNode :public IHierarchicalStorageNode
@@ -52,6 +53,10 @@ public:
 	virtual void SetInlineBinaryDataEnabled(bool state);
 	void AddBinaryDataEntitiesToList(std::list<IHierarchicalStorageNode*>& binaryEntityList);
 
+	//Child index functions
+	virtual unsigned int GetChildCount() const;
+	virtual IHierarchicalStorageNode* GetChildAtIndex(unsigned int index) const;
+
 protected:
 	//Stream functions
 	virtual void ResetInternalStreamPosition() const;
@@ -64,6 +69,11 @@ private:
 	//Parent functions
 	void SetParent(HierarchicalStorageNode* aparent);
 
+	//Lookup index functions
+	void UpdateChildIndex();
+	void UpdateAttributeIndex();
+	void RenameChildIndexEntry(const HierarchicalStorageNode* child, const std::wstring& oldName);
+
 private:
 	//Typedefs
 	typedef std::vector<HierarchicalStorageNode*> ChildList;
@@ -71,12 +81,26 @@ private:
 	//Note that this is a vector rather than a map, so that we can preserve the explicit
 	//ordering of attributes.
 	typedef std::vector<AttributeListEntry> AttributeList;
+	typedef std::unordered_map<std::wstring, std::vector<unsigned int>> ChildIndex;
+	typedef std::unordered_map<std::wstring, unsigned int> AttributeIndex;
+
+private:
+	//Constants
+	//We only build a hashed lookup index for the children or attributes of a node once
+	//the number of entries passes this threshold. Below this, a linear search is faster.
+	//Note that the indexes are only ever built or modified by non-const functions, so
+	//concurrent lookups on a node which isn't being modified are safe.
+	static const unsigned int lookupIndexThreshold = 8;
 
 private:
 	std::wstring name;
 	HierarchicalStorageNode* parent;
 	ChildList children;
 	AttributeList attributes;
+	bool childIndexValid;
+	ChildIndex childIndex;
+	bool attributeIndexValid;
+	AttributeIndex attributeIndex;
 	bool binaryDataPresent;
 	bool inlineBinaryData;
 	std::wstring binaryDataName;
@@ -5,7 +5,7 @@
 //Constructors
 //----------------------------------------------------------------------------------------
 HierarchicalStorageTree::HierarchicalStorageTree()
-:allowSeparateBinaryData(true), storageMode(StorageMode::XML)
+:allowSeparateBinaryData(true), storageMode(StorageMode::XML), currentNodeDuringLoad(0), nodeLoadStateStackDepth(0)
 {
 	root = new HierarchicalStorageNode();
 }
@@ -33,20 +33,31 @@ bool HierarchicalStorageTree::SaveTree(Stream::IStream& target)
 //----------------------------------------------------------------------------------------
 bool HierarchicalStorageTree::LoadTree(Stream::IStream& source)
 {
-	//Load the contents of the source stream into a buffer of unicode characters
+	//If the source stream is UTF-8 encoded, which is the case for all our module and
+	//savestate files, we pass the raw stream data directly to expat in chunks, and let it
+	//perform the decoding. For any other text encoding, we fall back to decoding the
+	//entire stream into a buffer of unicode characters first.
+	bool parseSourceDirectly = (source.GetTextEncoding() == Stream::IStream::TextEncoding::UTF8);
 	std::wstring buffer;
-	Stream::ViewText view(source);
-	if(!view.ReadTextString(buffer, false))
+	if(!parseSourceDirectly)
 	{
-		return false;
+		Stream::ViewText view(source);
+		if(!view.ReadTextString(buffer, false))
+		{
+			return false;
+		}
+		if(buffer.empty())
+		{
+			return false;
+		}
 	}
-	if(buffer.empty())
+	else if(source.IsAtEnd())
 	{
 		return false;
 	}
 
 	//Create a new expat XML parser
-	XML_Parser parser = XML_ParserCreate(NULL);
+	XML_Parser parser = XML_ParserCreate(parseSourceDirectly? L"UTF-8": NULL);
 	if(parser == 0)
 	{
 		return false;
@@ -59,7 +70,9 @@ bool HierarchicalStorageTree::LoadTree(Stream::IStream& source)
 
 	//Parse the XML data
 	currentNodeDuringLoad = 0;
-	if(XML_Parse(parser, (char*)&buffer[0], (int)(buffer.size() * sizeof(wchar_t)), 1) != XML_STATUS_OK)
+	nodeLoadStateStackDepth = 0;
+	bool parseResult = parseSourceDirectly? ParseTreeInChunks(parser, source): (XML_Parse(parser, (char*)&buffer[0], (int)(buffer.size() * sizeof(wchar_t)), 1) == XML_STATUS_OK);
+	if(!parseResult)
 	{
 		//If XML parsing failed, set the error string, and return false.
 		std::wstringstream errorStream;
@@ -75,6 +88,35 @@ bool HierarchicalStorageTree::LoadTree(Stream::IStream& source)
 	return true;
 }
 
+//----------------------------------------------------------------------------------------
+bool HierarchicalStorageTree::ParseTreeInChunks(XML_Parser parser, Stream::IStream& source)
+{
+	//Read the source stream directly into the parse buffer of the XML parser, one chunk
+	//at a time, until we reach the end of the stream.
+	static const Stream::IStream::SizeType chunkSize = 0x10000;
+	Stream::IStream::SizeType remainingSize = source.Size() - source.GetStreamPos();
+	do
+	{
+		Stream::IStream::SizeType nextChunkSize = (remainingSize < chunkSize)? remainingSize: chunkSize;
+		void* parseBuffer = XML_GetBuffer(parser, (int)nextChunkSize);
+		if(parseBuffer == 0)
+		{
+			return false;
+		}
+		if((nextChunkSize > 0) && !source.ReadData((unsigned char*)parseBuffer, nextChunkSize))
+		{
+			return false;
+		}
+		remainingSize -= nextChunkSize;
+		if(XML_ParseBuffer(parser, (int)nextChunkSize, (remainingSize <= 0)? 1: 0) != XML_STATUS_OK)
+		{
+			return false;
+		}
+	}
+	while(remainingSize > 0);
+	return true;
+}
+
 //----------------------------------------------------------------------------------------
 bool HierarchicalStorageTree::SaveNode(IHierarchicalStorageNode& node, Stream::IStream& stream, const std::wstring& indentPrefix) const
 {
@@ -202,6 +244,16 @@ void XMLCALL HierarchicalStorageTree::LoadStartElement(void *userData, const XML
 		tree->currentNodeDuringLoad = node;
 	}
 
+	//Begin collecting character data for this node. Note that we keep the load state
+	//entries allocated between nodes, so that the data buffers can be reused.
+	if(tree->nodeLoadStateStackDepth >= tree->nodeLoadStateStack.size())
+	{
+		tree->nodeLoadStateStack.resize(tree->nodeLoadStateStackDepth + 1);
+	}
+	NodeLoadState& loadState = tree->nodeLoadStateStack[tree->nodeLoadStateStackDepth++];
+	loadState.data.clear();
+	loadState.dataPresent = false;
+
 	node->SetName(std::wstring(aname));
 	while(*aatts != 0)
 	{
@@ -222,6 +274,16 @@ void XMLCALL HierarchicalStorageTree::LoadEndElement(void *userData, const XML_C
 	HierarchicalStorageTree* tree = (HierarchicalStorageTree*)userData;
 	if(tree->currentNodeDuringLoad != 0)
 	{
+		//Now that all the character data for this node has been collected, commit it to
+		//the node.
+		if(tree->nodeLoadStateStackDepth > 0)
+		{
+			const NodeLoadState& loadState = tree->nodeLoadStateStack[--tree->nodeLoadStateStackDepth];
+			if(loadState.dataPresent)
+			{
+				tree->CommitNodeData(*tree->currentNodeDuringLoad, loadState);
+			}
+		}
 		tree->currentNodeDuringLoad = &tree->currentNodeDuringLoad->GetParent();
 	}
 }
@@ -230,53 +292,84 @@ void XMLCALL HierarchicalStorageTree::LoadEndElement(void *userData, const XML_C
 void XMLCALL HierarchicalStorageTree::LoadData(void *userData, const XML_Char *s, int len)
 {
 	HierarchicalStorageTree* tree = (HierarchicalStorageTree*)userData;
-
-	//Append all printable characters to the data stream
-	std::wstring data;
-	if(!tree->currentNodeDuringLoad->GetBinaryDataPresent())
+	if((tree->currentNodeDuringLoad == 0) || (tree->nodeLoadStateStackDepth == 0))
 	{
-		data = tree->currentNodeDuringLoad->GetData();
+		return;
 	}
+
+	//Append all printable characters to the data buffer for the current node. The data
+	//is committed to the node once the closing tag for the node is reached.
+	NodeLoadState& loadState = tree->nodeLoadStateStack[tree->nodeLoadStateStackDepth - 1];
+	loadState.dataPresent = true;
 	for(int i = 0; i < len; ++i)
 	{
 		//Exclude all characters that are not printable, and exclude all whitespace
 		//characters with the exception of space.
 		if((iswprint(*(s + i)) != 0) && ((iswspace(*(s + i)) == 0) || (*(s + i) == L' ')))
 		{
-			data.push_back(*(s + i));
+			loadState.data.push_back(*(s + i));
 		}
 	}
-	if(tree->currentNodeDuringLoad->IsAttributePresent(L"BinaryDataPresent"))
+}
+
+//----------------------------------------------------------------------------------------
+void HierarchicalStorageTree::CommitNodeData(IHierarchicalStorageNode& node, const NodeLoadState& loadState) const
+{
+	if(node.IsAttributePresent(L"BinaryDataPresent"))
 	{
-		tree->currentNodeDuringLoad->SetBinaryDataPresent(true);
-		if(tree->currentNodeDuringLoad->IsAttributePresent(L"SeparateBinaryData"))
+		node.SetBinaryDataPresent(true);
+		if(node.IsAttributePresent(L"SeparateBinaryData"))
 		{
-			tree->currentNodeDuringLoad->SetInlineBinaryDataEnabled(false);
+			node.SetInlineBinaryDataEnabled(false);
 			//Load the name of the separate binary storage buffer
-			tree->currentNodeDuringLoad->SetBinaryDataBufferName(tree->currentNodeDuringLoad->GetBinaryDataBufferName() + data);
+			node.SetBinaryDataBufferName(loadState.data);
 		}
 		else
 		{
-			tree->currentNodeDuringLoad->SetInlineBinaryDataEnabled(true);
+			node.SetInlineBinaryDataEnabled(true);
 			//Load inline binary data from the XML structure
-			size_t charPos = 0;
-			while((data.length() - charPos) >= 2)
+			std::vector<unsigned char> buffer;
+			DecodeHexData(loadState.data, buffer);
+			if(!buffer.empty())
 			{
-				std::wstringstream dataStream;
-				dataStream << data[charPos + 0] << data[charPos + 1];
-				unsigned int byte;
-				dataStream >> std::hex >> byte;
-
-				Stream::IStream& bufferStream = tree->currentNodeDuringLoad->GetBinaryDataBufferStream();
-				bufferStream.WriteData((unsigned char)byte);
-
-				charPos += 2;
+				Stream::IStream& bufferStream = node.GetBinaryDataBufferStream();
+				bufferStream.WriteData(&buffer[0], (Stream::IStream::SizeType)buffer.size());
 			}
 		}
 	}
 	else
 	{
-		tree->currentNodeDuringLoad->SetData(data);
+		node.SetData(loadState.data);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void HierarchicalStorageTree::DecodeHexData(const std::wstring& data, std::vector<unsigned char>& buffer)
+{
+	//Lookup table converting each ASCII hex digit character to its value. Any other
+	//character is treated as a digit with a value of 0.
+	static const unsigned char hexDigitTable[0x80] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0, 0,
+		0, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+	};
+
+	//Decode each pair of hex digits into a byte. Any trailing unpaired digit is ignored.
+	size_t byteCount = data.length() / 2;
+	buffer.resize(byteCount);
+	const wchar_t* sourceData = data.c_str();
+	for(size_t i = 0; i < byteCount; ++i)
+	{
+		unsigned int upperDigit = (unsigned int)sourceData[(i * 2) + 0];
+		unsigned int lowerDigit = (unsigned int)sourceData[(i * 2) + 1];
+		unsigned char upperDigitValue = (upperDigit < 0x80)? hexDigitTable[upperDigit]: 0;
+		unsigned char lowerDigitValue = (lowerDigit < 0x80)? hexDigitTable[lowerDigit]: 0;
+		buffer[i] = (unsigned char)((upperDigitValue << 4) | lowerDigitValue);
 	}
 }
 
@@ -33,12 +33,23 @@ public:
 	virtual IHierarchicalStorageNode& GetRootNode() const;
 	virtual MarshalSupport::Marshal::Ret<std::list<IHierarchicalStorageNode*>> GetBinaryDataNodeList();
 
+private:
+	//Structures
+	struct NodeLoadState
+	{
+		std::wstring data;
+		bool dataPresent;
+	};
+
 private:
 	//Save/Load functions
+	bool ParseTreeInChunks(XML_Parser parser, Stream::IStream& source);
 	bool SaveNode(IHierarchicalStorageNode& node, Stream::IStream& stream, const std::wstring& indentPrefix) const;
 	static void XMLCALL LoadStartElement(void *userData, const XML_Char *aname, const XML_Char **aatts);
 	static void XMLCALL LoadEndElement(void *userData, const XML_Char *aname);
 	static void XMLCALL LoadData(void *userData, const XML_Char *s, int len);
+	void CommitNodeData(IHierarchicalStorageNode& node, const NodeLoadState& loadState) const;
+	static void DecodeHexData(const std::wstring& data, std::vector<unsigned char>& buffer);
 
 	//Reserved character substitution functions
 	bool IsCharacterReserved(wchar_t character) const;
@@ -48,6 +59,8 @@ private:
 	StorageMode storageMode;
 	HierarchicalStorageNode* root;
 	IHierarchicalStorageNode* currentNodeDuringLoad;
+	std::vector<NodeLoadState> nodeLoadStateStack;
+	unsigned int nodeLoadStateStackDepth;
 	mutable std::wstring errorString;
 	bool allowSeparateBinaryData;
 };
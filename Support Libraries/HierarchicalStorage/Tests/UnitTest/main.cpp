@@ -0,0 +1,419 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "HierarchicalStorage/HierarchicalStorage.pkg"
+#include <vector>
+#include <list>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <iostream>
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+static std::wstring BuildChildName(unsigned int childNo)
+{
+	//Reuse a small set of names, so that several children share each name, as they do
+	//for the device and register entries in modules and savestates.
+	std::wstringstream nameStream;
+	nameStream << L"Child" << (childNo % 5);
+	return nameStream.str();
+}
+
+//----------------------------------------------------------------------------------------
+static void CreateNumberedChildren(IHierarchicalStorageNode& node, unsigned int childCount)
+{
+	for(unsigned int childNo = 0; childNo < childCount; ++childNo)
+	{
+		node.CreateChild(BuildChildName(childNo)).CreateAttribute(L"Number", childNo);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Ensures that index-based child access visits the same children in the same order as the
+//child list, and that each child holds the expected name and number.
+static void CheckChildrenByIndex(const IHierarchicalStorageNode& node, const std::vector<unsigned int>& expectedNumbers)
+{
+	REQUIRE(node.GetChildCount() == (unsigned int)expectedNumbers.size());
+	std::list<IHierarchicalStorageNode*> childList = node.GetChildList();
+	REQUIRE(childList.size() == expectedNumbers.size());
+	std::list<IHierarchicalStorageNode*>::const_iterator childListIterator = childList.begin();
+	for(unsigned int childIndex = 0; childIndex < node.GetChildCount(); ++childIndex)
+	{
+		IHierarchicalStorageNode* child = node.GetChildAtIndex(childIndex);
+		REQUIRE(child != 0);
+		CHECK(child == *childListIterator);
+		std::wstring childName = child->GetName();
+		CHECK(childName == BuildChildName(expectedNumbers[childIndex]));
+		unsigned int childNumber = 0;
+		CHECK(child->ExtractAttribute(L"Number", childNumber));
+		CHECK(childNumber == expectedNumbers[childIndex]);
+		++childListIterator;
+	}
+	CHECK(node.GetChildAtIndex(node.GetChildCount()) == 0);
+	CHECK(node.GetChildAtIndex(0xFFFFFFFF) == 0);
+}
+
+//----------------------------------------------------------------------------------------
+static void CheckChildAccessForNodeSize(unsigned int childCount)
+{
+	std::vector<unsigned int> expectedNumbers;
+	for(unsigned int childNo = 0; childNo < childCount; ++childNo)
+	{
+		expectedNumbers.push_back(childNo);
+	}
+
+	//Ensure children are visited in creation order
+	HierarchicalStorageNode node(L"Root");
+	CreateNumberedChildren(node, childCount);
+	CheckChildrenByIndex(node, expectedNumbers);
+
+	//Step through every child with the same name using the named search, and ensure we
+	//find them at the same positions as a scan by index.
+	std::wstring targetName = BuildChildName(1);
+	IHierarchicalStorageNode* searchNode = node.GetChild(targetName);
+	for(unsigned int childIndex = 0; childIndex < node.GetChildCount(); ++childIndex)
+	{
+		IHierarchicalStorageNode* child = node.GetChildAtIndex(childIndex);
+		std::wstring childName = child->GetName();
+		if(childName == targetName)
+		{
+			REQUIRE(searchNode == child);
+			searchNode = node.GetChild(targetName, searchNode);
+		}
+	}
+	CHECK(searchNode == 0);
+
+	//Save the children as part of a tree, load it back, and ensure the loaded children
+	//are visited in the same order by index.
+	HierarchicalStorageTree savedTree;
+	savedTree.GetRootNode().SetName(L"Root");
+	CreateNumberedChildren(savedTree.GetRootNode(), childCount);
+	Stream::Buffer buffer(Stream::IStream::TextEncoding::UTF8, 0);
+	buffer.InsertByteOrderMark();
+	REQUIRE(savedTree.SaveTree(buffer));
+	HierarchicalStorageTree loadedTree;
+	buffer.SetStreamPos(0);
+	buffer.ProcessByteOrderMark();
+	REQUIRE(loadedTree.LoadTree(buffer));
+	CheckChildrenByIndex(loadedTree.GetRootNode(), expectedNumbers);
+
+	//Delete the last, a middle, and the first child, and ensure the remaining children
+	//shift down to fill the gaps, and are still found by name.
+	node.DeleteChild(*node.GetChildAtIndex(childCount - 1));
+	node.DeleteChild(*node.GetChildAtIndex(childCount / 2));
+	node.DeleteChild(*node.GetChildAtIndex(0));
+	expectedNumbers.erase(expectedNumbers.begin() + (childCount - 1));
+	expectedNumbers.erase(expectedNumbers.begin() + (childCount / 2));
+	expectedNumbers.erase(expectedNumbers.begin());
+	CheckChildrenByIndex(node, expectedNumbers);
+	CHECK(node.GetChild(BuildChildName(expectedNumbers[0])) == node.GetChildAtIndex(0));
+}
+
+//----------------------------------------------------------------------------------------
+//Builds a tree laid out in the same way as an XML savestate of a Mega Drive system, with
+//a set of registers stored as text data for each processor and sound device, and the
+//contents of each memory device stored as inline binary data.
+static void BuildRepresentativeSavestate(HierarchicalStorageTree& tree)
+{
+	struct MemoryDeviceInfo
+	{
+		const wchar_t* name;
+		unsigned int size;
+	};
+	static const MemoryDeviceInfo memoryDevices[] = {{L"WorkRAM", 0x10000}, {L"VRAM", 0x10000}, {L"Z80RAM", 0x2000}, {L"CRAM", 0x80}, {L"VSRAM", 0x50}};
+	static const wchar_t* registerDevices[] = {L"M68000", L"Z80", L"VDP", L"YM2612", L"SN76489", L"BusArbiter"};
+	static const unsigned int registersPerDevice = 200;
+
+	tree.SetSeparateBinaryDataEnabled(false);
+	IHierarchicalStorageNode& root = tree.GetRootNode();
+	root.SetName(L"State");
+	root.CreateChild(L"Info").CreateAttribute(L"CreationDate", std::wstring(L"2014-01-01")).CreateAttribute(L"CreationTime", std::wstring(L"12:00:00")).CreateAttribute(L"DebuggerState", false);
+	for(unsigned int deviceNo = 0; deviceNo < (unsigned int)(sizeof(registerDevices) / sizeof(registerDevices[0])); ++deviceNo)
+	{
+		IHierarchicalStorageNode& deviceNode = root.CreateChild(L"Device");
+		deviceNode.CreateAttribute(L"Name", std::wstring(registerDevices[deviceNo])).CreateAttribute(L"ModuleID", 1u);
+		for(unsigned int registerNo = 0; registerNo < registersPerDevice; ++registerNo)
+		{
+			std::wstringstream nameStream;
+			nameStream << L"Register" << registerNo;
+			deviceNode.CreateChild(L"Register", (deviceNo * 0x10000) + (registerNo * 0x1234)).CreateAttribute(L"name", nameStream.str());
+		}
+	}
+	for(unsigned int deviceNo = 0; deviceNo < (unsigned int)(sizeof(memoryDevices) / sizeof(memoryDevices[0])); ++deviceNo)
+	{
+		std::vector<unsigned char> memory(memoryDevices[deviceNo].size);
+		for(unsigned int i = 0; i < (unsigned int)memory.size(); ++i)
+		{
+			memory[i] = (unsigned char)((i * 7) + (i >> 8));
+		}
+		IHierarchicalStorageNode& deviceNode = root.CreateChild(L"Device");
+		deviceNode.CreateAttribute(L"Name", std::wstring(memoryDevices[deviceNo].name)).CreateAttribute(L"ModuleID", 1u);
+		deviceNode.InsertBinaryData(memory, memoryDevices[deviceNo].name, false);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+static void SaveTreeToBuffer(HierarchicalStorageTree& tree, Stream::Buffer& buffer)
+{
+	buffer.SetTextEncoding(Stream::IStream::TextEncoding::UTF8);
+	buffer.InsertByteOrderMark();
+	REQUIRE(tree.SaveTree(buffer));
+}
+
+//----------------------------------------------------------------------------------------
+//Ensures that a loaded node holds the same name, attributes, data, and children as the
+//node it was saved from. Loaded nodes also carry the attributes used to flag binary data
+//in the XML structure, which we don't require to be present in the saved node.
+static void CheckNodesMatch(IHierarchicalStorageNode& savedNode, IHierarchicalStorageNode& loadedNode)
+{
+	std::wstring savedName = savedNode.GetName();
+	std::wstring loadedName = loadedNode.GetName();
+	REQUIRE(loadedName == savedName);
+
+	std::list<IHierarchicalStorageAttribute*> savedAttributes = savedNode.GetAttributeList();
+	for(std::list<IHierarchicalStorageAttribute*>::const_iterator i = savedAttributes.begin(); i != savedAttributes.end(); ++i)
+	{
+		IHierarchicalStorageAttribute* loadedAttribute = loadedNode.GetAttribute((*i)->GetName());
+		REQUIRE(loadedAttribute != 0);
+		std::wstring savedValue = (*i)->GetValue();
+		std::wstring loadedValue = loadedAttribute->GetValue();
+		CHECK(loadedValue == savedValue);
+	}
+
+	REQUIRE(loadedNode.GetBinaryDataPresent() == savedNode.GetBinaryDataPresent());
+	if(savedNode.GetBinaryDataPresent())
+	{
+		std::vector<unsigned char> savedData((size_t)savedNode.GetBinaryDataBufferStream().Size());
+		std::vector<unsigned char> loadedData((size_t)loadedNode.GetBinaryDataBufferStream().Size());
+		savedNode.ExtractBinaryData(savedData);
+		loadedNode.ExtractBinaryData(loadedData);
+		REQUIRE(loadedData == savedData);
+	}
+	else
+	{
+		CHECK(loadedNode.GetData() == savedNode.GetData());
+	}
+
+	REQUIRE(loadedNode.GetChildCount() == savedNode.GetChildCount());
+	for(unsigned int childIndex = 0; childIndex < savedNode.GetChildCount(); ++childIndex)
+	{
+		CheckNodesMatch(*savedNode.GetChildAtIndex(childIndex), *loadedNode.GetChildAtIndex(childIndex));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Loads a tree in the same way as HierarchicalStorageTree::LoadTree did before UTF-8
+//streams were passed directly to expat. The entire stream is decoded into a string
+//before parsing, the full data string of a node is fetched and set again on every
+//character data callback, and inline binary data is decoded through a string stream for
+//each byte.
+struct ReferenceLoadState
+{
+	IHierarchicalStorageNode* root;
+	IHierarchicalStorageNode* currentNode;
+};
+
+//----------------------------------------------------------------------------------------
+static void XMLCALL ReferenceLoadStartElement(void* userData, const XML_Char* aname, const XML_Char** aatts)
+{
+	ReferenceLoadState* loadState = (ReferenceLoadState*)userData;
+	IHierarchicalStorageNode* node = (loadState->currentNode == 0)? loadState->root: &loadState->currentNode->CreateChild();
+	loadState->currentNode = node;
+	node->SetName(std::wstring(aname));
+	while(*aatts != 0)
+	{
+		std::wstring name = *(aatts++);
+		if(*aatts != 0)
+		{
+			std::wstring value = *(aatts++);
+			node->CreateAttribute(name, value);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+static void XMLCALL ReferenceLoadEndElement(void* userData, const XML_Char* aname)
+{
+	ReferenceLoadState* loadState = (ReferenceLoadState*)userData;
+	if(loadState->currentNode != 0)
+	{
+		loadState->currentNode = &loadState->currentNode->GetParent();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+static void XMLCALL ReferenceLoadData(void* userData, const XML_Char* s, int len)
+{
+	ReferenceLoadState* loadState = (ReferenceLoadState*)userData;
+	IHierarchicalStorageNode* node = loadState->currentNode;
+	std::wstring data;
+	if(!node->GetBinaryDataPresent())
+	{
+		data = node->GetData();
+	}
+	for(int i = 0; i < len; ++i)
+	{
+		if((iswprint(*(s + i)) != 0) && ((iswspace(*(s + i)) == 0) || (*(s + i) == L' ')))
+		{
+			data.push_back(*(s + i));
+		}
+	}
+	if(node->IsAttributePresent(L"BinaryDataPresent"))
+	{
+		node->SetBinaryDataPresent(true);
+		if(node->IsAttributePresent(L"SeparateBinaryData"))
+		{
+			node->SetInlineBinaryDataEnabled(false);
+			std::wstring bufferName = node->GetBinaryDataBufferName();
+			node->SetBinaryDataBufferName(bufferName + data);
+		}
+		else
+		{
+			node->SetInlineBinaryDataEnabled(true);
+			size_t charPos = 0;
+			while((data.length() - charPos) >= 2)
+			{
+				std::wstringstream dataStream;
+				dataStream << data[charPos + 0] << data[charPos + 1];
+				unsigned int byte;
+				dataStream >> std::hex >> byte;
+				node->GetBinaryDataBufferStream().WriteData((unsigned char)byte);
+				charPos += 2;
+			}
+		}
+	}
+	else
+	{
+		node->SetData(data);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+static bool ReferenceLoadTree(IHierarchicalStorageNode& root, Stream::IStream& source)
+{
+	std::wstring buffer;
+	Stream::ViewText view(source);
+	if(!view.ReadTextString(buffer, false) || buffer.empty())
+	{
+		return false;
+	}
+	XML_Parser parser = XML_ParserCreate(NULL);
+	if(parser == 0)
+	{
+		return false;
+	}
+	ReferenceLoadState loadState;
+	loadState.root = &root;
+	loadState.currentNode = 0;
+	XML_SetUserData(parser, &loadState);
+	XML_SetElementHandler(parser, ReferenceLoadStartElement, ReferenceLoadEndElement);
+	XML_SetCharacterDataHandler(parser, ReferenceLoadData);
+	bool result = (XML_Parse(parser, (char*)&buffer[0], (int)(buffer.size() * sizeof(wchar_t)), 1) == XML_STATUS_OK);
+	XML_ParserFree(parser);
+	return result;
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("HierarchicalStorageNode::GetChildAtIndex", "")
+{
+	//Run the checks on a node small enough to be searched linearly, and on one large
+	//enough to have its children indexed by name.
+	SECTION("Unindexed node", "")
+	{
+		CheckChildAccessForNodeSize(4);
+	}
+	SECTION("Indexed node", "")
+	{
+		CheckChildAccessForNodeSize(40);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("HierarchicalStorageNode::GetChildCount", "")
+{
+	HierarchicalStorageNode node(L"Root");
+	CHECK(node.GetChildCount() == 0);
+	CHECK(node.GetChildAtIndex(0) == 0);
+
+	IHierarchicalStorageNode& child = node.CreateChild(L"Child");
+	CHECK(node.GetChildCount() == 1);
+	CHECK(node.GetChildAtIndex(0) == &child);
+	CHECK(child.GetChildCount() == 0);
+
+	node.DeleteChild(child);
+	CHECK(node.GetChildCount() == 0);
+	CHECK(node.GetChildAtIndex(0) == 0);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("HierarchicalStorageTree::LoadTree", "")
+{
+	//The inline binary data for the larger memory devices spans several of the chunks the
+	//stream is passed to expat in, so this also covers hex data split across chunks.
+	HierarchicalStorageTree savedTree;
+	BuildRepresentativeSavestate(savedTree);
+	Stream::Buffer buffer(0);
+	SaveTreeToBuffer(savedTree, buffer);
+
+	SECTION("Loaded tree matches the saved tree", "")
+	{
+		HierarchicalStorageTree loadedTree;
+		buffer.SetStreamPos(0);
+		buffer.ProcessByteOrderMark();
+		REQUIRE(loadedTree.LoadTree(buffer));
+		CheckNodesMatch(savedTree.GetRootNode(), loadedTree.GetRootNode());
+	}
+	SECTION("Reference loader gives the same tree", "")
+	{
+		HierarchicalStorageTree loadedTree;
+		buffer.SetStreamPos(0);
+		buffer.ProcessByteOrderMark();
+		REQUIRE(ReferenceLoadTree(loadedTree.GetRootNode(), buffer));
+		CheckNodesMatch(savedTree.GetRootNode(), loadedTree.GetRootNode());
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Benchmarks
+//----------------------------------------------------------------------------------------
+TEST_CASE("HierarchicalStorageTree::LoadTree benchmark", "[.][benchmark]")
+{
+	//Load an XML savestate of a Mega Drive system repeatedly, first in the way LoadTree
+	//did before UTF-8 streams were passed directly to expat, then through LoadTree itself.
+	static const unsigned int loadCount = 20;
+	HierarchicalStorageTree savedTree;
+	BuildRepresentativeSavestate(savedTree);
+	Stream::Buffer buffer(0);
+	SaveTreeToBuffer(savedTree, buffer);
+
+	bool referenceLoadResult = true;
+	std::chrono::high_resolution_clock::time_point referenceStartTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int i = 0; i < loadCount; ++i)
+	{
+		HierarchicalStorageTree loadedTree;
+		buffer.SetStreamPos(0);
+		buffer.ProcessByteOrderMark();
+		referenceLoadResult &= ReferenceLoadTree(loadedTree.GetRootNode(), buffer);
+	}
+	std::chrono::high_resolution_clock::duration referenceTime = std::chrono::high_resolution_clock::now() - referenceStartTime;
+	REQUIRE(referenceLoadResult);
+
+	bool loadResult = true;
+	std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int i = 0; i < loadCount; ++i)
+	{
+		HierarchicalStorageTree loadedTree;
+		buffer.SetStreamPos(0);
+		buffer.ProcessByteOrderMark();
+		loadResult &= loadedTree.LoadTree(buffer);
+	}
+	std::chrono::high_resolution_clock::duration loadTime = std::chrono::high_resolution_clock::now() - startTime;
+	REQUIRE(loadResult);
+
+	double referenceMillisecondsPerLoad = (double)std::chrono::duration_cast<std::chrono::microseconds>(referenceTime).count() / (1000.0 * (double)loadCount);
+	double millisecondsPerLoad = (double)std::chrono::duration_cast<std::chrono::microseconds>(loadTime).count() / (1000.0 * (double)loadCount);
+	std::wcout << L"Savestate of " << (buffer.Size() / 1024) << L"KB: before " << referenceMillisecondsPerLoad << L"ms/load, after " << millisecondsPerLoad << L"ms/load\n";
+}
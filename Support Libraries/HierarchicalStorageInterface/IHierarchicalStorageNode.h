@@ -82,6 +82,11 @@ protected:
 	//Stream functions
 	virtual void ResetInternalStreamPosition() const = 0;
 	virtual Stream::IStream& GetInternalStream() const = 0;
+
+public:
+	//Child index functions
+	virtual unsigned int GetChildCount() const = 0;
+	virtual IHierarchicalStorageNode* GetChildAtIndex(unsigned int index) const = 0;
 };
 
 #include "IHierarchicalStorageNode.inl"
@@ -1,13 +1,32 @@
 #include "Image.h"
 #include "Stream/Stream.pkg"
 #include <climits>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <emmintrin.h>
 
 //----------------------------------------------------------------------------------------
 //Image format functions
 //----------------------------------------------------------------------------------------
 void Image::ResizeBuffer(unsigned int newSize)
 {
-	imageData.resize(newSize);
+	//Allocate the buffer for the current data format, and release the buffer for any
+	//other format.
+	switch(dataFormat)
+	{
+	case DATAFORMAT_FLOAT:
+		imageDataFloat.resize(newSize);
+		std::vector<unsigned char>().swap(imageData8Bit);
+		break;
+	case DATAFORMAT_8BIT:
+		imageData8Bit.resize(newSize);
+		std::vector<float>().swap(imageDataFloat);
+		break;
+	default:
+		DebugAssert(false);
+		break;
+	}
 }
 
 //----------------------------------------------------------------------------------------
@@ -65,7 +84,8 @@ void Image::SetImageFormat(unsigned int aimageWidth, unsigned int aimageHeight,
 		dataPlaneCount = 4;
 		break;
 	}
-	unsigned int newDataBufferSize = imageWidth * imageHeight * dataPlaneCount;
+	rowElementCount = imageWidth * dataPlaneCount;
+	unsigned int newDataBufferSize = rowElementCount * imageHeight;
 	ResizeBuffer(newDataBufferSize);
 }
 
@@ -119,6 +139,166 @@ void Image::WritePixelData(unsigned int posX, unsigned int posY, unsigned int pl
 	WritePixelDataInternal(posX, posY, planeNo, data, bitCount);
 }
 
+//----------------------------------------------------------------------------------------
+//Row data functions
+//----------------------------------------------------------------------------------------
+unsigned int Image::GetRowElementCount() const
+{
+	return rowElementCount;
+}
+
+//----------------------------------------------------------------------------------------
+const unsigned char* Image::GetRowData8Bit(unsigned int posY) const
+{
+	if((dataFormat != DATAFORMAT_8BIT) || (posY >= imageHeight) || imageData8Bit.empty())
+	{
+		return 0;
+	}
+	return &imageData8Bit[posY * rowElementCount];
+}
+
+//----------------------------------------------------------------------------------------
+unsigned char* Image::GetRowData8Bit(unsigned int posY)
+{
+	if((dataFormat != DATAFORMAT_8BIT) || (posY >= imageHeight) || imageData8Bit.empty())
+	{
+		return 0;
+	}
+	return &imageData8Bit[posY * rowElementCount];
+}
+
+//----------------------------------------------------------------------------------------
+const float* Image::GetRowDataFloat(unsigned int posY) const
+{
+	if((dataFormat != DATAFORMAT_FLOAT) || (posY >= imageHeight) || imageDataFloat.empty())
+	{
+		return 0;
+	}
+	return &imageDataFloat[posY * rowElementCount];
+}
+
+//----------------------------------------------------------------------------------------
+float* Image::GetRowDataFloat(unsigned int posY)
+{
+	if((dataFormat != DATAFORMAT_FLOAT) || (posY >= imageHeight) || imageDataFloat.empty())
+	{
+		return 0;
+	}
+	return &imageDataFloat[posY * rowElementCount];
+}
+
+//----------------------------------------------------------------------------------------
+void Image::ConvertRowDataToFloat(const unsigned char* sourceData, float* targetData, unsigned int elementCount)
+{
+	for(unsigned int elementNo = 0; elementNo < elementCount; ++elementNo)
+	{
+		targetData[elementNo] = ((float)sourceData[elementNo] / 255.0f);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void Image::ConvertRowDataTo8Bit(const float* sourceData, unsigned char* targetData, unsigned int elementCount)
+{
+	//Convert 16 elements at a time using SSE2, which is part of the baseline instruction
+	//set for all our build targets. Note that the packing instructions saturate the
+	//result, so out of range values are clamped rather than wrapping around.
+	unsigned int elementNo = 0;
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128 bias = _mm_set1_ps(0.5f);
+	static const unsigned int elementsPerBlock = sizeof(__m128i) / sizeof(unsigned char);
+	for(; (elementNo + elementsPerBlock) <= elementCount; elementNo += elementsPerBlock)
+	{
+		__m128i block0 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(sourceData + elementNo + 0), scale), bias));
+		__m128i block1 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(sourceData + elementNo + 4), scale), bias));
+		__m128i block2 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(sourceData + elementNo + 8), scale), bias));
+		__m128i block3 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(sourceData + elementNo + 12), scale), bias));
+		__m128i packedBlock = _mm_packus_epi16(_mm_packs_epi32(block0, block1), _mm_packs_epi32(block2, block3));
+		_mm_storeu_si128((__m128i*)(targetData + elementNo), packedBlock);
+	}
+
+	//Convert any remaining elements individually
+	for(; elementNo < elementCount; ++elementNo)
+	{
+		targetData[elementNo] = (unsigned char)((sourceData[elementNo] * 255.0f) + 0.5f);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Sub-image functions
+//----------------------------------------------------------------------------------------
+void Image::CopyImageData(const IImage& sourceImage, unsigned int sourcePosX, unsigned int sourcePosY, unsigned int regionWidth, unsigned int regionHeight, unsigned int targetPosX, unsigned int targetPosY)
+{
+	//Clip the copy region to the boundaries of both images
+	unsigned int sourceImageWidth = sourceImage.GetImageWidth();
+	unsigned int sourceImageHeight = sourceImage.GetImageHeight();
+	if((sourcePosX >= sourceImageWidth) || (sourcePosY >= sourceImageHeight) || (targetPosX >= imageWidth) || (targetPosY >= imageHeight))
+	{
+		return;
+	}
+	regionWidth = std::min(regionWidth, std::min(sourceImageWidth - sourcePosX, imageWidth - targetPosX));
+	regionHeight = std::min(regionHeight, std::min(sourceImageHeight - sourcePosY, imageHeight - targetPosY));
+
+	//If the source image has a different set of data planes to this image, copy each
+	//data plane the two images have in common individually.
+	unsigned int sourcePlaneCount = sourceImage.GetDataPlaneCount();
+	if(sourcePlaneCount != dataPlaneCount)
+	{
+		unsigned int commonPlaneCount = std::min(sourcePlaneCount, dataPlaneCount);
+		for(unsigned int ypos = 0; ypos < regionHeight; ++ypos)
+		{
+			for(unsigned int xpos = 0; xpos < regionWidth; ++xpos)
+			{
+				for(unsigned int plane = 0; plane < commonPlaneCount; ++plane)
+				{
+					float data;
+					sourceImage.ReadPixelData(sourcePosX + xpos, sourcePosY + ypos, plane, data);
+					WritePixelDataInternal(targetPosX + xpos, targetPosY + ypos, plane, data);
+				}
+			}
+		}
+		return;
+	}
+
+	//Copy each row of the region, converting the data format if required. If we're
+	//copying a region within this image, we work from the bottom row upwards when the
+	//target is below the source, so that we don't overwrite rows before we've copied
+	//them.
+	bool reverseRowOrder = ((&sourceImage == this) && (targetPosY > sourcePosY));
+	unsigned int sourceElementOffset = sourcePosX * dataPlaneCount;
+	unsigned int targetElementOffset = targetPosX * dataPlaneCount;
+	unsigned int regionElementCount = regionWidth * dataPlaneCount;
+	for(unsigned int rowNo = 0; rowNo < regionHeight; ++rowNo)
+	{
+		unsigned int regionRowNo = reverseRowOrder? ((regionHeight - 1) - rowNo): rowNo;
+		const unsigned char* sourceRowData8Bit = sourceImage.GetRowData8Bit(sourcePosY + regionRowNo);
+		const float* sourceRowDataFloat = sourceImage.GetRowDataFloat(sourcePosY + regionRowNo);
+		if(dataFormat == DATAFORMAT_8BIT)
+		{
+			unsigned char* targetRowData = GetRowData8Bit(targetPosY + regionRowNo) + targetElementOffset;
+			if(sourceRowData8Bit != 0)
+			{
+				memmove(targetRowData, sourceRowData8Bit + sourceElementOffset, regionElementCount * sizeof(unsigned char));
+			}
+			else if(sourceRowDataFloat != 0)
+			{
+				ConvertRowDataTo8Bit(sourceRowDataFloat + sourceElementOffset, targetRowData, regionElementCount);
+			}
+		}
+		else if(dataFormat == DATAFORMAT_FLOAT)
+		{
+			float* targetRowData = GetRowDataFloat(targetPosY + regionRowNo) + targetElementOffset;
+			if(sourceRowDataFloat != 0)
+			{
+				memmove(targetRowData, sourceRowDataFloat + sourceElementOffset, regionElementCount * sizeof(float));
+			}
+			else if(sourceRowData8Bit != 0)
+			{
+				ConvertRowDataToFloat(sourceRowData8Bit + sourceElementOffset, targetRowData, regionElementCount);
+			}
+		}
+	}
+}
+
 //----------------------------------------------------------------------------------------
 //Generic load functions
 //----------------------------------------------------------------------------------------
@@ -785,7 +965,15 @@ bool Image::LoadJPGImage(Stream::IStream& stream)
 	JSAMPROW buffer = new JSAMPLE[rowStride];
 	for(unsigned int ypos = 0; ypos < imageHeight; ++ypos)
 	{
+		//If the decoded pixel layout matches our data planes, decode this scanline
+		//directly into our image buffer.
 		unsigned int writeYPos = ((imageHeight - 1) - ypos);
+		if((unsigned int)cinfo.output_components == dataPlaneCount)
+		{
+			JSAMPROW rowData = GetRowData8Bit(writeYPos);
+			jpeg_read_scanlines(&cinfo, &rowData, 1);
+			continue;
+		}
 		jpeg_read_scanlines(&cinfo, &buffer, 1);
 		for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
 		{
@@ -863,7 +1051,15 @@ bool Image::SaveJPGImage(Stream::IStream& stream)
 	JSAMPROW buffer = new JSAMPLE[rowStride];
 	for(unsigned int ypos = 0; ypos < imageHeight; ++ypos)
 	{
+		//If our image data is already in the layout libjpeg expects, pass the row in
+		//directly, otherwise build the scanline in our buffer.
 		unsigned int readYPos = ((imageHeight - 1) - ypos);
+		if((dataFormat == DATAFORMAT_8BIT) && ((unsigned int)cinfo.input_components == dataPlaneCount))
+		{
+			JSAMPROW rowData = GetRowData8Bit(readYPos);
+			jpeg_write_scanlines(&cinfo, &rowData, 1);
+			continue;
+		}
 		for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
 		{
 			if((pixelFormat == PIXELFORMAT_M) || (pixelFormat == PIXELFORMAT_MA))
@@ -1478,9 +1674,15 @@ bool Image::LoadPNGImage(Stream::IStream& stream)
 	}
 	SetImageFormat(newImageWidth, newImageHeight, newPixelFormat, newDataFormat);
 
-	//Build our image data from the decoded PNG pixel data
+	//Build our image data from the decoded PNG pixel data. Where the decoded pixel layout
+	//matches our data planes, we can copy each row directly into our image buffer.
 	for(unsigned int ypos = 0; ypos < imageHeight; ++ypos)
 	{
+		if(pngPixelSize == dataPlaneCount)
+		{
+			memcpy(GetRowData8Bit(ypos), pngPixelData[ypos], rowElementCount);
+			continue;
+		}
 		for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
 		{
 			if((pngColorType & PNG_COLOR_MASK_COLOR) == 0)
@@ -1561,23 +1763,21 @@ bool Image::SavePNGImage(Stream::IStream& stream)
 	//Write the PNG header
 	png_write_info(pngStruct, pngInfo);
 
-	//Write the image data to the file one scanline at a time
-	png_bytep rowData = new png_byte[imageWidth * bytesPerPixel];
+	//Write the image data to the file one scanline at a time. Our 8-bit image data is
+	//already in the layout libpng expects, so we can pass each row in directly.
+	std::vector<png_byte> rowData(imageWidth * bytesPerPixel);
 	for(unsigned int ypos = 0; ypos < imageHeight; ++ypos)
 	{
-		for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
+		if(dataFormat == DATAFORMAT_8BIT)
 		{
-			for(unsigned int planeNo = 0; planeNo < GetDataPlaneCount(); ++planeNo)
-			{
-				unsigned char data;
-				ReadPixelDataInternal(xpos, ypos, planeNo, data);
-				unsigned int targetBufferPos = (xpos * bytesPerPixel) + planeNo;
-				rowData[targetBufferPos] = (png_byte)data;
-			}
+			png_write_row(pngStruct, GetRowData8Bit(ypos));
+		}
+		else
+		{
+			ConvertRowDataTo8Bit(GetRowDataFloat(ypos), &rowData[0], rowElementCount);
+			png_write_row(pngStruct, &rowData[0]);
 		}
-		png_write_row(pngStruct, rowData);
 	}
-	delete[] rowData;
 
 	//Write the last data to the PNG file
 	png_write_end(pngStruct, pngInfo);
@@ -2477,23 +2677,43 @@ void Image::ResampleNearest(const IImage& oldImage, unsigned int newWidth, unsig
 		return;
 	}
 
+	//Build a table of the source column to sample for each column in the target image
 	unsigned int maxOldImageXPos = (oldImage.GetImageWidth() - 1);
 	unsigned int maxOldImageYPos = (oldImage.GetImageHeight() - 1);
 	float imageWidthConversionRatio = (float)maxOldImageXPos / (float)imageWidth;
 	float imageHeightConversionRatio = (float)maxOldImageYPos / (float)imageHeight;
+	std::vector<unsigned int> sourceColumnPos(imageWidth);
+	for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
+	{
+		float xposNormalized = (float)xpos * imageWidthConversionRatio;
+		sourceColumnPos[xpos] = (unsigned int)(xposNormalized + 0.5f);
+	}
+
+	//Generate each line of the target image from the nearest line in the source image
 	for(unsigned int ypos = 0; ypos < imageHeight; ++ypos)
 	{
 		float yposNormalized = (float)ypos * imageHeightConversionRatio;
 		unsigned int yposOld = (unsigned int)(yposNormalized + 0.5f);
-		for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
+		const unsigned char* sourceRowData8Bit = oldImage.GetRowData8Bit(yposOld);
+		const float* sourceRowDataFloat = oldImage.GetRowDataFloat(yposOld);
+		if((dataFormat == DATAFORMAT_8BIT) && (sourceRowData8Bit != 0))
 		{
-			float xposNormalized = (float)xpos * imageWidthConversionRatio;
-			unsigned int xposOld = (unsigned int)(xposNormalized + 0.5f);
-			for(unsigned int plane = 0; plane < dataPlaneCount; ++plane)
+			ResampleNearestRow(sourceRowData8Bit, GetRowData8Bit(ypos), sourceColumnPos);
+		}
+		else if((dataFormat == DATAFORMAT_FLOAT) && (sourceRowDataFloat != 0))
+		{
+			ResampleNearestRow(sourceRowDataFloat, GetRowDataFloat(ypos), sourceColumnPos);
+		}
+		else
+		{
+			for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
 			{
-				PixelData pixelData;
-				oldImage.GetRawPixelData(xposOld, yposOld, plane, pixelData);
-				SetRawPixelDataInternal(xpos, ypos, plane, pixelData);
+				for(unsigned int plane = 0; plane < dataPlaneCount; ++plane)
+				{
+					PixelData pixelData;
+					oldImage.GetRawPixelData(sourceColumnPos[xpos], yposOld, plane, pixelData);
+					SetRawPixelDataInternal(xpos, ypos, plane, pixelData);
+				}
 			}
 		}
 	}
@@ -2519,137 +2739,212 @@ void Image::ResampleBilinear(const IImage& oldImage, unsigned int newWidth, unsi
 		return;
 	}
 
-	//This is a basic bilinear resampling algorithm. It will not cope well when reducing
-	//a dimension of the source image by a factor of more than 1.5x.
-	//float imageWidthConversionRatio = (float)oldImage.GetImageWidth() / (float)imageWidth;
-	//float imageHeightConversionRatio = (float)oldImage.GetImageHeight() / (float)imageHeight;
-	//for(unsigned int ypos = 0; ypos < imageHeight; ++ypos)
-	//{
-	//	float yposNormalized = (float)ypos * imageHeightConversionRatio;
-	//	unsigned int yposOld0 = (unsigned int)(yposNormalized - 0.5);
-	//	unsigned int yposOld1 = (unsigned int)(yposNormalized + 0.5);
-	//	float yposNew = (yposNormalized * (float)oldImage.GetImageHeight()) - (float)((unsigned int)(yposNormalized * (float)oldImage.GetImageHeight()));
-	//	for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
-	//	{
-	//		float xposNormalized = (float)xpos * imageWidthConversionRatio;
-	//		unsigned int xposOld0 = (unsigned int)(xposNormalized - 0.5);
-	//		unsigned int xposOld1 = (unsigned int)(xposNormalized + 0.5);
-	//		float xposNew = (xposNormalized * (float)oldImage.GetImageWidth()) - (float)((unsigned int)(xposNormalized * (float)oldImage.GetImageWidth()));
-	//		for(unsigned int plane = 0; plane < dataPlaneCount; ++plane)
-	//		{
-	//			float x0y0;
-	//			float x1y0;
-	//			float x0y1;
-	//			float x1y1;
-	//			oldImage.ReadPixelData(xposOld0, yposOld0, plane, x0y0);
-	//			oldImage.ReadPixelData(xposOld1, yposOld0, plane, x1y0);
-	//			oldImage.ReadPixelData(xposOld0, yposOld1, plane, x0y1);
-	//			oldImage.ReadPixelData(xposOld1, yposOld1, plane, x1y1);
-	//			float finalData = x0y0 * (1.0f - xposNew) * (1.0f - yposNew);
-	//			finalData += x1y0 * xposNew * (1.0f - yposNew);
-	//			finalData += x0y1 * (1.0f - xposNew) * yposNew;
-	//			finalData += x1y1 * xposNew * yposNew;
-	//			WritePixelDataInternal(xpos, ypos, plane, finalData);
-	//		}
-	//	}
-	//}
-
-	//This method is much more sophisticated than the one above, and will give the best
-	//result possible from linear resampling when either upsampling or downsampling,
-	//regardless of the respective dimensions of the source and target images.
-	float imageWidthConversionRatio = (float)oldImage.GetImageWidth() / (float)imageWidth;
-	float imageHeightConversionRatio = (float)oldImage.GetImageHeight() / (float)imageHeight;
-	for(unsigned int ypos = 0; ypos < imageHeight; ++ypos)
-	{
-		//Calculate the beginning and end of the sample region on the Y axis in the
-		//source image, which is being mapped onto this pixel in the target image. Note
-		//that because we're adding 1 to the current pixel location, the second sample
-		//point may be past the end of the image, but this is ok, because this sample
-		//point is really a limit. We protect against reading past the boundaries of the
-		//image further below, and if this is attempted, this dud sample will be assigned
-		//a weight of zero.
-		float firstSamplePointY = (float)ypos * imageHeightConversionRatio;
-		float lastSamplePointY = (float)(ypos + 1) * imageHeightConversionRatio;
+	//This method will give the best result possible from linear resampling when either
+	//upsampling or downsampling, regardless of the respective dimensions of the source
+	//and target images. Each pixel in the target image is the average of the region of
+	//the source image which maps onto it, with each source pixel weighted by the area of
+	//it which falls inside that region. Since the weights on each axis are independent
+	//of each other, we apply the filter in two passes, first across each line of the
+	//source image into an intermediate buffer, then down each column of that buffer into
+	//this image. The weights for each pass are calculated once up front.
+	ResampleKernel kernelX;
+	ResampleKernel kernelY;
+	BuildBilinearResampleKernel(oldImage.GetImageWidth(), imageWidth, kernelX);
+	BuildBilinearResampleKernel(oldImage.GetImageHeight(), imageHeight, kernelY);
+
+	//Resample each line of the source image to the width of this image
+	unsigned int oldImageHeight = oldImage.GetImageHeight();
+	std::vector<float> intermediateData((size_t)oldImageHeight * rowElementCount);
+	ExecuteRowOperation(oldImageHeight, intermediateData.size(), std::bind(std::mem_fn(&Image::ResampleRowsHorizontal), this, std::cref(oldImage), std::cref(kernelX), std::ref(intermediateData), std::placeholders::_1, std::placeholders::_2));
+
+	//Resample each column of the intermediate buffer to the height of this image
+	ExecuteRowOperation(imageHeight, (size_t)imageHeight * rowElementCount, std::bind(std::mem_fn(&Image::ResampleRowsVertical), this, std::cref(intermediateData), std::cref(kernelY), std::placeholders::_1, std::placeholders::_2));
+}
 
-		//Calculate the total domain, or length, of this sample region on the Y axis.
-		float totalDomainY = lastSamplePointY - firstSamplePointY;
+//----------------------------------------------------------------------------------------
+void Image::BuildBilinearResampleKernel(unsigned int sourceSize, unsigned int targetSize, ResampleKernel& kernel)
+{
+	kernel.contributions.resize(targetSize);
+	kernel.weights.clear();
+	float conversionRatio = (float)sourceSize / (float)targetSize;
+	for(unsigned int targetPos = 0; targetPos < targetSize; ++targetPos)
+	{
+		//Calculate the beginning and end of the sample region in the source image, which
+		//is being mapped onto this pixel in the target image. Note that because we're
+		//adding 1 to the current pixel location, the second sample point may be past the
+		//end of the image, but this is ok, because this sample point is really a limit.
+		float firstSamplePoint = (float)targetPos * conversionRatio;
+		float lastSamplePoint = (float)(targetPos + 1) * conversionRatio;
+
+		//Calculate the total domain, or length, of this sample region. We divide each
+		//weight by this value, to normalize the sampled data back to a single pixel.
+		float totalDomain = lastSamplePoint - firstSamplePoint;
+
+		//Calculate the first and last pixels of interest from the source region
+		unsigned int firstSamplePos = (unsigned int)firstSamplePoint;
+		unsigned int lastSamplePos = (unsigned int)lastSamplePoint;
+
+		//Calculate the weight of each source pixel in the sample region. If the end of
+		//the sample region falls exactly on a pixel boundary, or past the end of the
+		//image, the last pixel has no weight, and we leave it out.
+		ResampleContribution& contribution = kernel.contributions[targetPos];
+		contribution.firstSourcePos = firstSamplePos;
+		contribution.firstWeightNo = (unsigned int)kernel.weights.size();
+		contribution.weightCount = 0;
+		for(unsigned int currentSamplePos = firstSamplePos; (currentSamplePos <= lastSamplePos) && (currentSamplePos < sourceSize); ++currentSamplePos)
+		{
+			float sampleStartPoint = 0.0f;
+			if(currentSamplePos == firstSamplePos)
+			{
+				sampleStartPoint = firstSamplePoint - (float)firstSamplePos;
+			}
+			float sampleEndPoint = 1.0f;
+			if(currentSamplePos == lastSamplePos)
+			{
+				sampleEndPoint = lastSamplePoint - (float)lastSamplePos;
+			}
+			float sampleWeight = sampleEndPoint - sampleStartPoint;
+			if(sampleWeight <= 0.0f)
+			{
+				break;
+			}
+			kernel.weights.push_back(sampleWeight / totalDomain);
+			++contribution.weightCount;
+		}
+	}
+}
 
-		//Calculate the first and last pixels of interest from the source region.
-		unsigned int firstSamplePosY = (unsigned int)firstSamplePointY;
-		unsigned int lastSamplePosY = (unsigned int)lastSamplePointY;
+//----------------------------------------------------------------------------------------
+void Image::ResampleRowsHorizontal(const IImage& sourceImage, const ResampleKernel& kernel, std::vector<float>& intermediateData, unsigned int firstRow, unsigned int lastRow) const
+{
+	unsigned int sourceImageWidth = sourceImage.GetImageWidth();
+	unsigned int sourceRowElementCount = sourceImageWidth * dataPlaneCount;
+	std::vector<float> sourceRowBuffer(sourceRowElementCount);
+	for(unsigned int rowNo = firstRow; rowNo < lastRow; ++rowNo)
+	{
+		//Obtain the data for this line of the source image in floating point form
+		const float* sourceRowData = sourceImage.GetRowDataFloat(rowNo);
+		if(sourceRowData == 0)
+		{
+			const unsigned char* sourceRowData8Bit = sourceImage.GetRowData8Bit(rowNo);
+			if(sourceRowData8Bit != 0)
+			{
+				ConvertRowDataToFloat(sourceRowData8Bit, &sourceRowBuffer[0], sourceRowElementCount);
+			}
+			else
+			{
+				for(unsigned int xpos = 0; xpos < sourceImageWidth; ++xpos)
+				{
+					for(unsigned int plane = 0; plane < dataPlaneCount; ++plane)
+					{
+						sourceImage.ReadPixelData(xpos, rowNo, plane, sourceRowBuffer[(xpos * dataPlaneCount) + plane]);
+					}
+				}
+			}
+			sourceRowData = &sourceRowBuffer[0];
+		}
 
-		//Generate each pixel in this line
+		//Combine the weighted source pixels for each pixel in the target line
+		float* targetRowData = &intermediateData[(size_t)rowNo * rowElementCount];
 		for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
 		{
-			//Calculate the beginning and end of the sample region on the X axis in the
-			//source image, which is being mapped onto this pixel in the target image.
-			//Note that because we're adding 1 to the current pixel location, the second
-			//sample point may be past the end of the image, but this is ok, because this
-			//sample point is really a limit. We protect against reading past the
-			//boundaries of the image further below, and if this is attempted, this dud
-			//sample will be assigned a weight of zero.
-			float firstSamplePointX = (float)xpos * imageWidthConversionRatio;
-			float lastSamplePointX = (float)(xpos + 1) * imageWidthConversionRatio;
-
-			//Calculate the total domain, or length, of this sample region on the X axis.
-			float totalDomainX = lastSamplePointX - firstSamplePointX;
-
-			//Calculate the first and last pixels of interest from the source region
-			unsigned int firstSamplePosX = (unsigned int)firstSamplePointX;
-			unsigned int lastSamplePosX = (unsigned int)lastSamplePointX;
-
-			//Calculate the total domain, or area, of the sample region in the source
-			//image. We use this to normalize the sampled data back to an area of one
-			//pixel at the end.
-			float totalDomain = totalDomainX * totalDomainY;
-
-			//Calculate the sample value in each plane
+			const ResampleContribution& contribution = kernel.contributions[xpos];
+			const float* weights = &kernel.weights[contribution.firstWeightNo];
+			const float* sourcePixel = sourceRowData + (contribution.firstSourcePos * dataPlaneCount);
+			float* targetPixel = targetRowData + (xpos * dataPlaneCount);
 			for(unsigned int plane = 0; plane < dataPlaneCount; ++plane)
 			{
-				//Combine sample values from the source image, on both the X and Y axis,
-				//with their respective weightings.
 				float finalSample = 0.0f;
-				for(unsigned int currentSampleY = firstSamplePosY; currentSampleY <= lastSamplePosY; ++currentSampleY)
+				for(unsigned int weightNo = 0; weightNo < contribution.weightCount; ++weightNo)
 				{
-					float sampleStartPointY = 0.0f;
-					if(currentSampleY == firstSamplePosY)
-					{
-						sampleStartPointY = firstSamplePointY - (float)firstSamplePosY;
-					}
-					float sampleEndPointY = 1.0f;
-					if(currentSampleY == lastSamplePosY)
-					{
-						sampleEndPointY = lastSamplePointY - (float)lastSamplePosY;
-					}
-					float sampleWeightY = sampleEndPointY - sampleStartPointY;
-
-					for(unsigned int currentSampleX = firstSamplePosX; currentSampleX <= lastSamplePosX; ++currentSampleX)
-					{
-						float sampleStartPointX = 0.0f;
-						if(currentSampleX == firstSamplePosX)
-						{
-							sampleStartPointX = firstSamplePointX - (float)firstSamplePosX;
-						}
-						float sampleEndPointX = 1.0f;
-						if(currentSampleX == lastSamplePosX)
-						{
-							sampleEndPointX = lastSamplePointX - (float)lastSamplePosX;
-						}
-						float sampleWeightX = sampleEndPointX - sampleStartPointX;
-
-						float sample;
-						oldImage.ReadPixelData(currentSampleX % oldImage.GetImageWidth(), currentSampleY % oldImage.GetImageHeight(), plane, sample);
-						finalSample += sample * sampleWeightX * sampleWeightY;
-					}
+					finalSample += sourcePixel[(weightNo * dataPlaneCount) + plane] * weights[weightNo];
 				}
+				targetPixel[plane] = finalSample;
+			}
+		}
+	}
+}
 
-				//Normalize the sample value back to a single pixel value, by dividing it
-				//by the total area of the sample region in the source image.
-				finalSample /= totalDomain;
+//----------------------------------------------------------------------------------------
+void Image::ResampleRowsVertical(const std::vector<float>& intermediateData, const ResampleKernel& kernel, unsigned int firstRow, unsigned int lastRow)
+{
+	std::vector<float> targetRowBuffer(rowElementCount);
+	for(unsigned int rowNo = firstRow; rowNo < lastRow; ++rowNo)
+	{
+		const ResampleContribution& contribution = kernel.contributions[rowNo];
+		const float* weights = &kernel.weights[contribution.firstWeightNo];
+		const float* sourceData = &intermediateData[(size_t)contribution.firstSourcePos * rowElementCount];
+		float* targetRowData = (dataFormat == DATAFORMAT_FLOAT)? GetRowDataFloat(rowNo): &targetRowBuffer[0];
+
+		//Combine the weighted source lines for 4 elements at a time using SSE. Since the
+		//lines in the intermediate buffer are contiguous, each block of elements shares
+		//the same weight regardless of the number of data planes in the image.
+		unsigned int elementNo = 0;
+		static const unsigned int elementsPerBlock = sizeof(__m128) / sizeof(float);
+		for(; (elementNo + elementsPerBlock) <= rowElementCount; elementNo += elementsPerBlock)
+		{
+			__m128 finalSample = _mm_setzero_ps();
+			for(unsigned int weightNo = 0; weightNo < contribution.weightCount; ++weightNo)
+			{
+				__m128 sourceBlock = _mm_loadu_ps(sourceData + ((size_t)weightNo * rowElementCount) + elementNo);
+				finalSample = _mm_add_ps(finalSample, _mm_mul_ps(sourceBlock, _mm_set1_ps(weights[weightNo])));
+			}
+			_mm_storeu_ps(targetRowData + elementNo, finalSample);
+		}
 
-				//Write the generated pixel to the image
-				WritePixelDataInternal(xpos, ypos, plane, finalSample);
+		//Combine any remaining elements individually
+		for(; elementNo < rowElementCount; ++elementNo)
+		{
+			float finalSample = 0.0f;
+			for(unsigned int weightNo = 0; weightNo < contribution.weightCount; ++weightNo)
+			{
+				finalSample += sourceData[((size_t)weightNo * rowElementCount) + elementNo] * weights[weightNo];
 			}
+			targetRowData[elementNo] = finalSample;
+		}
+
+		//Write the generated line to the image
+		if(dataFormat == DATAFORMAT_8BIT)
+		{
+			ConvertRowDataTo8Bit(targetRowData, GetRowData8Bit(rowNo), rowElementCount);
 		}
 	}
 }
+
+//----------------------------------------------------------------------------------------
+void Image::ExecuteRowOperation(unsigned int rowCount, size_t elementCount, const std::function<void(unsigned int, unsigned int)>& rowOperation)
+{
+	//Split the rows between worker threads if there's enough work to justify the cost of
+	//creating them. Small images, such as thumbnails and single lines, are processed
+	//entirely on the calling thread.
+	unsigned int threadCount = 1;
+	if(elementCount >= (minResampleElementCountPerThread * 2))
+	{
+		threadCount = std::thread::hardware_concurrency();
+		threadCount = (unsigned int)std::min((size_t)threadCount, elementCount / minResampleElementCountPerThread);
+		threadCount = std::max(std::min(threadCount, rowCount), 1u);
+	}
+
+	//Process each block of rows, using the calling thread for the last block.
+	std::vector<std::thread> workerThreads;
+	unsigned int firstRow = 0;
+	for(unsigned int threadNo = 0; threadNo < threadCount; ++threadNo)
+	{
+		unsigned int lastRow = (unsigned int)(((unsigned long long)rowCount * (threadNo + 1)) / threadCount);
+		if(threadNo < (threadCount - 1))
+		{
+			workerThreads.push_back(std::thread(rowOperation, firstRow, lastRow));
+		}
+		else
+		{
+			rowOperation(firstRow, lastRow);
+		}
+		firstRow = lastRow;
+	}
+
+	//Wait for all worker threads to complete
+	for(unsigned int threadNo = 0; threadNo < workerThreads.size(); ++threadNo)
+	{
+		workerThreads[threadNo].join();
+	}
+}
@@ -47,6 +47,7 @@ for, which should be supported.
 #define __IMAGE_H__
 #include "ImageInterface/ImageInterface.pkg"
 #include <vector>
+#include <functional>
 #include "WindowsSupport/WindowsSupport.pkg"
 #define PNG_SETJMP_NOT_SUPPORTED
 #include <png.h>
@@ -122,12 +123,29 @@ public:
 	//virtual void ResampleBicubic(unsigned int newWidth, unsigned int newHeight);
 	//virtual void ResampleBicubic(Image& newImage, unsigned int newWidth, unsigned int newHeight);
 
+	//Row data functions
+	virtual unsigned int GetRowElementCount() const;
+	virtual const unsigned char* GetRowData8Bit(unsigned int posY) const;
+	virtual unsigned char* GetRowData8Bit(unsigned int posY);
+	virtual const float* GetRowDataFloat(unsigned int posY) const;
+	virtual float* GetRowDataFloat(unsigned int posY);
+
+	//Sub-image functions
+	virtual void CopyImageData(const IImage& sourceImage, unsigned int sourcePosX, unsigned int sourcePosY, unsigned int regionWidth, unsigned int regionHeight, unsigned int targetPosX, unsigned int targetPosY);
+
 public:
 	//BMP structures
 	struct BITMAPV2INFOHEADER;
 	struct BITMAPV3INFOHEADER;
 
 private:
+	//Constants
+	static const size_t minResampleElementCountPerThread = 0x10000;
+
+	//Resampling structures
+	struct ResampleContribution;
+	struct ResampleKernel;
+
 	//PCX structures
 	struct PCXFileHeader;
 	enum class PCXImageFormat;
@@ -149,6 +167,7 @@ private:
 	inline void ResizeBuffer(unsigned int newSize);
 
 	//Pixel data manipulation
+	inline unsigned int GetDataPos(unsigned int posX, unsigned int posY, unsigned int planeNo) const;
 	inline void GetRawPixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, PixelData& data) const;
 	inline void SetRawPixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, PixelData data);
 	inline void ReadPixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, float& data) const;
@@ -158,6 +177,10 @@ private:
 	inline void WritePixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, unsigned char data);
 	inline void WritePixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, unsigned int data, unsigned int bitCount);
 
+	//Row data functions
+	static void ConvertRowDataToFloat(const unsigned char* sourceData, float* targetData, unsigned int elementCount);
+	static void ConvertRowDataTo8Bit(const float* sourceData, unsigned char* targetData, unsigned int elementCount);
+
 	//Bitfield functions
 	unsigned int ReadBitfieldData(Stream::IStream& stream, unsigned char& currentBuffer, unsigned int& remainingBitsInBuffer, unsigned int dataBitCount) const;
 	void WriteBitfieldData(Stream::IStream& stream, unsigned char& currentBuffer, unsigned int& remainingBitsInBuffer, unsigned int data, unsigned int dataBitCount) const;
@@ -175,20 +198,25 @@ private:
 	//Image verification methods
 	bool ImageValid() const;
 
+	//Resampling functions
+	template<class T> inline void ResampleNearestRow(const T* sourceRowData, T* targetRowData, const std::vector<unsigned int>& sourceColumnPos) const;
+	static void BuildBilinearResampleKernel(unsigned int sourceSize, unsigned int targetSize, ResampleKernel& kernel);
+	void ResampleRowsHorizontal(const IImage& sourceImage, const ResampleKernel& kernel, std::vector<float>& intermediateData, unsigned int firstRow, unsigned int lastRow) const;
+	void ResampleRowsVertical(const std::vector<float>& intermediateData, const ResampleKernel& kernel, unsigned int firstRow, unsigned int lastRow);
+	static void ExecuteRowOperation(unsigned int rowCount, size_t elementCount, const std::function<void(unsigned int, unsigned int)>& rowOperation);
+
 private:
 	PixelFormat pixelFormat;
 	DataFormat dataFormat;
 	unsigned int imageWidth;
 	unsigned int imageHeight;
 	unsigned int dataPlaneCount;
-	//##TODO## Use a raw array rather than a vector here
-	//##TODO## Don't use the PixelData structure internally, only use it for passing pixel
-	//data externally in a generic way.
-	//##TODO## Add fast methods to get and set sub-image data, to allow copying and
-	//modifying regions of an image.
-	//##TODO## When we make this a raw array, add a copy constructor which uses memcpy to
-	//duplicate the elements of the array.
-	std::vector<PixelData> imageData;
+	unsigned int rowElementCount;
+
+	//Pixel data is stored packed in rows, with the data planes for each pixel stored
+	//together. Only the buffer matching the current data format is populated.
+	std::vector<unsigned char> imageData8Bit;
+	std::vector<float> imageDataFloat;
 };
 
 #include "Image.inl"
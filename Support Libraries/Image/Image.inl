@@ -1,5 +1,22 @@
 #include "Debug/Debug.pkg"
 
+//----------------------------------------------------------------------------------------
+//Resampling structures
+//----------------------------------------------------------------------------------------
+struct Image::ResampleContribution
+{
+	unsigned int firstSourcePos;
+	unsigned int firstWeightNo;
+	unsigned int weightCount;
+};
+
+//----------------------------------------------------------------------------------------
+struct Image::ResampleKernel
+{
+	std::vector<ResampleContribution> contributions;
+	std::vector<float> weights;
+};
+
 //----------------------------------------------------------------------------------------
 //PCX structures
 //----------------------------------------------------------------------------------------
@@ -364,34 +381,65 @@ Image::Image(unsigned int aimageWidth, unsigned int aimageHeight, PixelFormat ap
 
 //----------------------------------------------------------------------------------------
 //Pixel data manipulation
+//----------------------------------------------------------------------------------------
+unsigned int Image::GetDataPos(unsigned int posX, unsigned int posY, unsigned int planeNo) const
+{
+	return (posY * rowElementCount) + (posX * dataPlaneCount) + planeNo;
+}
+
 //----------------------------------------------------------------------------------------
 void Image::GetRawPixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, PixelData& data) const
 {
-	unsigned int dataPos = ((posX + (posY * imageWidth)) * dataPlaneCount) + planeNo;
-	DebugAssert(dataPos < imageData.size());
-	data = imageData[dataPos];
+	unsigned int dataPos = GetDataPos(posX, posY, planeNo);
+	switch(dataFormat)
+	{
+	case DATAFORMAT_FLOAT:
+		DebugAssert(dataPos < imageDataFloat.size());
+		data.dataFloat = imageDataFloat[dataPos];
+		break;
+	case DATAFORMAT_8BIT:
+		DebugAssert(dataPos < imageData8Bit.size());
+		data.data8Bit = imageData8Bit[dataPos];
+		break;
+	default:
+		DebugAssert(false);
+		return;
+	}
 }
 
 //----------------------------------------------------------------------------------------
 void Image::SetRawPixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, PixelData data)
 {
-	unsigned int dataPos = ((posX + (posY * imageWidth)) * dataPlaneCount) + planeNo;
-	DebugAssert(dataPos < imageData.size());
-	imageData[dataPos] = data;
+	unsigned int dataPos = GetDataPos(posX, posY, planeNo);
+	switch(dataFormat)
+	{
+	case DATAFORMAT_FLOAT:
+		DebugAssert(dataPos < imageDataFloat.size());
+		imageDataFloat[dataPos] = data.dataFloat;
+		break;
+	case DATAFORMAT_8BIT:
+		DebugAssert(dataPos < imageData8Bit.size());
+		imageData8Bit[dataPos] = data.data8Bit;
+		break;
+	default:
+		DebugAssert(false);
+		return;
+	}
 }
 
 //----------------------------------------------------------------------------------------
 void Image::ReadPixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, float& data) const
 {
-	PixelData pixelData;
-	GetRawPixelDataInternal(posX, posY, planeNo, pixelData);
+	unsigned int dataPos = GetDataPos(posX, posY, planeNo);
 	switch(dataFormat)
 	{
 	case DATAFORMAT_FLOAT:
-		data = pixelData.dataFloat;
+		DebugAssert(dataPos < imageDataFloat.size());
+		data = imageDataFloat[dataPos];
 		break;
 	case DATAFORMAT_8BIT:
-		data = ((float)pixelData.data8Bit / 255.0f);
+		DebugAssert(dataPos < imageData8Bit.size());
+		data = ((float)imageData8Bit[dataPos] / 255.0f);
 		break;
 	default:
 		DebugAssert(false);
@@ -402,15 +450,16 @@ void Image::ReadPixelDataInternal(unsigned int posX, unsigned int posY, unsigned
 //----------------------------------------------------------------------------------------
 void Image::ReadPixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, unsigned char& data) const
 {
-	PixelData pixelData;
-	GetRawPixelDataInternal(posX, posY, planeNo, pixelData);
+	unsigned int dataPos = GetDataPos(posX, posY, planeNo);
 	switch(dataFormat)
 	{
 	case DATAFORMAT_FLOAT:
-		data = (unsigned char)((pixelData.dataFloat * 255.0f) + 0.5f);
+		DebugAssert(dataPos < imageDataFloat.size());
+		data = (unsigned char)((imageDataFloat[dataPos] * 255.0f) + 0.5f);
 		break;
 	case DATAFORMAT_8BIT:
-		data = pixelData.data8Bit;
+		DebugAssert(dataPos < imageData8Bit.size());
+		data = imageData8Bit[dataPos];
 		break;
 	default:
 		DebugAssert(false);
@@ -422,15 +471,16 @@ void Image::ReadPixelDataInternal(unsigned int posX, unsigned int posY, unsigned
 void Image::ReadPixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, unsigned int& data, unsigned int bitCount) const
 {
 	unsigned int maxValue = (((1 << (bitCount - 1)) - 1) << 1) | 0x01;
-	PixelData pixelData;
-	GetRawPixelDataInternal(posX, posY, planeNo, pixelData);
+	unsigned int dataPos = GetDataPos(posX, posY, planeNo);
 	switch(dataFormat)
 	{
 	case DATAFORMAT_FLOAT:
-		data = (unsigned int)(((double)pixelData.dataFloat * ((double)maxValue / 1.0)) + 0.5f);
+		DebugAssert(dataPos < imageDataFloat.size());
+		data = (unsigned int)(((double)imageDataFloat[dataPos] * ((double)maxValue / 1.0)) + 0.5f);
 		break;
 	case DATAFORMAT_8BIT:
-		data = (unsigned int)(((double)pixelData.data8Bit * ((double)maxValue / 255.0)) + 0.5f);
+		DebugAssert(dataPos < imageData8Bit.size());
+		data = (unsigned int)(((double)imageData8Bit[dataPos] * ((double)maxValue / 255.0)) + 0.5f);
 		break;
 	default:
 		DebugAssert(false);
@@ -441,57 +491,76 @@ void Image::ReadPixelDataInternal(unsigned int posX, unsigned int posY, unsigned
 //----------------------------------------------------------------------------------------
 void Image::WritePixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, float data)
 {
-	PixelData pixelData;
+	unsigned int dataPos = GetDataPos(posX, posY, planeNo);
 	switch(dataFormat)
 	{
 	case DATAFORMAT_FLOAT:
-		pixelData.dataFloat = data;
+		DebugAssert(dataPos < imageDataFloat.size());
+		imageDataFloat[dataPos] = data;
 		break;
 	case DATAFORMAT_8BIT:
-		pixelData.data8Bit = (unsigned char)((data * 255.0f) + 0.5f);
+		DebugAssert(dataPos < imageData8Bit.size());
+		imageData8Bit[dataPos] = (unsigned char)((data * 255.0f) + 0.5f);
 		break;
 	default:
 		DebugAssert(false);
 		return;
 	}
-	SetRawPixelDataInternal(posX, posY, planeNo, pixelData);
 }
 
 //----------------------------------------------------------------------------------------
 void Image::WritePixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, unsigned char data)
 {
-	PixelData pixelData;
+	unsigned int dataPos = GetDataPos(posX, posY, planeNo);
 	switch(dataFormat)
 	{
 	case DATAFORMAT_FLOAT:
-		pixelData.dataFloat = ((float)data / 255.0f);
+		DebugAssert(dataPos < imageDataFloat.size());
+		imageDataFloat[dataPos] = ((float)data / 255.0f);
 		break;
 	case DATAFORMAT_8BIT:
-		pixelData.data8Bit = data;
+		DebugAssert(dataPos < imageData8Bit.size());
+		imageData8Bit[dataPos] = data;
 		break;
 	default:
 		DebugAssert(false);
 		return;
 	}
-	SetRawPixelDataInternal(posX, posY, planeNo, pixelData);
 }
 
 //----------------------------------------------------------------------------------------
 void Image::WritePixelDataInternal(unsigned int posX, unsigned int posY, unsigned int planeNo, unsigned int data, unsigned int bitCount)
 {
 	unsigned int maxValue = (((1 << (bitCount - 1)) - 1) << 1) | 0x01;
-	PixelData pixelData;
+	unsigned int dataPos = GetDataPos(posX, posY, planeNo);
 	switch(dataFormat)
 	{
 	case DATAFORMAT_FLOAT:
-		pixelData.dataFloat = (float)((double)data * (1.0 / (double)maxValue));
+		DebugAssert(dataPos < imageDataFloat.size());
+		imageDataFloat[dataPos] = (float)((double)data * (1.0 / (double)maxValue));
 		break;
 	case DATAFORMAT_8BIT:
-		pixelData.data8Bit = (unsigned char)(((double)data * (255.0 / (double)maxValue)) + 0.5f);
+		DebugAssert(dataPos < imageData8Bit.size());
+		imageData8Bit[dataPos] = (unsigned char)(((double)data * (255.0 / (double)maxValue)) + 0.5f);
 		break;
 	default:
 		DebugAssert(false);
 		return;
 	}
-	SetRawPixelDataInternal(posX, posY, planeNo, pixelData);
+}
+
+//----------------------------------------------------------------------------------------
+//Resampling functions
+//----------------------------------------------------------------------------------------
+template<class T> void Image::ResampleNearestRow(const T* sourceRowData, T* targetRowData, const std::vector<unsigned int>& sourceColumnPos) const
+{
+	for(unsigned int xpos = 0; xpos < imageWidth; ++xpos)
+	{
+		const T* sourcePixel = sourceRowData + (sourceColumnPos[xpos] * dataPlaneCount);
+		T* targetPixel = targetRowData + (xpos * dataPlaneCount);
+		for(unsigned int plane = 0; plane < dataPlaneCount; ++plane)
+		{
+			targetPixel[plane] = sourcePixel[plane];
+		}
+	}
 }
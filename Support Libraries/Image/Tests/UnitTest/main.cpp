@@ -0,0 +1,273 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "Image/Image.pkg"
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <cmath>
+
+//----------------------------------------------------------------------------------------
+//Helper structures
+//----------------------------------------------------------------------------------------
+//The source and target dimensions and format for a single resampling operation
+struct ResampleCase
+{
+	unsigned int sourceWidth;
+	unsigned int sourceHeight;
+	unsigned int targetWidth;
+	unsigned int targetHeight;
+	IImage::PixelFormat pixelFormat;
+	IImage::DataFormat dataFormat;
+};
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+static void FillImageRandom(Image& image, unsigned int seed)
+{
+	std::mt19937 randomGenerator(seed);
+	std::uniform_int_distribution<unsigned int> dataDistribution(0, 0xFF);
+	for(unsigned int ypos = 0; ypos < image.GetImageHeight(); ++ypos)
+	{
+		for(unsigned int xpos = 0; xpos < image.GetImageWidth(); ++xpos)
+		{
+			for(unsigned int plane = 0; plane < image.GetDataPlaneCount(); ++plane)
+			{
+				image.WritePixelData(xpos, ypos, plane, (unsigned char)dataDistribution(randomGenerator));
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Resamples an image in the same way as ResampleBilinear did before the area weights were
+//precomputed, with the weights for every source pixel calculated again for each target
+//pixel and plane, and each sample read through the per-pixel accessors.
+static void ReferenceResampleBilinear(Image& newImage, const IImage& oldImage, unsigned int newWidth, unsigned int newHeight)
+{
+	newImage.SetImageFormat(newWidth, newHeight, oldImage.GetPixelFormat(), oldImage.GetDataFormat());
+	if((oldImage.GetImageWidth() <= 0) || (oldImage.GetImageHeight() <= 0) || (newWidth <= 0) || (newHeight <= 0))
+	{
+		return;
+	}
+
+	unsigned int dataPlaneCount = newImage.GetDataPlaneCount();
+	float imageWidthConversionRatio = (float)oldImage.GetImageWidth() / (float)newWidth;
+	float imageHeightConversionRatio = (float)oldImage.GetImageHeight() / (float)newHeight;
+	for(unsigned int ypos = 0; ypos < newHeight; ++ypos)
+	{
+		float firstSamplePointY = (float)ypos * imageHeightConversionRatio;
+		float lastSamplePointY = (float)(ypos + 1) * imageHeightConversionRatio;
+		float totalDomainY = lastSamplePointY - firstSamplePointY;
+		unsigned int firstSamplePosY = (unsigned int)firstSamplePointY;
+		unsigned int lastSamplePosY = (unsigned int)lastSamplePointY;
+		for(unsigned int xpos = 0; xpos < newWidth; ++xpos)
+		{
+			float firstSamplePointX = (float)xpos * imageWidthConversionRatio;
+			float lastSamplePointX = (float)(xpos + 1) * imageWidthConversionRatio;
+			float totalDomainX = lastSamplePointX - firstSamplePointX;
+			unsigned int firstSamplePosX = (unsigned int)firstSamplePointX;
+			unsigned int lastSamplePosX = (unsigned int)lastSamplePointX;
+			float totalDomain = totalDomainX * totalDomainY;
+			for(unsigned int plane = 0; plane < dataPlaneCount; ++plane)
+			{
+				float finalSample = 0.0f;
+				for(unsigned int currentSampleY = firstSamplePosY; currentSampleY <= lastSamplePosY; ++currentSampleY)
+				{
+					float sampleStartPointY = (currentSampleY == firstSamplePosY)? (firstSamplePointY - (float)firstSamplePosY): 0.0f;
+					float sampleEndPointY = (currentSampleY == lastSamplePosY)? (lastSamplePointY - (float)lastSamplePosY): 1.0f;
+					float sampleWeightY = sampleEndPointY - sampleStartPointY;
+					for(unsigned int currentSampleX = firstSamplePosX; currentSampleX <= lastSamplePosX; ++currentSampleX)
+					{
+						float sampleStartPointX = (currentSampleX == firstSamplePosX)? (firstSamplePointX - (float)firstSamplePosX): 0.0f;
+						float sampleEndPointX = (currentSampleX == lastSamplePosX)? (lastSamplePointX - (float)lastSamplePosX): 1.0f;
+						float sampleWeightX = sampleEndPointX - sampleStartPointX;
+						float sample;
+						oldImage.ReadPixelData(currentSampleX % oldImage.GetImageWidth(), currentSampleY % oldImage.GetImageHeight(), plane, sample);
+						finalSample += sample * sampleWeightX * sampleWeightY;
+					}
+				}
+				finalSample /= totalDomain;
+				newImage.WritePixelData(xpos, ypos, plane, finalSample);
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Returns the number of data elements which differ between two images by more than the
+//given tolerance. 8-bit data is compared as raw values, and float data is compared
+//directly. Images with different formats are counted as entirely different.
+static unsigned int CompareImageData(const IImage& imageA, const IImage& imageB, unsigned int tolerance8Bit, float toleranceFloat)
+{
+	if((imageA.GetImageWidth() != imageB.GetImageWidth()) || (imageA.GetImageHeight() != imageB.GetImageHeight()) || (imageA.GetPixelFormat() != imageB.GetPixelFormat()) || (imageA.GetDataFormat() != imageB.GetDataFormat()))
+	{
+		return imageA.GetImageWidth() * imageA.GetImageHeight() * imageA.GetDataPlaneCount();
+	}
+
+	unsigned int mismatchCount = 0;
+	for(unsigned int ypos = 0; ypos < imageA.GetImageHeight(); ++ypos)
+	{
+		for(unsigned int xpos = 0; xpos < imageA.GetImageWidth(); ++xpos)
+		{
+			for(unsigned int plane = 0; plane < imageA.GetDataPlaneCount(); ++plane)
+			{
+				if(imageA.GetDataFormat() == IImage::DATAFORMAT_8BIT)
+				{
+					unsigned char dataA;
+					unsigned char dataB;
+					imageA.ReadPixelData(xpos, ypos, plane, dataA);
+					imageB.ReadPixelData(xpos, ypos, plane, dataB);
+					unsigned int difference = (dataA > dataB)? (unsigned int)(dataA - dataB): (unsigned int)(dataB - dataA);
+					mismatchCount += (difference > tolerance8Bit)? 1: 0;
+				}
+				else
+				{
+					float dataA;
+					float dataB;
+					imageA.ReadPixelData(xpos, ypos, plane, dataA);
+					imageB.ReadPixelData(xpos, ypos, plane, dataB);
+					mismatchCount += (std::fabs(dataA - dataB) > toleranceFloat)? 1: 0;
+				}
+			}
+		}
+	}
+	return mismatchCount;
+}
+
+//----------------------------------------------------------------------------------------
+//Resamples a random source image with both the reference and the current implementation,
+//and returns the number of data elements which differ. The weights are summed in a
+//different order, so results may differ by one 8-bit rounding step.
+static unsigned int CompareResampleBilinear(const ResampleCase& resampleCase)
+{
+	Image sourceImage(resampleCase.sourceWidth, resampleCase.sourceHeight, resampleCase.pixelFormat, resampleCase.dataFormat);
+	FillImageRandom(sourceImage, resampleCase.sourceWidth ^ (resampleCase.sourceHeight << 16));
+	Image referenceImage;
+	ReferenceResampleBilinear(referenceImage, sourceImage, resampleCase.targetWidth, resampleCase.targetHeight);
+	Image image;
+	image.ResampleBilinear(sourceImage, resampleCase.targetWidth, resampleCase.targetHeight);
+	return CompareImageData(referenceImage, image, 1, 0.0001f);
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("Image::ResampleBilinear", "")
+{
+	SECTION("Upsampling 8-bit colour", "")
+	{
+		ResampleCase resampleCase = {320, 224, 1280, 896, IImage::PIXELFORMAT_RGB, IImage::DATAFORMAT_8BIT};
+		REQUIRE(CompareResampleBilinear(resampleCase) == 0);
+	}
+	SECTION("Downsampling 8-bit colour with alpha", "")
+	{
+		ResampleCase resampleCase = {1920, 1080, 160, 90, IImage::PIXELFORMAT_RGBA, IImage::DATAFORMAT_8BIT};
+		REQUIRE(CompareResampleBilinear(resampleCase) == 0);
+	}
+	SECTION("Single line", "")
+	{
+		ResampleCase resampleCase = {341, 1, 320, 1, IImage::PIXELFORMAT_RGB, IImage::DATAFORMAT_8BIT};
+		REQUIRE(CompareResampleBilinear(resampleCase) == 0);
+	}
+	SECTION("Mixed ratios float monochrome", "")
+	{
+		ResampleCase resampleCase = {100, 77, 33, 250, IImage::PIXELFORMAT_M, IImage::DATAFORMAT_FLOAT};
+		REQUIRE(CompareResampleBilinear(resampleCase) == 0);
+	}
+	SECTION("Near identity float monochrome with alpha", "")
+	{
+		ResampleCase resampleCase = {320, 240, 321, 239, IImage::PIXELFORMAT_MA, IImage::DATAFORMAT_FLOAT};
+		REQUIRE(CompareResampleBilinear(resampleCase) == 0);
+	}
+	SECTION("In place", "")
+	{
+		Image sourceImage(64, 48, IImage::PIXELFORMAT_RGB, IImage::DATAFORMAT_8BIT);
+		FillImageRandom(sourceImage, 1);
+		Image referenceImage;
+		ReferenceResampleBilinear(referenceImage, sourceImage, 100, 30);
+		sourceImage.ResampleBilinear(100, 30);
+		REQUIRE(CompareImageData(referenceImage, sourceImage, 1, 0.0001f) == 0);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("Image::CopyImageData", "")
+{
+	Image image(8, 8, IImage::PIXELFORMAT_RGB, IImage::DATAFORMAT_8BIT);
+	for(unsigned int ypos = 0; ypos < 8; ++ypos)
+	{
+		for(unsigned int xpos = 0; xpos < 8; ++xpos)
+		{
+			for(unsigned int plane = 0; plane < 3; ++plane)
+			{
+				image.WritePixelData(xpos, ypos, plane, (unsigned char)((ypos * 8) + xpos));
+			}
+		}
+	}
+
+	SECTION("Overlapping copy within one image", "")
+	{
+		image.CopyImageData(image, 0, 0, 8, 6, 1, 2);
+		unsigned char data;
+		image.ReadPixelData(1, 2, 0, data);
+		REQUIRE(data == 0);
+		image.ReadPixelData(7, 7, 0, data);
+		REQUIRE(data == ((5 * 8) + 6));
+		image.ReadPixelData(0, 7, 0, data);
+		REQUIRE(data == (7 * 8));
+	}
+	SECTION("Clipped copy with format conversion", "")
+	{
+		Image floatImage(4, 4, IImage::PIXELFORMAT_RGB, IImage::DATAFORMAT_FLOAT);
+		floatImage.CopyImageData(image, 0, 0, 10, 10, 0, 0);
+		Image monochromeImage(4, 4, IImage::PIXELFORMAT_M, IImage::DATAFORMAT_8BIT);
+		monochromeImage.CopyImageData(floatImage, 0, 0, 4, 4, 0, 0);
+		float dataFloat;
+		unsigned char data;
+		floatImage.ReadPixelData(3, 3, 1, dataFloat);
+		REQUIRE(std::fabs(dataFloat - ((float)((3 * 8) + 3) / 255.0f)) < 0.000001f);
+		monochromeImage.ReadPixelData(3, 3, 0, data);
+		REQUIRE(data == ((3 * 8) + 3));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Benchmarks
+//----------------------------------------------------------------------------------------
+TEST_CASE("Image::ResampleBilinear benchmark", "[.][benchmark]")
+{
+	//Scale a Mega Drive frame up to four times its size, as the screenshot path does, and
+	//scale a large image down to a thumbnail, with both the reference and the current
+	//implementation.
+	static const unsigned int iterationCount = 10;
+	static const ResampleCase resampleCases[] = {
+		{320, 224, 1280, 896, IImage::PIXELFORMAT_RGB, IImage::DATAFORMAT_8BIT},
+		{1920, 1080, 160, 90, IImage::PIXELFORMAT_RGBA, IImage::DATAFORMAT_8BIT}};
+	for(unsigned int caseNo = 0; caseNo < (unsigned int)(sizeof(resampleCases) / sizeof(resampleCases[0])); ++caseNo)
+	{
+		const ResampleCase& resampleCase = resampleCases[caseNo];
+		Image sourceImage(resampleCase.sourceWidth, resampleCase.sourceHeight, resampleCase.pixelFormat, resampleCase.dataFormat);
+		FillImageRandom(sourceImage, caseNo);
+
+		Image referenceImage;
+		std::chrono::high_resolution_clock::time_point referenceStartTime = std::chrono::high_resolution_clock::now();
+		for(unsigned int iteration = 0; iteration < iterationCount; ++iteration)
+		{
+			ReferenceResampleBilinear(referenceImage, sourceImage, resampleCase.targetWidth, resampleCase.targetHeight);
+		}
+		std::chrono::high_resolution_clock::duration referenceTime = std::chrono::high_resolution_clock::now() - referenceStartTime;
+
+		Image image;
+		std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+		for(unsigned int iteration = 0; iteration < iterationCount; ++iteration)
+		{
+			image.ResampleBilinear(sourceImage, resampleCase.targetWidth, resampleCase.targetHeight);
+		}
+		std::chrono::high_resolution_clock::duration time = std::chrono::high_resolution_clock::now() - startTime;
+
+		double referenceMilliseconds = (double)std::chrono::duration_cast<std::chrono::microseconds>(referenceTime).count() / (1000.0 * iterationCount);
+		double milliseconds = (double)std::chrono::duration_cast<std::chrono::microseconds>(time).count() / (1000.0 * iterationCount);
+		std::wcout << resampleCase.sourceWidth << L"x" << resampleCase.sourceHeight << L" -> " << resampleCase.targetWidth << L"x" << resampleCase.targetHeight << L": reference " << referenceMilliseconds << L"ms, current " << milliseconds << L"ms\n";
+	}
+}
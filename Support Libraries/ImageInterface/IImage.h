@@ -93,6 +93,16 @@ public:
 	virtual void ResampleBilinear(const IImage& oldImage, unsigned int newWidth, unsigned int newHeight) = 0;
 	//virtual void ResampleBicubic(unsigned int newWidth, unsigned int newHeight) = 0;
 	//virtual void ResampleBicubic(Image& newImage, unsigned int newWidth, unsigned int newHeight) = 0;
+
+	//Row data functions
+	virtual unsigned int GetRowElementCount() const = 0;
+	virtual const unsigned char* GetRowData8Bit(unsigned int posY) const = 0;
+	virtual unsigned char* GetRowData8Bit(unsigned int posY) = 0;
+	virtual const float* GetRowDataFloat(unsigned int posY) const = 0;
+	virtual float* GetRowDataFloat(unsigned int posY) = 0;
+
+	//Sub-image functions
+	virtual void CopyImageData(const IImage& sourceImage, unsigned int sourcePosX, unsigned int sourcePosY, unsigned int regionWidth, unsigned int regionHeight, unsigned int targetPosX, unsigned int targetPosY) = 0;
 };
 
 #include "IImage.inl"
@@ -0,0 +1,48 @@
+#ifndef __BUFFEREDWAVFILE_H__
+#define __BUFFEREDWAVFILE_H__
+#include "WAVFile.h"
+#include "WAVFileWriter.h"
+#include <string>
+#include <vector>
+namespace Stream {
+
+//The BufferedWAVFile class accumulates sample data into large blocks in memory, and
+//passes completed blocks to a WAVFileWriter to be written to disk on a background
+//thread. This allows high frequency sample data to be logged from time critical threads.
+//Note that this class is not thread safe. The owner must ensure that write operations
+//don't overlap with calls to open or close the file.
+class BufferedWAVFile
+{
+public:
+	//Make sure the BufferedWAVFile object is non-copyable
+	protected: BufferedWAVFile(const BufferedWAVFile& object) {} public:
+
+	//Constructors
+	inline BufferedWAVFile();
+	inline ~BufferedWAVFile();
+
+	//File binding
+	inline bool Open(WAVFileWriter& awriter, const std::wstring& filename, unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec);
+	inline void Close();
+	inline bool IsOpen() const;
+
+	//Write functions
+	inline void WriteData(short data);
+	inline void WriteData(const short* data, unsigned int sampleCount);
+	inline void WriteData(const std::vector<short>& data);
+
+private:
+	//Block functions
+	inline void WriteBinary(const void* rawData, unsigned int bytesToWrite);
+
+private:
+	WAVFileWriter* writer;
+	WAVFile wavFile;
+	bool fileOpen;
+	std::vector<unsigned char> block;
+	unsigned int blockPos;
+};
+
+} //Close namespace Stream
+#include "BufferedWAVFile.inl"
+#endif
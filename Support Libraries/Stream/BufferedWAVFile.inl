@@ -0,0 +1,117 @@
+#include <cstring>
+namespace Stream {
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+BufferedWAVFile::BufferedWAVFile()
+:writer(0), fileOpen(false), blockPos(0)
+{}
+
+//----------------------------------------------------------------------------------------
+BufferedWAVFile::~BufferedWAVFile()
+{
+	Close();
+}
+
+//----------------------------------------------------------------------------------------
+//File binding
+//----------------------------------------------------------------------------------------
+bool BufferedWAVFile::Open(WAVFileWriter& awriter, const std::wstring& filename, unsigned int channelCount, unsigned int bitsPerSample, unsigned int samplesPerSec)
+{
+	//If a file is currently open, close it.
+	if(fileOpen)
+	{
+		Close();
+	}
+
+	//Create the target file. Note that the file headers are written at this point, and
+	//are finalized by the writer thread when the file is closed.
+	wavFile.SetDataFormat(channelCount, bitsPerSample, samplesPerSec);
+	if(!wavFile.Open(filename, WAVFile::OpenMode::WriteOnly, WAVFile::CreateMode::Create))
+	{
+		return false;
+	}
+
+	//Register this file with the writer, and obtain our initial block.
+	writer = &awriter;
+	writer->BeginFile(block);
+	blockPos = 0;
+	fileOpen = true;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+void BufferedWAVFile::Close()
+{
+	if(fileOpen)
+	{
+		//Pass the final partial block to the writer, and wait for the file to be closed.
+		writer->EndFile(wavFile, block, blockPos);
+		blockPos = 0;
+		writer = 0;
+		fileOpen = false;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+bool BufferedWAVFile::IsOpen() const
+{
+	return fileOpen;
+}
+
+//----------------------------------------------------------------------------------------
+//Write functions
+//----------------------------------------------------------------------------------------
+void BufferedWAVFile::WriteData(short data)
+{
+	//Note that WAV files are little-endian, which matches the byte order of all our
+	//supported platforms, so we write the sample data in native byte order.
+	WriteBinary(&data, sizeof(data));
+}
+
+//----------------------------------------------------------------------------------------
+void BufferedWAVFile::WriteData(const short* data, unsigned int sampleCount)
+{
+	WriteBinary(data, sampleCount * sizeof(*data));
+}
+
+//----------------------------------------------------------------------------------------
+void BufferedWAVFile::WriteData(const std::vector<short>& data)
+{
+	if(!data.empty())
+	{
+		WriteBinary(&data[0], (unsigned int)(data.size() * sizeof(data[0])));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Block functions
+//----------------------------------------------------------------------------------------
+void BufferedWAVFile::WriteBinary(const void* rawData, unsigned int bytesToWrite)
+{
+	//Ensure that a file is currently open
+	if(!fileOpen)
+	{
+		return;
+	}
+
+	//Copy the data into the current block, passing each block to the writer as it fills.
+	const unsigned char* rawDataAsCharArray = (const unsigned char*)rawData;
+	while(bytesToWrite > 0)
+	{
+		unsigned int bytesRemainingInBlock = (unsigned int)block.size() - blockPos;
+		unsigned int bytesToWriteToBlock = (bytesToWrite <= bytesRemainingInBlock)? bytesToWrite: bytesRemainingInBlock;
+		std::memcpy(&block[blockPos], rawDataAsCharArray, bytesToWriteToBlock);
+		blockPos += bytesToWriteToBlock;
+		rawDataAsCharArray += bytesToWriteToBlock;
+		bytesToWrite -= bytesToWriteToBlock;
+		if(blockPos >= (unsigned int)block.size())
+		{
+			writer->QueueBlock(wavFile, block, blockPos);
+			blockPos = 0;
+		}
+	}
+}
+
+} //Close namespace Stream
@@ -0,0 +1,137 @@
+#include "ByteOrderConversion.h"
+#include <intrin.h>
+#include <tmmintrin.h>
+#include <stdlib.h>
+namespace Stream {
+
+//----------------------------------------------------------------------------------------
+//Static members
+//----------------------------------------------------------------------------------------
+const bool ByteOrderConversion::shuffleBytesInstructionSupported = ByteOrderConversion::IsShuffleBytesInstructionSupported();
+
+//----------------------------------------------------------------------------------------
+//Byte order inversion functions
+//----------------------------------------------------------------------------------------
+void ByteOrderConversion::InvertByteOrder16(const void* source, void* target, size_t elementCount)
+{
+	const unsigned short* sourceData = (const unsigned short*)source;
+	unsigned short* targetData = (unsigned short*)target;
+	size_t elementNo = 0;
+
+	//Convert 8 elements at a time using the SSSE3 byte shuffle instruction if it's
+	//available. We use unaligned loads and stores here, since our callers make no
+	//guarantees about the alignment of their buffers.
+	if(shuffleBytesInstructionSupported)
+	{
+		const __m128i shuffleMask = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+		static const size_t elementsPerBlock = sizeof(__m128i) / sizeof(unsigned short);
+		for(; (elementNo + elementsPerBlock) <= elementCount; elementNo += elementsPerBlock)
+		{
+			__m128i block = _mm_loadu_si128((const __m128i*)(sourceData + elementNo));
+			_mm_storeu_si128((__m128i*)(targetData + elementNo), _mm_shuffle_epi8(block, shuffleMask));
+		}
+	}
+
+	//Convert any remaining elements individually
+	for(; elementNo < elementCount; ++elementNo)
+	{
+		targetData[elementNo] = _byteswap_ushort(sourceData[elementNo]);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void ByteOrderConversion::InvertByteOrder32(const void* source, void* target, size_t elementCount)
+{
+	const unsigned long* sourceData = (const unsigned long*)source;
+	unsigned long* targetData = (unsigned long*)target;
+	size_t elementNo = 0;
+
+	//Convert 4 elements at a time using the SSSE3 byte shuffle instruction if it's
+	//available
+	if(shuffleBytesInstructionSupported)
+	{
+		const __m128i shuffleMask = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+		static const size_t elementsPerBlock = sizeof(__m128i) / sizeof(unsigned long);
+		for(; (elementNo + elementsPerBlock) <= elementCount; elementNo += elementsPerBlock)
+		{
+			__m128i block = _mm_loadu_si128((const __m128i*)(sourceData + elementNo));
+			_mm_storeu_si128((__m128i*)(targetData + elementNo), _mm_shuffle_epi8(block, shuffleMask));
+		}
+	}
+
+	//Convert any remaining elements individually
+	for(; elementNo < elementCount; ++elementNo)
+	{
+		targetData[elementNo] = _byteswap_ulong(sourceData[elementNo]);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void ByteOrderConversion::InvertByteOrder64(const void* source, void* target, size_t elementCount)
+{
+	const unsigned __int64* sourceData = (const unsigned __int64*)source;
+	unsigned __int64* targetData = (unsigned __int64*)target;
+	size_t elementNo = 0;
+
+	//Convert 2 elements at a time using the SSSE3 byte shuffle instruction if it's
+	//available
+	if(shuffleBytesInstructionSupported)
+	{
+		const __m128i shuffleMask = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+		static const size_t elementsPerBlock = sizeof(__m128i) / sizeof(unsigned __int64);
+		for(; (elementNo + elementsPerBlock) <= elementCount; elementNo += elementsPerBlock)
+		{
+			__m128i block = _mm_loadu_si128((const __m128i*)(sourceData + elementNo));
+			_mm_storeu_si128((__m128i*)(targetData + elementNo), _mm_shuffle_epi8(block, shuffleMask));
+		}
+	}
+
+	//Convert any remaining elements individually
+	for(; elementNo < elementCount; ++elementNo)
+	{
+		targetData[elementNo] = _byteswap_uint64(sourceData[elementNo]);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void ByteOrderConversion::InvertByteOrder(const void* source, void* target, size_t elementSize, size_t elementCount)
+{
+	//Reverse the bytes of each element by swapping from each end towards the middle.
+	//This is safe to perform in place, since each pair of bytes is read before either is
+	//written.
+	const unsigned char* sourceData = (const unsigned char*)source;
+	unsigned char* targetData = (unsigned char*)target;
+	for(size_t elementNo = 0; elementNo < elementCount; ++elementNo)
+	{
+		const unsigned char* sourceElement = sourceData + (elementNo * elementSize);
+		unsigned char* targetElement = targetData + (elementNo * elementSize);
+		for(size_t i = 0; i < ((elementSize + 1) / 2); ++i)
+		{
+			unsigned char lowByte = sourceElement[i];
+			unsigned char highByte = sourceElement[(elementSize - 1) - i];
+			targetElement[i] = highByte;
+			targetElement[(elementSize - 1) - i] = lowByte;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Processor feature detection
+//----------------------------------------------------------------------------------------
+bool ByteOrderConversion::IsShuffleBytesInstructionSupported()
+{
+	//Query the feature flags of the processor to determine if the SSSE3 instruction set
+	//is supported. SSSE3 support is reported in bit 9 of ECX for leaf 1.
+	static const unsigned int cpuidLeafFeatures = 1;
+	static const unsigned int cpuidSSSE3BitMask = 1 << 9;
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	if((unsigned int)cpuInfo[0] < cpuidLeafFeatures)
+	{
+		return false;
+	}
+	__cpuid(cpuInfo, cpuidLeafFeatures);
+	return ((unsigned int)cpuInfo[2] & cpuidSSSE3BitMask) != 0;
+}
+
+} //Close namespace Stream
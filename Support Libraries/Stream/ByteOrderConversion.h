@@ -0,0 +1,26 @@
+#ifndef __BYTEORDERCONVERSION_H__
+#define __BYTEORDERCONVERSION_H__
+#include <cstddef>
+namespace Stream {
+
+class ByteOrderConversion
+{
+public:
+	//Byte order inversion functions
+	static void InvertByteOrder16(const void* source, void* target, size_t elementCount);
+	static void InvertByteOrder32(const void* source, void* target, size_t elementCount);
+	static void InvertByteOrder64(const void* source, void* target, size_t elementCount);
+	static void InvertByteOrder(const void* source, void* target, size_t elementSize, size_t elementCount);
+	template<class T> inline static void InvertByteOrder(const T* source, T* target, size_t elementCount);
+
+private:
+	//Processor feature detection
+	static bool IsShuffleBytesInstructionSupported();
+
+private:
+	static const bool shuffleBytesInstructionSupported;
+};
+
+} //Close namespace Stream
+#include "ByteOrderConversion.inl"
+#endif
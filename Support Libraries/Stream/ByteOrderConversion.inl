@@ -0,0 +1,37 @@
+namespace Stream {
+
+//----------------------------------------------------------------------------------------
+//Byte order inversion functions
+//----------------------------------------------------------------------------------------
+template<class T> void ByteOrderConversion::InvertByteOrder(const T* source, T* target, size_t elementCount)
+{
+	//Select the conversion kernel for the size of the target data type. Note that the
+	//source and target arrays may be the same, in which case the conversion is performed
+	//in place.
+	switch(sizeof(T))
+	{
+	case 1:
+		if(source != target)
+		{
+			for(size_t i = 0; i < elementCount; ++i)
+			{
+				target[i] = source[i];
+			}
+		}
+		break;
+	case 2:
+		InvertByteOrder16(source, target, elementCount);
+		break;
+	case 4:
+		InvertByteOrder32(source, target, elementCount);
+		break;
+	case 8:
+		InvertByteOrder64(source, target, elementCount);
+		break;
+	default:
+		InvertByteOrder(source, target, sizeof(T), elementCount);
+		break;
+	}
+}
+
+} //Close namespace Stream
@@ -6,6 +6,7 @@ so that it can work regardless of the particular encoding wchar_t uses.
 #include "StreamInterface/StreamInterface.pkg"
 #ifndef __STREAM_H__
 #define __STREAM_H__
+#include "ByteOrderConversion.h"
 namespace Stream {
 
 //##TODO## Detect byte order and new line encoding for this platform
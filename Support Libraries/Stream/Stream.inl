@@ -719,27 +719,14 @@ template<class B> template<class T> bool Stream<B>::ReadBinaryInvertedByteOrder(
 //----------------------------------------------------------------------------------------
 template<class B> template<class T> bool Stream<B>::ReadBinaryInvertedByteOrder(T* data, typename B::SizeType length)
 {
-	//Read the data in the native byte order
-	T* temp = new T[(size_t)length];
-	if(!ReadBinaryNativeByteOrder(temp, length))
+	//Read the data in the native byte order directly into the target buffer
+	if(!ReadBinaryNativeByteOrder(data, length))
 	{
-		delete[] temp;
 		return false;
 	}
 
-	//Invert the byte order
-	unsigned int dataTypeSize = sizeof(*data);
-	for(unsigned int entry = 0; entry < length; ++entry)
-	{
-		unsigned char* binaryData = (unsigned char*)&data[entry];
-		unsigned char* binaryTemp = (unsigned char*)&temp[entry];
-		for(unsigned int i = 0; i < dataTypeSize; ++i)
-		{
-			*(binaryData + i) = *(binaryTemp + ((dataTypeSize - 1) - i));
-		}
-	}
-
-	delete[] temp;
+	//Invert the byte order in place
+	ByteOrderConversion::InvertByteOrder(data, data, (size_t)length);
 	return true;
 }
 
@@ -1663,22 +1650,23 @@ template<class B> template<class T> bool Stream<B>::WriteBinaryInvertedByteOrder
 //----------------------------------------------------------------------------------------
 template<class B> template<class T> bool Stream<B>::WriteBinaryInvertedByteOrder(const T* data, typename B::SizeType length)
 {
-	//Invert the byte order
-	T* temp = new T[(size_t)length];
-
-	unsigned int dataTypeSize = sizeof(*data);
-	for(unsigned int entry = 0; entry < length; ++entry)
+	//Since we can't modify the source data, invert the byte order of the data in fixed
+	//size blocks into a local buffer, and write each block in the native byte order.
+	static const unsigned int conversionBufferSize = 0x1000;
+	static const unsigned int conversionBufferEntryCount = ((conversionBufferSize / sizeof(T)) > 0)? (conversionBufferSize / sizeof(T)): 1;
+	T conversionBuffer[conversionBufferEntryCount];
+	typename B::SizeType entriesWritten = 0;
+	while(entriesWritten < length)
 	{
-		unsigned char* binaryData = (unsigned char*)&data[entry];
-		unsigned char* binaryTemp = (unsigned char*)&temp[entry];
-		for(unsigned int i = 0; i < dataTypeSize; ++i)
+		typename B::SizeType blockEntryCount = ((length - entriesWritten) < conversionBufferEntryCount)? (length - entriesWritten): conversionBufferEntryCount;
+		ByteOrderConversion::InvertByteOrder(data + entriesWritten, &conversionBuffer[0], (size_t)blockEntryCount);
+		if(!WriteBinaryNativeByteOrder(&conversionBuffer[0], blockEntryCount))
 		{
-			*(binaryTemp + i) = *(binaryData + ((dataTypeSize - 1) - i));
+			return false;
 		}
+		entriesWritten += blockEntryCount;
 	}
-
-	//Write the data in the native byte order
-	return WriteBinaryNativeByteOrder(temp, length);
+	return true;
 }
 
 //----------------------------------------------------------------------------------------
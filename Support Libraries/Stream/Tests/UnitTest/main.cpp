@@ -0,0 +1,463 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "Stream/Stream.pkg"
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+static std::vector<short> BuildSampleRamp(unsigned int sampleCount, short firstValue)
+{
+	std::vector<short> samples(sampleCount);
+	for(unsigned int i = 0; i < sampleCount; ++i)
+	{
+		samples[i] = (short)(firstValue + (int)(i * 7));
+	}
+	return samples;
+}
+
+//----------------------------------------------------------------------------------------
+//Writes the samples to a buffered file in a mix of single sample, array, and vector
+//writes of varying lengths, so that writes both fit within and span block boundaries.
+static void WriteSamplesMixed(Stream::BufferedWAVFile& wavFile, const std::vector<short>& samples)
+{
+	unsigned int samplePos = 0;
+	unsigned int writeNo = 0;
+	while(samplePos < (unsigned int)samples.size())
+	{
+		unsigned int samplesRemaining = (unsigned int)samples.size() - samplePos;
+		unsigned int writeLength = ((writeNo * 13) % 97) + 1;
+		writeLength = (writeLength < samplesRemaining)? writeLength: samplesRemaining;
+		switch(writeNo % 3)
+		{
+		case 0:
+			for(unsigned int i = 0; i < writeLength; ++i)
+			{
+				wavFile.WriteData(samples[samplePos + i]);
+			}
+			break;
+		case 1:
+			wavFile.WriteData(&samples[samplePos], writeLength);
+			break;
+		case 2:
+			wavFile.WriteData(std::vector<short>(samples.begin() + samplePos, samples.begin() + samplePos + writeLength));
+			break;
+		}
+		samplePos += writeLength;
+		++writeNo;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+static bool ReadWAVFileSamples(const std::wstring& filePath, unsigned int& channelCount, std::vector<short>& samples)
+{
+	Stream::WAVFile wavFile;
+	if(!wavFile.Open(filePath, Stream::WAVFile::OpenMode::ReadOnly, Stream::WAVFile::CreateMode::Open))
+	{
+		return false;
+	}
+	unsigned int bitsPerSample;
+	unsigned int samplesPerSec;
+	if(!wavFile.GetDataFormat(channelCount, bitsPerSample, samplesPerSec) || (bitsPerSample != 16))
+	{
+		return false;
+	}
+	samples.resize((size_t)wavFile.GetSavedSampleCount() * channelCount);
+	return samples.empty() || wavFile.ReadData(&samples[0], (Stream::WAVFile::SizeType)samples.size());
+}
+
+//----------------------------------------------------------------------------------------
+//Inverts the byte order of each element one byte at a time, in the same way as the stream
+//read and write functions did before the byte order conversion kernels were added.
+static void ReferenceInvertByteOrder(const void* source, void* target, size_t elementSize, size_t elementCount)
+{
+	const unsigned char* sourceData = (const unsigned char*)source;
+	unsigned char* targetData = (unsigned char*)target;
+	for(size_t elementNo = 0; elementNo < elementCount; ++elementNo)
+	{
+		for(size_t i = 0; i < elementSize; ++i)
+		{
+			targetData[(elementNo * elementSize) + i] = sourceData[(elementNo * elementSize) + ((elementSize - 1) - i)];
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+static void InvertByteOrderForElementSize(const void* source, void* target, size_t elementSize, size_t elementCount)
+{
+	switch(elementSize)
+	{
+	case 2:
+		Stream::ByteOrderConversion::InvertByteOrder16(source, target, elementCount);
+		break;
+	case 4:
+		Stream::ByteOrderConversion::InvertByteOrder32(source, target, elementCount);
+		break;
+	case 8:
+		Stream::ByteOrderConversion::InvertByteOrder64(source, target, elementCount);
+		break;
+	default:
+		Stream::ByteOrderConversion::InvertByteOrder(source, target, elementSize, elementCount);
+		break;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Converts every element count from 0 up to several full SSE blocks, so that each kernel
+//covers its block loop, its tail loop, and both together. Each conversion is performed
+//from an aligned and an unaligned source, both into a separate buffer and in place.
+static void CheckInvertByteOrderForElementSize(size_t elementSize)
+{
+	static const size_t maxElementCount = 41;
+	std::vector<unsigned char> source(1 + (maxElementCount * elementSize));
+	for(size_t i = 0; i < source.size(); ++i)
+	{
+		source[i] = (unsigned char)((i * 29) + 1);
+	}
+	for(size_t sourceOffset = 0; sourceOffset < 2; ++sourceOffset)
+	{
+		for(size_t elementCount = 0; elementCount <= maxElementCount; ++elementCount)
+		{
+			std::vector<unsigned char> expected(maxElementCount * elementSize, 0xCC);
+			ReferenceInvertByteOrder(&source[sourceOffset], &expected[0], elementSize, elementCount);
+
+			std::vector<unsigned char> target(maxElementCount * elementSize, 0xCC);
+			InvertByteOrderForElementSize(&source[sourceOffset], &target[0], elementSize, elementCount);
+			REQUIRE(target == expected);
+
+			std::vector<unsigned char> inPlace(source);
+			InvertByteOrderForElementSize(&inPlace[sourceOffset], &inPlace[sourceOffset], elementSize, elementCount);
+			REQUIRE(std::equal(expected.begin(), expected.begin() + (elementCount * elementSize), inPlace.begin() + sourceOffset));
+			REQUIRE(std::equal(source.begin() + sourceOffset + (elementCount * elementSize), source.end(), inPlace.begin() + sourceOffset + (elementCount * elementSize)));
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+template<class T> static std::vector<T> BuildByteOrderTestValues(size_t elementCount)
+{
+	std::vector<T> values(elementCount);
+	unsigned long long nextValue = 0x0123456789ABCDEFULL;
+	for(size_t i = 0; i < elementCount; ++i)
+	{
+		nextValue = (nextValue * 6364136223846793005ULL) + 1442695040888963407ULL;
+		values[i] = (T)nextValue;
+	}
+	return values;
+}
+
+//----------------------------------------------------------------------------------------
+//Writes an array in big endian byte order after a single byte, so that the array is
+//unaligned in the stream, and spans several of the blocks the write is converted in.
+//Ensures the stream holds each element most significant byte first, then reads the
+//array back and ensures it matches.
+template<class T> static void CheckBigEndianArrayRoundTrip()
+{
+	static const size_t elementCount = 5000;
+	std::vector<T> values = BuildByteOrderTestValues<T>(elementCount);
+	Stream::Buffer buffer(0);
+	REQUIRE(buffer.WriteData((unsigned char)0x5A));
+	REQUIRE(buffer.WriteDataBigEndian(&values[0], (Stream::IStream::SizeType)values.size()));
+	REQUIRE(buffer.Size() == (Stream::IStream::SizeType)(1 + (elementCount * sizeof(T))));
+
+	const unsigned char* rawData = buffer.GetRawBuffer() + 1;
+	bool storedBigEndian = true;
+	for(size_t elementNo = 0; elementNo < elementCount; ++elementNo)
+	{
+		for(size_t i = 0; i < sizeof(T); ++i)
+		{
+			unsigned char expectedByte = (unsigned char)((unsigned long long)values[elementNo] >> (((sizeof(T) - 1) - i) * 8));
+			storedBigEndian &= (rawData[(elementNo * sizeof(T)) + i] == expectedByte);
+		}
+	}
+	REQUIRE(storedBigEndian);
+
+	std::vector<T> valuesRead(elementCount);
+	buffer.SetStreamPos(1);
+	REQUIRE(buffer.ReadDataBigEndian(&valuesRead[0], (Stream::IStream::SizeType)valuesRead.size()));
+	REQUIRE(valuesRead == values);
+}
+
+//----------------------------------------------------------------------------------------
+//Reads an array in inverted byte order in the same way as the stream did before the
+//byte order conversion kernels were added, by reading into a temporary array, then
+//inverting each element into the target one byte at a time.
+template<class T> static bool ReferenceReadDataBigEndian(Stream::Buffer& buffer, T* data, size_t elementCount)
+{
+	T* temp = new T[elementCount];
+	if(!buffer.ReadData(temp, (Stream::IStream::SizeType)elementCount))
+	{
+		delete[] temp;
+		return false;
+	}
+	ReferenceInvertByteOrder(temp, data, sizeof(T), elementCount);
+	delete[] temp;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+template<class T> static bool ReferenceWriteDataBigEndian(Stream::Buffer& buffer, const T* data, size_t elementCount)
+{
+	T* temp = new T[elementCount];
+	ReferenceInvertByteOrder(data, temp, sizeof(T), elementCount);
+	bool result = buffer.WriteData(temp, (Stream::IStream::SizeType)elementCount);
+	delete[] temp;
+	return result;
+}
+
+//----------------------------------------------------------------------------------------
+static double CalculateGigabytesPerSecond(size_t byteCount, std::chrono::high_resolution_clock::duration time)
+{
+	return ((double)byteCount / (1024.0 * 1024.0 * 1024.0)) / std::chrono::duration<double>(time).count();
+}
+
+//----------------------------------------------------------------------------------------
+//Writes and reads a large array in big endian byte order repeatedly, through both the
+//stream functions and the old byte at a time conversion, and prints the throughput of
+//each in gigabytes per second.
+template<class T> static void RunBigEndianArrayBenchmark(const wchar_t* typeName)
+{
+	static const size_t arraySize = 16 * 1024 * 1024;
+	static const unsigned int passCount = 8;
+	static const size_t elementCount = arraySize / sizeof(T);
+	std::vector<T> values = BuildByteOrderTestValues<T>(elementCount);
+	std::vector<T> valuesRead(elementCount);
+	Stream::Buffer buffer(0);
+	REQUIRE(buffer.WriteDataBigEndian(&values[0], (Stream::IStream::SizeType)elementCount));
+
+	std::chrono::high_resolution_clock::time_point referenceWriteStartTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int passNo = 0; passNo < passCount; ++passNo)
+	{
+		buffer.SetStreamPos(0);
+		REQUIRE(ReferenceWriteDataBigEndian(buffer, &values[0], elementCount));
+	}
+	std::chrono::high_resolution_clock::duration referenceWriteTime = std::chrono::high_resolution_clock::now() - referenceWriteStartTime;
+
+	std::chrono::high_resolution_clock::time_point writeStartTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int passNo = 0; passNo < passCount; ++passNo)
+	{
+		buffer.SetStreamPos(0);
+		REQUIRE(buffer.WriteDataBigEndian(&values[0], (Stream::IStream::SizeType)elementCount));
+	}
+	std::chrono::high_resolution_clock::duration writeTime = std::chrono::high_resolution_clock::now() - writeStartTime;
+
+	std::chrono::high_resolution_clock::time_point referenceReadStartTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int passNo = 0; passNo < passCount; ++passNo)
+	{
+		buffer.SetStreamPos(0);
+		REQUIRE(ReferenceReadDataBigEndian(buffer, &valuesRead[0], elementCount));
+	}
+	std::chrono::high_resolution_clock::duration referenceReadTime = std::chrono::high_resolution_clock::now() - referenceReadStartTime;
+	REQUIRE(valuesRead == values);
+
+	std::chrono::high_resolution_clock::time_point readStartTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int passNo = 0; passNo < passCount; ++passNo)
+	{
+		buffer.SetStreamPos(0);
+		REQUIRE(buffer.ReadDataBigEndian(&valuesRead[0], (Stream::IStream::SizeType)elementCount));
+	}
+	std::chrono::high_resolution_clock::duration readTime = std::chrono::high_resolution_clock::now() - readStartTime;
+	REQUIRE(valuesRead == values);
+
+	size_t byteCount = arraySize * passCount;
+	std::wcout << typeName << L" write: byte at a time " << CalculateGigabytesPerSecond(byteCount, referenceWriteTime) << L"GB/s, stream " << CalculateGigabytesPerSecond(byteCount, writeTime) << L"GB/s\n";
+	std::wcout << typeName << L" read: byte at a time " << CalculateGigabytesPerSecond(byteCount, referenceReadTime) << L"GB/s, stream " << CalculateGigabytesPerSecond(byteCount, readTime) << L"GB/s\n";
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("ByteOrderConversion::InvertByteOrder", "")
+{
+	SECTION("16-bit elements", "")
+	{
+		CheckInvertByteOrderForElementSize(2);
+	}
+	SECTION("32-bit elements", "")
+	{
+		CheckInvertByteOrderForElementSize(4);
+	}
+	SECTION("64-bit elements", "")
+	{
+		CheckInvertByteOrderForElementSize(8);
+	}
+	SECTION("Other element sizes", "")
+	{
+		CheckInvertByteOrderForElementSize(3);
+		CheckInvertByteOrderForElementSize(10);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("Stream::WriteDataBigEndian", "")
+{
+	SECTION("16-bit arrays", "")
+	{
+		CheckBigEndianArrayRoundTrip<unsigned short>();
+	}
+	SECTION("32-bit arrays", "")
+	{
+		CheckBigEndianArrayRoundTrip<unsigned int>();
+	}
+	SECTION("64-bit arrays", "")
+	{
+		CheckBigEndianArrayRoundTrip<unsigned long long>();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("BufferedWAVFile::WriteData", "")
+{
+	//Use a small block size and queue limit, so that every write path crosses many block
+	//boundaries, and the producer regularly waits on the writer thread.
+	static const unsigned int blockSize = 64;
+	static const unsigned int maxQueuedBlockCount = 2;
+	static const unsigned int samplesPerSec = 44100;
+	std::wstring filePathA = PathCombinePaths(PathGetCurrentWorkingDirectory(), L"BufferedWAVFileA.wav");
+	std::wstring filePathB = PathCombinePaths(PathGetCurrentWorkingDirectory(), L"BufferedWAVFileB.wav");
+	Stream::WAVFileWriter writer(blockSize, maxQueuedBlockCount);
+	unsigned int channelCount;
+	std::vector<short> samplesRead;
+
+	SECTION("Mixed write lengths", "")
+	{
+		std::vector<short> samples = BuildSampleRamp(2 * 5000, -20000);
+		Stream::BufferedWAVFile wavFile;
+		REQUIRE(wavFile.Open(writer, filePathA, 2, 16, samplesPerSec));
+		WriteSamplesMixed(wavFile, samples);
+		wavFile.Close();
+		REQUIRE(!wavFile.IsOpen());
+
+		REQUIRE(ReadWAVFileSamples(filePathA, channelCount, samplesRead));
+		CHECK(channelCount == 2);
+		REQUIRE(samplesRead == samples);
+	}
+	SECTION("Partial final block", "")
+	{
+		std::vector<short> samples = BuildSampleRamp((blockSize / sizeof(short)) + 3, 100);
+		Stream::BufferedWAVFile wavFile;
+		REQUIRE(wavFile.Open(writer, filePathA, 1, 16, samplesPerSec));
+		wavFile.WriteData(samples);
+		wavFile.Close();
+
+		REQUIRE(ReadWAVFileSamples(filePathA, channelCount, samplesRead));
+		CHECK(channelCount == 1);
+		REQUIRE(samplesRead == samples);
+	}
+	SECTION("Several files sharing one writer", "")
+	{
+		std::vector<short> samplesA = BuildSampleRamp(2 * 3000, 0);
+		std::vector<short> samplesB = BuildSampleRamp(4000, 1000);
+		Stream::BufferedWAVFile wavFileA;
+		Stream::BufferedWAVFile wavFileB;
+		REQUIRE(wavFileA.Open(writer, filePathA, 2, 16, samplesPerSec));
+		REQUIRE(wavFileB.Open(writer, filePathB, 1, 16, samplesPerSec));
+		for(unsigned int i = 0; i < (unsigned int)samplesA.size(); ++i)
+		{
+			wavFileA.WriteData(samplesA[i]);
+			if(i < (unsigned int)samplesB.size())
+			{
+				wavFileB.WriteData(samplesB[i]);
+			}
+		}
+		wavFileA.Close();
+		wavFileB.Close();
+
+		REQUIRE(ReadWAVFileSamples(filePathA, channelCount, samplesRead));
+		CHECK(channelCount == 2);
+		REQUIRE(samplesRead == samplesA);
+		REQUIRE(ReadWAVFileSamples(filePathB, channelCount, samplesRead));
+		CHECK(channelCount == 1);
+		REQUIRE(samplesRead == samplesB);
+	}
+	SECTION("Reopen after the writer thread stops", "")
+	{
+		Stream::BufferedWAVFile wavFile;
+		for(unsigned int i = 0; i < 3; ++i)
+		{
+			std::vector<short> samples = BuildSampleRamp(1000 + i, (short)(i * 100));
+			REQUIRE(wavFile.Open(writer, filePathA, 1, 16, samplesPerSec));
+			wavFile.WriteData(samples);
+			wavFile.Close();
+
+			REQUIRE(ReadWAVFileSamples(filePathA, channelCount, samplesRead));
+			REQUIRE(samplesRead == samples);
+		}
+	}
+	SECTION("Writes to a closed file are ignored", "")
+	{
+		std::vector<short> samples = BuildSampleRamp(500, 0);
+		Stream::BufferedWAVFile wavFile;
+		wavFile.WriteData(samples);
+		REQUIRE(wavFile.Open(writer, filePathA, 1, 16, samplesPerSec));
+		wavFile.WriteData(samples);
+		wavFile.Close();
+		wavFile.WriteData(samples);
+
+		REQUIRE(ReadWAVFileSamples(filePathA, channelCount, samplesRead));
+		REQUIRE(samplesRead == samples);
+	}
+
+	DeleteFile(filePathA.c_str());
+	DeleteFile(filePathB.c_str());
+}
+
+//----------------------------------------------------------------------------------------
+//Benchmarks
+//----------------------------------------------------------------------------------------
+TEST_CASE("Stream::WriteDataBigEndian benchmark", "[.][benchmark]")
+{
+	RunBigEndianArrayBenchmark<unsigned short>(L"16-bit");
+	RunBigEndianArrayBenchmark<unsigned int>(L"32-bit");
+	RunBigEndianArrayBenchmark<unsigned long long>(L"64-bit");
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("BufferedWAVFile::WriteData benchmark", "[.][benchmark]")
+{
+	//Log ten seconds of stereo output at the internal sample rate of the YM2612 on an NTSC
+	//system, taking a lock and writing each sample separately as the render thread once
+	//did, then writing the same data one frame at a time under a single lock, as the
+	//render thread now does at the end of each timeslice.
+	static const unsigned int samplesPerSec = 53693175 / 7 / 144;
+	static const unsigned int samplesPerFrame = samplesPerSec / 60;
+	static const unsigned int frameCount = 600;
+	std::wstring filePath = PathCombinePaths(PathGetCurrentWorkingDirectory(), L"BufferedWAVFileBenchmark.wav");
+	std::vector<short> frameSamples = BuildSampleRamp(samplesPerFrame * 2, 0);
+	std::mutex waveLoggingMutex;
+	Stream::WAVFileWriter writer;
+	Stream::BufferedWAVFile wavFile;
+
+	REQUIRE(wavFile.Open(writer, filePath, 2, 16, samplesPerSec));
+	std::chrono::high_resolution_clock::time_point sampleStartTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int frameNo = 0; frameNo < frameCount; ++frameNo)
+	{
+		for(unsigned int i = 0; i < (unsigned int)frameSamples.size(); ++i)
+		{
+			std::unique_lock<std::mutex> lock(waveLoggingMutex);
+			wavFile.WriteData(frameSamples[i]);
+		}
+	}
+	std::chrono::high_resolution_clock::duration sampleTime = std::chrono::high_resolution_clock::now() - sampleStartTime;
+	wavFile.Close();
+
+	REQUIRE(wavFile.Open(writer, filePath, 2, 16, samplesPerSec));
+	std::chrono::high_resolution_clock::time_point blockStartTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int frameNo = 0; frameNo < frameCount; ++frameNo)
+	{
+		std::unique_lock<std::mutex> lock(waveLoggingMutex);
+		wavFile.WriteData(frameSamples);
+	}
+	std::chrono::high_resolution_clock::duration blockTime = std::chrono::high_resolution_clock::now() - blockStartTime;
+	wavFile.Close();
+	DeleteFile(filePath.c_str());
+
+	double sampleCount = (double)frameSamples.size() * (double)frameCount;
+	double sampleNanosecondsPerSample = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(sampleTime).count() / sampleCount;
+	double blockNanosecondsPerSample = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(blockTime).count() / sampleCount;
+	std::wcout << L"Per-sample " << sampleNanosecondsPerSample << L"ns/sample, per-frame block " << blockNanosecondsPerSample << L"ns/sample\n";
+}
@@ -0,0 +1,175 @@
+#include "WAVFileWriter.h"
+#include <thread>
+#include <functional>
+namespace Stream {
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+WAVFileWriter::WAVFileWriter(unsigned int ablockSize, unsigned int amaxQueuedBlockCount)
+:blockSize(ablockSize), maxQueuedBlockCount(amaxQueuedBlockCount), queuedBlockCount(0), queuedBlockSequenceNo(0), writtenBlockSequenceNo(0), openFileCount(0), writerThreadActive(false), writerThreadRunning(false)
+{}
+
+//----------------------------------------------------------------------------------------
+WAVFileWriter::~WAVFileWriter()
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	StopWriterThread(lock);
+}
+
+//----------------------------------------------------------------------------------------
+//File functions
+//----------------------------------------------------------------------------------------
+void WAVFileWriter::BeginFile(std::vector<unsigned char>& block)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+
+	//Allocate the initial block for the new file
+	AllocateBlockInternal(block);
+
+	//If the writer thread isn't currently running, start it now.
+	++openFileCount;
+	if(!writerThreadRunning)
+	{
+		writerThreadActive = true;
+		writerThreadRunning = true;
+		std::thread workerThread(std::bind(std::mem_fn(&WAVFileWriter::WriterThread), this));
+		workerThread.detach();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void WAVFileWriter::QueueBlock(WAVFile& wavFile, std::vector<unsigned char>& block, unsigned int dataSize)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	QueueBlockInternal(lock, wavFile, block, dataSize, false);
+	AllocateBlockInternal(block);
+}
+
+//----------------------------------------------------------------------------------------
+void WAVFileWriter::EndFile(WAVFile& wavFile, std::vector<unsigned char>& block, unsigned int dataSize)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+
+	//Queue the final block for the file, and wait for the writer thread to write it and
+	//close the target file. Once we return, the WAV file headers have been finalized,
+	//and the file is closed.
+	QueueBlockInternal(lock, wavFile, block, dataSize, true);
+	unsigned long long closeBlockSequenceNo = queuedBlockSequenceNo;
+	while(writtenBlockSequenceNo < closeBlockSequenceNo)
+	{
+		blockWritten.wait(lock);
+	}
+
+	//If there are no more open files, stop the writer thread.
+	--openFileCount;
+	if(openFileCount == 0)
+	{
+		StopWriterThread(lock);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Block functions
+//----------------------------------------------------------------------------------------
+void WAVFileWriter::QueueBlockInternal(std::unique_lock<std::mutex>& lock, WAVFile& wavFile, std::vector<unsigned char>& block, unsigned int dataSize, bool closeFile)
+{
+	//If the queue is full, wait for the writer thread to catch up. This bounds the amount
+	//of memory held by pending blocks if the file system can't keep up with the rate at
+	//which data is being generated.
+	while(queuedBlockCount >= maxQueuedBlockCount)
+	{
+		blockWritten.wait(lock);
+	}
+
+	//Add the block to the queue. Note that we swap the block contents into the queue
+	//entry, so no sample data is copied here.
+	queuedBlocks.push_back(QueuedBlock());
+	QueuedBlock& queuedBlock = queuedBlocks.back();
+	queuedBlock.wavFile = &wavFile;
+	queuedBlock.data.swap(block);
+	queuedBlock.dataSize = dataSize;
+	queuedBlock.closeFile = closeFile;
+	++queuedBlockCount;
+	++queuedBlockSequenceNo;
+	blockQueued.notify_all();
+}
+
+//----------------------------------------------------------------------------------------
+void WAVFileWriter::AllocateBlockInternal(std::vector<unsigned char>& block)
+{
+	//Reuse a previously written block if one is available, otherwise allocate a new one.
+	if(!freeBlocks.empty())
+	{
+		block.swap(freeBlocks.back());
+		freeBlocks.pop_back();
+	}
+	block.resize(blockSize);
+}
+
+//----------------------------------------------------------------------------------------
+//Writer thread functions
+//----------------------------------------------------------------------------------------
+void WAVFileWriter::StopWriterThread(std::unique_lock<std::mutex>& lock)
+{
+	//Instruct the writer thread to stop, and wait for it to drain the queue and exit.
+	writerThreadActive = false;
+	blockQueued.notify_all();
+	while(writerThreadRunning)
+	{
+		writerThreadStopped.wait(lock);
+	}
+
+	//Release the memory for any free blocks
+	std::vector<std::vector<unsigned char>>().swap(freeBlocks);
+}
+
+//----------------------------------------------------------------------------------------
+void WAVFileWriter::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+
+	//Write out queued blocks until we're instructed to stop and the queue is empty
+	while(writerThreadActive || !queuedBlocks.empty())
+	{
+		//If no blocks are waiting to be written, wait for a block to be queued.
+		if(queuedBlocks.empty())
+		{
+			blockQueued.wait(lock);
+			continue;
+		}
+
+		//Take the next block from the queue. We splice the entry into a local list so
+		//that we can release the lock while performing the write.
+		std::list<QueuedBlock> currentBlockList;
+		currentBlockList.splice(currentBlockList.begin(), queuedBlocks, queuedBlocks.begin());
+		QueuedBlock& currentBlock = currentBlockList.front();
+		lock.unlock();
+
+		//Write the block to the target file, and close the file if requested. Closing the
+		//file finalizes the chunk sizes in the WAV file headers.
+		if(currentBlock.dataSize > 0)
+		{
+			currentBlock.wavFile->WriteData(&currentBlock.data[0], (WAVFile::SizeType)currentBlock.dataSize);
+		}
+		if(currentBlock.closeFile)
+		{
+			currentBlock.wavFile->Close();
+		}
+
+		//Return the block to the free list, and notify any waiting threads that the block
+		//has been written.
+		lock.lock();
+		freeBlocks.push_back(std::vector<unsigned char>());
+		freeBlocks.back().swap(currentBlock.data);
+		--queuedBlockCount;
+		++writtenBlockSequenceNo;
+		blockWritten.notify_all();
+	}
+
+	//Notify that this thread has stopped
+	writerThreadRunning = false;
+	writerThreadStopped.notify_all();
+}
+
+} //Close namespace Stream
@@ -0,0 +1,69 @@
+#ifndef __WAVFILEWRITER_H__
+#define __WAVFILEWRITER_H__
+#include "WAVFile.h"
+#include <vector>
+#include <list>
+#include <mutex>
+#include <condition_variable>
+namespace Stream {
+
+//The WAVFileWriter class owns a single background thread which performs the file writes
+//for any number of BufferedWAVFile objects. Sample data is passed to the writer in large
+//blocks, so the thread producing the samples never waits on the file system, unless the
+//number of blocks waiting to be written reaches the configured limit.
+class WAVFileWriter
+{
+public:
+	//Make sure the WAVFileWriter object is non-copyable
+	protected: WAVFileWriter(const WAVFileWriter& object) {} public:
+
+	//Constructors
+	WAVFileWriter(unsigned int ablockSize = 0x10000, unsigned int amaxQueuedBlockCount = 32);
+	~WAVFileWriter();
+
+	//Block functions
+	inline unsigned int GetBlockSize() const;
+
+	//File functions
+	void BeginFile(std::vector<unsigned char>& block);
+	void QueueBlock(WAVFile& wavFile, std::vector<unsigned char>& block, unsigned int dataSize);
+	void EndFile(WAVFile& wavFile, std::vector<unsigned char>& block, unsigned int dataSize);
+
+private:
+	//Structures
+	struct QueuedBlock;
+
+private:
+	//Block functions
+	void QueueBlockInternal(std::unique_lock<std::mutex>& lock, WAVFile& wavFile, std::vector<unsigned char>& block, unsigned int dataSize, bool closeFile);
+	void AllocateBlockInternal(std::vector<unsigned char>& block);
+
+	//Writer thread functions
+	void StopWriterThread(std::unique_lock<std::mutex>& lock);
+	void WriterThread();
+
+private:
+	//Block settings
+	unsigned int blockSize;
+	unsigned int maxQueuedBlockCount;
+
+	//Block queue
+	std::mutex accessMutex;
+	std::condition_variable blockQueued;
+	std::condition_variable blockWritten;
+	std::list<QueuedBlock> queuedBlocks;
+	unsigned int queuedBlockCount;
+	std::vector<std::vector<unsigned char>> freeBlocks;
+	unsigned long long queuedBlockSequenceNo;
+	unsigned long long writtenBlockSequenceNo;
+
+	//Writer thread state
+	std::condition_variable writerThreadStopped;
+	unsigned int openFileCount;
+	bool writerThreadActive;
+	bool writerThreadRunning;
+};
+
+} //Close namespace Stream
+#include "WAVFileWriter.inl"
+#endif
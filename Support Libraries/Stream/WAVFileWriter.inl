@@ -0,0 +1,26 @@
+namespace Stream {
+
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+struct WAVFileWriter::QueuedBlock
+{
+	QueuedBlock()
+	:wavFile(0), dataSize(0), closeFile(false)
+	{}
+
+	WAVFile* wavFile;
+	std::vector<unsigned char> data;
+	unsigned int dataSize;
+	bool closeFile;
+};
+
+//----------------------------------------------------------------------------------------
+//Block functions
+//----------------------------------------------------------------------------------------
+unsigned int WAVFileWriter::GetBlockSize() const
+{
+	return blockSize;
+}
+
+} //Close namespace Stream
@@ -0,0 +1,71 @@
+#ifndef __FRAMEPACER_H__
+#define __FRAMEPACER_H__
+#include "HighResolutionClock.h"
+
+class FramePacer
+{
+public:
+	//Enumerations
+	enum class PacingMode;
+
+	//Structures
+	struct JitterStatistics;
+
+public:
+	//Constructors
+	inline FramePacer();
+	inline ~FramePacer();
+
+	//Pacing mode functions
+	inline PacingMode GetPacingMode() const;
+	inline void SetPacingMode(PacingMode apacingMode);
+	inline long long GetMaxSpinTimeInNanoseconds() const;
+	inline void SetMaxSpinTimeInNanoseconds(long long amaxSpinTimeInNanoseconds);
+
+	//Synchronization functions
+	inline void Reset();
+	inline void Sync(double targetExecutionTime, bool enableSync = true, bool outputTimerDebug = false);
+
+	//Statistics functions
+	inline JitterStatistics GetJitterStatistics() const;
+	inline void ResetJitterStatistics();
+
+private:
+	//Time functions
+	inline void SleepUntil(long long asleepTargetTime);
+	inline void SpinUntil(long long aspinTargetTime);
+
+	//Calibration functions
+	inline void RecordSleepOvershoot(long long overshootInNanoseconds);
+	inline long long GetSleepMarginInNanoseconds() const;
+
+	//Statistics functions
+	inline void RecordPacingError(long long errorInNanoseconds);
+
+private:
+	//Pacing settings
+	PacingMode pacingMode;
+	long long maxSpinTimeInNanoseconds;
+
+	//Timing state
+#ifdef _WIN32
+	bool timerResolutionRaised;
+#endif
+	long long targetTimeInNanoseconds;
+
+	//Sleep calibration state
+	double sleepOvershootMeanInNanoseconds;
+	double sleepOvershootDeviationInNanoseconds;
+
+	//Jitter statistics
+	unsigned int statsSyncCount;
+	unsigned int statsResyncCount;
+	long long statsMinErrorInNanoseconds;
+	long long statsMaxErrorInNanoseconds;
+	double statsErrorSumInNanoseconds;
+	double statsErrorSquareSumInNanoseconds;
+	long long statsSpinTimeInNanoseconds;
+};
+
+#include "FramePacer.inl"
+#endif
@@ -0,0 +1,306 @@
+//##DEBUG##
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#ifdef _WIN32
+#ifdef _MSC_VER
+#pragma comment(lib, "Winmm.lib")
+#endif
+#else
+#include <errno.h>
+#endif
+
+//----------------------------------------------------------------------------------------
+//Enumerations
+//----------------------------------------------------------------------------------------
+enum class FramePacer::PacingMode
+{
+	//Sleep until just before the target time, based on the measured sleep overshoot, then
+	//spin for the remainder of the time, up to the configured spin limit.
+	Precise,
+	//Never spin. The thread sleeps until the target time, and any overshoot is recovered
+	//over the following sync points. This trades per-frame precision for leaving the
+	//core free for other work.
+	SleepOnly
+};
+
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+struct FramePacer::JitterStatistics
+{
+	JitterStatistics()
+	:syncCount(0), resyncCount(0), meanErrorInNanoseconds(0), errorStandardDeviationInNanoseconds(0), minErrorInNanoseconds(0), maxErrorInNanoseconds(0), sleepMarginInNanoseconds(0), spinTimeInNanoseconds(0)
+	{}
+
+	//The number of sync points which have been measured, and the number of those where
+	//we were so far behind the target time that we abandoned the attempt to catch up.
+	unsigned int syncCount;
+	unsigned int resyncCount;
+
+	//The difference between the time we resumed execution and the target time. Positive
+	//values indicate we resumed late.
+	double meanErrorInNanoseconds;
+	double errorStandardDeviationInNanoseconds;
+	long long minErrorInNanoseconds;
+	long long maxErrorInNanoseconds;
+
+	//The current amount of time we stop sleeping before the target time, and the total
+	//time spent spinning.
+	long long sleepMarginInNanoseconds;
+	long long spinTimeInNanoseconds;
+};
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+FramePacer::FramePacer()
+:pacingMode(PacingMode::Precise), maxSpinTimeInNanoseconds(2000000), sleepOvershootMeanInNanoseconds(1000000.0), sleepOvershootDeviationInNanoseconds(500000.0)
+{
+#ifdef _WIN32
+	//Raise the resolution of the system timer for the lifetime of this object. By
+	//default, Sleep only wakes on the scheduler tick, which is usually around 15.6ms,
+	//which is most of a sync window. With a 1ms timer period, the sleep overshoot is
+	//small enough to be absorbed by the final spin.
+	timerResolutionRaised = (timeBeginPeriod(1) == TIMERR_NOERROR);
+#endif
+	ResetJitterStatistics();
+	Reset();
+}
+
+//----------------------------------------------------------------------------------------
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+	if(timerResolutionRaised)
+	{
+		timeEndPeriod(1);
+	}
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//Pacing mode functions
+//----------------------------------------------------------------------------------------
+FramePacer::PacingMode FramePacer::GetPacingMode() const
+{
+	return pacingMode;
+}
+
+//----------------------------------------------------------------------------------------
+void FramePacer::SetPacingMode(PacingMode apacingMode)
+{
+	pacingMode = apacingMode;
+}
+
+//----------------------------------------------------------------------------------------
+long long FramePacer::GetMaxSpinTimeInNanoseconds() const
+{
+	return maxSpinTimeInNanoseconds;
+}
+
+//----------------------------------------------------------------------------------------
+void FramePacer::SetMaxSpinTimeInNanoseconds(long long amaxSpinTimeInNanoseconds)
+{
+	maxSpinTimeInNanoseconds = (amaxSpinTimeInNanoseconds < 0)? 0: amaxSpinTimeInNanoseconds;
+}
+
+//----------------------------------------------------------------------------------------
+//Synchronization functions
+//----------------------------------------------------------------------------------------
+void FramePacer::Reset()
+{
+	targetTimeInNanoseconds = GetHighResolutionTimeInNanoseconds();
+}
+
+//----------------------------------------------------------------------------------------
+void FramePacer::Sync(double targetExecutionTime, bool enableSync, bool outputTimerDebug)
+{
+	//Advance the target time by the amount of time which has just been executed. Note
+	//that we advance from the previous target time rather than the time we actually
+	//resumed at, so that any error at one sync point is corrected at the next one rather
+	//than accumulating as drift.
+	long long executionTimeStart = targetTimeInNanoseconds;
+	targetTimeInNanoseconds += (long long)(targetExecutionTime + 0.5);
+	long long executionTimeRealEnd = GetHighResolutionTimeInNanoseconds();
+
+	//If synchronization is disabled, rebase the target time to the current time, so that
+	//we don't try and catch up when synchronization is enabled again.
+	if(!enableSync)
+	{
+		targetTimeInNanoseconds = executionTimeRealEnd;
+		return;
+	}
+
+	//If we're running a long way behind the target time, we've either been suspended,
+	//or the system can't run at full speed. In this case, we rebase the target time to
+	//the current time rather than running flat out to try and catch up.
+	static const long long maxLagInNanoseconds = 50000000;
+	if((executionTimeRealEnd - targetTimeInNanoseconds) > maxLagInNanoseconds)
+	{
+		++statsResyncCount;
+		targetTimeInNanoseconds = executionTimeRealEnd;
+		return;
+	}
+
+	//Wait until we reach the target time
+	long long currentTime = executionTimeRealEnd;
+	while(currentTime < targetTimeInNanoseconds)
+	{
+		//If we're within our sleep margin of the target time, spin for the remaining time,
+		//and we're done. Note that if the measured sleep overshoot is larger than the time
+		//we're prepared to spin for, the spin ends early, and we resume slightly ahead of
+		//the target time. This is preferable to sleeping through the target time, and the
+		//shortfall is corrected at the next sync point.
+		long long sleepMargin = GetSleepMarginInNanoseconds();
+		long long remainingTime = targetTimeInNanoseconds - currentTime;
+		if(remainingTime <= sleepMargin)
+		{
+			SpinUntil(targetTimeInNanoseconds);
+			statsSpinTimeInNanoseconds += GetHighResolutionTimeInNanoseconds() - currentTime;
+			break;
+		}
+
+		//Sleep until we're within our sleep margin of the target time, and record how far
+		//the sleep overshot its requested wake time so we can refine the margin.
+		long long sleepTargetTime = targetTimeInNanoseconds - sleepMargin;
+		SleepUntil(sleepTargetTime);
+		currentTime = GetHighResolutionTimeInNanoseconds();
+		RecordSleepOvershoot(currentTime - sleepTargetTime);
+	}
+
+	//Record how close we came to the target time
+	long long executionTimeEnd = GetHighResolutionTimeInNanoseconds();
+	RecordPacingError(executionTimeEnd - targetTimeInNanoseconds);
+
+	//##DEBUG##
+	if(outputTimerDebug)
+	{
+		std::wcout << std::setprecision(16) << targetExecutionTime << '\t' << executionTimeEnd - executionTimeStart << '\t' << executionTimeRealEnd - executionTimeStart << '\t' << std::setprecision(4) << (targetExecutionTime / (double)(executionTimeEnd - executionTimeStart)) * 100.0 << '\t' << (targetExecutionTime / (double)(executionTimeRealEnd - executionTimeStart)) * 100.0 << '\t' << executionTimeEnd - targetTimeInNanoseconds << '\t' << GetSleepMarginInNanoseconds() << '\n';
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Statistics functions
+//----------------------------------------------------------------------------------------
+FramePacer::JitterStatistics FramePacer::GetJitterStatistics() const
+{
+	JitterStatistics statistics;
+	statistics.syncCount = statsSyncCount;
+	statistics.resyncCount = statsResyncCount;
+	statistics.minErrorInNanoseconds = statsMinErrorInNanoseconds;
+	statistics.maxErrorInNanoseconds = statsMaxErrorInNanoseconds;
+	statistics.sleepMarginInNanoseconds = GetSleepMarginInNanoseconds();
+	statistics.spinTimeInNanoseconds = statsSpinTimeInNanoseconds;
+	if(statsSyncCount > 0)
+	{
+		double mean = statsErrorSumInNanoseconds / (double)statsSyncCount;
+		double variance = (statsErrorSquareSumInNanoseconds / (double)statsSyncCount) - (mean * mean);
+		statistics.meanErrorInNanoseconds = mean;
+		statistics.errorStandardDeviationInNanoseconds = (variance > 0.0)? std::sqrt(variance): 0.0;
+	}
+	return statistics;
+}
+
+//----------------------------------------------------------------------------------------
+void FramePacer::ResetJitterStatistics()
+{
+	statsSyncCount = 0;
+	statsResyncCount = 0;
+	statsMinErrorInNanoseconds = 0;
+	statsMaxErrorInNanoseconds = 0;
+	statsErrorSumInNanoseconds = 0.0;
+	statsErrorSquareSumInNanoseconds = 0.0;
+	statsSpinTimeInNanoseconds = 0;
+}
+
+//----------------------------------------------------------------------------------------
+void FramePacer::RecordPacingError(long long errorInNanoseconds)
+{
+	if((statsSyncCount == 0) || (errorInNanoseconds < statsMinErrorInNanoseconds))
+	{
+		statsMinErrorInNanoseconds = errorInNanoseconds;
+	}
+	if((statsSyncCount == 0) || (errorInNanoseconds > statsMaxErrorInNanoseconds))
+	{
+		statsMaxErrorInNanoseconds = errorInNanoseconds;
+	}
+	statsErrorSumInNanoseconds += (double)errorInNanoseconds;
+	statsErrorSquareSumInNanoseconds += (double)errorInNanoseconds * (double)errorInNanoseconds;
+	++statsSyncCount;
+}
+
+//----------------------------------------------------------------------------------------
+//Time functions
+//----------------------------------------------------------------------------------------
+void FramePacer::SleepUntil(long long asleepTargetTime)
+{
+#ifdef _WIN32
+	//Sleep only offers millisecond granularity, and in practice wakes up on the next
+	//scheduler tick after the requested time. We always request at least one
+	//millisecond, and rely on the measured overshoot to keep us from waking too late.
+	long long remainingTime = asleepTargetTime - GetHighResolutionTimeInNanoseconds();
+	DWORD sleepTimeInMilliseconds = (remainingTime >= 1000000)? (DWORD)(remainingTime / 1000000): 1;
+	Sleep(sleepTimeInMilliseconds);
+#else
+	timespec sleepTargetTime;
+	sleepTargetTime.tv_sec = (time_t)(asleepTargetTime / 1000000000LL);
+	sleepTargetTime.tv_nsec = (long)(asleepTargetTime % 1000000000LL);
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &sleepTargetTime, 0) == EINTR)
+	{}
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+void FramePacer::SpinUntil(long long aspinTargetTime)
+{
+	//Busy-wait for the remaining time, up to our spin limit. If the spin limit is reached
+	//we stop early, and the shortfall is corrected at the next sync point. We issue a
+	//pause instruction on each iteration to reduce the power consumption of the spin, and
+	//to free up execution resources for another hardware thread on the same core.
+	long long spinEndTime = GetHighResolutionTimeInNanoseconds() + maxSpinTimeInNanoseconds;
+	if(spinEndTime > aspinTargetTime)
+	{
+		spinEndTime = aspinTargetTime;
+	}
+	while(GetHighResolutionTimeInNanoseconds() < spinEndTime)
+	{
+#ifdef _WIN32
+		YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+		__builtin_ia32_pause();
+#endif
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Calibration functions
+//----------------------------------------------------------------------------------------
+void FramePacer::RecordSleepOvershoot(long long overshootInNanoseconds)
+{
+	//Maintain an exponentially weighted running mean and mean deviation of the sleep
+	//overshoot. We clamp each sample, so that a single long stall caused by the thread
+	//being descheduled doesn't push the margin out for a long period of time.
+	static const double maxOvershootSampleInNanoseconds = 20000000.0;
+	static const double sampleWeight = 1.0 / 16.0;
+	double overshoot = (double)overshootInNanoseconds;
+	overshoot = (overshoot < 0.0)? 0.0: ((overshoot > maxOvershootSampleInNanoseconds)? maxOvershootSampleInNanoseconds: overshoot);
+	double deviation = std::fabs(overshoot - sleepOvershootMeanInNanoseconds);
+	sleepOvershootMeanInNanoseconds += (overshoot - sleepOvershootMeanInNanoseconds) * sampleWeight;
+	sleepOvershootDeviationInNanoseconds += (deviation - sleepOvershootDeviationInNanoseconds) * sampleWeight;
+}
+
+//----------------------------------------------------------------------------------------
+long long FramePacer::GetSleepMarginInNanoseconds() const
+{
+	//In sleep only mode we never stop short of the target time. Otherwise, we stop
+	//sleeping early enough to absorb most observed overshoots. Note that we don't limit
+	//the margin to the time we're prepared to spin for. If the platform can't sleep with
+	//enough precision, we need to wake early by the full overshoot, or we'd resume late
+	//at every sync point.
+	if(pacingMode == PacingMode::SleepOnly)
+	{
+		return 0;
+	}
+	return (long long)(sleepOvershootMeanInNanoseconds + (2.0 * sleepOvershootDeviationInNanoseconds));
+}
@@ -0,0 +1,15 @@
+#ifndef __HIGHRESOLUTIONCLOCK_H__
+#define __HIGHRESOLUTIONCLOCK_H__
+#ifdef _WIN32
+#include "WindowsSupport/WindowsSupport.pkg"
+#else
+#include <time.h>
+#endif
+
+//Returns the current value of a monotonic high resolution clock in nanoseconds. The
+//value has no defined epoch, and is only meaningful when compared with other values
+//returned by this function.
+inline long long GetHighResolutionTimeInNanoseconds();
+
+#include "HighResolutionClock.inl"
+#endif
@@ -0,0 +1,23 @@
+//----------------------------------------------------------------------------------------
+//Time functions
+//----------------------------------------------------------------------------------------
+long long GetHighResolutionTimeInNanoseconds()
+{
+#ifdef _WIN32
+	//Note that the counter frequency is fixed at system boot, and reading it is cheap, so
+	//we query it here rather than caching it. We split the conversion into whole seconds
+	//and the remaining ticks to avoid overflow and loss of precision at large counter
+	//values.
+	LARGE_INTEGER counterFrequency;
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&counterFrequency);
+	QueryPerformanceCounter(&counter);
+	long long seconds = counter.QuadPart / counterFrequency.QuadPart;
+	long long remainingTicks = counter.QuadPart % counterFrequency.QuadPart;
+	return (seconds * 1000000000LL) + ((remainingTicks * 1000000000LL) / counterFrequency.QuadPart);
+#else
+	timespec currentTime;
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return ((long long)currentTime.tv_sec * 1000000000LL) + (long long)currentTime.tv_nsec;
+#endif
+}
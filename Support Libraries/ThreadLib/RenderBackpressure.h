@@ -0,0 +1,88 @@
+#ifndef __RENDERBACKPRESSURE_H__
+#define __RENDERBACKPRESSURE_H__
+#include "HighResolutionClock.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+//The RenderBackpressure class regulates the amount of work which can be queued for a
+//device render thread. Work is measured in emulated time rather than operation count,
+//and the render thread's drain rate is measured as work completes, so that the limits
+//are expressed in terms of how long the render thread would take to catch up in real
+//time. When the render thread falls behind, the controller first enters a degraded
+//state, which devices can respond to by reducing the work they perform, and only blocks
+//the producer once the backlog exceeds the blocking limit.
+class RenderBackpressure
+{
+public:
+	//Enumerations
+	enum class Policy;
+	enum class State;
+
+	//Structures
+	struct Telemetry;
+
+public:
+	//Constructors
+	inline RenderBackpressure();
+
+	//Policy functions
+	inline Policy GetPolicy() const;
+	inline void SetPolicy(Policy apolicy);
+	inline double GetDegradeLatencyInNanoseconds() const;
+	inline void SetDegradeLatencyInNanoseconds(double adegradeLatencyInNanoseconds);
+	inline double GetBlockLatencyInNanoseconds() const;
+	inline void SetBlockLatencyInNanoseconds(double ablockLatencyInNanoseconds);
+
+	//Producer functions
+	inline void QueueWork(unsigned int operationCount, double emulatedTimeInNanoseconds);
+	inline void WaitWhileBlocked();
+	inline void WaitForIdle();
+
+	//Render thread functions
+	inline void BeginOperation();
+	inline void EndOperation();
+
+	//State functions
+	inline void Reset();
+	inline State GetState() const;
+	inline bool IsDegraded() const;
+	inline unsigned int GetPendingOperationCount() const;
+
+	//Telemetry functions
+	inline Telemetry GetTelemetry() const;
+
+private:
+	//State functions
+	inline void UpdateState();
+	inline double GetEstimatedDrainTimeInNanoseconds() const;
+
+private:
+	//Policy settings
+	Policy policy;
+	double degradeLatencyInNanoseconds;
+	double blockLatencyInNanoseconds;
+
+	//Queue state
+	mutable std::mutex accessMutex;
+	std::condition_variable stateChanged;
+	volatile State state;
+	std::deque<double> pendingOperationTimes;
+	double pendingTimeInNanoseconds;
+	bool operationInProgress;
+	double currentOperationTimeInNanoseconds;
+	long long currentOperationStartTime;
+
+	//Drain rate measurement
+	double drainRate;
+	bool drainRateMeasured;
+
+	//Telemetry
+	double maxPendingTimeInNanoseconds;
+	unsigned int degradedCount;
+	unsigned int blockedCount;
+	long long blockedTimeInNanoseconds;
+};
+
+#include "RenderBackpressure.inl"
+#endif
@@ -0,0 +1,308 @@
+//----------------------------------------------------------------------------------------
+//Enumerations
+//----------------------------------------------------------------------------------------
+enum class RenderBackpressure::Policy
+{
+	//Never enter the degraded state. The producer is blocked once the backlog exceeds the
+	//blocking limit.
+	BlockOnly,
+	//Enter the degraded state once the backlog exceeds the degrade limit, and only block
+	//the producer once the backlog exceeds the blocking limit.
+	DegradeThenBlock
+};
+
+//----------------------------------------------------------------------------------------
+enum class RenderBackpressure::State
+{
+	Normal,
+	Degraded,
+	Blocked
+};
+
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+struct RenderBackpressure::Telemetry
+{
+	Telemetry()
+	:state(State::Normal), pendingOperationCount(0), pendingTimeInNanoseconds(0), maxPendingTimeInNanoseconds(0), drainRate(0), estimatedDrainTimeInNanoseconds(0), degradedCount(0), blockedCount(0), blockedTimeInNanoseconds(0)
+	{}
+
+	//The current state of the queue, and the amount of work waiting for the render thread.
+	State state;
+	unsigned int pendingOperationCount;
+	double pendingTimeInNanoseconds;
+	double maxPendingTimeInNanoseconds;
+
+	//The measured rate at which the render thread processes work, as a ratio of emulated
+	//time to real time, and the estimated real time to clear the current backlog.
+	double drainRate;
+	double estimatedDrainTimeInNanoseconds;
+
+	//The number of times the queue has entered the degraded and blocked states, and the
+	//total time producers have spent blocked.
+	unsigned int degradedCount;
+	unsigned int blockedCount;
+	long long blockedTimeInNanoseconds;
+};
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+RenderBackpressure::RenderBackpressure()
+:policy(Policy::BlockOnly), degradeLatencyInNanoseconds(50000000.0), blockLatencyInNanoseconds(150000000.0)
+{
+	Reset();
+}
+
+//----------------------------------------------------------------------------------------
+//Policy functions
+//----------------------------------------------------------------------------------------
+RenderBackpressure::Policy RenderBackpressure::GetPolicy() const
+{
+	return policy;
+}
+
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::SetPolicy(Policy apolicy)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	policy = apolicy;
+	UpdateState();
+}
+
+//----------------------------------------------------------------------------------------
+double RenderBackpressure::GetDegradeLatencyInNanoseconds() const
+{
+	return degradeLatencyInNanoseconds;
+}
+
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::SetDegradeLatencyInNanoseconds(double adegradeLatencyInNanoseconds)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	degradeLatencyInNanoseconds = adegradeLatencyInNanoseconds;
+	UpdateState();
+}
+
+//----------------------------------------------------------------------------------------
+double RenderBackpressure::GetBlockLatencyInNanoseconds() const
+{
+	return blockLatencyInNanoseconds;
+}
+
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::SetBlockLatencyInNanoseconds(double ablockLatencyInNanoseconds)
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	blockLatencyInNanoseconds = ablockLatencyInNanoseconds;
+	UpdateState();
+}
+
+//----------------------------------------------------------------------------------------
+//Producer functions
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::QueueWork(unsigned int operationCount, double emulatedTimeInNanoseconds)
+{
+	if(operationCount == 0)
+	{
+		return;
+	}
+
+	//Record the emulated time covered by each new operation. Note that we only know the
+	//total time for the group of operations being committed, so we divide it evenly
+	//between them.
+	std::unique_lock<std::mutex> lock(accessMutex);
+	double operationTimeInNanoseconds = emulatedTimeInNanoseconds / (double)operationCount;
+	for(unsigned int i = 0; i < operationCount; ++i)
+	{
+		pendingOperationTimes.push_back(operationTimeInNanoseconds);
+	}
+	pendingTimeInNanoseconds += emulatedTimeInNanoseconds;
+	maxPendingTimeInNanoseconds = (pendingTimeInNanoseconds > maxPendingTimeInNanoseconds)? pendingTimeInNanoseconds: maxPendingTimeInNanoseconds;
+	UpdateState();
+}
+
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::WaitWhileBlocked()
+{
+	//If the render thread has fallen too far behind, pause here until it has caught up,
+	//so we don't leave the render thread behind with an ever-increasing workload it will
+	//never be able to complete. Note that we check the state before obtaining the lock,
+	//so that the common case doesn't incur any locking overhead.
+	if(state != State::Blocked)
+	{
+		return;
+	}
+	std::unique_lock<std::mutex> lock(accessMutex);
+	long long blockStartTime = GetHighResolutionTimeInNanoseconds();
+	while(state == State::Blocked)
+	{
+		stateChanged.wait(lock);
+	}
+	blockedTimeInNanoseconds += GetHighResolutionTimeInNanoseconds() - blockStartTime;
+}
+
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::WaitForIdle()
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	while(!pendingOperationTimes.empty() || operationInProgress)
+	{
+		stateChanged.wait(lock);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Render thread functions
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::BeginOperation()
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+
+	//Remove the next operation from the queue. We consider the operation to be drained
+	//from the queue as soon as the render thread picks it up.
+	currentOperationTimeInNanoseconds = 0.0;
+	if(!pendingOperationTimes.empty())
+	{
+		currentOperationTimeInNanoseconds = pendingOperationTimes.front();
+		pendingOperationTimes.pop_front();
+		pendingTimeInNanoseconds -= currentOperationTimeInNanoseconds;
+		if(pendingOperationTimes.empty())
+		{
+			pendingTimeInNanoseconds = 0.0;
+		}
+	}
+	operationInProgress = true;
+	currentOperationStartTime = GetHighResolutionTimeInNanoseconds();
+	UpdateState();
+}
+
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::EndOperation()
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+
+	//Update the measured drain rate for the render thread. We only measure the time the
+	//render thread spends actively processing work, so time the render thread spends
+	//idle waiting for work doesn't affect the result. The rate is smoothed over recent
+	//operations to filter out noise from individual timeslices.
+	long long operationRealTime = GetHighResolutionTimeInNanoseconds() - currentOperationStartTime;
+	if((operationRealTime > 0) && (currentOperationTimeInNanoseconds > 0.0))
+	{
+		double operationDrainRate = currentOperationTimeInNanoseconds / (double)operationRealTime;
+		drainRate = drainRateMeasured? ((drainRate * 0.9) + (operationDrainRate * 0.1)): operationDrainRate;
+		drainRateMeasured = true;
+	}
+	operationInProgress = false;
+	UpdateState();
+}
+
+//----------------------------------------------------------------------------------------
+//State functions
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::Reset()
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	state = State::Normal;
+	pendingOperationTimes.clear();
+	pendingTimeInNanoseconds = 0.0;
+	operationInProgress = false;
+	currentOperationTimeInNanoseconds = 0.0;
+	currentOperationStartTime = 0;
+	drainRate = 1.0;
+	drainRateMeasured = false;
+	maxPendingTimeInNanoseconds = 0.0;
+	degradedCount = 0;
+	blockedCount = 0;
+	blockedTimeInNanoseconds = 0;
+	stateChanged.notify_all();
+}
+
+//----------------------------------------------------------------------------------------
+RenderBackpressure::State RenderBackpressure::GetState() const
+{
+	return state;
+}
+
+//----------------------------------------------------------------------------------------
+bool RenderBackpressure::IsDegraded() const
+{
+	return (state != State::Normal);
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int RenderBackpressure::GetPendingOperationCount() const
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	return (unsigned int)pendingOperationTimes.size();
+}
+
+//----------------------------------------------------------------------------------------
+void RenderBackpressure::UpdateState()
+{
+	//Determine the new state based on how long we expect the render thread to take to
+	//clear its backlog. Once blocked, we remain blocked until the backlog has dropped
+	//back below the degrade limit, so that the producer doesn't rapidly switch between
+	//running and blocking around the limit.
+	double estimatedDrainTime = GetEstimatedDrainTimeInNanoseconds();
+	State newState = State::Normal;
+	if((estimatedDrainTime > blockLatencyInNanoseconds) || ((state == State::Blocked) && (estimatedDrainTime > degradeLatencyInNanoseconds)))
+	{
+		newState = State::Blocked;
+	}
+	else if((policy == Policy::DegradeThenBlock) && (estimatedDrainTime > degradeLatencyInNanoseconds))
+	{
+		newState = State::Degraded;
+	}
+
+	//Never block while the queue is empty. This ensures a producer can't be left waiting
+	//on a render thread which has no work left to complete.
+	if(pendingOperationTimes.empty() && (newState == State::Blocked))
+	{
+		newState = State::Normal;
+	}
+
+	//Apply the new state, and notify any waiting threads of the change.
+	if(newState != state)
+	{
+		if(newState == State::Blocked)
+		{
+			++blockedCount;
+		}
+		else if((newState == State::Degraded) && (state == State::Normal))
+		{
+			++degradedCount;
+		}
+		state = newState;
+	}
+	stateChanged.notify_all();
+}
+
+//----------------------------------------------------------------------------------------
+double RenderBackpressure::GetEstimatedDrainTimeInNanoseconds() const
+{
+	//Until we've measured the drain rate for the render thread, we assume it renders in
+	//realtime.
+	return (drainRate > 0.0)? (pendingTimeInNanoseconds / drainRate): pendingTimeInNanoseconds;
+}
+
+//----------------------------------------------------------------------------------------
+//Telemetry functions
+//----------------------------------------------------------------------------------------
+RenderBackpressure::Telemetry RenderBackpressure::GetTelemetry() const
+{
+	std::unique_lock<std::mutex> lock(accessMutex);
+	Telemetry telemetry;
+	telemetry.state = state;
+	telemetry.pendingOperationCount = (unsigned int)pendingOperationTimes.size();
+	telemetry.pendingTimeInNanoseconds = pendingTimeInNanoseconds;
+	telemetry.maxPendingTimeInNanoseconds = maxPendingTimeInNanoseconds;
+	telemetry.drainRate = drainRate;
+	telemetry.estimatedDrainTimeInNanoseconds = GetEstimatedDrainTimeInNanoseconds();
+	telemetry.degradedCount = degradedCount;
+	telemetry.blockedCount = blockedCount;
+	telemetry.blockedTimeInNanoseconds = blockedTimeInNanoseconds;
+	return telemetry;
+}
+
@@ -0,0 +1,102 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "HighResolutionClock.h"
+#include "RenderBackpressure.h"
+#include <thread>
+#include <functional>
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+static void DrainOperations(RenderBackpressure* renderBackpressure, unsigned int operationCount)
+{
+	for(unsigned int i = 0; i < operationCount; ++i)
+	{
+		renderBackpressure->BeginOperation();
+		renderBackpressure->EndOperation();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("HighResolutionClock", "")
+{
+	long long startTime = GetHighResolutionTimeInNanoseconds();
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	long long endTime = GetHighResolutionTimeInNanoseconds();
+	REQUIRE(endTime >= startTime);
+	CHECK((endTime - startTime) >= 5000000LL);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("RenderBackpressure", "")
+{
+	static const double millisecond = 1000000.0;
+	RenderBackpressure renderBackpressure;
+	renderBackpressure.SetDegradeLatencyInNanoseconds(50.0 * millisecond);
+	renderBackpressure.SetBlockLatencyInNanoseconds(150.0 * millisecond);
+
+	SECTION("BlockOnly", "")
+	{
+		//The render thread is assumed to run in realtime until its drain rate has been
+		//measured, so queued emulated time maps directly to drain time here.
+		renderBackpressure.SetPolicy(RenderBackpressure::Policy::BlockOnly);
+		renderBackpressure.QueueWork(2, 100.0 * millisecond);
+		CHECK(renderBackpressure.GetState() == RenderBackpressure::State::Normal);
+		CHECK(!renderBackpressure.IsDegraded());
+		CHECK(renderBackpressure.GetPendingOperationCount() == 2);
+		renderBackpressure.QueueWork(1, 60.0 * millisecond);
+		CHECK(renderBackpressure.GetState() == RenderBackpressure::State::Blocked);
+		CHECK(renderBackpressure.GetTelemetry().blockedCount == 1);
+	}
+	SECTION("DegradeThenBlock", "")
+	{
+		renderBackpressure.SetPolicy(RenderBackpressure::Policy::DegradeThenBlock);
+		renderBackpressure.QueueWork(1, 60.0 * millisecond);
+		CHECK(renderBackpressure.GetState() == RenderBackpressure::State::Degraded);
+		CHECK(renderBackpressure.IsDegraded());
+		renderBackpressure.QueueWork(1, 100.0 * millisecond);
+		CHECK(renderBackpressure.GetState() == RenderBackpressure::State::Blocked);
+
+		RenderBackpressure::Telemetry telemetry = renderBackpressure.GetTelemetry();
+		CHECK(telemetry.degradedCount == 1);
+		CHECK(telemetry.blockedCount == 1);
+		CHECK(telemetry.pendingOperationCount == 2);
+		CHECK(telemetry.maxPendingTimeInNanoseconds == (160.0 * millisecond));
+	}
+	SECTION("Hysteresis", "")
+	{
+		//Once blocked, the producer must remain blocked until the backlog drops below the
+		//degrade limit, not just the block limit.
+		renderBackpressure.QueueWork(1, 40.0 * millisecond);
+		renderBackpressure.QueueWork(1, 120.0 * millisecond);
+		CHECK(renderBackpressure.GetState() == RenderBackpressure::State::Blocked);
+		renderBackpressure.BeginOperation();
+		CHECK(renderBackpressure.GetState() == RenderBackpressure::State::Blocked);
+		renderBackpressure.EndOperation();
+		renderBackpressure.BeginOperation();
+		CHECK(renderBackpressure.GetState() == RenderBackpressure::State::Normal);
+		renderBackpressure.EndOperation();
+		CHECK(renderBackpressure.GetPendingOperationCount() == 0);
+	}
+	SECTION("WaitWhileBlocked", "")
+	{
+		renderBackpressure.QueueWork(4, 400.0 * millisecond);
+		REQUIRE(renderBackpressure.GetState() == RenderBackpressure::State::Blocked);
+		std::thread renderThread(std::bind(DrainOperations, &renderBackpressure, 4));
+		renderBackpressure.WaitWhileBlocked();
+		CHECK(renderBackpressure.GetState() != RenderBackpressure::State::Blocked);
+		renderBackpressure.WaitForIdle();
+		CHECK(renderBackpressure.GetPendingOperationCount() == 0);
+		renderThread.join();
+	}
+	SECTION("Reset", "")
+	{
+		renderBackpressure.QueueWork(4, 400.0 * millisecond);
+		renderBackpressure.Reset();
+		CHECK(renderBackpressure.GetState() == RenderBackpressure::State::Normal);
+		CHECK(renderBackpressure.GetPendingOperationCount() == 0);
+		CHECK(renderBackpressure.GetTelemetry().blockedCount == 0);
+	}
+}
@@ -140,13 +140,30 @@ bool DeflateCompress(Stream::IStream& source, Stream::IStream& target, unsigned
 
 //----------------------------------------------------------------------------------------
 bool DeflateDecompress(Stream::IStream& source, Stream::IStream& target, unsigned int& calculatedCRC, unsigned int inputCacheSize, unsigned int outputCacheSize)
+{
+	//Decompress all the remaining data in the source stream
+	Stream::IStream::SizeType sourceDataSize = (source.Size() - source.GetStreamPos());
+	if(sourceDataSize < 0)
+	{
+		sourceDataSize = 0;
+	}
+	return DeflateDecompress(source, sourceDataSize, target, calculatedCRC, inputCacheSize, outputCacheSize);
+}
+
+//----------------------------------------------------------------------------------------
+bool DeflateDecompress(Stream::IStream& source, Stream::IStream::SizeType sourceDataSize, Stream::IStream& target, unsigned int& calculatedCRC, unsigned int inputCacheSize, unsigned int outputCacheSize)
 {
 	//If no input cache size was specified, set the input cache size to 1MB, and create
-	//our input buffer.
+	//our input buffer. Since we never read more than the specified amount of source data,
+	//we limit the size of the input buffer to the size of the source data.
 	if(inputCacheSize <= 0)
 	{
 		inputCacheSize = (1024*1024);
 	}
+	if((sourceDataSize > 0) && ((Stream::IStream::SizeType)inputCacheSize > sourceDataSize))
+	{
+		inputCacheSize = (unsigned int)sourceDataSize;
+	}
 	std::vector<unsigned char> inputCache(inputCacheSize);
 
 	//If no output cache size was specified, set the output cache size to 1MB, and create
@@ -195,16 +212,11 @@ bool DeflateDecompress(Stream::IStream& source, Stream::IStream& target, unsigne
 		if(strm.avail_in <= 0)
 		{
 			//Grab enough data from the source to either fill our buffer, or reach the end
-			//of the stream.
-			Stream::IStream::SizeType remainingSourceData = (source.Size() - source.GetStreamPos());
-			if(remainingSourceData < 0)
-			{
-				remainingSourceData = 0;
-			}
+			//of the source data.
 			strm.avail_in = (uInt)inputCache.size();
-			if((uInt)remainingSourceData <= strm.avail_in)
+			if((uInt)sourceDataSize <= strm.avail_in)
 			{
-				strm.avail_in = (uInt)remainingSourceData;
+				strm.avail_in = (uInt)sourceDataSize;
 			}
 			if(!source.ReadData(&inputCache[0], strm.avail_in))
 			{
@@ -213,6 +225,7 @@ bool DeflateDecompress(Stream::IStream& source, Stream::IStream& target, unsigne
 				inflateEnd(&strm);
 				return false;
 			}
+			sourceDataSize -= strm.avail_in;
 			strm.next_in = &inputCache[0];
 		}
 
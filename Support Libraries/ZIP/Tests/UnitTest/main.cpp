@@ -0,0 +1,217 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "ZIP/ZIP.pkg"
+#include <vector>
+#include <string>
+#include <cstring>
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+//Builds a block of test data for a file in an archive. The data mixes runs of repeated
+//bytes with pseudo-random bytes, so that it compresses, but not to a trivial size.
+static std::vector<unsigned char> BuildTestFileData(unsigned int seed, unsigned int size)
+{
+	std::vector<unsigned char> fileData(size);
+	unsigned int value = seed;
+	for(unsigned int i = 0; i < size; ++i)
+	{
+		value = (value * 1103515245) + 12345;
+		fileData[i] = ((i & 0x100) != 0)? (unsigned char)(i >> 9): (unsigned char)(value >> 16);
+	}
+	return fileData;
+}
+
+//----------------------------------------------------------------------------------------
+//Compresses each file into a new archive, and saves the archive to the target buffer.
+static void BuildTestArchive(Stream::Buffer& archiveBuffer, const std::vector<std::wstring>& fileNames, const std::vector<std::vector<unsigned char>>& fileData)
+{
+	ZIPArchive archive;
+	for(unsigned int i = 0; i < (unsigned int)fileNames.size(); ++i)
+	{
+		Stream::Buffer fileBuffer(0);
+		if(!fileData[i].empty())
+		{
+			REQUIRE(fileBuffer.WriteData(&fileData[i][0], (unsigned int)fileData[i].size()));
+		}
+		fileBuffer.SetStreamPos(0);
+		ZIPFileEntry fileEntry;
+		REQUIRE(fileEntry.Compress(fileBuffer));
+		fileEntry.SetFileName(fileNames[i]);
+		archive.AddFileEntry(fileEntry);
+	}
+	REQUIRE(archive.SaveToStream(archiveBuffer));
+}
+
+//----------------------------------------------------------------------------------------
+//Decompresses a file entry, and ensures the decompressed data matches the expected data.
+static void CheckFileEntryData(ZIPFileEntry* fileEntry, const std::vector<unsigned char>& expectedData)
+{
+	REQUIRE(fileEntry != 0);
+	Stream::Buffer decompressedBuffer(0);
+	REQUIRE(fileEntry->Decompress(decompressedBuffer));
+	REQUIRE(decompressedBuffer.Size() == (Stream::IStream::SizeType)expectedData.size());
+	REQUIRE((expectedData.empty() || (memcmp(decompressedBuffer.GetRawBuffer(), &expectedData[0], expectedData.size()) == 0)));
+}
+
+//----------------------------------------------------------------------------------------
+//Loads an archive from the source stream, starting at the current stream position, and
+//ensures each file can be located by name and decompressed. The files are decompressed
+//in reverse order, so that no entry relies on the entries before it having been read.
+static void CheckArchiveContents(Stream::IStream& source, const std::vector<std::wstring>& fileNames, const std::vector<std::vector<unsigned char>>& fileData)
+{
+	ZIPArchive archive;
+	REQUIRE(archive.LoadFromStream(source));
+	REQUIRE(archive.GetFileEntryCount() == (unsigned int)fileNames.size());
+	for(unsigned int i = (unsigned int)fileNames.size(); i > 0; --i)
+	{
+		CheckFileEntryData(archive.GetFileEntry(fileNames[i - 1]), fileData[i - 1]);
+	}
+	REQUIRE(archive.GetFileEntry(L"missing.bin") == 0);
+}
+
+//----------------------------------------------------------------------------------------
+static void WriteLittleEndian32(Stream::Buffer& buffer, Stream::IStream::SizeType position, unsigned int data)
+{
+	for(unsigned int i = 0; i < 4; ++i)
+	{
+		buffer[position + i] = (unsigned char)(data >> (i * 8));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Changes a local file header to the form used when a data descriptor follows the
+//compressed data. In this form the CRC and sizes in the local header are zero, and only
+//the central directory holds the real values. Since the compressed size is unknown, an
+//archive containing such an entry can't be loaded by walking the local headers in
+//sequence, so it can only be loaded through the central directory.
+static void SetLocalHeaderDataDescriptorFlag(Stream::Buffer& buffer, Stream::IStream::SizeType localHeaderPos)
+{
+	static const unsigned int localHeaderBitFlagsOffset = 6;
+	static const unsigned int localHeaderCRCOffset = 14;
+	static const unsigned int localHeaderCompressedSizeOffset = 18;
+	static const unsigned int localHeaderUncompressedSizeOffset = 22;
+	buffer[localHeaderPos + localHeaderBitFlagsOffset] |= (1 << 3);
+	WriteLittleEndian32(buffer, localHeaderPos + localHeaderCRCOffset, 0);
+	WriteLittleEndian32(buffer, localHeaderPos + localHeaderCompressedSizeOffset, 0);
+	WriteLittleEndian32(buffer, localHeaderPos + localHeaderUncompressedSizeOffset, 0);
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("ZIPArchive::LoadFromStream", "")
+{
+	//Build an archive with a small file, a file larger than the block size used to copy
+	//compressed data between streams, and an empty file.
+	std::vector<std::wstring> fileNames;
+	std::vector<std::vector<unsigned char>> fileData;
+	fileNames.push_back(L"first.bin");
+	fileData.push_back(BuildTestFileData(1, 100));
+	fileNames.push_back(L"second.bin");
+	fileData.push_back(BuildTestFileData(2, 0x30000));
+	fileNames.push_back(L"empty.bin");
+	fileData.push_back(std::vector<unsigned char>());
+	Stream::Buffer archiveBuffer(0);
+	BuildTestArchive(archiveBuffer, fileNames, fileData);
+
+	SECTION("Central directory", "")
+	{
+		archiveBuffer.SetStreamPos(0);
+		CheckArchiveContents(archiveBuffer, fileNames, fileData);
+	}
+
+	SECTION("Archive preceded by other data", "")
+	{
+		//Offsets in the central directory are relative to the start of the archive, not
+		//the start of the stream. We flag the first entry as using a data descriptor, so
+		//that a wrong offset can't be hidden by falling back to a sequential load.
+		static const unsigned int prefixSize = 37;
+		Stream::Buffer prefixedBuffer(0);
+		std::vector<unsigned char> prefixData = BuildTestFileData(3, prefixSize);
+		REQUIRE(prefixedBuffer.WriteData(&prefixData[0], prefixSize));
+		REQUIRE(prefixedBuffer.WriteData(archiveBuffer.GetRawBuffer(), archiveBuffer.Size()));
+		SetLocalHeaderDataDescriptorFlag(prefixedBuffer, prefixSize);
+		prefixedBuffer.SetStreamPos(prefixSize);
+		CheckArchiveContents(prefixedBuffer, fileNames, fileData);
+	}
+
+	SECTION("Archive comment containing a record signature", "")
+	{
+		//Append a comment to the end of central directory record, which itself contains
+		//an end of central directory signature. The search for the record must skip the
+		//signature in the comment, since the comment length it implies doesn't reach the
+		//end of the stream.
+		static const unsigned char commentData[] = {'c', 'o', 'm', 'm', 'e', 'n', 't', 'P', 'K', 0x05, 0x06, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 'e', 'n', 'd'};
+		Stream::IStream::SizeType commentLengthPos = archiveBuffer.Size() - 2;
+		archiveBuffer[commentLengthPos] = (unsigned char)sizeof(commentData);
+		archiveBuffer[commentLengthPos + 1] = 0;
+		archiveBuffer.SetStreamPos(archiveBuffer.Size());
+		REQUIRE(archiveBuffer.WriteData(&commentData[0], (unsigned int)sizeof(commentData)));
+		archiveBuffer.SetStreamPos(0);
+		CheckArchiveContents(archiveBuffer, fileNames, fileData);
+	}
+
+	SECTION("Entry written with a data descriptor", "")
+	{
+		//The sizes and CRC for the first entry, which is at the start of the archive,
+		//must be taken from the central directory.
+		SetLocalHeaderDataDescriptorFlag(archiveBuffer, 0);
+		archiveBuffer.SetStreamPos(0);
+		CheckArchiveContents(archiveBuffer, fileNames, fileData);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("ZIPFileEntry::SaveToStream", "")
+{
+	std::vector<std::wstring> fileNames;
+	std::vector<std::vector<unsigned char>> fileData;
+	fileNames.push_back(L"first.bin");
+	fileData.push_back(BuildTestFileData(4, 0x28000));
+	fileNames.push_back(L"second.bin");
+	fileData.push_back(BuildTestFileData(5, 1000));
+	Stream::Buffer archiveBuffer(0);
+	BuildTestArchive(archiveBuffer, fileNames, fileData);
+	archiveBuffer.SetStreamPos(0);
+	ZIPArchive archive;
+	REQUIRE(archive.LoadFromStream(archiveBuffer));
+
+	SECTION("Entry loaded from central directory", "")
+	{
+		//An entry loaded from the central directory copies its compressed data from the
+		//source stream. Save the entry, then load it back through the local file header
+		//alone, and ensure the data is intact.
+		ZIPFileEntry* fileEntry = archive.GetFileEntry(L"first.bin");
+		REQUIRE(fileEntry != 0);
+		Stream::Buffer entryBuffer(0);
+		REQUIRE(fileEntry->SaveToStream(entryBuffer));
+		entryBuffer.SetStreamPos(0);
+		ZIPFileEntry savedFileEntry;
+		REQUIRE(savedFileEntry.LoadFromStream(entryBuffer));
+		REQUIRE(savedFileEntry.GetFileName() == L"first.bin");
+		CheckFileEntryData(&savedFileEntry, fileData[0]);
+	}
+
+	SECTION("Entry data replaced after loading", "")
+	{
+		//Once new data has been compressed into an entry loaded from the central
+		//directory, the entry must use the new data rather than the data in the source
+		//stream.
+		ZIPFileEntry* fileEntry = archive.GetFileEntry(L"second.bin");
+		REQUIRE(fileEntry != 0);
+		std::vector<unsigned char> replacementData = BuildTestFileData(6, 5000);
+		Stream::Buffer replacementBuffer(0);
+		REQUIRE(replacementBuffer.WriteData(&replacementData[0], (unsigned int)replacementData.size()));
+		replacementBuffer.SetStreamPos(0);
+		REQUIRE(fileEntry->Compress(replacementBuffer));
+		CheckFileEntryData(fileEntry, replacementData);
+
+		Stream::Buffer entryBuffer(0);
+		REQUIRE(fileEntry->SaveToStream(entryBuffer));
+		entryBuffer.SetStreamPos(0);
+		ZIPFileEntry savedFileEntry;
+		REQUIRE(savedFileEntry.LoadFromStream(entryBuffer));
+		CheckFileEntryData(&savedFileEntry, replacementData);
+	}
+}
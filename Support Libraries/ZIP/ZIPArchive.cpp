@@ -1,4 +1,5 @@
 #include "ZIPArchive.h"
+#include <vector>
 
 //----------------------------------------------------------------------------------------
 //Constructors
@@ -11,6 +12,129 @@ ZIPArchive::ZIPArchive(CompressionMethod acompressionmMethod)
 //Serialization functions
 //----------------------------------------------------------------------------------------
 bool ZIPArchive::LoadFromStream(Stream::IStream& source)
+{
+	//Attempt to load the archive from its central directory. In this case, only the
+	//central directory is read from the stream, and the data for each file entry is read
+	//from the source stream on demand when the entry is decompressed. Note that the
+	//source stream must remain valid for the lifetime of this object in this case.
+	Stream::IStream::SizeType archiveStartPos = source.GetStreamPos();
+	if(LoadFromCentralDirectory(source, archiveStartPos))
+	{
+		return true;
+	}
+
+	//If we couldn't load the archive from the central directory, fall back to loading
+	//each chunk in the file sequentially.
+	fileList.clear();
+	centralDirectory.clear();
+	endOfCentralDirectoryHeader.Initialize();
+	source.SetStreamPos(archiveStartPos);
+	return LoadSequentially(source);
+}
+
+//----------------------------------------------------------------------------------------
+bool ZIPArchive::LoadFromCentralDirectory(Stream::IStream& source, Stream::IStream::SizeType archiveStartPos)
+{
+	//Locate and load the end of central directory record
+	Stream::IStream::SizeType endOfCentralDirectoryPos;
+	if(!FindEndOfCentralDirectory(source, archiveStartPos, endOfCentralDirectoryPos))
+	{
+		return false;
+	}
+	source.SetStreamPos(endOfCentralDirectoryPos);
+	if(!endOfCentralDirectoryHeader.LoadFromStream(source))
+	{
+		return false;
+	}
+
+	//Ensure the central directory lies within the stream, and precedes the end of
+	//central directory record.
+	Stream::IStream::SizeType centralDirectoryPos = archiveStartPos + endOfCentralDirectoryHeader.centralDirectoryOffset;
+	if((centralDirectoryPos + endOfCentralDirectoryHeader.centralDirectorySize) > endOfCentralDirectoryPos)
+	{
+		return false;
+	}
+
+	//Read the entire central directory into memory in a single operation, rather than
+	//performing a separate read from the source stream for each field.
+	Stream::Buffer centralDirectoryBuffer(endOfCentralDirectoryHeader.centralDirectorySize);
+	source.SetStreamPos(centralDirectoryPos);
+	if((endOfCentralDirectoryHeader.centralDirectorySize > 0) && !source.ReadData(centralDirectoryBuffer.GetRawBuffer(), endOfCentralDirectoryHeader.centralDirectorySize))
+	{
+		return false;
+	}
+
+	//Load each central directory entry, and build a file entry which references the
+	//compressed data for the entry in the source stream.
+	for(unsigned int i = 0; i < endOfCentralDirectoryHeader.centralDirectoryEntries; ++i)
+	{
+		ZIPChunk_CentralFileHeader header;
+		if(!header.LoadFromStream(centralDirectoryBuffer))
+		{
+			return false;
+		}
+		ZIPFileEntry fileEntry;
+		if(!fileEntry.LoadFromCentralDirectory(source, archiveStartPos, header))
+		{
+			return false;
+		}
+		centralDirectory.push_back(header);
+		fileList.push_back(fileEntry);
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool ZIPArchive::FindEndOfCentralDirectory(Stream::IStream& source, Stream::IStream::SizeType archiveStartPos, Stream::IStream::SizeType& endOfCentralDirectoryPos) const
+{
+	//The end of central directory record is located at the end of the archive, followed
+	//only by a variable length comment of up to 65535 bytes. Calculate the region at the
+	//end of the stream which could contain the record.
+	static const unsigned int endOfCentralDirectoryMinimumSize = 22;
+	static const unsigned int endOfCentralDirectoryMaximumCommentSize = 0xFFFF;
+	Stream::IStream::SizeType streamSize = source.Size();
+	if((streamSize - archiveStartPos) < endOfCentralDirectoryMinimumSize)
+	{
+		return false;
+	}
+	Stream::IStream::SizeType searchRegionSize = streamSize - archiveStartPos;
+	if(searchRegionSize > (endOfCentralDirectoryMinimumSize + endOfCentralDirectoryMaximumCommentSize))
+	{
+		searchRegionSize = (endOfCentralDirectoryMinimumSize + endOfCentralDirectoryMaximumCommentSize);
+	}
+
+	//Read the search region into memory
+	std::vector<unsigned char> searchRegion((size_t)searchRegionSize);
+	Stream::IStream::SizeType searchRegionPos = streamSize - searchRegionSize;
+	source.SetStreamPos(searchRegionPos);
+	if(!source.ReadData(&searchRegion[0], (Stream::IStream::SizeType)searchRegion.size()))
+	{
+		return false;
+	}
+
+	//Search backwards from the end of the stream for the record signature. We only
+	//accept a signature where the comment length in the record extends exactly to the
+	//end of the stream, to avoid matching a signature sequence within the comment data.
+	for(unsigned int i = (unsigned int)searchRegion.size() - endOfCentralDirectoryMinimumSize + 1; i > 0; --i)
+	{
+		unsigned int recordOffset = i - 1;
+		const unsigned char* record = &searchRegion[recordOffset];
+		unsigned int signature = (unsigned int)record[0] | ((unsigned int)record[1] << 8) | ((unsigned int)record[2] << 16) | ((unsigned int)record[3] << 24);
+		if(signature == ZIPChunk_EndOfCentralDirectory::validSignature)
+		{
+			unsigned int commentLength = (unsigned int)record[20] | ((unsigned int)record[21] << 8);
+			if((recordOffset + endOfCentralDirectoryMinimumSize + commentLength) == (unsigned int)searchRegion.size())
+			{
+				endOfCentralDirectoryPos = searchRegionPos + recordOffset;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------------------------------
+bool ZIPArchive::LoadSequentially(Stream::IStream& source)
 {
 	//Parse the ZIP file, and extract all data chunks
 	bool done = false;
@@ -75,6 +75,12 @@ public:
 	ZIPFileEntry* GetFileEntry(unsigned int fileNumber);
 	ZIPFileEntry* GetFileEntry(const std::wstring& fileName);
 
+private:
+	//Serialization functions
+	bool LoadFromCentralDirectory(Stream::IStream& source, Stream::IStream::SizeType archiveStartPos);
+	bool LoadSequentially(Stream::IStream& source);
+	bool FindEndOfCentralDirectory(Stream::IStream& source, Stream::IStream::SizeType archiveStartPos, Stream::IStream::SizeType& endOfCentralDirectoryPos) const;
+
 private:
 	std::list<ZIPFileEntry> fileList;
 	std::list<ZIPChunk_CentralFileHeader> centralDirectory;
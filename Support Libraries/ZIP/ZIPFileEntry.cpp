@@ -6,7 +6,7 @@
 //Constructors
 //----------------------------------------------------------------------------------------
 ZIPFileEntry::ZIPFileEntry()
-:compressedDataWritten(false), data(0)
+:compressedDataWritten(false), data(0), sourceStream(0), sourceLocalHeaderPos(0)
 {}
 
 //----------------------------------------------------------------------------------------
@@ -18,7 +18,11 @@ ZIPFileEntry::ZIPFileEntry()
 //----------------------------------------------------------------------------------------
 bool ZIPFileEntry::LoadFromStream(Stream::IStream& source)
 {
-	//Load the local file header and compressed file data from the stream
+	//Load the local file header and compressed file data from the stream. Since our
+	//data buffer is replaced here, any previous association with a source stream is
+	//discarded.
+	sourceStream = 0;
+	sourceLocalHeaderPos = 0;
 	localFileHeader.LoadFromStream(source);
 	data.Resize(localFileHeader.compressedSize);
 	if(!source.ReadData(data.GetRawBuffer(), localFileHeader.compressedSize))
@@ -32,6 +36,42 @@ bool ZIPFileEntry::LoadFromStream(Stream::IStream& source)
 	return true;
 }
 
+//----------------------------------------------------------------------------------------
+bool ZIPFileEntry::LoadFromCentralDirectory(Stream::IStream& source, Stream::IStream::SizeType archiveStartPos, const ZIPChunk_CentralFileHeader& centralFileHeader)
+{
+	//Build our local file header from the central directory entry. Note that we take
+	//the compressed size and CRC from the central directory rather than the local header,
+	//since the local header values aren't valid if a data descriptor has been used.
+	localFileHeader.Initialize();
+	localFileHeader.versionToExtract = centralFileHeader.versionNeededToExtract;
+	localFileHeader.bitFlags = centralFileHeader.bitFlags;
+	localFileHeader.compressionMethod = centralFileHeader.compressionMethod;
+	localFileHeader.modFileTime = centralFileHeader.lastModFileTime;
+	localFileHeader.modFileDate = centralFileHeader.lastModFileDate;
+	localFileHeader.crc32 = centralFileHeader.crc32;
+	localFileHeader.compressedSize = centralFileHeader.compressedSize;
+	localFileHeader.uncompressedSize = centralFileHeader.uncompressedSize;
+	localFileHeader.fileName = centralFileHeader.fileName;
+	localFileHeader.extraField = centralFileHeader.extraField;
+
+	//Record the location of the local header for this entry in the source stream. The
+	//compressed data will be read from the source stream when it's required.
+	data.Resize(0);
+	sourceStream = &source;
+	sourceLocalHeaderPos = archiveStartPos + centralFileHeader.relativeOffsetOfLocalHeader;
+	if(sourceLocalHeaderPos >= source.Size())
+	{
+		sourceStream = 0;
+		sourceLocalHeaderPos = 0;
+		return false;
+	}
+
+	//Flag that the object has been populated with a compressed data stream
+	compressedDataWritten = true;
+
+	return true;
+}
+
 //----------------------------------------------------------------------------------------
 bool ZIPFileEntry::SaveToStream(Stream::IStream& target) const
 {
@@ -41,9 +81,53 @@ bool ZIPFileEntry::SaveToStream(Stream::IStream& target) const
 		return false;
 	}
 
-	//Save the local file header and compressed file data to the stream
-	localFileHeader.SaveToStream(target);
-	return target.WriteData(data.GetRawBuffer(), data.Size());
+	//Save the local file header to the stream. Note that since we save the correct
+	//sizes and CRC in the local header, we clear any data descriptor flag which was set
+	//when this entry was loaded.
+	ZIPChunk_LocalFileHeader targetLocalFileHeader = localFileHeader;
+	targetLocalFileHeader.bitFlags &= ~(1 << 3);
+	if(!targetLocalFileHeader.SaveToStream(target))
+	{
+		return false;
+	}
+
+	//If our compressed data is held in memory, write it to the target stream.
+	if(sourceStream == 0)
+	{
+		return target.WriteData(data.GetRawBuffer(), data.Size());
+	}
+
+	//Copy our compressed data from the source stream to the target stream in blocks
+	if(!SeekToSourceData())
+	{
+		return false;
+	}
+	static const unsigned int copyBufferSize = 0x10000;
+	std::vector<unsigned char> copyBuffer((localFileHeader.compressedSize < copyBufferSize)? localFileHeader.compressedSize: copyBufferSize);
+	unsigned int bytesRemaining = localFileHeader.compressedSize;
+	while(bytesRemaining > 0)
+	{
+		unsigned int blockSize = (bytesRemaining < (unsigned int)copyBuffer.size())? bytesRemaining: (unsigned int)copyBuffer.size();
+		if(!sourceStream->ReadData(&copyBuffer[0], blockSize) || !target.WriteData(&copyBuffer[0], blockSize))
+		{
+			return false;
+		}
+		bytesRemaining -= blockSize;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+//Source stream functions
+//----------------------------------------------------------------------------------------
+bool ZIPFileEntry::SeekToSourceData() const
+{
+	//Read the local header for this entry from the source stream, to skip over the
+	//variable length file name and extra field data which precede the compressed data.
+	//Note that these fields may differ in length from the central directory entry.
+	ZIPChunk_LocalFileHeader sourceLocalFileHeader;
+	sourceStream->SetStreamPos(sourceLocalHeaderPos);
+	return sourceLocalFileHeader.LoadFromStream(*sourceStream);
 }
 
 //----------------------------------------------------------------------------------------
@@ -60,8 +144,12 @@ bool ZIPFileEntry::Compress(Stream::IStream& source, unsigned int inputCacheSize
 	}
 
 	//Clean our data buffer. The buffer will automatically grow to a size large enough to
-	//hold the compressed data.
+	//hold the compressed data. Since the compressed data is now held in our buffer, we
+	//also discard any previous association with a source stream, otherwise the stale
+	//source data would be saved or decompressed in place of the new data.
 	data.Resize(0);
+	sourceStream = 0;
+	sourceLocalHeaderPos = 0;
 
 	//Attempt to compress the file to our buffer using deflate compression
 	unsigned int calculatedCRC;
@@ -105,11 +193,34 @@ bool ZIPFileEntry::Decompress(Stream::IStream& target, unsigned int outputCacheS
 		return false;
 	}
 
-	//Attempt to decompress the file from our buffer using deflate compression
+	//If no output cache size was specified, limit the output cache to the size of the
+	//uncompressed data, so that we don't allocate a full size cache for small files.
+	if((outputCacheSize <= 0) && (localFileHeader.uncompressedSize > 0) && (localFileHeader.uncompressedSize < (1024*1024)))
+	{
+		outputCacheSize = localFileHeader.uncompressedSize;
+	}
+
+	//Attempt to decompress the file using deflate compression. If our compressed data
+	//is held in the source stream, we decompress it directly from the source stream.
 	unsigned int calculatedCRC;
-	if(!Deflate::DeflateDecompress(data, target, calculatedCRC, (unsigned int)data.Size(), outputCacheSize))
+	if(sourceStream == 0)
 	{
-		return false;
+		data.SetStreamPos(0);
+		if(!Deflate::DeflateDecompress(data, target, calculatedCRC, (unsigned int)data.Size(), outputCacheSize))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		if(!SeekToSourceData())
+		{
+			return false;
+		}
+		if(!Deflate::DeflateDecompress(*sourceStream, localFileHeader.compressedSize, target, calculatedCRC, 0, outputCacheSize))
+		{
+			return false;
+		}
 	}
 
 	//If the CRC of the decompressed data doesn't match the CRC reported in the header,
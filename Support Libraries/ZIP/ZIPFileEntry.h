@@ -13,6 +13,7 @@ public:
 
 	//Serialization functions
 	bool LoadFromStream(Stream::IStream& source);
+	bool LoadFromCentralDirectory(Stream::IStream& source, Stream::IStream::SizeType archiveStartPos, const ZIPChunk_CentralFileHeader& centralFileHeader);
 	bool SaveToStream(Stream::IStream& target) const;
 
 	//Data compression functions
@@ -36,10 +37,21 @@ public:
 	//File header functions
 	ZIPChunk_CentralFileHeader GetCentralDirectoryFileHeader() const;
 
+private:
+	//Source stream functions
+	bool SeekToSourceData() const;
+
 private:
 	bool compressedDataWritten;
 	Stream::Buffer data;
 	ZIPChunk_LocalFileHeader localFileHeader;
+
+	//If this entry was loaded from a central directory, the compressed data isn't loaded
+	//into our data buffer, but is instead read directly from the source stream when it's
+	//required. The source stream must remain valid for the lifetime of this object in
+	//this case.
+	Stream::IStream* sourceStream;
+	Stream::IStream::SizeType sourceLocalHeaderPos;
 };
 
 #endif
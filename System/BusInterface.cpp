@@ -8,7 +8,7 @@
 //Constructors
 //----------------------------------------------------------------------------------------
 BusInterface::BusInterface()
-:memoryInterfaceDefined(false), portInterfaceDefined(false), nextCELineID(1)
+:memoryInterfaceDefined(false), memoryMappingChangeCount(0), ceLineStateChangeCount(0), portInterfaceDefined(false), nextCELineID(1)
 {}
 
 //----------------------------------------------------------------------------------------
@@ -680,6 +680,7 @@ bool BusInterface::MapDevice(MapEntry* mapEntry)
 
 	//Add the new entry to the memory map
 	memoryMap.push_back(mapEntry);
+	++memoryMappingChangeCount;
 
 	//If a physical memory map is being used, add the map entry to the array.
 	if(usePhysicalMemoryMap)
@@ -713,6 +714,10 @@ void BusInterface::UnmapMemoryForDevice(IDevice* device)
 //----------------------------------------------------------------------------------------
 void BusInterface::UnmapDevice(MapEntry* mapEntry)
 {
+	//Flag that the memory map has changed, so that any resolved memory targets which
+	//refer to this entry are discarded.
+	++memoryMappingChangeCount;
+
 	//If a physical memory map is being used, remove the map entry from the array.
 	if(usePhysicalMemoryMap)
 	{
@@ -1680,6 +1685,10 @@ bool BusInterface::BindCELineMappings()
 	bool result = true;
 	result &= BindCELineMappings(true);
 	result &= BindCELineMappings(false);
+
+	//Since CE line state affects how addresses are resolved, flag that the memory map
+	//has changed.
+	++memoryMappingChangeCount;
 	return result;
 }
 
@@ -2234,6 +2243,7 @@ void BusInterface::UnmapCELinesForDevice(IDevice* device)
 	{
 		ceLineDeviceMappingsMemory.erase(ceLineDeviceMappingsMemory.begin() + *i);
 	}
+	++memoryMappingChangeCount;
 
 	//Delete port CE lines defined by this device
 	std::list<unsigned int> portMappingsToDelete;
@@ -2588,6 +2598,85 @@ void BusInterface::TransparentWriteMemory(unsigned int location, const Data& dat
 	}
 }
 
+//----------------------------------------------------------------------------------------
+//Memory target resolution functions
+//----------------------------------------------------------------------------------------
+bool BusInterface::ResolveMemoryTarget(unsigned int location, unsigned int windowSize, IDeviceContext* caller, MemoryTarget& target) const
+{
+	//Ensure the requested window is valid, and doesn't wrap around the end of the
+	//address space.
+	location &= addressBusMask;
+	if((windowSize == 0) || (((windowSize - 1) & ~addressBusMask) != 0) || (((location + (windowSize - 1)) & ~addressBusMask) != 0))
+	{
+		return false;
+	}
+	unsigned int lastLocation = location + (windowSize - 1);
+
+	//Latch the current mapping and CE line state change counts before we resolve the
+	//window, so that if the memory map or CE line generation state is modified while
+	//we're working, the resolved target will be discarded by the caller.
+	unsigned int mappingChangeCountAtResolve = memoryMappingChangeCount;
+	unsigned int ceLineStateChangeCountAtResolve = ceLineStateChangeCount;
+
+	//Calculate the CE line state for the window. It's the responsibility of the caller
+	//to only request windows where the CE line state is known to be constant across the
+	//entire window, but we check both ends of the window here as a safeguard.
+	Data data(dataBusWidth);
+	unsigned int ce = CalculateCELineStateMemoryTransparent(location, data, caller, 0);
+	if(CalculateCELineStateMemoryTransparent(lastLocation, data, caller, 0) != ce)
+	{
+		return false;
+	}
+
+	//Resolve the mapping for the start of the window. We only resolve plain mappings
+	//here, since remapped address or data lines require conversion on each access.
+	MapEntry* mapEntry = ResolveMemoryAddress(ce, location);
+	if((mapEntry == 0) || mapEntry->remapAddressLines || mapEntry->remapDataLines)
+	{
+		return false;
+	}
+
+	//Ensure every address within the window resolves to the same mapping
+	for(unsigned int i = location + 1; (i <= lastLocation) && (i > location); ++i)
+	{
+		if(ResolveMemoryAddress(ce, i) != mapEntry)
+		{
+			return false;
+		}
+	}
+
+	//Return the resolved target to the caller
+	target.device = mapEntry->device;
+	target.interfaceNumber = mapEntry->interfaceNumber;
+	target.address = mapEntry->address;
+	target.addressMask = mapEntry->addressMask;
+	target.addressDiscardLowerBitCount = mapEntry->addressDiscardLowerBitCount;
+	target.interfaceOffset = mapEntry->interfaceOffset;
+	target.mappingChangeCount = mappingChangeCountAtResolve;
+	target.ceLineStateChangeCount = ceLineStateChangeCountAtResolve;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int BusInterface::GetMemoryMappingChangeCount() const
+{
+	return memoryMappingChangeCount;
+}
+
+//----------------------------------------------------------------------------------------
+//CE line state change functions
+//----------------------------------------------------------------------------------------
+unsigned int BusInterface::GetCELineStateChangeCount() const
+{
+	return ceLineStateChangeCount;
+}
+
+//----------------------------------------------------------------------------------------
+void BusInterface::NotifyCELineStateChanged()
+{
+	++ceLineStateChangeCount;
+}
+
 //----------------------------------------------------------------------------------------
 //Port interface functions
 //----------------------------------------------------------------------------------------
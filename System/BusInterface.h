@@ -47,6 +47,7 @@ frequently.
 #include <vector>
 #include <list>
 #include <map>
+#include <atomic>
 #include "HierarchicalStorageInterface/HierarchicalStorageInterface.pkg"
 #include "ThinContainers/ThinContainers.pkg"
 #include "DeviceInterface/DeviceInterface.pkg"
@@ -110,6 +111,14 @@ public:
 	virtual void TransparentReadMemory(unsigned int location, Data& data, IDeviceContext* caller, unsigned int accessContext, void* calculateCELineStateContext = 0) const;
 	virtual void TransparentWriteMemory(unsigned int location, const Data& data, IDeviceContext* caller, unsigned int accessContext, void* calculateCELineStateContext = 0) const;
 
+	//Memory target resolution functions
+	virtual bool ResolveMemoryTarget(unsigned int location, unsigned int windowSize, IDeviceContext* caller, MemoryTarget& target) const;
+	virtual unsigned int GetMemoryMappingChangeCount() const;
+
+	//CE line state change functions
+	virtual unsigned int GetCELineStateChangeCount() const;
+	virtual void NotifyCELineStateChanged();
+
 	//Port interface functions
 	virtual AccessResult ReadPort(unsigned int location, Data& data, IDeviceContext* caller, double accessTime, unsigned int accessContext, void* calculateCELineStateContext = 0);
 	virtual AccessResult WritePort(unsigned int location, const Data& data, IDeviceContext* caller, double accessTime, unsigned int accessContext, void* calculateCELineStateContext = 0);
@@ -203,6 +212,8 @@ private:
 	unsigned int addressBusWidth;
 	unsigned int dataBusWidth;
 	unsigned int addressBusMask;
+	volatile unsigned int memoryMappingChangeCount;
+	std::atomic<unsigned int> ceLineStateChangeCount;
 
 	//Port map
 	bool portInterfaceDefined;
@@ -1,12 +1,14 @@
 #include "DataRemapTable.h"
 #include "DataConversion/DataConversion.pkg"
 #include <list>
+#include <intrin.h>
+#include <immintrin.h>
 
 //----------------------------------------------------------------------------------------
 //Constructors
 //----------------------------------------------------------------------------------------
 DataRemapTable::DataRemapTable()
-:conversionTableStateSetManually(false)
+:conversionTableStateSetManually(false), useMethodBitExtract(false), useMethodSplitTableTo(false), useMethodSplitTableFrom(false)
 {
 	//Set the default maximum bit counts for our conversion tables to 20 bits, which gives
 	//us a maximum table size of 1 MegaByte.
@@ -145,12 +147,16 @@ bool DataRemapTable::SetDataMapping(const std::wstring& mappingString, unsigned
 	discardBottomBitCount = 0;
 	discardTopBitCount = 0;
 	forcedSetBitMaskInConverted = 0;
+	useMethodSplitTableTo = false;
+	useMethodSplitTableFrom = false;
 
 	//Process our mapping elements, and build our mapping settings.
 	unsigned int highestSourceBitNumberUsed = 0;
 	unsigned int lowestSourceBitNumberUsed = sourceBitCount;
 	bool allSourceBitsInRelativeOrder = true;
+	bool allSourceBitsInIncreasingOrder = true;
 	bool foundFirstSourceMapping = false;
+	unsigned int lastSourceBitNumber = 0;
 	int firstSourceMappingDisplacement;
 	for(std::list<MappingElement>::const_reverse_iterator i = mappingElements.rbegin(); i != mappingElements.rend(); ++i)
 	{
@@ -200,7 +206,16 @@ bool DataRemapTable::SetDataMapping(const std::wstring& mappingString, unsigned
 				{
 					allSourceBitsInRelativeOrder = false;
 				}
+
+				//If this source bit isn't above the last source bit we mapped, the order
+				//of the source bits isn't preserved in the converted data, even allowing
+				//for gaps between the bits.
+				if(i->sourceDataBitNumber <= lastSourceBitNumber)
+				{
+					allSourceBitsInIncreasingOrder = false;
+				}
 			}
+			lastSourceBitNumber = i->sourceDataBitNumber;
 
 			//Build our bit mapping entry
 			BitMapping bitMappingEntry;
@@ -237,17 +252,27 @@ bool DataRemapTable::SetDataMapping(const std::wstring& mappingString, unsigned
 	//that we can use the shift and mask method to perform the conversion.
 	useMethodShiftAndMask = allSourceBitsInRelativeOrder;
 
+	//If the source bits appear in increasing order in the converted data, but with
+	//varying gaps between them, the conversion is a pure bit gather and scatter
+	//operation. We can perform this directly with the BMI2 pext and pdep instructions if
+	//they're supported by the host.
+	useMethodBitExtract = !useMethodShiftAndMask && allSourceBitsInIncreasingOrder && IsBitExtractInstructionSupported();
+
 	//Determine whether to use physical conversion tables
 	if(!conversionTableStateSetManually)
 	{
-		//Only build conversion tables if we can't use the shift and mask method. The
-		//shift and mask method is so efficient, the table method is almost certainly
-		//going to be slower due to the latency involved in memory access, and the high
-		//likelihood of a cache miss with a conversion table.
-		if(!useMethodShiftAndMask)
+		//Only build conversion tables if we can't use the shift and mask or bit extract
+		//methods. These methods are so efficient, the table method is almost certainly
+		//going to be slower due to the latency involved in memory access. We also limit
+		//full conversion tables to a single byte of input here. Above that size, the
+		//split tables built below, which only occupy a few kilobytes in total, are far
+		//less likely to cause a cache miss than a full conversion table.
+		if(!useMethodShiftAndMask && !useMethodBitExtract)
 		{
-			useMethodConversionTableTo = ((bitCountOriginal - (discardBottomBitCount + discardTopBitCount)) <= conversionTableToMaxBitCount);
-			useMethodConversionTableFrom = ((bitCountConverted - (insertBottomBitCount + insertTopBitCount)) <= conversionTableFromMaxBitCount);
+			unsigned int conversionTableToBitCount = (conversionTableToMaxBitCount < splitTableBitCount)? conversionTableToMaxBitCount: splitTableBitCount;
+			unsigned int conversionTableFromBitCount = (conversionTableFromMaxBitCount < splitTableBitCount)? conversionTableFromMaxBitCount: splitTableBitCount;
+			useMethodConversionTableTo = ((bitCountOriginal - (discardBottomBitCount + discardTopBitCount)) <= conversionTableToBitCount);
+			useMethodConversionTableFrom = ((bitCountConverted - (insertBottomBitCount + insertTopBitCount)) <= conversionTableFromBitCount);
 		}
 		else
 		{
@@ -284,9 +309,94 @@ bool DataRemapTable::SetDataMapping(const std::wstring& mappingString, unsigned
 		useMethodConversionTableFrom = true;
 	}
 
+	//Build split conversion tables for any conversion direction which isn't covered by
+	//one of the methods above
+	BuildSplitTables();
+
 	return true;
 }
 
+//----------------------------------------------------------------------------------------
+//Conversion table functions
+//----------------------------------------------------------------------------------------
+void DataRemapTable::BuildSplitTables()
+{
+	//Split tables are used for arbitrary bit permutations which are too large for a full
+	//conversion table. We split the input data into bytes, and store the converted
+	//contribution of each possible byte value at each byte position in the input. A
+	//conversion is then performed by combining the result of one lookup per byte.
+	bool useManualBitMapping = !useMethodShiftAndMask && !useMethodBitExtract;
+	useMethodSplitTableTo = useManualBitMapping && !useMethodConversionTableTo;
+	useMethodSplitTableFrom = useManualBitMapping && !useMethodConversionTableFrom;
+
+	//Build the split table for conversions to the new mapping
+	if(useMethodSplitTableTo)
+	{
+		splitTableTo.assign(splitTableCount * splitTableEntryCount, 0);
+		for(unsigned int tableNo = 0; tableNo < splitTableCount; ++tableNo)
+		{
+			for(unsigned int entryNo = 0; entryNo < splitTableEntryCount; ++entryNo)
+			{
+				unsigned int sourceData = entryNo << (tableNo * splitTableBitCount);
+				unsigned int result = 0;
+				for(unsigned int i = 0; i < dataBitMappingsSize; ++i)
+				{
+					result |= ((sourceData & dataBitMappings[i].bitMaskOriginal) != 0)? dataBitMappings[i].bitMaskConverted: 0;
+				}
+				splitTableTo[(tableNo * splitTableEntryCount) + entryNo] = result;
+			}
+		}
+	}
+
+	//Build the split table for conversions from the new mapping
+	if(useMethodSplitTableFrom)
+	{
+		splitTableFrom.assign(splitTableCount * splitTableEntryCount, 0);
+		for(unsigned int tableNo = 0; tableNo < splitTableCount; ++tableNo)
+		{
+			for(unsigned int entryNo = 0; entryNo < splitTableEntryCount; ++entryNo)
+			{
+				unsigned int sourceData = entryNo << (tableNo * splitTableBitCount);
+				unsigned int result = 0;
+				for(unsigned int i = 0; i < dataBitMappingsSize; ++i)
+				{
+					result |= ((sourceData & dataBitMappings[i].bitMaskConverted) != 0)? dataBitMappings[i].bitMaskOriginal: 0;
+				}
+				splitTableFrom[(tableNo * splitTableEntryCount) + entryNo] = result;
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+bool DataRemapTable::IsBitExtractInstructionSupported()
+{
+	//Processor features can't change while we're running, so we only query them once.
+	//Note that under VS2013, initialization of function-local statics isn't guaranteed to
+	//be thread safe. If two threads race on the first call here, one of them may observe
+	//a value of false before the query completes. This is harmless, as it only causes that
+	//table to fall back to one of the other conversion methods, which give the same result.
+	static const bool bitExtractInstructionSupported = QueryBitExtractInstructionSupport();
+	return bitExtractInstructionSupported;
+}
+
+//----------------------------------------------------------------------------------------
+bool DataRemapTable::QueryBitExtractInstructionSupport()
+{
+	//Query the extended feature flags of the processor to determine if the BMI2
+	//instruction set is supported. BMI2 support is reported in bit 8 of EBX for leaf 7.
+	static const unsigned int cpuidLeafExtendedFeatures = 7;
+	static const unsigned int cpuidBMI2BitMask = 1 << 8;
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	if((unsigned int)cpuInfo[0] < cpuidLeafExtendedFeatures)
+	{
+		return false;
+	}
+	__cpuidex(cpuInfo, cpuidLeafExtendedFeatures, 0);
+	return ((unsigned int)cpuInfo[1] & cpuidBMI2BitMask) != 0;
+}
+
 //----------------------------------------------------------------------------------------
 //Data conversion functions
 //----------------------------------------------------------------------------------------
@@ -294,13 +404,27 @@ unsigned int DataRemapTable::ConvertTo(unsigned int sourceData) const
 {
 	unsigned int result = 0;
 
-	if(useMethodConversionTableTo)
+	if(useMethodShiftAndMask && !useMethodConversionTableTo)
+	{
+		result = ((sourceData & bitMaskOriginal) >> discardBottomBitCount) << insertBottomBitCount;
+		result |= forcedSetBitMaskInConverted;
+	}
+	else if(useMethodConversionTableTo)
 	{
 		result = conversionTableTo[(sourceData & bitMaskOriginal) >> discardBottomBitCount];
 	}
-	else if(useMethodShiftAndMask)
+	else if(useMethodBitExtract)
 	{
-		result = ((sourceData & bitMaskOriginal) >> discardBottomBitCount) << insertBottomBitCount;
+		result = _pdep_u32(_pext_u32(sourceData, bitMaskOriginal), bitMaskConverted);
+		result |= forcedSetBitMaskInConverted;
+	}
+	else if(useMethodSplitTableTo)
+	{
+		const unsigned int* splitTable = &splitTableTo[0];
+		result = splitTable[sourceData & (splitTableEntryCount - 1)];
+		result |= splitTable[splitTableEntryCount + ((sourceData >> splitTableBitCount) & (splitTableEntryCount - 1))];
+		result |= splitTable[(2 * splitTableEntryCount) + ((sourceData >> (2 * splitTableBitCount)) & (splitTableEntryCount - 1))];
+		result |= splitTable[(3 * splitTableEntryCount) + ((sourceData >> (3 * splitTableBitCount)) & (splitTableEntryCount - 1))];
 		result |= forcedSetBitMaskInConverted;
 	}
 	else
@@ -320,13 +444,25 @@ unsigned int DataRemapTable::ConvertFrom(unsigned int sourceData) const
 {
 	unsigned int result = 0;
 
-	if(useMethodConversionTableFrom)
+	if(useMethodShiftAndMask && !useMethodConversionTableFrom)
+	{
+		result = ((sourceData >> insertBottomBitCount) << discardBottomBitCount) & bitMaskOriginal;
+	}
+	else if(useMethodConversionTableFrom)
 	{
 		result = conversionTableFrom[(sourceData & bitMaskConverted) >> insertBottomBitCount];
 	}
-	else if(useMethodShiftAndMask)
+	else if(useMethodBitExtract)
 	{
-		result = ((sourceData >> insertBottomBitCount) << discardBottomBitCount) & bitMaskOriginal;
+		result = _pdep_u32(_pext_u32(sourceData, bitMaskConverted), bitMaskOriginal);
+	}
+	else if(useMethodSplitTableFrom)
+	{
+		const unsigned int* splitTable = &splitTableFrom[0];
+		result = splitTable[sourceData & (splitTableEntryCount - 1)];
+		result |= splitTable[splitTableEntryCount + ((sourceData >> splitTableBitCount) & (splitTableEntryCount - 1))];
+		result |= splitTable[(2 * splitTableEntryCount) + ((sourceData >> (2 * splitTableBitCount)) & (splitTableEntryCount - 1))];
+		result |= splitTable[(3 * splitTableEntryCount) + ((sourceData >> (3 * splitTableBitCount)) & (splitTableEntryCount - 1))];
 	}
 	else
 	{
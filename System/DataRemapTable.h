@@ -27,6 +27,17 @@ private:
 	struct BitMapping;
 	struct MappingElement;
 
+	//Constants
+	static const unsigned int splitTableCount = 4;
+	static const unsigned int splitTableBitCount = 8;
+	static const unsigned int splitTableEntryCount = 1 << splitTableBitCount;
+
+private:
+	//Conversion table functions
+	void BuildSplitTables();
+	static bool IsBitExtractInstructionSupported();
+	static bool QueryBitExtractInstructionSupport();
+
 private:
 	//Mapping settings
 	unsigned int bitMaskOriginal;   //Mask of the lines to preserve in the original data
@@ -43,6 +54,9 @@ private:
 	bool useMethodConversionTableTo;
 	bool useMethodConversionTableFrom;
 	bool useMethodShiftAndMask;
+	bool useMethodBitExtract;
+	bool useMethodSplitTableTo;
+	bool useMethodSplitTableFrom;
 
 	//Manual bit mapping data
 	unsigned int dataBitMappingsSize; //We cache this purely as a paranoid optimization
@@ -54,6 +68,8 @@ private:
 	unsigned int conversionTableFromMaxBitCount;
 	std::vector<unsigned int> conversionTableTo;
 	std::vector<unsigned int> conversionTableFrom;
+	std::vector<unsigned int> splitTableTo;
+	std::vector<unsigned int> splitTableFrom;
 };
 
 #include "DataRemapTable.inl"
@@ -0,0 +1,191 @@
+#include "EventLogRing.h"
+#include <thread>
+
+//----------------------------------------------------------------------------------------
+//Constructors
+//----------------------------------------------------------------------------------------
+EventLogRing::EventLogRing(unsigned int acapacity)
+:slots(acapacity), firstTicket(0), nextTicket(0), activeWriterCount(0), exclusiveAccessRequested(false), modifiedToken(0)
+{}
+
+//----------------------------------------------------------------------------------------
+//Capacity functions
+//----------------------------------------------------------------------------------------
+unsigned int EventLogRing::GetCapacity() const
+{
+	return (unsigned int)slots.size();
+}
+
+//----------------------------------------------------------------------------------------
+void EventLogRing::SetCapacity(unsigned int acapacity)
+{
+	std::unique_lock<std::mutex> lock(readMutex);
+	BeginExclusiveAccess();
+
+	//Move as many of the newest entries as will fit into a new set of slots. Since the
+	//retained entries have consecutive tickets, they each map to a different slot.
+	unsigned long long endTicket = nextTicket;
+	unsigned long long retainedEntryCount = endTicket - firstTicket;
+	retainedEntryCount = (retainedEntryCount < (unsigned long long)slots.size())? retainedEntryCount: (unsigned long long)slots.size();
+	retainedEntryCount = (retainedEntryCount < (unsigned long long)acapacity)? retainedEntryCount: (unsigned long long)acapacity;
+	std::vector<Slot> newSlots(acapacity);
+	for(unsigned long long ticket = endTicket - retainedEntryCount; ticket < endTicket; ++ticket)
+	{
+		Slot& sourceSlot = slots[(size_t)(ticket % slots.size())];
+		if(sourceSlot.written && (sourceSlot.ticket == ticket))
+		{
+			Slot& targetSlot = newSlots[(size_t)(ticket % acapacity)];
+			targetSlot.written = true;
+			targetSlot.ticket = ticket;
+			std::swap(targetSlot.entry, sourceSlot.entry);
+		}
+	}
+	slots.swap(newSlots);
+	firstTicket = endTicket - retainedEntryCount;
+	++modifiedToken;
+
+	EndExclusiveAccess();
+}
+
+//----------------------------------------------------------------------------------------
+//Write functions
+//----------------------------------------------------------------------------------------
+void EventLogRing::Write(Entry& entry)
+{
+	//If the log has no capacity, abort any further processing.
+	BeginWrite();
+	if(slots.empty())
+	{
+		EndWrite();
+		return;
+	}
+
+	//Claim the next ticket, and lock the slot it maps to. This only waits if a reader is
+	//currently copying this slot, or another writer which claimed this slot a whole lap
+	//of the ring earlier is still filling it.
+	unsigned long long ticket = nextTicket++;
+	Slot& slot = slots[(size_t)(ticket % slots.size())];
+	LockSlot(slot);
+
+	//Swap the new entry into the slot, overwriting the oldest entry. If a writer which
+	//claimed a later ticket has already filled this slot, our entry is older than any
+	//entry the log now holds, so we discard it, just as it would have been overwritten.
+	//Note that we swap the string contents here rather than copying them, so that no
+	//memory allocation occurs while the slot is locked. The old entry data is returned
+	//to the caller to be released.
+	if(!slot.written || (slot.ticket < ticket))
+	{
+		slot.written = true;
+		slot.ticket = ticket;
+		std::swap(slot.entry, entry);
+	}
+	UnlockSlot(slot);
+	EndWrite();
+	++modifiedToken;
+}
+
+//----------------------------------------------------------------------------------------
+//Read functions
+//----------------------------------------------------------------------------------------
+void EventLogRing::Read(std::vector<Entry>& entries)
+{
+	//Copy the log entries from newest to oldest. Writers continue to run while we step
+	//through the slots, so we skip any slot which is still waiting on its writer, or
+	//which has already been overwritten with a newer entry. These entries will appear
+	//when the log is next read.
+	std::unique_lock<std::mutex> lock(readMutex);
+	entries.clear();
+	unsigned long long endTicket = nextTicket;
+	unsigned long long entryCount = endTicket - firstTicket;
+	entryCount = (entryCount < (unsigned long long)slots.size())? entryCount: (unsigned long long)slots.size();
+	entries.reserve((size_t)entryCount);
+	for(unsigned long long i = 1; i <= entryCount; ++i)
+	{
+		unsigned long long ticket = endTicket - i;
+		Slot& slot = slots[(size_t)(ticket % slots.size())];
+		LockSlot(slot);
+		if(slot.written && (slot.ticket == ticket))
+		{
+			entries.push_back(slot.entry);
+		}
+		UnlockSlot(slot);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void EventLogRing::Clear()
+{
+	std::unique_lock<std::mutex> lock(readMutex);
+	BeginExclusiveAccess();
+	for(unsigned int i = 0; i < (unsigned int)slots.size(); ++i)
+	{
+		slots[i].written = false;
+		slots[i].entry = Entry();
+	}
+	firstTicket = nextTicket;
+	++modifiedToken;
+	EndExclusiveAccess();
+}
+
+//----------------------------------------------------------------------------------------
+//Slot functions
+//----------------------------------------------------------------------------------------
+void EventLogRing::LockSlot(Slot& slot)
+{
+	while(slot.locked.exchange(true, std::memory_order_acquire))
+	{
+		std::this_thread::yield();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void EventLogRing::UnlockSlot(Slot& slot)
+{
+	slot.locked.store(false, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------
+//Exclusive access functions
+//----------------------------------------------------------------------------------------
+//Writers never block each other on a shared lock, but resizing or clearing the log
+//needs to know that no writer is using the slots. Each writer registers itself with an
+//atomic counter while it works, and the exclusive access functions raise a flag which
+//holds back new writers, then wait for the counter to drain. Note that the counter is
+//incremented before the flag is tested, and the flag is set before the counter is
+//tested, so a writer and an exclusive access request can never both proceed.
+//----------------------------------------------------------------------------------------
+void EventLogRing::BeginWrite()
+{
+	++activeWriterCount;
+	while(exclusiveAccessRequested)
+	{
+		--activeWriterCount;
+		while(exclusiveAccessRequested)
+		{
+			std::this_thread::yield();
+		}
+		++activeWriterCount;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void EventLogRing::EndWrite()
+{
+	--activeWriterCount;
+}
+
+//----------------------------------------------------------------------------------------
+void EventLogRing::BeginExclusiveAccess()
+{
+	exclusiveAccessRequested = true;
+	while(activeWriterCount != 0)
+	{
+		std::this_thread::yield();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void EventLogRing::EndExclusiveAccess()
+{
+	exclusiveAccessRequested = false;
+}
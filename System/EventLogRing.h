@@ -0,0 +1,63 @@
+#ifndef __EVENTLOGRING_H__
+#define __EVENTLOGRING_H__
+#include "DeviceInterface/DeviceInterface.pkg"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+//An event log ring holds the most recent entries written to the system event log, in a
+//fixed number of preallocated slots. Any number of threads can write entries at the same
+//time without taking a shared lock. Each writer claims the next slot with an atomic
+//counter, and only waits if a reader, or a writer which has lapped the entire ring, is
+//currently using that same slot. Entries are stored in their raw form, and the caller
+//formats them for display when the log is read.
+class EventLogRing
+{
+public:
+	//Structures
+	struct Entry;
+
+public:
+	//Constructors
+	explicit EventLogRing(unsigned int acapacity = 0);
+
+	//Capacity functions
+	unsigned int GetCapacity() const;
+	void SetCapacity(unsigned int acapacity);
+
+	//Write functions
+	void Write(Entry& entry);
+
+	//Read functions
+	void Read(std::vector<Entry>& entries);
+	void Clear();
+	inline unsigned int GetModifiedToken() const;
+
+private:
+	//Structures
+	struct Slot;
+
+private:
+	//Slot functions
+	static void LockSlot(Slot& slot);
+	static void UnlockSlot(Slot& slot);
+
+	//Exclusive access functions
+	void BeginWrite();
+	void EndWrite();
+	void BeginExclusiveAccess();
+	void EndExclusiveAccess();
+
+private:
+	std::mutex readMutex;
+	std::vector<Slot> slots;
+	unsigned long long firstTicket;
+	std::atomic<unsigned long long> nextTicket;
+	std::atomic<unsigned int> activeWriterCount;
+	std::atomic<bool> exclusiveAccessRequested;
+	std::atomic<unsigned int> modifiedToken;
+};
+
+#include "EventLogRing.inl"
+#endif
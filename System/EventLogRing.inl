@@ -0,0 +1,44 @@
+//----------------------------------------------------------------------------------------
+//Structures
+//----------------------------------------------------------------------------------------
+struct EventLogRing::Entry
+{
+	Entry()
+	:eventLevel(ILogEntry::EventLevel::Info), hour(0), minute(0), second(0), millisecond(0)
+	{}
+
+	ILogEntry::EventLevel eventLevel;
+	int hour;
+	int minute;
+	int second;
+	int millisecond;
+	std::wstring text;
+	std::wstring source;
+	std::wstring timeString; //Only set if the log entry couldn't supply its raw time
+};
+
+//----------------------------------------------------------------------------------------
+struct EventLogRing::Slot
+{
+	Slot()
+	:locked(false), written(false), ticket(0)
+	{}
+	//Slots are only ever copied while the slot vector is first being allocated, before
+	//any other thread can access them, so a copy always begins unlocked.
+	Slot(const Slot& source)
+	:locked(false), written(source.written), ticket(source.ticket), entry(source.entry)
+	{}
+
+	std::atomic<bool> locked;
+	bool written;
+	unsigned long long ticket;
+	Entry entry;
+};
+
+//----------------------------------------------------------------------------------------
+//Read functions
+//----------------------------------------------------------------------------------------
+unsigned int EventLogRing::GetModifiedToken() const
+{
+	return modifiedToken;
+}
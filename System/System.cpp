@@ -17,10 +17,9 @@
 //Constructors
 //----------------------------------------------------------------------------------------
 System::System(IGUIExtensionInterface& aguiExtensionInterface)
-:guiExtensionInterface(aguiExtensionInterface), stopSystem(false), systemStopped(true), initialize(true), rollback(false), performingSingleDeviceStep(false), enableThrottling(true), runWhenProgramModuleLoaded(true), enablePersistentState(true)
+:guiExtensionInterface(aguiExtensionInterface), stopSystem(false), systemStopped(true), initialize(true), rollback(false), performingSingleDeviceStep(false), enableThrottling(true), throttlingSleepOnly(false), runWhenProgramModuleLoaded(true), enablePersistentState(true)
 {
-	eventLogSize = 500;
-	eventLogLastModifiedToken = 0;
+	eventLog.SetCapacity(500);
 
 	embeddedROMInfoLastModifiedToken = 0;
 
@@ -1316,30 +1315,45 @@ bool System::DoesLoadedModuleMatchSavedModule(const SavedRelationshipMap& savedR
 //----------------------------------------------------------------------------------------
 void System::WriteLogEvent(const ILogEntry& entry) const
 {
-	std::unique_lock<std::mutex> lock(eventLogMutex);
-	SystemLogEntry logEntryInternal;
+	//Extract the raw log entry data. The event level and time are stored as they are,
+	//and only formatted into strings when the event log is read. Log entries built
+	//against the first version of the interface can't supply their raw time, so we take
+	//their time string instead.
+	EventLogRing::Entry logEntryInternal;
+	logEntryInternal.eventLevel = entry.GetEventLevel();
 	logEntryInternal.text = entry.GetText();
 	logEntryInternal.source = entry.GetSource();
-	logEntryInternal.eventLevel = entry.GetEventLevel();
-	logEntryInternal.eventLevelString = entry.GetEventLevelString();
-	logEntryInternal.eventTimeString = entry.GetTimeString();
-	log.push_front(logEntryInternal);
-	if(log.size() > eventLogSize)
+	if(entry.GetILogEntryVersion() >= 2)
 	{
-		log.pop_back();
+		entry.GetTime(logEntryInternal.hour, logEntryInternal.minute, logEntryInternal.second, logEntryInternal.millisecond);
 	}
-	++eventLogLastModifiedToken;
+	else
+	{
+		logEntryInternal.timeString = entry.GetTimeString();
+	}
+
+	//Write the entry into the event log. This doesn't take a lock shared with other
+	//threads which are logging events, so emulation threads aren't serialized here.
+	eventLog.Write(logEntryInternal);
 }
 
 //----------------------------------------------------------------------------------------
 MarshalSupport::Marshal::Ret<std::vector<System::SystemLogEntry>> System::GetEventLog() const
 {
-	std::unique_lock<std::mutex> lock(eventLogMutex);
-	std::vector<SystemLogEntry> eventLogCopy(log.size());
-	unsigned int eventLogCopyIndex = 0;
-	for(std::list<SystemLogEntry>::const_iterator i = log.begin(); i != log.end(); ++i)
-	{
-		eventLogCopy[eventLogCopyIndex++] = *i;
+	//Return the log entries from newest to oldest, formatting the event level and time
+	//of each entry for display.
+	std::vector<EventLogRing::Entry> logEntries;
+	eventLog.Read(logEntries);
+	std::vector<SystemLogEntry> eventLogCopy(logEntries.size());
+	for(unsigned int i = 0; i < (unsigned int)logEntries.size(); ++i)
+	{
+		EventLogRing::Entry& sourceEntry = logEntries[i];
+		SystemLogEntry& targetEntry = eventLogCopy[i];
+		targetEntry.eventLevel = sourceEntry.eventLevel;
+		targetEntry.text.swap(sourceEntry.text);
+		targetEntry.source.swap(sourceEntry.source);
+		targetEntry.eventLevelString = LogEntry::FormatEventLevelString(sourceEntry.eventLevel);
+		targetEntry.eventTimeString = sourceEntry.timeString.empty()? LogEntry::FormatTimeString(sourceEntry.hour, sourceEntry.minute, sourceEntry.second, sourceEntry.millisecond): sourceEntry.timeString;
 	}
 	return eventLogCopy;
 }
@@ -1347,35 +1361,29 @@ MarshalSupport::Marshal::Ret<std::vector<System::SystemLogEntry>> System::GetEve
 //----------------------------------------------------------------------------------------
 unsigned int System::GetEventLogLastModifiedToken() const
 {
-	std::unique_lock<std::mutex> lock(eventLogMutex);
-	return eventLogLastModifiedToken;
+	//Note that no lock is required here. The token is atomic, so a reader always sees a
+	//whole value, and a stale read simply defers the refresh of the caller.
+	return eventLog.GetModifiedToken();
 }
 
 //----------------------------------------------------------------------------------------
 void System::ClearEventLog()
 {
-	std::unique_lock<std::mutex> lock(eventLogMutex);
-	log.clear();
-	++eventLogLastModifiedToken;
+	eventLog.Clear();
 }
 
 //----------------------------------------------------------------------------------------
 unsigned int System::GetEventLogSize() const
 {
-	std::unique_lock<std::mutex> lock(eventLogMutex);
-	return eventLogSize;
+	return eventLog.GetCapacity();
 }
 
 //----------------------------------------------------------------------------------------
 void System::SetEventLogSize(unsigned int alogSize)
 {
-	std::unique_lock<std::mutex> lock(eventLogMutex);
-	eventLogSize = alogSize;
-	while(log.size() > eventLogSize)
-	{
-		log.pop_back();
-	}
-	++eventLogLastModifiedToken;
+	//Rebuild the event log at the new size, retaining as many of the newest log entries
+	//as will fit.
+	eventLog.SetCapacity(alogSize);
 }
 
 //----------------------------------------------------------------------------------------
@@ -2065,6 +2073,25 @@ void System::SetThrottlingState(bool state)
 	enableThrottling = state;
 }
 
+//----------------------------------------------------------------------------------------
+bool System::GetThrottlingSleepOnlyState() const
+{
+	return throttlingSleepOnly;
+}
+
+//----------------------------------------------------------------------------------------
+void System::SetThrottlingSleepOnlyState(bool state)
+{
+	throttlingSleepOnly = state;
+}
+
+//----------------------------------------------------------------------------------------
+System::ThrottlingStatistics System::GetThrottlingStatistics() const
+{
+	std::unique_lock<std::mutex> lock(throttlingStatisticsMutex);
+	return throttlingStatistics;
+}
+
 //----------------------------------------------------------------------------------------
 bool System::GetRunWhenProgramModuleLoadedState() const
 {
@@ -2386,7 +2413,10 @@ void System::ExecuteThread()
 
 	//Main system loop
 	double accumulatedExecutionTime = 0;
-	PerformanceTimer timer;
+	FramePacer framePacer;
+	std::unique_lock<std::mutex> throttlingStatisticsLock(throttlingStatisticsMutex);
+	throttlingStatistics = ThrottlingStatistics();
+	throttlingStatisticsLock.unlock();
 	while(!stopSystem)
 	{
 		//Initialize all devices if it has been requested
@@ -2422,8 +2452,22 @@ void System::ExecuteThread()
 		if(accumulatedExecutionTime >= 20000000.0)
 //		if(accumulatedExecutionTime >= 1000000000.0)
 		{
-			timer.Sync(accumulatedExecutionTime, enableThrottling, guiExtensionInterface.GetGlobalPreferenceShowDebugConsole());
+			framePacer.SetPacingMode(throttlingSleepOnly? FramePacer::PacingMode::SleepOnly: FramePacer::PacingMode::Precise);
+			framePacer.Sync(accumulatedExecutionTime, enableThrottling, guiExtensionInterface.GetGlobalPreferenceShowDebugConsole());
 			accumulatedExecutionTime = 0;
+
+			//Publish the latest pacing statistics for the GUI
+			FramePacer::JitterStatistics jitterStatistics = framePacer.GetJitterStatistics();
+			throttlingStatisticsLock.lock();
+			throttlingStatistics.syncCount = jitterStatistics.syncCount;
+			throttlingStatistics.resyncCount = jitterStatistics.resyncCount;
+			throttlingStatistics.meanErrorInNanoseconds = jitterStatistics.meanErrorInNanoseconds;
+			throttlingStatistics.errorStandardDeviationInNanoseconds = jitterStatistics.errorStandardDeviationInNanoseconds;
+			throttlingStatistics.minErrorInNanoseconds = jitterStatistics.minErrorInNanoseconds;
+			throttlingStatistics.maxErrorInNanoseconds = jitterStatistics.maxErrorInNanoseconds;
+			throttlingStatistics.sleepMarginInNanoseconds = jitterStatistics.sleepMarginInNanoseconds;
+			throttlingStatistics.spinTimeInNanoseconds = jitterStatistics.spinTimeInNanoseconds;
+			throttlingStatisticsLock.unlock();
 		}
 	}
 
@@ -3515,124 +3559,124 @@ bool System::LoadModuleInternal(const std::wstring& filePath, const ConnectorMap
 	NameToIDMap connectorNameToIDMap;
 	NameToIDMap lineGroupNameToIDMap;
 	unsigned int entriesProcessed = 0;
-	std::list<IHierarchicalStorageNode*> childList = rootNode.GetChildList();
-	unsigned int entryCount = (unsigned int)childList.size();
-	for(std::list<IHierarchicalStorageNode*>::const_iterator i = childList.begin(); !loadSystemAbort && (i != childList.end()); ++i)
+	unsigned int entryCount = rootNode.GetChildCount();
+	for(unsigned int childIndex = 0; !loadSystemAbort && (childIndex < entryCount); ++childIndex)
 	{
 		loadSystemProgress = ((float)++entriesProcessed / (float)entryCount);
 
-		std::wstring elementName = (*i)->GetName();
+		IHierarchicalStorageNode& childNode = *rootNode.GetChildAtIndex(childIndex);
+		std::wstring elementName = childNode.GetName();
 		if(elementName == L"Device")
 		{
-			loadedWithoutErrors &= LoadModule_Device(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Device(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Device.SetDependentDevice")
 		{
-			loadedWithoutErrors &= LoadModule_Device_SetDependentDevice(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Device_SetDependentDevice(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Device.ReferenceDevice")
 		{
-			loadedWithoutErrors &= LoadModule_Device_ReferenceDevice(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Device_ReferenceDevice(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Device.ReferenceExtension")
 		{
-			loadedWithoutErrors &= LoadModule_Device_ReferenceExtension(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Device_ReferenceExtension(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Device.ReferenceBus")
 		{
-			loadedWithoutErrors &= LoadModule_Device_ReferenceBus(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Device_ReferenceBus(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Device.ReferenceClockSource")
 		{
-			loadedWithoutErrors &= LoadModule_Device_ReferenceClockSource(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Device_ReferenceClockSource(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Device.RegisterInput")
 		{
-			loadedWithoutErrors &= LoadModule_Device_RegisterInput(*(*i), moduleInfo.moduleID, inputRegistrationRequests);
+			loadedWithoutErrors &= LoadModule_Device_RegisterInput(childNode, moduleInfo.moduleID, inputRegistrationRequests);
 		}
 		else if(elementName == L"GlobalExtension")
 		{
-			loadedWithoutErrors &= LoadModule_GlobalExtension(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_GlobalExtension(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Extension")
 		{
-			loadedWithoutErrors &= LoadModule_Extension(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Extension(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Extension.ReferenceDevice")
 		{
-			loadedWithoutErrors &= LoadModule_Extension_ReferenceDevice(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Extension_ReferenceDevice(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Extension.ReferenceExtension")
 		{
-			loadedWithoutErrors &= LoadModule_Extension_ReferenceExtension(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Extension_ReferenceExtension(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Extension.ReferenceBus")
 		{
-			loadedWithoutErrors &= LoadModule_Extension_ReferenceBus(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Extension_ReferenceBus(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"Extension.ReferenceClockSource")
 		{
-			loadedWithoutErrors &= LoadModule_Extension_ReferenceClockSource(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_Extension_ReferenceClockSource(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.DefineLineGroup")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_DefineLineGroup(*(*i), moduleInfo.moduleID, lineGroupNameToIDMap);
+			loadedWithoutErrors &= LoadModule_BusInterface_DefineLineGroup(childNode, moduleInfo.moduleID, lineGroupNameToIDMap);
 		}
 		else if(elementName == L"BusInterface.DefineCELineMemory")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_DefineCELineMemory(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_DefineCELineMemory(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.DefineCELinePort")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_DefineCELinePort(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_DefineCELinePort(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.MapCELineInputMemory")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_MapCELineInputMemory(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_MapCELineInputMemory(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.MapCELineInputPort")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_MapCELineInputPort(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_MapCELineInputPort(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.MapCELineOutputMemory")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_MapCELineOutputMemory(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_MapCELineOutputMemory(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.MapCELineOutputPort")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_MapCELineOutputPort(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_MapCELineOutputPort(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.MapDevice")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_MapDevice(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_MapDevice(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.MapPort")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_MapPort(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_MapPort(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.MapLine")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_MapLine(*(*i), moduleInfo.moduleID, lineGroupNameToIDMap);
+			loadedWithoutErrors &= LoadModule_BusInterface_MapLine(childNode, moduleInfo.moduleID, lineGroupNameToIDMap);
 		}
 		else if(elementName == L"BusInterface.MapClockSource")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_MapClockSource(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_MapClockSource(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"BusInterface.UnmappedLineState")
 		{
-			loadedWithoutErrors &= LoadModule_BusInterface_UnmappedLineState(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_BusInterface_UnmappedLineState(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"ClockSource")
 		{
-			loadedWithoutErrors &= LoadModule_ClockSource(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_ClockSource(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"ClockSource.SetInputClockSource")
 		{
-			loadedWithoutErrors &= LoadModule_ClockSource_SetInputClockSource(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_ClockSource_SetInputClockSource(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"System.OpenView")
 		{
@@ -3641,35 +3685,35 @@ bool System::LoadModuleInternal(const std::wstring& filePath, const ConnectorMap
 			//has loaded successfully. This removes the need to worry about locked threads
 			//waiting for views to open preventing us from doing cleanup of this module,
 			//in the case that the load fails.
-			loadedWithoutErrors &= LoadModule_System_OpenView(*(*i), moduleInfo.moduleID, viewOpenRequests);
+			loadedWithoutErrors &= LoadModule_System_OpenView(childNode, moduleInfo.moduleID, viewOpenRequests);
 		}
 		else if(elementName == L"System.ExportConnector")
 		{
-			loadedWithoutErrors &= LoadModule_System_ExportConnector(*(*i), moduleInfo.moduleID, moduleInfo.systemClassName, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ExportConnector(childNode, moduleInfo.moduleID, moduleInfo.systemClassName, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ExportDevice")
 		{
-			loadedWithoutErrors &= LoadModule_System_ExportDevice(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ExportDevice(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ExportExtension")
 		{
-			loadedWithoutErrors &= LoadModule_System_ExportExtension(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ExportExtension(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ExportBusInterface")
 		{
-			loadedWithoutErrors &= LoadModule_System_ExportBusInterface(*(*i), moduleInfo.moduleID, connectorNameToIDMap, lineGroupNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ExportBusInterface(childNode, moduleInfo.moduleID, connectorNameToIDMap, lineGroupNameToIDMap);
 		}
 		else if(elementName == L"System.ExportClockSource")
 		{
-			loadedWithoutErrors &= LoadModule_System_ExportClockSource(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ExportClockSource(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ExportSystemLine")
 		{
-			loadedWithoutErrors &= LoadModule_System_ExportSystemLine(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ExportSystemLine(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ExportSystemSetting")
 		{
-			loadedWithoutErrors &= LoadModule_System_ExportSystemSetting(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ExportSystemSetting(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ImportConnector")
 		{
@@ -3677,52 +3721,52 @@ bool System::LoadModuleInternal(const std::wstring& filePath, const ConnectorMap
 			//connector to import, specifying a target connector. This is required, in
 			//order to allow the user to specify connections between modules before
 			//performing a load.
-			loadedWithoutErrors &= LoadModule_System_ImportConnector(*(*i), moduleInfo.moduleID, moduleInfo.systemClassName, connectorMappings, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ImportConnector(childNode, moduleInfo.moduleID, moduleInfo.systemClassName, connectorMappings, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ImportDevice")
 		{
-			loadedWithoutErrors &= LoadModule_System_ImportDevice(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ImportDevice(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ImportExtension")
 		{
-			loadedWithoutErrors &= LoadModule_System_ImportExtension(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ImportExtension(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ImportBusInterface")
 		{
-			loadedWithoutErrors &= LoadModule_System_ImportBusInterface(*(*i), moduleInfo.moduleID, connectorNameToIDMap, lineGroupNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ImportBusInterface(childNode, moduleInfo.moduleID, connectorNameToIDMap, lineGroupNameToIDMap);
 		}
 		else if(elementName == L"System.ImportClockSource")
 		{
-			loadedWithoutErrors &= LoadModule_System_ImportClockSource(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ImportClockSource(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ImportSystemLine")
 		{
-			loadedWithoutErrors &= LoadModule_System_ImportSystemLine(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ImportSystemLine(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.ImportSystemSetting")
 		{
-			loadedWithoutErrors &= LoadModule_System_ImportSystemSetting(*(*i), moduleInfo.moduleID, connectorNameToIDMap);
+			loadedWithoutErrors &= LoadModule_System_ImportSystemSetting(childNode, moduleInfo.moduleID, connectorNameToIDMap);
 		}
 		else if(elementName == L"System.DefineEmbeddedROM")
 		{
-			loadedWithoutErrors &= LoadModule_System_DefineEmbeddedROM(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_System_DefineEmbeddedROM(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"System.DefineSystemLine")
 		{
-			loadedWithoutErrors &= LoadModule_System_DefineSystemLine(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_System_DefineSystemLine(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"System.MapSystemLine")
 		{
-			loadedWithoutErrors &= LoadModule_System_MapSystemLine(*(*i), moduleInfo.moduleID);
+			loadedWithoutErrors &= LoadModule_System_MapSystemLine(childNode, moduleInfo.moduleID);
 		}
 		else if(elementName == L"System.Setting")
 		{
-			loadedWithoutErrors &= LoadModule_System_Setting(*(*i), moduleInfo.moduleID, fileName);
+			loadedWithoutErrors &= LoadModule_System_Setting(childNode, moduleInfo.moduleID, fileName);
 		}
 		else if(elementName == L"System.SelectSettingOption")
 		{
 			SystemStateChange systemStateChange;
-			if(LoadModule_System_SelectSettingOption(*(*i), moduleInfo.moduleID, systemStateChange))
+			if(LoadModule_System_SelectSettingOption(childNode, moduleInfo.moduleID, systemStateChange))
 			{
 				systemSettingsChangeRequests.push_back(systemStateChange);
 			}
@@ -3734,7 +3778,7 @@ bool System::LoadModuleInternal(const std::wstring& filePath, const ConnectorMap
 		else if(elementName == L"System.SetClockFrequency")
 		{
 			SystemStateChange systemStateChange;
-			if(LoadModule_System_SetClockFrequency(*(*i), moduleInfo.moduleID, systemStateChange))
+			if(LoadModule_System_SetClockFrequency(childNode, moduleInfo.moduleID, systemStateChange))
 			{
 				systemSettingsChangeRequests.push_back(systemStateChange);
 			}
@@ -3746,7 +3790,7 @@ bool System::LoadModuleInternal(const std::wstring& filePath, const ConnectorMap
 		else if(elementName == L"System.SetLineState")
 		{
 			SystemStateChange systemStateChange;
-			if(LoadModule_System_SetLineState(*(*i), moduleInfo.moduleID, systemStateChange))
+			if(LoadModule_System_SetLineState(childNode, moduleInfo.moduleID, systemStateChange))
 			{
 				systemSettingsChangeRequests.push_back(systemStateChange);
 			}
@@ -26,11 +26,13 @@ should be able to be sent to all devices simultaneously.
 #include "ClockSource.h"
 #include "DeviceContext.h"
 #include "ExecutionManager.h"
+#include "EventLogRing.h"
 #include <string>
 #include <vector>
 #include <map>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 
 //Terminology:
 //Assembly  - An assembly (IE, a dll) which contains the definition of one or more devices
@@ -111,6 +113,9 @@ public:
 	virtual void InitializeDevice(IDevice* device);
 	virtual bool GetThrottlingState() const;
 	virtual void SetThrottlingState(bool state);
+	virtual bool GetThrottlingSleepOnlyState() const;
+	virtual void SetThrottlingSleepOnlyState(bool state);
+	virtual ThrottlingStatistics GetThrottlingStatistics() const;
 	virtual bool GetRunWhenProgramModuleLoadedState() const;
 	virtual void SetRunWhenProgramModuleLoadedState(bool state);
 	virtual bool GetEnablePersistentState() const;
@@ -535,6 +540,9 @@ private:
 	//System settings
 	std::wstring capturePath;
 	bool enableThrottling;
+	bool throttlingSleepOnly;
+	mutable std::mutex throttlingStatisticsMutex;
+	ThrottlingStatistics throttlingStatistics;
 	bool runWhenProgramModuleLoaded;
 	bool enablePersistentState;
 
@@ -551,7 +559,6 @@ private:
 	mutable std::mutex systemStateMutex;
 	mutable std::mutex moduleLoadMutex;
 	mutable std::mutex loadedElementMutex;
-	mutable std::mutex eventLogMutex;
 	mutable std::mutex embeddedROMMutex;
 	mutable std::recursive_mutex moduleSettingMutex;
 
@@ -580,9 +587,7 @@ private:
 	void* rollbackParams;
 
 	//Event log settings
-	unsigned int eventLogSize;
-	mutable unsigned int eventLogLastModifiedToken;
-	mutable std::list<SystemLogEntry> log;
+	mutable EventLogRing eventLog;
 
 	//Notification settings
 	ObserverCollection loadedModuleChangeObservers;
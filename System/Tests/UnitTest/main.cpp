@@ -0,0 +1,542 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "DataRemapTable.h"
+#include "EventLogRing.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <chrono>
+#include <iostream>
+
+//----------------------------------------------------------------------------------------
+//Test data
+//----------------------------------------------------------------------------------------
+struct DataMappingTestEntry
+{
+	const wchar_t* mappingString;
+	unsigned int sourceBitCount;
+};
+
+//These are the data line mappings used by the bundled modules under Data\Modules, paired
+//with the data bus width of the bus they're mapped onto.
+static const DataMappingTestEntry bundledModuleDataMappings[] = {
+	{L"[08]", 16},
+	{L"[00]", 8},
+	{L"[15][14][13][12][11][10][09][08]", 16},
+	{L"[07][06][05][04][03][02][01][00]", 16}};
+static const unsigned int bundledModuleDataMappingCount = sizeof(bundledModuleDataMappings) / sizeof(bundledModuleDataMappings[0]);
+
+//These mappings can't be performed with a shift and mask. The first two keep the source
+//bits in increasing order with gaps between them, so they use the bit extract method when
+//the host supports BMI2. The rest reorder the bits across more than one byte, so they use
+//the split tables.
+static const DataMappingTestEntry remappedDataMappings[] = {
+	{L"[15][12][09][04][03][00]", 16},
+	{L"1[31][27][22]0[16][15][08][07][01]", 32},
+	{L"[00][01][02][03][04][05][06][07][08][09][10][11]", 12},
+	{L"[07][06][05][04][03][02][01][00][15][14][13][12][11][10][09][08]", 16},
+	{L"1[03][17][09]0[22][05][30][11]1", 32}};
+static const unsigned int remappedDataMappingCount = sizeof(remappedDataMappings) / sizeof(remappedDataMappings[0]);
+
+//Bits in a mapping string which are forced to a fixed value are recorded in the list of
+//source bit numbers using these values.
+static const unsigned int forcedBitClear = 0xFFFFFFFE;
+static const unsigned int forcedBitSet = 0xFFFFFFFF;
+
+//----------------------------------------------------------------------------------------
+//Helper functions
+//----------------------------------------------------------------------------------------
+//Builds the list of source bit numbers from a mapping string, with the first entry in the
+//list being the lowest bit in the converted value.
+static std::vector<unsigned int> GetSourceBitNumbers(const std::wstring& mappingString)
+{
+	std::vector<unsigned int> sourceBitNumbers;
+	size_t nextChar = 0;
+	while(nextChar < mappingString.size())
+	{
+		if(mappingString[nextChar] == L'[')
+		{
+			size_t endBracketLocation = mappingString.find(L']', nextChar);
+			sourceBitNumbers.insert(sourceBitNumbers.begin(), (unsigned int)std::stoul(mappingString.substr(nextChar + 1, endBracketLocation - (nextChar + 1))));
+			nextChar = endBracketLocation + 1;
+		}
+		else
+		{
+			sourceBitNumbers.insert(sourceBitNumbers.begin(), (mappingString[nextChar] == L'1')? forcedBitSet: forcedBitClear);
+			++nextChar;
+		}
+	}
+	return sourceBitNumbers;
+}
+
+//----------------------------------------------------------------------------------------
+//Builds the list of values to convert for data of the specified width. Every value is
+//included for data up to 16 bits wide. For wider data, we use every single bit value,
+//along with a fixed pseudo-random sequence of values across the full width.
+static std::vector<unsigned int> BuildConversionTestValues(unsigned int bitCount)
+{
+	std::vector<unsigned int> values;
+	if(bitCount <= 16)
+	{
+		for(unsigned int value = 0; value < (1u << bitCount); ++value)
+		{
+			values.push_back(value);
+		}
+		return values;
+	}
+
+	unsigned int bitMask = (bitCount < 32)? ((1u << bitCount) - 1): 0xFFFFFFFF;
+	values.push_back(0);
+	values.push_back(bitMask);
+	for(unsigned int bitNo = 0; bitNo < bitCount; ++bitNo)
+	{
+		values.push_back(1u << bitNo);
+		values.push_back(bitMask & ~(1u << bitNo));
+	}
+	unsigned int nextValue = 12345;
+	for(unsigned int i = 0; i < 0x10000; ++i)
+	{
+		nextValue = (nextValue * 1664525) + 1013904223;
+		values.push_back(nextValue & bitMask);
+	}
+	return values;
+}
+
+//----------------------------------------------------------------------------------------
+//Converts data to the new mapping one bit at a time, as DataRemapTable did before the
+//split table and bit extract conversion methods were added.
+static unsigned int ReferenceConvertTo(const std::vector<unsigned int>& sourceBitNumbers, unsigned int sourceData)
+{
+	unsigned int result = 0;
+	for(unsigned int i = 0; i < (unsigned int)sourceBitNumbers.size(); ++i)
+	{
+		if(sourceBitNumbers[i] == forcedBitSet)
+		{
+			result |= 1u << i;
+		}
+		else if(sourceBitNumbers[i] != forcedBitClear)
+		{
+			result |= ((sourceData >> sourceBitNumbers[i]) & 1) << i;
+		}
+	}
+	return result;
+}
+
+//----------------------------------------------------------------------------------------
+static unsigned int ReferenceConvertFrom(const std::vector<unsigned int>& sourceBitNumbers, unsigned int convertedData)
+{
+	unsigned int result = 0;
+	for(unsigned int i = 0; i < (unsigned int)sourceBitNumbers.size(); ++i)
+	{
+		if((sourceBitNumbers[i] != forcedBitSet) && (sourceBitNumbers[i] != forcedBitClear))
+		{
+			result |= ((convertedData >> i) & 1) << sourceBitNumbers[i];
+		}
+	}
+	return result;
+}
+
+//----------------------------------------------------------------------------------------
+static void CheckConversionAgainstReference(const DataRemapTable& remapTable, const DataMappingTestEntry& entry)
+{
+	std::vector<unsigned int> sourceBitNumbers = GetSourceBitNumbers(entry.mappingString);
+	REQUIRE(remapTable.GetBitCountConverted() == (unsigned int)sourceBitNumbers.size());
+
+	std::vector<unsigned int> sourceValues = BuildConversionTestValues(entry.sourceBitCount);
+	bool convertToResult = true;
+	for(unsigned int i = 0; i < (unsigned int)sourceValues.size(); ++i)
+	{
+		convertToResult &= (remapTable.ConvertTo(sourceValues[i]) == ReferenceConvertTo(sourceBitNumbers, sourceValues[i]));
+	}
+	CHECK(convertToResult);
+
+	std::vector<unsigned int> convertedValues = BuildConversionTestValues((unsigned int)sourceBitNumbers.size());
+	bool convertFromResult = true;
+	for(unsigned int i = 0; i < (unsigned int)convertedValues.size(); ++i)
+	{
+		convertFromResult &= (remapTable.ConvertFrom(convertedValues[i]) == ReferenceConvertFrom(sourceBitNumbers, convertedValues[i]));
+	}
+	CHECK(convertFromResult);
+}
+
+//----------------------------------------------------------------------------------------
+//Performs the conversion on each value in turn, for the specified number of passes over
+//the values, and returns the time taken. The results are combined into a checksum, so
+//that the conversions can't be optimized away.
+template<class ConvertFunction> static std::chrono::high_resolution_clock::duration TimeConversions(ConvertFunction convertFunction, const std::vector<unsigned int>& values, unsigned int passCount, unsigned int& checksum)
+{
+	checksum = 0;
+	std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int passNo = 0; passNo < passCount; ++passNo)
+	{
+		for(unsigned int i = 0; i < (unsigned int)values.size(); ++i)
+		{
+			checksum = (checksum * 31) + convertFunction(values[i]);
+		}
+	}
+	return std::chrono::high_resolution_clock::now() - startTime;
+}
+
+//----------------------------------------------------------------------------------------
+//Holds the system event log in the same way as the system did before the event log ring
+//was introduced, with every writer taking a shared lock to swap its entry into a
+//circular buffer.
+class ReferenceEventLog
+{
+public:
+	explicit ReferenceEventLog(unsigned int capacity)
+	:log(capacity), nextEntryIndex(0), entryCount(0)
+	{}
+
+	void Write(EventLogRing::Entry& entry)
+	{
+		std::unique_lock<std::mutex> lock(logMutex);
+		std::swap(log[nextEntryIndex], entry);
+		nextEntryIndex = (nextEntryIndex + 1) % (unsigned int)log.size();
+		entryCount = (entryCount < (unsigned int)log.size())? entryCount + 1: entryCount;
+	}
+
+private:
+	std::mutex logMutex;
+	std::vector<EventLogRing::Entry> log;
+	unsigned int nextEntryIndex;
+	unsigned int entryCount;
+};
+
+//----------------------------------------------------------------------------------------
+static EventLogRing::Entry BuildEventLogEntry(const std::wstring& source, unsigned int entryNo)
+{
+	EventLogRing::Entry entry;
+	entry.eventLevel = ILogEntry::EventLevel::Warning;
+	entry.source = source;
+	entry.text = std::to_wstring(entryNo);
+	entry.millisecond = (int)(entryNo % 1000);
+	return entry;
+}
+
+//----------------------------------------------------------------------------------------
+static std::vector<unsigned int> ReadEventLogEntryNumbers(EventLogRing& eventLog)
+{
+	std::vector<EventLogRing::Entry> entries;
+	eventLog.Read(entries);
+	std::vector<unsigned int> entryNumbers;
+	for(unsigned int i = 0; i < (unsigned int)entries.size(); ++i)
+	{
+		entryNumbers.push_back((unsigned int)std::stoul(entries[i].text));
+	}
+	return entryNumbers;
+}
+
+//----------------------------------------------------------------------------------------
+static std::vector<unsigned int> BuildDescendingNumbers(unsigned int firstNumber, unsigned int count)
+{
+	std::vector<unsigned int> numbers;
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		numbers.push_back(firstNumber - i);
+	}
+	return numbers;
+}
+
+//----------------------------------------------------------------------------------------
+template<class EventLogType> static void WriteEventLogEntries(EventLogType& eventLog, std::wstring source, unsigned int entryCount)
+{
+	for(unsigned int entryNo = 0; entryNo < entryCount; ++entryNo)
+	{
+		EventLogRing::Entry entry = BuildEventLogEntry(source, entryNo);
+		eventLog.Write(entry);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Repeatedly reads the event log while it's being written, and ensures that the entries
+//from each source always appear from newest to oldest.
+static void ReadEventLogWhileWriting(EventLogRing& eventLog, unsigned int readCount, bool& entryOrderCorrect)
+{
+	for(unsigned int readNo = 0; readNo < readCount; ++readNo)
+	{
+		std::vector<EventLogRing::Entry> entries;
+		eventLog.Read(entries);
+		std::map<std::wstring, unsigned int> lastEntryNoForSource;
+		for(unsigned int i = 0; i < (unsigned int)entries.size(); ++i)
+		{
+			unsigned int entryNo = (unsigned int)std::stoul(entries[i].text);
+			std::map<std::wstring, unsigned int>::iterator lastEntryNoIterator = lastEntryNoForSource.find(entries[i].source);
+			if((lastEntryNoIterator != lastEntryNoForSource.end()) && (entryNo >= lastEntryNoIterator->second))
+			{
+				entryOrderCorrect = false;
+			}
+			lastEntryNoForSource[entries[i].source] = entryNo;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Tests
+//----------------------------------------------------------------------------------------
+TEST_CASE("DataRemapTable::BundledModuleMappings", "")
+{
+	for(unsigned int mappingNo = 0; mappingNo < bundledModuleDataMappingCount; ++mappingNo)
+	{
+		const DataMappingTestEntry& entry = bundledModuleDataMappings[mappingNo];
+
+		//Build the table both with and without the physical conversion tables, so that we
+		//cover each of the conversion methods the table can select.
+		for(unsigned int tableState = 0; tableState < 2; ++tableState)
+		{
+			DataRemapTable remapTable;
+			remapTable.SetConversionTableState(tableState != 0, tableState != 0);
+			REQUIRE(remapTable.SetDataMapping(entry.mappingString, entry.sourceBitCount));
+			CheckConversionAgainstReference(remapTable, entry);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("DataRemapTable::RemappedMappings", "")
+{
+	for(unsigned int mappingNo = 0; mappingNo < remappedDataMappingCount; ++mappingNo)
+	{
+		const DataMappingTestEntry& entry = remappedDataMappings[mappingNo];
+
+		//Let the table select its own conversion method, which uses the bit extract method
+		//or the split tables depending on the mapping, along with a small conversion table
+		//for any direction which covers no more than a byte.
+		DataRemapTable remapTable;
+		REQUIRE(remapTable.SetDataMapping(entry.mappingString, entry.sourceBitCount));
+		CheckConversionAgainstReference(remapTable, entry);
+
+		//Disable the conversion tables, so that the split tables are used in both
+		//directions wherever the bit extract method isn't available.
+		DataRemapTable splitRemapTable;
+		splitRemapTable.SetConversionTableState(false, false);
+		REQUIRE(splitRemapTable.SetDataMapping(entry.mappingString, entry.sourceBitCount));
+		CheckConversionAgainstReference(splitRemapTable, entry);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("EventLogRing::Write", "")
+{
+	EventLogRing eventLog(8);
+
+	SECTION("Entries are read newest first", "")
+	{
+		WriteEventLogEntries(eventLog, L"Source", 5);
+		REQUIRE(ReadEventLogEntryNumbers(eventLog) == BuildDescendingNumbers(4, 5));
+
+		//Ensure the raw entry data is returned unchanged
+		std::vector<EventLogRing::Entry> entries;
+		eventLog.Read(entries);
+		REQUIRE(entries.size() == 5);
+		CHECK(entries[0].eventLevel == ILogEntry::EventLevel::Warning);
+		CHECK(entries[0].source == L"Source");
+		CHECK(entries[0].millisecond == 4);
+		CHECK(entries[0].timeString.empty());
+	}
+	SECTION("The oldest entries are overwritten when the log is full", "")
+	{
+		WriteEventLogEntries(eventLog, L"Source", 20);
+		REQUIRE(ReadEventLogEntryNumbers(eventLog) == BuildDescendingNumbers(19, 8));
+	}
+	SECTION("Writes to a log with no capacity are discarded", "")
+	{
+		EventLogRing emptyEventLog;
+		WriteEventLogEntries(emptyEventLog, L"Source", 5);
+		REQUIRE(ReadEventLogEntryNumbers(emptyEventLog).empty());
+	}
+	SECTION("Each write updates the modified token", "")
+	{
+		unsigned int initialToken = eventLog.GetModifiedToken();
+		WriteEventLogEntries(eventLog, L"Source", 3);
+		REQUIRE(eventLog.GetModifiedToken() == (initialToken + 3));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("EventLogRing::SetCapacity", "")
+{
+	EventLogRing eventLog(8);
+	WriteEventLogEntries(eventLog, L"Source", 12);
+
+	SECTION("Growing the log retains every entry", "")
+	{
+		eventLog.SetCapacity(32);
+		REQUIRE(eventLog.GetCapacity() == 32);
+		REQUIRE(ReadEventLogEntryNumbers(eventLog) == BuildDescendingNumbers(11, 8));
+
+		//Ensure new entries are added in front of the retained entries, and nothing is
+		//overwritten until the new capacity is reached.
+		WriteEventLogEntries(eventLog, L"Source", 3);
+		std::vector<unsigned int> expectedNumbers = BuildDescendingNumbers(2, 3);
+		std::vector<unsigned int> retainedNumbers = BuildDescendingNumbers(11, 8);
+		expectedNumbers.insert(expectedNumbers.end(), retainedNumbers.begin(), retainedNumbers.end());
+		REQUIRE(ReadEventLogEntryNumbers(eventLog) == expectedNumbers);
+	}
+	SECTION("Shrinking the log retains the newest entries", "")
+	{
+		eventLog.SetCapacity(3);
+		REQUIRE(eventLog.GetCapacity() == 3);
+		REQUIRE(ReadEventLogEntryNumbers(eventLog) == BuildDescendingNumbers(11, 3));
+		WriteEventLogEntries(eventLog, L"Source", 2);
+		std::vector<unsigned int> expectedNumbers = BuildDescendingNumbers(1, 2);
+		expectedNumbers.push_back(11);
+		REQUIRE(ReadEventLogEntryNumbers(eventLog) == expectedNumbers);
+	}
+	SECTION("Shrinking the log to zero discards every entry", "")
+	{
+		eventLog.SetCapacity(0);
+		REQUIRE(ReadEventLogEntryNumbers(eventLog).empty());
+		eventLog.SetCapacity(4);
+		REQUIRE(ReadEventLogEntryNumbers(eventLog).empty());
+		WriteEventLogEntries(eventLog, L"Source", 1);
+		REQUIRE(ReadEventLogEntryNumbers(eventLog) == BuildDescendingNumbers(0, 1));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("EventLogRing::Clear", "")
+{
+	EventLogRing eventLog(8);
+	WriteEventLogEntries(eventLog, L"Source", 12);
+	unsigned int tokenBeforeClear = eventLog.GetModifiedToken();
+	eventLog.Clear();
+	REQUIRE(eventLog.GetModifiedToken() != tokenBeforeClear);
+	REQUIRE(ReadEventLogEntryNumbers(eventLog).empty());
+	WriteEventLogEntries(eventLog, L"Source", 2);
+	REQUIRE(ReadEventLogEntryNumbers(eventLog) == BuildDescendingNumbers(1, 2));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("EventLogRing::ConcurrentWrite", "")
+{
+	//Write entries from several threads at once, while another thread reads the log, and
+	//ensure each read sees the entries from each thread in order. Once the writers have
+	//finished, the log should be full, with no entry appearing more than once.
+	static const unsigned int capacity = 64;
+	static const unsigned int writerCount = 4;
+	static const unsigned int entriesPerWriter = 20000;
+	EventLogRing eventLog(capacity);
+	bool entryOrderCorrect = true;
+	std::vector<std::thread> writers;
+	for(unsigned int writerNo = 0; writerNo < writerCount; ++writerNo)
+	{
+		writers.push_back(std::thread(std::bind(WriteEventLogEntries<EventLogRing>, std::ref(eventLog), L"Writer" + std::to_wstring(writerNo), entriesPerWriter)));
+	}
+	std::thread reader(std::bind(ReadEventLogWhileWriting, std::ref(eventLog), 200, std::ref(entryOrderCorrect)));
+	for(unsigned int writerNo = 0; writerNo < writerCount; ++writerNo)
+	{
+		writers[writerNo].join();
+	}
+	reader.join();
+	REQUIRE(entryOrderCorrect);
+
+	std::vector<EventLogRing::Entry> entries;
+	eventLog.Read(entries);
+	REQUIRE(entries.size() == capacity);
+	std::map<std::wstring, unsigned int> lastEntryNoForSource;
+	for(unsigned int i = 0; i < (unsigned int)entries.size(); ++i)
+	{
+		unsigned int entryNo = (unsigned int)std::stoul(entries[i].text);
+		std::map<std::wstring, unsigned int>::iterator lastEntryNoIterator = lastEntryNoForSource.find(entries[i].source);
+		if(lastEntryNoIterator != lastEntryNoForSource.end())
+		{
+			REQUIRE(entryNo < lastEntryNoIterator->second);
+		}
+		else
+		{
+			//If any entries from a writer remain, the newest must be its last entry,
+			//since that was written after all of its others.
+			REQUIRE(entryNo == (entriesPerWriter - 1));
+		}
+		lastEntryNoForSource[entries[i].source] = entryNo;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+//Benchmarks
+//----------------------------------------------------------------------------------------
+TEST_CASE("DataRemapTable::Convert benchmark", "[.][benchmark]")
+{
+	//Every bus access through a remapped data line converts the data in each direction.
+	//Time ConvertTo and ConvertFrom for each of the test mappings, using the conversion
+	//method the table selects for itself, against the bit by bit conversion the table
+	//used before the split table and bit extract methods were added.
+	static const unsigned int conversionCount = 20000000;
+	std::vector<DataMappingTestEntry> entries(bundledModuleDataMappings, bundledModuleDataMappings + bundledModuleDataMappingCount);
+	entries.insert(entries.end(), remappedDataMappings, remappedDataMappings + remappedDataMappingCount);
+	for(unsigned int mappingNo = 0; mappingNo < (unsigned int)entries.size(); ++mappingNo)
+	{
+		const DataMappingTestEntry& entry = entries[mappingNo];
+		std::vector<unsigned int> sourceBitNumbers = GetSourceBitNumbers(entry.mappingString);
+		DataRemapTable remapTable;
+		REQUIRE(remapTable.SetDataMapping(entry.mappingString, entry.sourceBitCount));
+
+		std::vector<unsigned int> sourceValues = BuildConversionTestValues(entry.sourceBitCount);
+		unsigned int convertToPassCount = (conversionCount + (unsigned int)sourceValues.size() - 1) / (unsigned int)sourceValues.size();
+		unsigned int convertToChecksum;
+		unsigned int referenceConvertToChecksum;
+		std::chrono::high_resolution_clock::duration convertToTime = TimeConversions(std::bind(&DataRemapTable::ConvertTo, std::cref(remapTable), std::placeholders::_1), sourceValues, convertToPassCount, convertToChecksum);
+		std::chrono::high_resolution_clock::duration referenceConvertToTime = TimeConversions(std::bind(ReferenceConvertTo, std::cref(sourceBitNumbers), std::placeholders::_1), sourceValues, convertToPassCount, referenceConvertToChecksum);
+		REQUIRE(convertToChecksum == referenceConvertToChecksum);
+
+		std::vector<unsigned int> convertedValues = BuildConversionTestValues((unsigned int)sourceBitNumbers.size());
+		unsigned int convertFromPassCount = (conversionCount + (unsigned int)convertedValues.size() - 1) / (unsigned int)convertedValues.size();
+		unsigned int convertFromChecksum;
+		unsigned int referenceConvertFromChecksum;
+		std::chrono::high_resolution_clock::duration convertFromTime = TimeConversions(std::bind(&DataRemapTable::ConvertFrom, std::cref(remapTable), std::placeholders::_1), convertedValues, convertFromPassCount, convertFromChecksum);
+		std::chrono::high_resolution_clock::duration referenceConvertFromTime = TimeConversions(std::bind(ReferenceConvertFrom, std::cref(sourceBitNumbers), std::placeholders::_1), convertedValues, convertFromPassCount, referenceConvertFromChecksum);
+		REQUIRE(convertFromChecksum == referenceConvertFromChecksum);
+
+		double convertToCount = (double)sourceValues.size() * (double)convertToPassCount;
+		double convertFromCount = (double)convertedValues.size() * (double)convertFromPassCount;
+		std::wcout << L"\"" << entry.mappingString << L"\", " << entry.sourceBitCount << L":\n";
+		std::wcout << L"\tConvertTo " << (double)std::chrono::duration_cast<std::chrono::nanoseconds>(convertToTime).count() / convertToCount << L"ns, bit by bit " << (double)std::chrono::duration_cast<std::chrono::nanoseconds>(referenceConvertToTime).count() / convertToCount << L"ns\n";
+		std::wcout << L"\tConvertFrom " << (double)std::chrono::duration_cast<std::chrono::nanoseconds>(convertFromTime).count() / convertFromCount << L"ns, bit by bit " << (double)std::chrono::duration_cast<std::chrono::nanoseconds>(referenceConvertFromTime).count() / convertFromCount << L"ns\n";
+	}
+}
+
+//----------------------------------------------------------------------------------------
+TEST_CASE("EventLogRing::Write benchmark", "[.][benchmark]")
+{
+	//Write a burst of log entries from several threads at once, as emulation threads do
+	//when a program triggers a stream of log events, through both the event log ring and
+	//the shared lock used by the old event log.
+	static const unsigned int capacity = 500;
+	static const unsigned int writerCount = 4;
+	static const unsigned int entriesPerWriter = 200000;
+	EventLogRing eventLog(capacity);
+	ReferenceEventLog referenceEventLog(capacity);
+
+	std::vector<std::thread> writers;
+	std::chrono::high_resolution_clock::time_point referenceStartTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int writerNo = 0; writerNo < writerCount; ++writerNo)
+	{
+		writers.push_back(std::thread(std::bind(WriteEventLogEntries<ReferenceEventLog>, std::ref(referenceEventLog), L"Writer" + std::to_wstring(writerNo), entriesPerWriter)));
+	}
+	for(unsigned int writerNo = 0; writerNo < writerCount; ++writerNo)
+	{
+		writers[writerNo].join();
+	}
+	std::chrono::high_resolution_clock::duration referenceTime = std::chrono::high_resolution_clock::now() - referenceStartTime;
+
+	writers.clear();
+	std::chrono::high_resolution_clock::time_point ringStartTime = std::chrono::high_resolution_clock::now();
+	for(unsigned int writerNo = 0; writerNo < writerCount; ++writerNo)
+	{
+		writers.push_back(std::thread(std::bind(WriteEventLogEntries<EventLogRing>, std::ref(eventLog), L"Writer" + std::to_wstring(writerNo), entriesPerWriter)));
+	}
+	for(unsigned int writerNo = 0; writerNo < writerCount; ++writerNo)
+	{
+		writers[writerNo].join();
+	}
+	std::chrono::high_resolution_clock::duration ringTime = std::chrono::high_resolution_clock::now() - ringStartTime;
+
+	double entryCount = (double)writerCount * (double)entriesPerWriter;
+	double referenceNanosecondsPerEntry = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(referenceTime).count() / entryCount;
+	double ringNanosecondsPerEntry = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(ringTime).count() / entryCount;
+	std::wcout << L"Shared lock " << referenceNanosecondsPerEntry << L"ns/entry, event log ring " << ringNanosecondsPerEntry << L"ns/entry\n";
+}